@@ -81,6 +81,19 @@ void DownloadQueueSet::addJob( HttpJob * const job )
     activateJobs();
 }
 
+bool DownloadQueueSet::removeQueuedJob( const QString& destinationFileName )
+{
+    if ( !m_jobs.contains( destinationFileName ))
+        return false;
+
+    HttpJob * const job = m_jobs.take( destinationFileName );
+    mDebug() << "removeQueuedJob:" << destinationFileName
+             << "new job queue size:" << m_jobs.count();
+    emit jobRemoved();
+    job->deleteLater();
+    return true;
+}
+
 void DownloadQueueSet::activateJobs()
 {
     while ( !m_jobs.isEmpty()
@@ -250,6 +263,20 @@ inline void DownloadQueueSet::JobStack::push( HttpJob * const job )
     m_jobsContent.insert( job->destinationFileName() );
 }
 
+inline HttpJob * DownloadQueueSet::JobStack::take( const QString& destinationFileName )
+{
+    Q_ASSERT( contains( destinationFileName ));
+    for ( int i = m_jobs.count() - 1; i >= 0; --i ) {
+        HttpJob * const job = m_jobs.at( i );
+        if ( job->destinationFileName() == destinationFileName ) {
+            m_jobs.remove( i );
+            m_jobsContent.remove( destinationFileName );
+            return job;
+        }
+    }
+    return 0;
+}
+
 
 }
 
@@ -85,6 +85,13 @@ class DownloadQueueSet: public QObject
                        const QString& destinationFileName ) const;
     void addJob( HttpJob * const job );
 
+    /**
+     * Removes the job for @p destinationFileName if it is still waiting in
+     * the queue. Jobs which are being downloaded already are left alone.
+     * Returns whether a job was removed.
+     */
+    bool removeQueuedJob( const QString& destinationFileName );
+
     void activateJobs();
     void retryJobs();
 
@@ -123,6 +130,7 @@ class DownloadQueueSet: public QObject
         bool isEmpty() const;
         HttpJob * pop();
         void push( HttpJob * const );
+        HttpJob * take( const QString& destinationFileName );
     private:
         QStack<HttpJob*> m_jobs;
         QSet<QString> m_jobsContent;
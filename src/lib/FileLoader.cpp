@@ -10,11 +10,15 @@
 
 #include "FileLoader.h"
 
+#include <QtCore/QAtomicInt>
 #include <QtCore/QBuffer>
+#include <QtCore/QCryptographicHash>
 #include <QtCore/QDataStream>
 #include <QtCore/QDateTime>
+#include <QtCore/QEventLoop>
 #include <QtCore/QFile>
 #include <QtCore/QThread>
+#include <QtCore/QTime>
 
 #include "GeoDataParser.h"
 #include "GeoDataDocument.h"
@@ -22,6 +26,7 @@
 #include "GeoDataPlacemark.h"
 #include "GeoDataData.h"
 #include "GeoDataExtendedData.h"
+#include "GeoDataMultiGeometry.h"
 #include "GeoDataStyleMap.h"
 #include "GeoDataTypes.h"
 #include "MarbleClock.h"
@@ -43,6 +48,7 @@ public:
           m_filepath ( file ),
           m_documentRole ( role ),
           m_document( 0 ),
+          m_parsedDocument( 0 ),
           m_clock( model->clock() )
     {
         m_runner->setModel( model );
@@ -56,6 +62,7 @@ public:
           m_contents ( contents ),
           m_documentRole ( role ),
           m_document( 0 ),
+          m_parsedDocument( 0 ),
           m_clock( model->clock() )
     {
         m_runner->setModel( model );
@@ -71,18 +78,30 @@ public:
     void saveFile(const QString& filename );
     void savePlacemarks(QDataStream &out, const GeoDataContainer *container);
 
+    QString snapshotFile( const QString& source ) const;
+    bool isSnapshotable( const GeoDataContainer *container ) const;
+    bool isSnapshotable( const GeoDataGeometry *geometry ) const;
+    static bool readSnapshotHeader( QDataStream &in, QString *source );
+    void pruneSnapshots();
+    GeoDataDocument* loadSnapshot( const QString& source );
+    void saveSnapshot( const QString& source, const GeoDataDocument *document );
+    void resolveStyles( GeoDataContainer *container );
+
     void createFilterProperties( GeoDataContainer *container );
     int cityPopIdx( qint64 population ) const;
     int spacePopIdx( qint64 population ) const;
     int areaPopIdx( qreal area ) const;
 
     void documentParsed( GeoDataDocument *doc, const QString& error);
+    void parsingResult( GeoDataDocument *doc, const QString& error );
 
     FileLoader *q;
     MarbleRunnerManager *m_runner;
     QString m_filepath;
     QString m_contents;
     QString m_nonExistentLocalCacheFile;
+    GeoDataDocument *m_parsedDocument;
+    QString m_parsedError;
     DocumentRole m_documentRole;
     GeoDataDocument *m_document;
     QString m_error;
@@ -183,10 +202,32 @@ void FileLoader::run()
         else {
             mDebug() << "No recent Default Placemark Cache File available!";
             if ( QFile::exists( defaultSourceName ) ) {
+                // a valid snapshot of an earlier parse saves running the parser again
+                GeoDataDocument *snapshot = d->loadSnapshot( defaultSourceName );
+                if ( snapshot ) {
+                    d->documentParsed( snapshot, QString() );
+                    return;
+                }
+
+                QTime parseTime;
+                parseTime.start();
+
                 // use runners: pnt, gpx, osm
+                // Wait for the result in this thread, so that the snapshot is not
+                // written by the GUI thread
+                QEventLoop localEventLoop;
                 connect( d->m_runner, SIGNAL( parsingFinished(GeoDataDocument*,QString) ),
-                        this, SLOT( documentParsed( GeoDataDocument*, QString ) ) );
+                         this, SLOT( parsingResult( GeoDataDocument*, QString ) ), Qt::DirectConnection );
+                connect( d->m_runner, SIGNAL( parsingFinished() ),
+                         &localEventLoop, SLOT( quit() ), Qt::QueuedConnection );
                 d->m_runner->parseFile( defaultSourceName, d->m_documentRole );
+                localEventLoop.exec();
+
+                if ( d->m_parsedDocument ) {
+                    mDebug() << "Parsed" << defaultSourceName << "in" << parseTime.elapsed() << "ms";
+                    d->saveSnapshot( defaultSourceName, d->m_parsedDocument );
+                }
+                d->documentParsed( d->m_parsedDocument, d->m_parsedError );
             } else {
                 mDebug() << "No Default Placemark Source File for " << name;
             }
@@ -202,6 +243,9 @@ void FileLoader::run()
 
 const quint32 MarbleMagicNumber = 0x31415926;
 
+const quint32 SnapshotMagicNumber = 0x534e4150;
+const qint32 SnapshotVersion = 2;
+
 void FileLoaderPrivate::importKmlFromData()
 {
     GeoDataParser parser( GeoData_KML );
@@ -287,6 +331,198 @@ void FileLoaderPrivate::savePlacemarks(QDataStream &out, const GeoDataContainer
     }
 }
 
+QString FileLoaderPrivate::snapshotFile( const QString& source ) const
+{
+    const QByteArray key = QFileInfo( source ).absoluteFilePath().toUtf8();
+    const QString hash = QCryptographicHash::hash( key, QCryptographicHash::Sha1 ).toHex();
+    return MarbleDirs::localPath() + "/cache/documents/" + hash + ".snapshot";
+}
+
+bool FileLoaderPrivate::isSnapshotable( const GeoDataContainer *container ) const
+{
+    // Mirrors what GeoDataContainer::unpack() and GeoDataPlacemark::unpack() are able to restore
+    QVector<GeoDataFeature*>::ConstIterator i = container->constBegin();
+    QVector<GeoDataFeature*>::ConstIterator const end = container->constEnd();
+    for (; i != end; ++i ) {
+        if ( (*i)->nodeType() == GeoDataTypes::GeoDataFolderType ) {
+            if ( !isSnapshotable( static_cast<const GeoDataContainer*>( *i ) ) ) {
+                return false;
+            }
+        } else if ( (*i)->nodeType() == GeoDataTypes::GeoDataPlacemarkType ) {
+            const GeoDataGeometry *geometry = static_cast<const GeoDataPlacemark*>( *i )->geometry();
+            if ( geometry && !isSnapshotable( geometry ) ) {
+                return false;
+            }
+        } else {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool FileLoaderPrivate::isSnapshotable( const GeoDataGeometry *geometry ) const
+{
+    switch ( geometry->geometryId() ) {
+    case GeoDataModelId:
+    case GeoDataTrackId:
+        return false;
+    case GeoDataMultiGeometryId:
+        {
+        const GeoDataMultiGeometry *multiGeometry = static_cast<const GeoDataMultiGeometry*>( geometry );
+        for ( int i = 0; i < multiGeometry->size(); ++i ) {
+            if ( !isSnapshotable( &multiGeometry->at( i ) ) ) {
+                return false;
+            }
+        }
+        }
+        return true;
+    default:
+        return true;
+    }
+}
+
+bool FileLoaderPrivate::readSnapshotHeader( QDataStream &in, QString *source )
+{
+    quint32 magicNumber;
+    qint32 version;
+    in >> magicNumber >> version;
+    if ( magicNumber != SnapshotMagicNumber || version != SnapshotVersion ) {
+        return false;
+    }
+
+    qint64 size;
+    QDateTime lastModified;
+    in >> *source >> size >> lastModified;
+    const QFileInfo sourceInfo( *source );
+    return in.status() == QDataStream::Ok && sourceInfo.exists()
+        && size == sourceInfo.size() && lastModified == sourceInfo.lastModified();
+}
+
+void FileLoaderPrivate::pruneSnapshots()
+{
+    // Several loaders run at startup, one of them is enough
+    static QAtomicInt pruned;
+    if ( !pruned.testAndSetOrdered( 0, 1 ) ) {
+        return;
+    }
+
+    // Snapshots are named by a hash, so check the source stored in each of them
+    const QDir directory( MarbleDirs::localPath() + "/cache/documents/" );
+    foreach ( const QFileInfo &info, directory.entryInfoList( QStringList() << "*.snapshot", QDir::Files ) ) {
+        QFile file( info.absoluteFilePath() );
+        if ( !file.open( QIODevice::ReadOnly ) ) {
+            continue;
+        }
+
+        QDataStream in( &file );
+        in.setVersion( QDataStream::Qt_4_2 );
+        QString source;
+        if ( !readSnapshotHeader( in, &source ) ) {
+            mDebug() << "Removing snapshot" << file.fileName() << "of the removed or changed file" << source;
+            file.close();
+            file.remove();
+        }
+    }
+}
+
+GeoDataDocument* FileLoaderPrivate::loadSnapshot( const QString& source )
+{
+    pruneSnapshots();
+
+    QFile file( snapshotFile( source ) );
+    if ( !file.open( QIODevice::ReadOnly ) ) {
+        return 0;
+    }
+
+    QTime time;
+    time.start();
+
+    QDataStream in( &file );
+    in.setVersion( QDataStream::Qt_4_2 );
+
+    QString path;
+    if ( !readSnapshotHeader( in, &path ) || path != QFileInfo( source ).absoluteFilePath() ) {
+        mDebug() << "Removing outdated snapshot of" << source;
+        file.close();
+        file.remove();
+        return 0;
+    }
+
+    GeoDataDocument *document = new GeoDataDocument;
+    document->unpack( in );
+    if ( in.status() != QDataStream::Ok ) {
+        mDebug() << "Removing corrupt snapshot of" << source;
+        delete document;
+        file.close();
+        file.remove();
+        return 0;
+    }
+
+    document->setDocumentRole( m_documentRole );
+    resolveStyles( document );
+
+    mDebug() << "Loaded snapshot of" << source << "in" << time.elapsed() << "ms";
+    return document;
+}
+
+void FileLoaderPrivate::saveSnapshot( const QString& source, const GeoDataDocument *document )
+{
+    if ( !isSnapshotable( document ) ) {
+        mDebug() << "Not creating a snapshot of" << source << "because of unsupported features";
+        return;
+    }
+
+    const QString directory = MarbleDirs::localPath() + "/cache/documents/";
+    if ( !QDir( directory ).exists() ) {
+        QDir::root().mkpath( directory );
+    }
+
+    const QString filename = snapshotFile( source );
+    QFile file( filename + ".part" );
+    if ( !file.open( QIODevice::WriteOnly ) ) {
+        mDebug() << Q_FUNC_INFO << "Can't open" << file.fileName() << "for writing";
+        return;
+    }
+
+    QTime time;
+    time.start();
+
+    QDataStream out( &file );
+    out.setVersion( QDataStream::Qt_4_2 );
+
+    const QFileInfo sourceInfo( source );
+    out << SnapshotMagicNumber << SnapshotVersion;
+    out << sourceInfo.absoluteFilePath() << sourceInfo.size() << sourceInfo.lastModified();
+    document->pack( out );
+    file.close();
+
+    // Only replace the old snapshot once the new one is complete
+    QFile::remove( filename );
+    if ( out.status() != QDataStream::Ok || !file.rename( filename ) ) {
+        mDebug() << "Failed to write snapshot" << filename;
+        file.remove();
+        return;
+    }
+
+    mDebug() << "Created snapshot of" << source << "in" << time.elapsed() << "ms";
+}
+
+void FileLoaderPrivate::resolveStyles( GeoDataContainer *container )
+{
+    // Shared styles are only referenced by styleUrl in a snapshot
+    QVector<GeoDataFeature*>::Iterator i = container->begin();
+    QVector<GeoDataFeature*>::Iterator const end = container->end();
+    for (; i != end; ++i ) {
+        if ( (*i)->nodeType() == GeoDataTypes::GeoDataFolderType ) {
+            resolveStyles( static_cast<GeoDataContainer*>( *i ) );
+        }
+        if ( !(*i)->styleUrl().isEmpty() ) {
+            (*i)->setStyleUrl( (*i)->styleUrl() );
+        }
+    }
+}
+
 void FileLoaderPrivate::documentParsed( GeoDataDocument* doc, const QString& error )
 {
     m_error = error;
@@ -302,6 +538,14 @@ void FileLoaderPrivate::documentParsed( GeoDataDocument* doc, const QString& err
     emit q->loaderFinished( q );
 }
 
+void FileLoaderPrivate::parsingResult( GeoDataDocument* doc, const QString& error )
+{
+    // Called in the thread of the runner manager, run() picks the result up
+    // once all parsing tasks are finished
+    m_parsedDocument = doc;
+    m_parsedError = error;
+}
+
 void FileLoaderPrivate::createFilterProperties( GeoDataContainer *container )
 {
     QVector<GeoDataFeature*>::Iterator i = container->begin();
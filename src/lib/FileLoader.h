@@ -42,6 +42,7 @@ class FileLoader : public QThread
 
 private:
         Q_PRIVATE_SLOT ( d, void documentParsed( GeoDataDocument *, QString) )
+        Q_PRIVATE_SLOT ( d, void parsingResult( GeoDataDocument *, QString) )
 
         friend class FileLoaderPrivate;
 
@@ -14,6 +14,7 @@
 #include <QtCore/QDir>
 #include <QtCore/QFileInfo>
 #include <QtCore/QTime>
+#include <QtCore/QTimer>
 #include <QtGui/QMessageBox>
 
 #include "FileLoader.h"
@@ -23,12 +24,20 @@
 
 #include "GeoDataDocument.h"
 #include "GeoDataLatLonAltBox.h"
+#include "GeoDataTypes.h"
 
 
 using namespace Marble;
 
 namespace Marble
 {
+
+// Time in ms spent inserting features into the tree model per event loop iteration
+const int InsertionTimeSlice = 20;
+
+// Maximum number of features inserted into the tree model at once
+const int InsertionBatchSize = 500;
+
 class FileManagerPrivate
 {
 public:
@@ -37,6 +46,8 @@ public:
           m_recenter( false ),
         m_t ( 0 )
     {
+        m_insertionTimer.setSingleShot( true );
+        m_insertionTimer.setInterval( 0 );
     }
 
     ~FileManagerPrivate()
@@ -46,20 +57,79 @@ public:
                 loader->wait();
             }
         }
+
+        foreach ( FileLoader *loader, m_cancelledLoaders ) {
+            loader->wait();
+        }
+
+        while ( !m_pendingDocuments.isEmpty() ) {
+            cancelInsertion( m_pendingDocuments.first().document );
+        }
     }
 
+    /**
+     * A document in the tree model whose features are still being inserted.
+     * The features are stored in pre-order, so each container is inserted
+     * before its children.
+     */
+    struct PendingDocument
+    {
+        GeoDataDocument *document;
+        QVector<GeoDataFeature*> features;
+        QVector<GeoDataContainer*> parents;
+        int inserted;
+    };
+
+    void takeFeatures( GeoDataContainer *container, PendingDocument &pending );
+    void cancelInsertion( GeoDataDocument *document );
+
     MarbleModel* const m_model;
     QList<FileLoader*> m_loaderList;
+    QList<FileLoader*> m_cancelledLoaders;
     QList < GeoDataDocument* > m_fileItemList;
+    QList<PendingDocument> m_pendingDocuments;
+    QTimer m_insertionTimer;
     bool m_recenter;
     QTime *m_t;
 };
+
+void FileManagerPrivate::takeFeatures( GeoDataContainer *container, PendingDocument &pending )
+{
+    const QVector<GeoDataFeature*> features = container->featureList();
+    for ( int i = features.size() - 1; i >= 0; --i ) {
+        container->remove( i );
+    }
+
+    foreach ( GeoDataFeature *feature, features ) {
+        pending.features << feature;
+        pending.parents << container;
+        if ( feature->nodeType() == GeoDataTypes::GeoDataFolderType
+             || feature->nodeType() == GeoDataTypes::GeoDataDocumentType ) {
+            takeFeatures( static_cast<GeoDataContainer*>( feature ), pending );
+        }
+    }
+}
+
+void FileManagerPrivate::cancelInsertion( GeoDataDocument *document )
+{
+    for ( int i = 0; i < m_pendingDocuments.size(); ++i ) {
+        if ( m_pendingDocuments.at( i ).document == document ) {
+            // Containers that were not inserted yet are empty, so each feature is deleted once
+            const PendingDocument &pending = m_pendingDocuments.at( i );
+            qDeleteAll( pending.features.constBegin() + pending.inserted, pending.features.constEnd() );
+            m_pendingDocuments.removeAt( i );
+            return;
+        }
+    }
+}
+
 }
 
 FileManager::FileManager( MarbleModel *model, QObject *parent )
     : QObject( parent )
     , d( new FileManagerPrivate( model ) )
 {
+    connect( &d->m_insertionTimer, SIGNAL( timeout() ), this, SLOT( insertPendingFeatures() ) );
 }
 
 
@@ -120,10 +190,10 @@ void FileManager::removeFile( const QString& key )
 {
     foreach ( FileLoader *loader, d->m_loaderList ) {
         if ( loader->path() == key ) {
-            disconnect( loader, 0, this, 0 );
-            loader->wait();
+            // Parsing cannot be interrupted, the document is discarded once it is done
+            disconnect( loader, SIGNAL( newGeoDataDocumentAdded( GeoDataDocument* ) ), this, 0 );
             d->m_loaderList.removeAll( loader );
-            delete loader->document();
+            d->m_cancelledLoaders << loader;
             return;
         }
     }
@@ -147,6 +217,7 @@ void FileManager::closeFile( int index )
 {
     mDebug() << "FileManager::closeFile " << d->m_fileItemList.at( index )->fileName();
     if ( index < d->m_fileItemList.size() ) {
+        d->cancelInsertion( d->m_fileItemList.at( index ) );
         d->m_model->treeModel()->removeDocument( d->m_fileItemList.at( index ) );
         emit fileRemoved( index );
         delete d->m_fileItemList.at( index );
@@ -175,20 +246,80 @@ void FileManager::addGeoDataDocument( GeoDataDocument* document )
         document->setName( file.baseName() );
     }
 
+    if ( d->m_recenter ) {
+        emit centeredDocument( document->latLonAltBox() );
+        d->m_recenter = false;
+    }
+
+    // Insert an empty document first and add its features bit by bit, such that
+    // the views and layers never have to process the complete file at once
+    FileManagerPrivate::PendingDocument pending;
+    pending.document = document;
+    pending.inserted = 0;
+    d->takeFeatures( document, pending );
+
     d->m_fileItemList.append( document );
     d->m_model->treeModel()->addDocument( document );
     emit fileAdded( d->m_fileItemList.indexOf( document ) );
+
+    if ( !pending.features.isEmpty() ) {
+        d->m_pendingDocuments << pending;
+        insertPendingFeatures();
+    }
+}
+
+void FileManager::insertPendingFeatures()
+{
+    QTime time;
+    time.start();
+
+    while ( !d->m_pendingDocuments.isEmpty() && time.elapsed() < InsertionTimeSlice ) {
+        FileManagerPrivate::PendingDocument &pending = d->m_pendingDocuments.first();
+
+        // Consecutive features of the same container are inserted together
+        const int first = pending.inserted;
+        GeoDataContainer *parent = pending.parents.at( first );
+        int last = first + 1;
+        while ( last < pending.features.size() && last - first < InsertionBatchSize
+                && pending.parents.at( last ) == parent ) {
+            ++last;
+        }
+
+        // Inserting features and reporting progress can close documents and
+        // thereby modify the pending list, so update it before and do not
+        // touch the reference afterwards.
+        GeoDataDocument *document = pending.document;
+        const QVector<GeoDataFeature*> batch = pending.features.mid( first, last - first );
+        const int total = pending.features.size();
+        pending.inserted = last;
+        if ( last == total ) {
+            mDebug() << "Inserted" << total << "features of" << document->fileName();
+            d->m_pendingDocuments.removeFirst();
+        }
+
+        d->m_model->treeModel()->addFeatures( parent, batch );
+        const int index = d->m_fileItemList.indexOf( document );
+        if ( index >= 0 ) {
+            emit fileLoadingProgress( index, last, total );
+        }
+    }
+
+    if ( !d->m_pendingDocuments.isEmpty() ) {
+        d->m_insertionTimer.start();
+    }
 }
 
 void FileManager::cleanupLoader( FileLoader* loader )
 {
-    GeoDataDocument *doc = loader->document();
+    if ( d->m_cancelledLoaders.removeAll( loader ) ) {
+        loader->wait();
+        delete loader->document();
+        delete loader;
+        return;
+    }
+
     d->m_loaderList.removeAll( loader );
     if ( loader->isFinished() ) {
-        if ( doc && d->m_recenter ) {
-            emit centeredDocument( doc->latLonAltBox() );
-            d->m_recenter = false;
-        }
         if ( !loader->error().isEmpty() ) {
             QMessageBox errorBox;
             errorBox.setWindowTitle( QObject::tr("File Parsing Error"));
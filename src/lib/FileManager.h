@@ -63,7 +63,8 @@ class FileManager : public QObject
 
 
     /**
-    * removes an existing file from the manager
+    * removes an existing file from the manager. Files that are still being
+    * loaded are cancelled.
     */
     void removeFile( const QString &fileName );
 
@@ -84,12 +85,22 @@ class FileManager : public QObject
     void fileRemoved( int index );
     void centeredDocument( const GeoDataLatLonBox& );
 
+    /**
+     * The features of a large file are inserted into the tree model in batches
+     * after parsing, so that the map stays responsive. Emitted after each batch
+     * with the number of features inserted so far. Loading of the file at
+     * @p index is complete when @p inserted equals @p total.
+     */
+    void fileLoadingProgress( int index, int inserted, int total );
+
  public Q_SLOTS:
     void addGeoDataDocument( GeoDataDocument *document );
 
  private Q_SLOTS:
     void cleanupLoader( FileLoader *loader );
 
+    void insertPendingFeatures();
+
  private:
 
     void appendLoader( FileLoader *loader );
@@ -14,6 +14,7 @@
 #include "marble_export.h"
 
 #include <QtCore/QAbstractItemModel>
+#include <QtCore/QVector>
 
 namespace Marble
 {
@@ -84,6 +85,12 @@ public Q_SLOTS:
 
     int addFeature( GeoDataContainer *parent, GeoDataFeature *feature );
 
+    /**
+      * Appends all @p features to @p parent with a single row insertion.
+      * Returns the row of the first feature, or -1 if @p parent is not in the model.
+      */
+    int addFeatures( GeoDataContainer *parent, const QVector<GeoDataFeature*> &features );
+
     bool removeFeature( GeoDataContainer *parent, int index );
 
     bool removeFeature( GeoDataFeature *feature );
@@ -565,33 +565,42 @@ void GeoPainter::drawPolyline ( const GeoDataLineString & lineString,
         }
     }
     else {
-        int labelWidth = fontMetrics().width( labelText );
-        int labelAscent = fontMetrics().ascent();
-
-        QVector<QPointF> labelNodes;
         foreach( QPolygonF* itPolygon, polygons ) {
-            labelNodes.clear();
-            ClipPainter::drawPolyline( *itPolygon, labelNodes, labelPositionFlags );
-            if ( !labelNodes.isEmpty() ) {
-                foreach ( const QPointF& labelNode, labelNodes ) {
-                    QPointF labelPosition = labelNode + QPointF( 3.0, -2.0 );
-
-                    // FIXME: This is a Q&D fix.
-                    qreal xmax = viewport().width() - 10.0 - labelWidth;
-                    if ( labelPosition.x() > xmax ) labelPosition.setX( xmax ); 
-                    qreal ymin = 10.0 + labelAscent;
-                    if ( labelPosition.y() < ymin ) labelPosition.setY( ymin );
-                    qreal ymax = viewport().height() - 10.0 - labelAscent;
-                    if ( labelPosition.y() > ymax ) labelPosition.setY( ymax );
- 
-                    drawText( labelPosition, labelText );
-                }
-            }
+            drawPolyline( *itPolygon, labelText, labelPositionFlags );
         }
     }
     qDeleteAll( polygons );
 }
 
+void GeoPainter::drawPolyline ( const QPolygonF & polyline,
+                                const QString& labelText,
+                                LabelPositionFlags labelPositionFlags )
+{
+    if ( labelText.isEmpty() ) {
+        ClipPainter::drawPolyline( polyline );
+        return;
+    }
+
+    int labelWidth = fontMetrics().width( labelText );
+    int labelAscent = fontMetrics().ascent();
+
+    QVector<QPointF> labelNodes;
+    ClipPainter::drawPolyline( polyline, labelNodes, labelPositionFlags );
+    foreach ( const QPointF& labelNode, labelNodes ) {
+        QPointF labelPosition = labelNode + QPointF( 3.0, -2.0 );
+
+        // FIXME: This is a Q&D fix.
+        qreal xmax = viewport().width() - 10.0 - labelWidth;
+        if ( labelPosition.x() > xmax ) labelPosition.setX( xmax ); 
+        qreal ymin = 10.0 + labelAscent;
+        if ( labelPosition.y() < ymin ) labelPosition.setY( ymin );
+        qreal ymax = viewport().height() - 10.0 - labelAscent;
+        if ( labelPosition.y() > ymax ) labelPosition.setY( ymax );
+
+        drawText( labelPosition, labelText );
+    }
+}
+
 
 QRegion GeoPainter::regionFromPolyline ( const GeoDataLineString & lineString,
                                          qreal strokeWidth ) const
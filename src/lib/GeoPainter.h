@@ -360,6 +360,18 @@ class MARBLE_EXPORT GeoPainter : public ClipPainter
                         LabelPositionFlags labelPositionFlags = LineCenter );
 
 
+/*!
+    \brief Draws a polyline that is given in screen coordinates.
+
+    Like drawPolyline( GeoDataLineString ), but for a \a polyline that has
+    already been projected onto the screen. The \a labelText is placed
+    according to the \a labelPositionFlags.
+*/
+    void drawPolyline ( const QPolygonF & polyline,
+                        const QString& labelText,
+                        LabelPositionFlags labelPositionFlags = LineCenter );
+
+
 /*!
     \brief Creates a region for a given line string (a "polyline").
 
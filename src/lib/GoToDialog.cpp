@@ -20,6 +20,7 @@
 #include "GeoDataDocument.h"
 #include "GeoDataFolder.h"
 #include "PositionTracking.h"
+#include "ViewportParams.h"
 #include "BookmarkManager.h"
 #include "routing/RoutingManager.h"
 #include "routing/RouteRequest.h"
@@ -327,7 +328,7 @@ void GoToDialogPrivate::startSearch()
                           m_parent, SLOT( stopProgressAnimation() ) );
     }
 
-    m_runnerManager->findPlacemarks( searchTerm );
+    m_runnerManager->findPlacemarks( searchTerm, m_marbleWidget->viewport()->viewLatLonAltBox() );
     if ( m_progressAnimation.isEmpty() ) {
         createProgressAnimation();
     }
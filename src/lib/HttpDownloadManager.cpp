@@ -169,6 +169,13 @@ void HttpDownloadManager::addJob( const QUrl& sourceUrl, const QString& destFile
     }
 }
 
+void HttpDownloadManager::removeQueuedJob( const QUrl& sourceUrl, const QString& destFileName,
+                                           const DownloadUsage usage )
+{
+    DownloadQueueSet * const queueSet = d->findQueues( sourceUrl.host(), usage );
+    queueSet->removeQueuedJob( destFileName );
+}
+
 void HttpDownloadManager::finishJob( const QByteArray& data, const QString& destinationFileName,
                                      const QString& id )
 {
@@ -78,6 +78,12 @@ class MARBLE_EXPORT HttpDownloadManager : public QObject
     void addJob( const QUrl& sourceUrl, const QString& destFilename, const QString &id,
                  const DownloadUsage usage );
 
+    /**
+     * Removes the job for the given destination file name if it has not been
+     * started yet. Jobs which are being downloaded already are finished.
+     */
+    void removeQueuedJob( const QUrl& sourceUrl, const QString& destFilename,
+                          const DownloadUsage usage );
 
  Q_SIGNALS:
     void downloadComplete( QString, QString );
@@ -24,5 +24,10 @@ qreal LayerInterface::zValue() const
     return 0.0;
 }
 
+QString LayerInterface::layerName() const
+{
+    return QString();
+}
+
 
 } // namespace Marble
@@ -62,6 +62,12 @@ public:
       * If both have the same z value, their paint order is undefined.
       */
     virtual qreal zValue() const;
+
+    /**
+      * @brief Returns a name that identifies the layer in the render statistics.
+      * Layers with an empty name (the default) are accounted to their render position.
+      */
+    virtual QString layerName() const;
 };
 
 } // namespace Marble
@@ -28,6 +28,7 @@
 #include "MarbleModel.h"
 #include "PluginManager.h"
 #include "RenderPlugin.h"
+#include "RenderStatistics.h"
 #include "LayerInterface.h"
 
 namespace Marble
@@ -49,6 +50,8 @@ class LayerManagerPrivate
     LayerManagerPrivate( const MarbleModel* model );
     ~LayerManagerPrivate();
 
+    static QString stageName( const LayerInterface *layer, const QString &renderPosition );
+
     GeoSceneDocument *m_mapTheme;
 
     const MarbleModel *m_marbleModel;
@@ -59,6 +62,7 @@ class LayerManagerPrivate
     QList<LayerInterface *> m_internalLayers;
 
     bool m_showBackground;
+    RenderStatistics *m_statistics;
 };
 
 LayerManagerPrivate::LayerManagerPrivate( const MarbleModel* model )
@@ -66,7 +70,8 @@ LayerManagerPrivate::LayerManagerPrivate( const MarbleModel* model )
       m_marbleModel( model ),
       m_pluginManager( model->pluginManager() ),
       m_renderPlugins( m_pluginManager->createRenderPlugins() ),
-      m_showBackground( true )
+      m_showBackground( true ),
+      m_statistics( 0 )
 {
 }
 
@@ -187,11 +192,25 @@ void LayerManager::renderLayer( GeoPainter *painter, ViewportParams *viewport,
     }
 
     qSort( layers.begin(), layers.end(), zValueLessThan );
+    const bool timed = d->m_statistics && d->m_statistics->isEnabled();
     foreach( LayerInterface *layer, layers ) {
+        RenderStatisticsTimer timer( timed ? d->m_statistics : 0,
+                                     timed ? d->stageName( layer, renderPosition ) : QString() );
         layer->render( painter, viewport, renderPosition );
     }
 }
 
+QString LayerManagerPrivate::stageName( const LayerInterface *layer, const QString &renderPosition )
+{
+    const QString name = layer->layerName();
+    return "layer/" + ( name.isEmpty() ? renderPosition : name );
+}
+
+void LayerManager::setRenderStatistics( RenderStatistics *statistics )
+{
+    d->m_statistics = statistics;
+}
+
 void LayerManager::setShowBackground( bool show )
 {
     d->m_showBackground = show;
@@ -34,6 +34,7 @@ class AbstractFloatItem;
 class AbstractDataPlugin;
 class MarbleModel;
 class LayerInterface;
+class RenderStatistics;
 
 /**
  * @short The class that handles Marble's DGML layers.
@@ -50,6 +51,11 @@ class LayerManager : public QObject
 
     void renderLayers( GeoPainter *painter, ViewportParams *viewport );
 
+    /**
+     * @brief Sets the statistics that the render time of each layer is added to
+     */
+    void setRenderStatistics( RenderStatistics *statistics );
+
     bool showBackground() const;
 
     /**
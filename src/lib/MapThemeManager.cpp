@@ -14,16 +14,21 @@
 #include "MapThemeManager.h"
 
 // Qt
+#include <QtCore/QDataStream>
+#include <QtCore/QDateTime>
 #include <QtCore/QDir>
 #include <QtCore/QFile>
 #include <QtCore/QFileInfo>
 #include <QtCore/QFileSystemWatcher>
+#include <QtCore/QHash>
+#include <QtCore/QSet>
 #include <QtCore/QString>
 #include <QtCore/QStringList>
 #include <QtCore/QTimer>
 #include <QtGui/QStandardItemModel>
 
 // Local dir
+#include "global.h"
 #include "GeoSceneDocument.h"
 #include "GeoSceneHead.h"
 #include "GeoSceneIcon.h"
@@ -35,6 +40,8 @@ namespace
 {
     static const QString mapDirName = "maps";
     static const int columnRelativePath = 1;
+    /** Identifies the map theme index file, followed by the Marble version which wrote it */
+    static const quint32 themeIndexMagic = 0x4d544958;
 }
 
 namespace Marble
@@ -53,6 +60,22 @@ public:
 class MapThemeManager::Private
 {
 public:
+    /** The properties of a map theme shown in the map theme model */
+    struct ThemeInfo
+    {
+        ThemeInfo() : visible( false ) {}
+
+        /** Absolute path of the .dgml file the properties were read from */
+        QString path;
+        QDateTime lastModified;
+        QString name;
+        QString description;
+        QString target;
+        QString theme;
+        QString icon;
+        bool visible;
+    };
+
     Private( MapThemeManager *parent );
     ~Private();
 
@@ -96,10 +119,30 @@ public:
      */
     QList<QStandardItem *> createMapThemeRow( const QString& mapThemeID );
 
+    /**
+     * @brief Looks up the properties of a map theme in the theme index.
+     *
+     * The .dgml file is only parsed if it is not indexed yet or if it changed
+     * since it was indexed. Returns false if the map theme cannot be loaded.
+     */
+    bool themeInfo( const QString& mapThemeID, ThemeInfo& info );
+
+    static QString themeIndexFileName();
+
+    void readThemeIndex();
+
+    /**
+     * @brief Writes the theme index to disk if it changed since it was read.
+     */
+    void writeThemeIndex();
+
     MapThemeManager *const q;
     StandardItemModelWithRoleNames m_mapThemeModel;
     QFileSystemWatcher m_fileSystemWatcher;
     bool m_isInitialized;
+    QHash<QString, ThemeInfo> m_themeIndex;
+    bool m_themeIndexRead;
+    bool m_themeIndexChanged;
 };
 
 StandardItemModelWithRoleNames::StandardItemModelWithRoleNames( int rows, int columns, QObject *parent ) :
@@ -117,7 +160,9 @@ MapThemeManager::Private::Private( MapThemeManager *parent )
     : q( parent ),
       m_mapThemeModel( 0, 3 ),
       m_fileSystemWatcher(),
-      m_isInitialized( false )
+      m_isInitialized( false ),
+      m_themeIndexRead( false ),
+      m_themeIndexChanged( false )
 {
     QHash<int,QByteArray> roleNames = m_mapThemeModel.roleNames();
     roleNames[ Qt::DecorationRole ] = "icon";
@@ -300,8 +345,8 @@ QList<QStandardItem *> MapThemeManager::Private::createMapThemeRow( QString cons
 {
     QList<QStandardItem *> itemList;
 
-    GeoSceneDocument *mapTheme = loadMapThemeFile( mapThemeID );
-    if ( !mapTheme || !mapTheme->head()->visible() ) {
+    ThemeInfo mapTheme;
+    if ( !themeInfo( mapThemeID, mapTheme ) || !mapTheme.visible ) {
         return itemList;
     }
 
@@ -309,8 +354,8 @@ QList<QStandardItem *> MapThemeManager::Private::createMapThemeRow( QString cons
     QString relativePath;
 
     relativePath = mapDirName + '/'
-        + mapTheme->head()->target() + '/' + mapTheme->head()->theme() + '/'
-        + mapTheme->head()->icon()->pixmap();
+        + mapTheme.target + '/' + mapTheme.theme + '/'
+        + mapTheme.icon;
     themeIconPixmap.load( MarbleDirs::path( relativePath ) );
 
     if ( themeIconPixmap.isNull() ) {
@@ -332,8 +377,8 @@ QList<QStandardItem *> MapThemeManager::Private::createMapThemeRow( QString cons
 
     QIcon mapThemeIcon =  QIcon( themeIconPixmap );
 
-    QString name = mapTheme->head()->name();
-    QString description = mapTheme->head()->description();
+    QString name = mapTheme.name;
+    QString description = mapTheme.description;
 
     QStandardItem *item = new QStandardItem( name );
     item->setData( QObject::tr( name.toUtf8() ), Qt::DisplayRole );
@@ -343,16 +388,117 @@ QList<QStandardItem *> MapThemeManager::Private::createMapThemeRow( QString cons
     item->setData( mapThemeID, Qt::UserRole + 1 );
 
     itemList << item;
-    itemList << new QStandardItem( mapTheme->head()->target() + '/'
-                                   + mapTheme->head()->theme() + '/'
-                                   + mapTheme->head()->theme() + ".dgml" );
+    itemList << new QStandardItem( mapTheme.target + '/'
+                                   + mapTheme.theme + '/'
+                                   + mapTheme.theme + ".dgml" );
     itemList << new QStandardItem( QObject::tr( description.toUtf8() ) );
 
+    return itemList;
+}
+
+bool MapThemeManager::Private::themeInfo( const QString& mapThemeID, ThemeInfo& info )
+{
+    if ( !m_themeIndexRead ) {
+        readThemeIndex();
+    }
+
+    const QString path = MarbleDirs::path( mapDirName + '/' + mapThemeID );
+    const QDateTime lastModified = QFileInfo( path ).lastModified();
+
+    QHash<QString, ThemeInfo>::const_iterator cached = m_themeIndex.constFind( mapThemeID );
+    if ( cached != m_themeIndex.constEnd()
+         && cached->path == path && cached->lastModified == lastModified ) {
+        info = *cached;
+        return true;
+    }
+
+    GeoSceneDocument *mapTheme = loadMapThemeFile( mapThemeID );
+    if ( !mapTheme ) {
+        m_themeIndexChanged = m_themeIndex.remove( mapThemeID ) > 0 || m_themeIndexChanged;
+        return false;
+    }
+
+    info.path = path;
+    info.lastModified = lastModified;
+    info.name = mapTheme->head()->name();
+    info.description = mapTheme->head()->description();
+    info.target = mapTheme->head()->target();
+    info.theme = mapTheme->head()->theme();
+    info.icon = mapTheme->head()->icon()->pixmap();
+    info.visible = mapTheme->head()->visible();
     delete mapTheme;
 
-    return itemList;
+    m_themeIndex.insert( mapThemeID, info );
+    m_themeIndexChanged = true;
+    return true;
+}
+
+QString MapThemeManager::Private::themeIndexFileName()
+{
+    return MarbleDirs::localPath() + "/mapthemes.cache";
 }
 
+void MapThemeManager::Private::readThemeIndex()
+{
+    m_themeIndexRead = true;
+
+    QFile file( themeIndexFileName() );
+    if ( !file.open( QIODevice::ReadOnly ) ) {
+        return;
+    }
+
+    QDataStream stream( &file );
+    stream.setVersion( 8 );
+
+    quint32 magic;
+    QString version;
+    stream >> magic >> version;
+    if ( magic != themeIndexMagic || version != MARBLE_VERSION_STRING ) {
+        mDebug() << "Ignoring map theme index of a different Marble version";
+        return;
+    }
+
+    qint32 count = 0;
+    stream >> count;
+    for ( int i = 0; i < count && stream.status() == QDataStream::Ok; ++i ) {
+        QString mapThemeID;
+        ThemeInfo info;
+        stream >> mapThemeID >> info.path >> info.lastModified >> info.name >> info.description
+               >> info.target >> info.theme >> info.icon >> info.visible;
+        if ( stream.status() == QDataStream::Ok ) {
+            m_themeIndex.insert( mapThemeID, info );
+        }
+    }
+}
+
+void MapThemeManager::Private::writeThemeIndex()
+{
+    if ( !m_themeIndexChanged ) {
+        return;
+    }
+
+    QDir().mkpath( MarbleDirs::localPath() );
+    QFile file( themeIndexFileName() );
+    if ( !file.open( QIODevice::WriteOnly ) ) {
+        mDebug() << "Unable to write the map theme index" << file.fileName();
+        return;
+    }
+
+    QDataStream stream( &file );
+    stream.setVersion( 8 );
+    stream << themeIndexMagic << MARBLE_VERSION_STRING << qint32( m_themeIndex.size() );
+    QHash<QString, ThemeInfo>::const_iterator i = m_themeIndex.constBegin();
+    QHash<QString, ThemeInfo>::const_iterator const end = m_themeIndex.constEnd();
+    for (; i != end; ++i ) {
+        stream << i.key() << i->path << i->lastModified << i->name << i->description
+               << i->target << i->theme << i->icon << i->visible;
+    }
+
+    m_themeIndexChanged = false;
+}
+
+
+
 void MapThemeManager::Private::updateMapThemeModel()
 {
     mDebug() << "updateMapThemeModel";
@@ -373,6 +519,20 @@ void MapThemeManager::Private::updateMapThemeModel()
             m_mapThemeModel.appendRow( itemList );
         }
     }
+
+    // Forget about themes which were removed
+    const QSet<QString> mapThemeIDs = stringlist.toSet();
+    QHash<QString, ThemeInfo>::iterator i = m_themeIndex.begin();
+    while ( i != m_themeIndex.end() ) {
+        if ( mapThemeIDs.contains( i.key() ) ) {
+            ++i;
+        } else {
+            i = m_themeIndex.erase( i );
+            m_themeIndexChanged = true;
+        }
+    }
+
+    writeThemeIndex();
 }
 
 void MapThemeManager::Private::directoryChanged( const QString& path )
@@ -422,6 +582,8 @@ void MapThemeManager::Private::fileChanged( const QString& path )
             m_mapThemeModel.insertRow( insertAtRow, newMapThemeRow );
         }
     }
+
+    writeThemeIndex();
     
     emit q->themesChanged();
 }
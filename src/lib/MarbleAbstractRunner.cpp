@@ -37,6 +37,16 @@ MarbleModel * MarbleAbstractRunner::model()
     return m_model;
 }
 
+void MarbleAbstractRunner::setPreferredArea( const GeoDataLatLonBox &area )
+{
+    m_preferredArea = area;
+}
+
+GeoDataLatLonBox MarbleAbstractRunner::preferredArea() const
+{
+    return m_preferredArea;
+}
+
 void MarbleAbstractRunner::search( const QString & )
 {
     // dummy implementation
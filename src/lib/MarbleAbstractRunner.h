@@ -16,6 +16,7 @@
 #include "GeoDataFeature.h"
 #include "GeoDataPlacemark.h"
 #include "GeoDataDocument.h"
+#include "GeoDataLatLonBox.h"
 
 #include <QtCore/QThread>
 #include <QtCore/QVector>
@@ -45,6 +46,12 @@ public:
       */
     void setModel( MarbleModel * model );
 
+    /**
+      * Stores the area the user is looking at. Search runners should prefer
+      * results inside or close to it. An empty box means no preference.
+      */
+    void setPreferredArea( const GeoDataLatLonBox &area );
+
     /**
      * This function gives the  icon for this runner
      * @return the icon of the runner
@@ -116,8 +123,14 @@ protected:
       */
     MarbleModel * model();
 
+    /**
+      * The area search results should preferably be in, see @see setPreferredArea
+      */
+    GeoDataLatLonBox preferredArea() const;
+
 private:
     MarbleModel *m_model;
+    GeoDataLatLonBox m_preferredArea;
 };
 
 }
@@ -57,7 +57,9 @@
 #include "MarbleDebug.h"
 #include "MarbleDirs.h"
 #include "MarbleModel.h"
+#include "PositionTracking.h"
 #include "RenderPlugin.h"
+#include "RenderStatistics.h"
 #include "SunLocator.h"
 #include "TextureColorizer.h"
 #include "TileCoordsPyramid.h"
@@ -96,6 +98,8 @@ class MarbleMap::CustomPaintLayer : public LayerInterface
 
     virtual qreal zValue() const { return 1.0e6; }
 
+    virtual QString layerName() const { return "CustomPaintLayer"; }
+
  private:
     MarbleMap *const m_map;
 };
@@ -136,6 +140,8 @@ class MarbleMapPrivate
     VectorMapLayer   m_vectorMapLayer;
     TextureLayer     m_textureLayer;
     PlacemarkLayout  m_placemarkLayout;
+
+    RenderStatistics m_renderStatistics;
 };
 
 MarbleMapPrivate::MarbleMapPrivate( MarbleMap *parent, MarbleModel *model )
@@ -147,17 +153,22 @@ MarbleMapPrivate::MarbleMapPrivate( MarbleMap *parent, MarbleModel *model )
           m_texcolorizer( 0 ),
           m_layerManager( model, parent ),
           m_customPaintLayer( parent ),
-          m_geometryLayer( model->treeModel() ),
+          m_geometryLayer( model->placemarkRegistry() ),
           m_vectorMapBaseLayer( &m_veccomposer ),
           m_vectorMapLayer( &m_veccomposer ),
           m_textureLayer( model->downloadManager(), model->sunLocator() ),
-          m_placemarkLayout( model->placemarkModel(), model->placemarkSelectionModel(), model->clock(), parent )
+          m_placemarkLayout( model->placemarkRegistry(), model->placemarkSelectionModel(), model->clock(), parent )
 {
     m_layerManager.addLayer( &m_fogLayer );
     m_layerManager.addLayer( &m_geometryLayer );
     m_layerManager.addLayer( &m_placemarkLayout );
     m_layerManager.addLayer( &m_customPaintLayer );
 
+    m_layerManager.setRenderStatistics( &m_renderStatistics );
+    m_geometryLayer.setRenderStatistics( &m_renderStatistics );
+    m_textureLayer.setRenderStatistics( &m_renderStatistics );
+    m_placemarkLayout.setRenderStatistics( &m_renderStatistics );
+
     QObject::connect( m_model, SIGNAL( themeChanged( QString ) ),
                       parent, SLOT( updateMapTheme() ) );
 
@@ -237,6 +248,9 @@ MarbleMap::MarbleMap()
                                                   QDBusConnection::ExportAllSlots
                                                   | QDBusConnection::ExportAllSignals
                                                   | QDBusConnection::ExportAllProperties );
+    QDBusConnection::sessionBus().registerObject( "/MarbleMap/RenderStatistics", &d->m_renderStatistics,
+                                                  QDBusConnection::ExportAllSlots
+                                                  | QDBusConnection::ExportAllProperties );
 #endif
 }
 
@@ -248,6 +262,9 @@ MarbleMap::MarbleMap(MarbleModel *model)
                                                   QDBusConnection::ExportAllSlots
                                                   | QDBusConnection::ExportAllSignals
                                                   | QDBusConnection::ExportAllProperties );
+    QDBusConnection::sessionBus().registerObject( "/MarbleMap/RenderStatistics", &d->m_renderStatistics,
+                                                  QDBusConnection::ExportAllSlots
+                                                  | QDBusConnection::ExportAllProperties );
 #endif
 
     d->m_modelIsOwned = false;
@@ -285,6 +302,11 @@ const ViewportParams *MarbleMap::viewport() const
     return &d->m_viewport;
 }
 
+RenderStatistics *MarbleMap::renderStatistics()
+{
+    return &d->m_renderStatistics;
+}
+
 
 void MarbleMap::setMapQualityForViewContext( MapQuality quality, ViewContext viewContext )
 {
@@ -696,10 +718,18 @@ void MarbleMap::paint( GeoPainter &painter, const QRect &dirtyRect )
     d->m_layerManager.renderLayers( &painter, &d->m_viewport );
 
     if ( d->m_showFrameRate ) {
-        FpsLayer fpsLayer( &t );
+        FpsLayer fpsLayer( &t, &d->m_renderStatistics );
         fpsLayer.render( &painter, &d->m_viewport );
     }
 
+    // Time from the oldest position update not shown yet until it is on screen
+    const int positionUpdateAge = d->m_model->positionTracking()->takePendingUpdateAge();
+    if ( positionUpdateAge >= 0 ) {
+        d->m_renderStatistics.addLatency( "position/update-to-frame", positionUpdateAge );
+    }
+
+    d->m_renderStatistics.finishFrame( t.elapsed() );
+
     const qreal fps = 1000.0 / (qreal)( t.elapsed() );
     emit framesPerSecond( fps );
 }
@@ -50,6 +50,7 @@ class GeoPainter;
 class LayerInterface;
 class Quaternion;
 class RenderPlugin;
+class RenderStatistics;
 class AbstractDataPlugin;
 class AbstractDataPluginItem;
 class AbstractFloatItem;
@@ -126,6 +127,12 @@ class MARBLE_EXPORT MarbleMap : public QObject
     ViewportParams *viewport();
     const ViewportParams *viewport() const;
 
+    /**
+     * @brief Return the timings and counters of the render pipeline.
+     * Collecting them needs to be enabled with RenderStatistics::setEnabled().
+     */
+    RenderStatistics *renderStatistics();
+
     void setMapQualityForViewContext( MapQuality qualityForViewContext, ViewContext viewContext );
     MapQuality mapQuality( ViewContext viewContext ) const;
 
@@ -23,9 +23,7 @@
 #include <QtCore/QAbstractItemModel>
 #include <QtCore/QSet>
 #include <QtGui/QItemSelectionModel>
-#include <QtGui/QSortFilterProxyModel>
 
-#include "kdescendantsproxymodel.h"
 
 #include "MapThemeManager.h"
 #include "global.h"
@@ -55,6 +53,7 @@
 #include "MarbleDirs.h"
 #include "FileManager.h"
 #include "GeoDataTreeModel.h"
+#include "PlacemarkRegistry.h"
 #include "Planet.h"
 #include "PluginManager.h"
 #include "StoragePolicy.h"
@@ -87,8 +86,7 @@ class MarbleModelPrivate
           m_fileManager( 0 ),
           m_fileviewmodel(),
           m_treemodel(),
-          m_descendantproxy(),
-          m_sortproxy(),
+          m_placemarkRegistry( &m_treemodel ),
           m_placemarkselectionmodel( 0 ),
           m_positionTracking( &m_treemodel ),
           m_trackedPlacemark( 0 ),
@@ -97,10 +95,6 @@ class MarbleModelPrivate
           m_legend( 0 ),
           m_workOffline( false )
     {
-        m_sortproxy.setFilterFixedString( GeoDataTypes::GeoDataPlacemarkType );
-        m_sortproxy.setFilterKeyColumn( 1 );
-        m_sortproxy.setSourceModel( &m_descendantproxy );
-        m_descendantproxy.setSourceModel( &m_treemodel );
     }
 
     ~MarbleModelPrivate()
@@ -133,8 +127,7 @@ class MarbleModelPrivate
 
     FileViewModel            m_fileviewmodel;
     GeoDataTreeModel         m_treemodel;
-    KDescendantsProxyModel   m_descendantproxy;
-    QSortFilterProxyModel    m_sortproxy;
+    PlacemarkRegistry        m_placemarkRegistry;
 
     // Selection handling
     QItemSelectionModel      m_placemarkselectionmodel;
@@ -372,7 +365,12 @@ GeoDataTreeModel *MarbleModel::treeModel()
 
 QAbstractItemModel *MarbleModel::placemarkModel()
 {
-    return &d->m_sortproxy;
+    return d->m_placemarkRegistry.model();
+}
+
+PlacemarkRegistry *MarbleModel::placemarkRegistry()
+{
+    return &d->m_placemarkRegistry;
 }
 
 QItemSelectionModel *MarbleModel::placemarkSelectionModel()
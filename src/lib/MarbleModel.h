@@ -61,6 +61,7 @@ class PluginManager;
 class GeoDataCoordinates;
 class GeoDataDocument;
 class GeoDataTreeModel;
+class PlacemarkRegistry;
 class GeoSceneDocument;
 class Planet;
 class RoutingManager;
@@ -120,6 +121,13 @@ class MARBLE_EXPORT MarbleModel : public QObject
     QAbstractItemModel *placemarkModel();
     QItemSelectionModel *placemarkSelectionModel();
 
+    /**
+     * @brief Return all placemarks of treeModel() as a flat list
+     * This is faster to iterate than placemarkModel(), which is an item model
+     * adapter of it.
+     */
+    PlacemarkRegistry *placemarkRegistry();
+
     /**
      * @brief Return the name of the current map theme.
      * @return the identifier of the current MapTheme.
@@ -14,6 +14,7 @@
 #include "MarbleWidget.h"
 #include "MarbleDebug.h"
 #include "GeoDataLineString.h"
+#include "TextureLayer.h"
 #include "ViewportParams.h"
 
 #include <QtCore/QTimeLine>
@@ -21,6 +22,9 @@
 namespace Marble
 {
 
+// How far ahead (in milliseconds) tiles are prefetched during animations
+const int PREFETCH_LOOK_AHEAD = 300;
+
 class MarblePhysicsPrivate {
 public:
     MarbleWidget *const m_widget;
@@ -66,6 +70,14 @@ public:
         return measure.length(m_planetRadius);
     }
 
+    void prefetchTiles( qreal t ) const
+    {
+        qreal lon(0.0), lat(0.0);
+        suggestedPos( t, lon, lat );
+        const int radius = qRound( m_widget->radiusFromDistance( suggestedRange( t ) * METER2KM ) );
+        m_widget->textureLayer()->prefetchTiles( m_widget->viewport(), lon, lat, radius );
+    }
+
     qreal suggestedRange(qreal t) const
     {
         Q_ASSERT( m_mode == Linear || m_mode == Jump);
@@ -123,6 +135,8 @@ MarblePhysics::~MarblePhysics()
 void MarblePhysics::flyTo( const GeoDataLookAt &target, FlyToMode mode )
 {
     d->m_timeline.stop();
+    // Downloads for the target of an earlier flight would hold up the new one
+    d->m_widget->textureLayer()->cancelPrefetch();
     d->m_source = d->m_widget->lookAt();
     d->m_target = target;
     const ViewportParams *viewport = d->m_widget->viewport();
@@ -197,6 +211,12 @@ void MarblePhysics::updateProgress(qreal progress)
 
     d->m_widget->setViewContext( Marble::Animation );
     d->m_widget->flyTo( intermediate, Instant );
+
+    // Prepare the tiles of the next frames and of the target view
+    const int lookAheadTime = qMin( d->m_timeline.currentTime() + PREFETCH_LOOK_AHEAD,
+                                    d->m_timeline.duration() );
+    d->prefetchTiles( d->m_timeline.valueForTime( lookAheadTime ) );
+    d->prefetchTiles( 1.0 );
 }
 
 void MarblePhysics::startStillMode()
@@ -173,21 +173,27 @@ QModelIndexList MarblePlacemarkModel::approxMatch( const QModelIndex & start, in
 void MarblePlacemarkModel::addPlacemarks( int start,
                                           int length )
 {
-    Q_UNUSED(start);
-
-// performance wise a reset is far better when the provided list
-// is significant. That is an issue because we have
-// MarbleControlBox::m_sortproxy as a sorting customer.
-// I leave the balance search as an exercise to the reader...
+    if ( length <= 0 ) {
+        return;
+    }
 
-    QTime t;
-    t.start();
-//    beginInsertRows( QModelIndex(), start, start + length );
+    beginInsertRows( QModelIndex(), start, start + length - 1 );
     d->m_size += length;
-//    endInsertRows();
-    reset();
+    endInsertRows();
+    emit countChanged();
+}
+
+void MarblePlacemarkModel::insertPlacemark( int index, GeoDataPlacemark *placemark )
+{
+    Q_ASSERT( d->m_placemarkContainer );
+
+    // Search results are inserted one by one at their ranked position,
+    // so views and MarbleControlBox::m_sortproxy are updated incrementally
+    beginInsertRows( QModelIndex(), index, index );
+    d->m_placemarkContainer->insert( index, placemark );
+    ++d->m_size;
+    endInsertRows();
     emit countChanged();
-    mDebug() << "addPlacemarks: Time elapsed:" << t.elapsed() << "ms for" << length << "Placemarks.";
 }
 
 void  MarblePlacemarkModel::removePlacemarks( const QString &containerName,
@@ -197,7 +203,7 @@ void  MarblePlacemarkModel::removePlacemarks( const QString &containerName,
     if ( length > 0 ) {
         QTime t;
         t.start();
-        beginRemoveRows( QModelIndex(), start, start + length );
+        beginRemoveRows( QModelIndex(), start, start + length - 1 );
         d->m_size -= length;
         endRemoveRows();
         emit layoutChanged();
@@ -106,6 +106,12 @@ class MARBLE_EXPORT MarblePlacemarkModel : public QAbstractListModel
     void addPlacemarks( int start,
                         int length );
 
+    /**
+     * Inserts the placemark into the placemark container at the given
+     * index, notifying views before and after the change.
+     */
+    void insertPlacemark( int index, GeoDataPlacemark *placemark );
+
     /**
      * This method is used by the PlacemarkManager to remove
      * place marks from the model.
@@ -13,6 +13,7 @@
 
 #include "MarblePlacemarkModel.h"
 #include "MarbleDebug.h"
+#include "MarbleMath.h"
 #include "MarbleModel.h"
 #include "Planet.h"
 #include "GeoDataDocument.h"
@@ -21,9 +22,11 @@
 #include "RunnerPlugin.h"
 #include "RunnerTask.h"
 #include "routing/RouteRequest.h"
+#include "routing/RoutingProcessRunner.h"
 #include "routing/RoutingProfilesModel.h"
 
 #include <QtCore/QObject>
+#include <QtCore/QSet>
 #include <QtCore/QString>
 #include <QtCore/QVector>
 #include <QtCore/QThreadPool>
@@ -34,6 +37,12 @@ namespace Marble
 
 class MarbleModel;
 
+/** Milliseconds each search runner gets before the search reports its partial result as finished */
+static const int SearchDeadline = 5000;
+
+/** Results of different runners with the same name closer than this (in meters) are the same place */
+static const qreal DuplicateDistance = 500.0;
+
 class MarbleRunnerManagerPrivate
 {
 public:
@@ -56,12 +65,29 @@ public:
     QList<RunnerPlugin*> plugins( RunnerPlugin::Capability capability );
 
     QList<RunnerTask*> m_searchTasks;
+    QSet<QObject*> m_searchRunners;
+    QTimer m_searchDeadline;
+    bool m_searchFinished;
     QList<RunnerTask*> m_reverseTasks;
     QList<RunnerTask*> m_routingTasks;
     QList<RunnerTask*> m_parsingTasks;
     int m_watchdogTimer;
 
     void addSearchResult( QVector<GeoDataPlacemark*> result );
+
+    /** Cancels the running search tasks and ignores their results from now on */
+    void cancelSearch();
+
+    void finishSearch();
+
+    /** Returns an earlier result describing the same place, if any */
+    GeoDataPlacemark* findDuplicate( const GeoDataPlacemark* placemark ) const;
+
+    /** Returns the index in the ranked result where the placemark belongs */
+    int searchRank( const GeoDataPlacemark* placemark ) const;
+
+    /** 0 for an exact match of the search term, 1 for a prefix, 2 for a substring, 3 otherwise */
+    int matchQuality( const GeoDataPlacemark* placemark ) const;
     void addReverseGeocodingResult( const GeoDataCoordinates &coordinates, const GeoDataPlacemark &placemark );
     void addRoutingResult( GeoDataDocument* route );
     void addParsingResult( GeoDataDocument* document, const QString& error = QString() );
@@ -79,9 +105,13 @@ MarbleRunnerManagerPrivate::MarbleRunnerManagerPrivate( MarbleRunnerManager* par
         m_fileResult( 0 ),
         m_marbleModel( 0 ),
         m_pluginManager( pluginManager ),
-        m_watchdogTimer( 30000 )
+        m_watchdogTimer( 30000 ),
+        m_searchFinished( true )
 {
     m_model->setPlacemarkContainer( &m_placemarkContainer );
+    m_searchDeadline.setSingleShot( true );
+    m_searchDeadline.setInterval( SearchDeadline );
+    QObject::connect( &m_searchDeadline, SIGNAL( timeout() ), parent, SLOT( finishSearch() ) );
     qRegisterMetaType<GeoDataDocument*>( "GeoDataDocument*" );
     qRegisterMetaType<GeoDataPlacemark>( "GeoDataPlacemark" );
     qRegisterMetaType<GeoDataCoordinates>( "GeoDataCoordinates" );
@@ -96,12 +126,8 @@ MarbleRunnerManagerPrivate::~MarbleRunnerManagerPrivate()
 QList<RunnerPlugin*> MarbleRunnerManagerPrivate::plugins( RunnerPlugin::Capability capability )
 {
     QList<RunnerPlugin*> result;
-    QList<RunnerPlugin*> plugins = m_pluginManager->runnerPlugins();
+    QList<RunnerPlugin*> plugins = m_pluginManager->runnerPlugins( capability );
     foreach( RunnerPlugin* plugin, plugins ) {
-        if ( !plugin->supports( capability ) ) {
-            continue;
-        }
-
         if ( ( m_marbleModel && m_marbleModel->workOffline() && !plugin->canWorkOffline() ) ) {
             continue;
         }
@@ -123,14 +149,45 @@ QList<RunnerPlugin*> MarbleRunnerManagerPrivate::plugins( RunnerPlugin::Capabili
 
 void MarbleRunnerManagerPrivate::cleanupSearchTask( RunnerTask* task )
 {
-    m_searchTasks.removeAll( task );
+    if ( !m_searchTasks.removeAll( task ) ) {
+        // A task of a previous, cancelled search
+        return;
+    }
+
     mDebug() << "removing task " << m_searchTasks.size() << " " << (long)task;
     if ( m_searchTasks.isEmpty() ) {
-        emit q->searchFinished( m_lastSearchTerm );
-        emit q->placemarkSearchFinished();
+        finishSearch();
     }
 }
 
+void MarbleRunnerManagerPrivate::cancelSearch()
+{
+    foreach( RunnerTask* task, m_searchTasks ) {
+        RunnerTask::cancel( task );
+    }
+    m_searchTasks.clear();
+    m_searchRunners.clear();
+    m_searchDeadline.stop();
+    m_searchFinished = true;
+}
+
+void MarbleRunnerManagerPrivate::finishSearch()
+{
+    m_searchDeadline.stop();
+    if ( m_searchFinished ) {
+        return;
+    }
+
+    if ( !m_searchTasks.isEmpty() ) {
+        // Results of slow runners still extend the model later on
+        mDebug() << "Search deadline reached with" << m_searchTasks.size() << "runners still busy";
+    }
+
+    m_searchFinished = true;
+    emit q->searchFinished( m_lastSearchTerm );
+    emit q->placemarkSearchFinished();
+}
+
 void MarbleRunnerManagerPrivate::cleanupReverseGeocodingTask( RunnerTask* task )
 {
     m_reverseTasks.removeAll( task );
@@ -173,22 +230,25 @@ MarbleRunnerManager::MarbleRunnerManager( const PluginManager* pluginManager, QO
 
 MarbleRunnerManager::~MarbleRunnerManager()
 {
+    d->cancelSearch();
     delete d;
 }
 
-void MarbleRunnerManager::findPlacemarks( const QString &searchTerm )
+void MarbleRunnerManager::findPlacemarks( const QString &searchTerm, const GeoDataLatLonBox &preferred )
 {
     if ( searchTerm == d->m_lastSearchTerm ) {
       emit searchResultChanged( d->m_model );
       emit searchResultChanged( d->m_placemarkContainer );
-      emit searchFinished( searchTerm );
-      emit placemarkSearchFinished();
+      if ( d->m_searchFinished ) {
+          emit searchFinished( searchTerm );
+          emit placemarkSearchFinished();
+      }
       return;
     }
 
     d->m_lastSearchTerm = searchTerm;
 
-    d->m_searchTasks.clear();
+    d->cancelSearch();
 
     d->m_modelMutex.lock();
     d->m_model->removePlacemarks( "MarbleRunnerManager", 0, d->m_placemarkContainer.size() );
@@ -197,9 +257,9 @@ void MarbleRunnerManager::findPlacemarks( const QString &searchTerm )
     d->m_modelMutex.unlock();
     emit searchResultChanged( d->m_model );
 
+    d->m_searchFinished = false;
     if ( searchTerm.trimmed().isEmpty() ) {
-        emit searchFinished( searchTerm );
-        emit placemarkSearchFinished();
+        d->finishSearch();
         return;
     }
 
@@ -210,15 +270,19 @@ void MarbleRunnerManager::findPlacemarks( const QString &searchTerm )
         connect( runner, SIGNAL( searchFinished( QVector<GeoDataPlacemark*> ) ),
                  this, SLOT( addSearchResult( QVector<GeoDataPlacemark*> ) ) );
         runner->setModel( d->m_marbleModel );
+        runner->setPreferredArea( preferred );
         SearchTask* task = new SearchTask( runner, searchTerm );
         connect( task, SIGNAL( finished( RunnerTask* ) ), this, SLOT( cleanupSearchTask( RunnerTask* ) ) );
         d->m_searchTasks << task;
+        d->m_searchRunners << runner;
         mDebug() << "search task " << plugin->nameId() << " " << (long)task;
         QThreadPool::globalInstance()->start( task );
     }
 
     if ( plugins.isEmpty() ) {
-        d->cleanupSearchTask( 0 );
+        d->finishSearch();
+    } else {
+        d->m_searchDeadline.start();
     }
 }
 
@@ -228,16 +292,93 @@ void MarbleRunnerManagerPrivate::addSearchResult( QVector<GeoDataPlacemark*> res
     if( result.isEmpty() )
         return;
 
+    if ( !m_searchRunners.contains( q->sender() ) ) {
+        // Late result of a previous search
+        qDeleteAll( result );
+        return;
+    }
+
+    bool changed = false;
     m_modelMutex.lock();
-    int start = m_placemarkContainer.size();
-    m_placemarkContainer << result;
-    m_model->addPlacemarks( start, result.size() );
+    foreach( GeoDataPlacemark* placemark, result ) {
+        GeoDataPlacemark* duplicate = findDuplicate( placemark );
+        if ( duplicate ) {
+            // Keep the first result, but complete it with details of the others
+            if ( duplicate->address().isEmpty() ) {
+                duplicate->setAddress( placemark->address() );
+            }
+            if ( duplicate->description().isEmpty() ) {
+                duplicate->setDescription( placemark->description() );
+            }
+            delete placemark;
+            continue;
+        }
+
+        const int index = searchRank( placemark );
+        m_model->insertPlacemark( index, placemark );
+        changed = true;
+    }
     m_modelMutex.unlock();
-    emit q->searchResultChanged( m_model );
-    emit q->searchResultChanged( m_placemarkContainer );
+
+    if ( changed ) {
+        emit q->searchResultChanged( m_model );
+        emit q->searchResultChanged( m_placemarkContainer );
+    }
+}
+
+GeoDataPlacemark* MarbleRunnerManagerPrivate::findDuplicate( const GeoDataPlacemark* placemark ) const
+{
+    const QString name = placemark->name().trimmed();
+    const GeoDataCoordinates coordinates = placemark->coordinate();
+    foreach( GeoDataPlacemark* other, m_placemarkContainer ) {
+        if ( other->name().trimmed().compare( name, Qt::CaseInsensitive ) != 0 ) {
+            continue;
+        }
+
+        const GeoDataCoordinates otherCoordinates = other->coordinate();
+        const qreal distance = EARTH_RADIUS * distanceSphere( coordinates.longitude(), coordinates.latitude(),
+                                                              otherCoordinates.longitude(), otherCoordinates.latitude() );
+        if ( distance < DuplicateDistance ) {
+            return other;
+        }
+    }
+
+    return 0;
+}
+
+int MarbleRunnerManagerPrivate::searchRank( const GeoDataPlacemark* placemark ) const
+{
+    // Better matches first, popular places first among equally good matches,
+    // otherwise in the order of arrival. The result is small, a linear scan suffices.
+    const int quality = matchQuality( placemark );
+    const qint64 popularity = placemark->popularity();
+    for ( int i = 0; i < m_placemarkContainer.size(); ++i ) {
+        const GeoDataPlacemark* other = m_placemarkContainer.at( i );
+        const int otherQuality = matchQuality( other );
+        if ( quality < otherQuality || ( quality == otherQuality && popularity > other->popularity() ) ) {
+            return i;
+        }
+    }
+
+    return m_placemarkContainer.size();
+}
+
+int MarbleRunnerManagerPrivate::matchQuality( const GeoDataPlacemark* placemark ) const
+{
+    const QString name = placemark->name().trimmed();
+    const QString term = m_lastSearchTerm.trimmed();
+    if ( name.compare( term, Qt::CaseInsensitive ) == 0 ) {
+        return 0;
+    } else if ( name.startsWith( term, Qt::CaseInsensitive ) ) {
+        return 1;
+    } else if ( name.contains( term, Qt::CaseInsensitive ) ) {
+        return 2;
+    }
+
+    return 3;
 }
 
-QVector<GeoDataPlacemark*> MarbleRunnerManager::searchPlacemarks( const QString &searchTerm ) {
+QVector<GeoDataPlacemark*> MarbleRunnerManager::searchPlacemarks( const QString &searchTerm, const GeoDataLatLonBox &preferred ) {
     QEventLoop localEventLoop;
     QTimer watchdog;
     watchdog.setSingleShot(true);
@@ -247,7 +388,7 @@ QVector<GeoDataPlacemark*> MarbleRunnerManager::searchPlacemarks( const QString
             &localEventLoop, SLOT(quit()), Qt::QueuedConnection );
 
     watchdog.start( d->m_watchdogTimer );
-    findPlacemarks( searchTerm );
+    findPlacemarks( searchTerm, preferred );
     localEventLoop.exec();
     return d->m_placemarkContainer;
 }
@@ -311,6 +452,8 @@ void MarbleRunnerManager::retrieveRoute( const RouteRequest *request )
 {
     RoutingProfile profile = request->routingProfile();
 
+    // Backend processes still working on the previous state of the request are obsolete
+    RoutingProcessRunner::instance()->cancel( request );
     d->m_routingTasks.clear();
     d->m_routingResult.clear();
 
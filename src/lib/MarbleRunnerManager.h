@@ -14,6 +14,7 @@
 
 #include "GeoDataCoordinates.h"
 #include "GeoDataDocument.h"
+#include "GeoDataLatLonBox.h"
 
 #include <QtCore/QObject>
 #include <QtCore/QVector>
@@ -58,9 +59,14 @@ public:
       * @see searchResultChanged signal.
       * @see searchPlacemark is blocking.
       * @see searchFinished signal indicates all runners are finished.
+      * Results of all runners are merged into one list ordered by relevance,
+      * places found by several runners are listed once. A new search cancels
+      * the runners of the previous one.
+      * @param preferred The area the user is looking at, if known. Runners
+      * prefer results inside or close to it.
       */
-    void findPlacemarks( const QString& searchTerm );
-    QVector<GeoDataPlacemark*> searchPlacemarks( const QString& searchTerm );
+    void findPlacemarks( const QString& searchTerm, const GeoDataLatLonBox &preferred = GeoDataLatLonBox() );
+    QVector<GeoDataPlacemark*> searchPlacemarks( const QString& searchTerm, const GeoDataLatLonBox &preferred = GeoDataLatLonBox() );
 
     /**
       * Find the address and other meta information for a given geoposition.
@@ -103,7 +109,9 @@ signals:
     /**
       * The search request for the given search term has finished, i.e. all
       * runners are finished and reported their results via the
-      * @see searchResultChanged signal
+      * @see searchResultChanged signal. Runners that take longer than a few
+      * seconds are not waited for; their results are still added to the
+      * model when they arrive.
       */
     void searchFinished( const QString &searchTerm );
 
@@ -150,6 +158,7 @@ private:
     Q_PRIVATE_SLOT( d, void addParsingResult( GeoDataDocument* document, const QString& error = QString() ) )
 
     Q_PRIVATE_SLOT( d, void cleanupSearchTask( RunnerTask* task ) )
+    Q_PRIVATE_SLOT( d, void finishSearch() )
     Q_PRIVATE_SLOT( d, void cleanupReverseGeocodingTask( RunnerTask* task ) )
     Q_PRIVATE_SLOT( d, void cleanupRoutingTask( RunnerTask* task ) )
     Q_PRIVATE_SLOT( d, void cleanupParsingTask( RunnerTask* task ) )
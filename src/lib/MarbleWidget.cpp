@@ -819,7 +819,7 @@ void MarbleWidget::paintEvent( QPaintEvent *evt )
 
     if ( d->m_showFrameRate )
     {
-        FpsLayer fpsLayer( &t );
+        FpsLayer fpsLayer( &t, d->m_map.renderStatistics() );
         fpsLayer.render( &painter, d->m_map.viewport() );
 
         const qreal fps = 1000.0 / (qreal)( t.elapsed() + 1 );
@@ -1045,6 +1045,7 @@ class MARBLE_EXPORT MarbleWidget : public QWidget
     friend class CustomPaintLayer;
 
     friend class DownloadRegionDialog;
+    friend class MarblePhysics;
     TextureLayer *textureLayer();
     const TextureLayer *textureLayer() const;
 
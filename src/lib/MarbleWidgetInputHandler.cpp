@@ -42,11 +42,15 @@
 #include "AbstractDataPluginItem.h"
 #include "MarbleWidgetPopupMenu.h"
 #include "Planet.h"
+#include "TextureLayer.h"
 
 namespace Marble {
 
 const int TOOLTIP_START_INTERVAL = 1000;
 
+// How far ahead (in seconds) tiles are prefetched during kinetic spinning
+const qreal KINETIC_PREFETCH_TIME = 0.5;
+
 class MarbleWidgetInputHandler::Protected
 {
 public:
@@ -312,6 +316,8 @@ MarbleWidgetDefaultInputHandler::MarbleWidgetDefaultInputHandler( MarbleWidget *
     d->m_kineticModel.setUpdateInterval( 35 );
     connect( &d->m_kineticModel, SIGNAL( positionChanged( qreal, qreal ) ),
              MarbleWidgetInputHandler::d->m_widget, SLOT( centerOn( qreal, qreal ) ) );
+    connect( &d->m_kineticModel, SIGNAL( positionChanged( qreal, qreal ) ),
+             this, SLOT( prefetchKineticTarget() ) );
     connect( &d->m_kineticModel, SIGNAL( finished() ), SLOT( restoreViewContext() ) );
 
 
@@ -334,6 +340,20 @@ void MarbleWidgetDefaultInputHandler::lmbTimeout()
     }
 }
 
+void MarbleWidgetDefaultInputHandler::prefetchKineticTarget()
+{
+    // Prepare the tiles of the area the map is spinning to
+    const QPointF target = d->m_kineticModel.position()
+                           + d->m_kineticModel.velocity() * KINETIC_PREFETCH_TIME;
+    qreal lon = target.x();
+    qreal lat = target.y();
+    GeoDataCoordinates::normalizeLonLat( lon, lat, GeoDataCoordinates::Degree );
+
+    MarbleWidget *const widget = MarbleWidgetInputHandler::d->m_widget;
+    widget->textureLayer()->prefetchTiles( widget->viewport(), lon * DEG2RAD, lat * DEG2RAD,
+                                           widget->radius() );
+}
+
 void MarbleWidgetInputHandler::restoreViewContext()
 {
     // Needs to stop the timer since it repeats otherwise.
@@ -491,6 +511,8 @@ bool MarbleWidgetDefaultInputHandler::eventFilter( QObject* o, QEvent* e )
 
                 d->m_kineticModel.setPosition( RAD2DEG * ( qreal )( d->m_leftPressedLon ), RAD2DEG * ( qreal )( d->m_leftPressedLat ) );
                 d->m_kineticModel.resetSpeed();
+                // The tiles prefetched for an earlier spin are not needed anymore
+                MarbleWidgetInputHandler::d->m_widget->textureLayer()->cancelPrefetch();
 
                 // Choose spin direction by taking into account whether we
                 // drag above or below the visible pole.
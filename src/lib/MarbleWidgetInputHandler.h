@@ -106,6 +106,8 @@ class MARBLE_EXPORT MarbleWidgetDefaultInputHandler  : public MarbleWidgetInputH
 
     void lmbTimeout();
 
+    void prefetchKineticTarget();
+
  private:
     Q_DISABLE_COPY( MarbleWidgetDefaultInputHandler )
     class Private;
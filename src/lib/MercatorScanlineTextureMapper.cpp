@@ -39,6 +39,9 @@ public:
     virtual void run();
 
 private:
+    template<typename T>
+    void render();
+
     StackedTileLoader *const m_tileLoader;
     const int m_tileLevel;
     QImage *const m_canvasImage;
@@ -78,9 +81,9 @@ void MercatorScanlineTextureMapper::mapTexture( GeoPainter *painter,
                                                 const QRect &dirtyRect,
                                                 TextureColorizer *texColorizer )
 {
-    if ( m_canvasImage.size() != viewport->size() || m_radius != viewport->radius() ) {
-        const QImage::Format optimalFormat = ScanlineTextureMapperContext::optimalCanvasImageFormat( viewport );
+    const QImage::Format optimalFormat = ScanlineTextureMapperContext::optimalCanvasImageFormat( viewport, texColorizer != 0 );
 
+    if ( m_canvasImage.size() != viewport->size() || m_canvasImage.format() != optimalFormat || m_radius != viewport->radius() ) {
         if ( m_canvasImage.size() != viewport->size() || m_canvasImage.format() != optimalFormat ) {
             m_canvasImage = QImage( viewport->size(), optimalFormat );
         }
@@ -89,6 +92,20 @@ void MercatorScanlineTextureMapper::mapTexture( GeoPainter *painter,
             m_canvasImage.fill( 0 );
         }
 
+        if ( texColorizer ) {
+            const QImage::Format colorizedFormat = ScanlineTextureMapperContext::optimalCanvasImageFormat( viewport );
+            if ( m_colorizedImage.size() != viewport->size() || m_colorizedImage.format() != colorizedFormat ) {
+                m_colorizedImage = QImage( viewport->size(), colorizedFormat );
+            }
+
+            if ( !viewport->mapCoversViewport() ) {
+                m_colorizedImage.fill( 0 );
+            }
+        }
+        else {
+            m_colorizedImage = QImage();
+        }
+
         m_radius = viewport->radius();
         m_repaintNeeded = true;
     }
@@ -97,13 +114,13 @@ void MercatorScanlineTextureMapper::mapTexture( GeoPainter *painter,
         mapTexture( viewport, painter->mapQuality() );
 
         if ( texColorizer ) {
-            texColorizer->colorize( &m_canvasImage, viewport, painter->mapQuality() );
+            texColorizer->colorize( &m_canvasImage, &m_colorizedImage, viewport, painter->mapQuality() );
         }
 
         m_repaintNeeded = false;
     }
 
-    painter->drawImage( dirtyRect, m_canvasImage, dirtyRect );
+    painter->drawImage( dirtyRect, texColorizer ? m_colorizedImage : m_canvasImage, dirtyRect );
 }
 
 void MercatorScanlineTextureMapper::setRepaintNeeded()
@@ -155,11 +172,12 @@ void MercatorScanlineTextureMapper::mapTexture( const ViewportParams *viewport,
     const int clearStart = ( yPaintedTop - m_oldYPaintedTop <= 0 ) ? yPaintedBottom : 0;
     const int clearStop  = ( yPaintedTop - m_oldYPaintedTop <= 0 ) ? imageHeight  : yTop;
 
-    QRgb * const itClearBegin = (QRgb*)( m_canvasImage.scanLine( clearStart ) );
-    QRgb * const itClearEnd   = (QRgb*)( m_canvasImage.scanLine( clearStop ) );
+    // Byte-wise, the canvas image may have 8 or 32 bit pixels
+    uchar * const itClearBegin = m_canvasImage.scanLine( clearStart );
+    uchar * const itClearEnd   = m_canvasImage.scanLine( clearStop );
 
-    for ( QRgb * it = itClearBegin; it < itClearEnd; ++it ) {
-        *(it) = 0;
+    if ( itClearBegin < itClearEnd ) {
+        memset( itClearBegin, 0, itClearEnd - itClearBegin );
     }
 
     m_threadPool.waitForDone();
@@ -171,6 +189,17 @@ void MercatorScanlineTextureMapper::mapTexture( const ViewportParams *viewport,
 
 
 void MercatorScanlineTextureMapper::RenderJob::run()
+{
+    if ( m_canvasImage->depth() == 8 ) {
+        render<uchar>();
+    }
+    else {
+        render<QRgb>();
+    }
+}
+
+template<typename T>
+void MercatorScanlineTextureMapper::RenderJob::render()
 {
     // Scanline based algorithm to do texture mapping
 
@@ -211,7 +240,7 @@ void MercatorScanlineTextureMapper::RenderJob::run()
 
     for ( int y = m_yPaintedTop; y < m_yPaintedBottom; ++y ) {
 
-        QRgb * scanLine = (QRgb*)( m_canvasImage->scanLine( y ) );
+        T * scanLine = (T*)( m_canvasImage->scanLine( y ) );
 
         qreal lon = leftLon;
         const qreal lat = atan( sinh( ( (imageHeight / 2 + yCenterOffset) - y )
@@ -255,7 +284,7 @@ void MercatorScanlineTextureMapper::RenderJob::run()
         // copy scanline to improve performance
         if ( interlaced && y + 1 < m_yPaintedBottom ) { 
 
-            const int pixelByteSize = m_canvasImage->bytesPerLine() / imageWidth;
+            const int pixelByteSize = sizeof( T );
 
             memcpy( m_canvasImage->scanLine( y + 1 ),
                     m_canvasImage->scanLine( y     ),
@@ -49,6 +49,8 @@ class MercatorScanlineTextureMapper : public TextureMapperInterface
     bool   m_repaintNeeded;
     int m_radius;
     QImage m_canvasImage;
+    /// The colored map if the canvas image holds the gray values to be colorized
+    QImage m_colorizedImage;
     int    m_oldYPaintedTop;
     QThreadPool m_threadPool;
 };
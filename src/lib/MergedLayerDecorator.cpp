@@ -78,7 +78,9 @@ QImage MergedLayerDecorator::merge( const TileId id, const QVector<QSharedPointe
                 if ( withConversion ) {
                     resultImage = tile->image()->convertToFormat( QImage::Format_ARGB32_Premultiplied );
                 } else {
-                    resultImage = tile->image()->copy();
+                    // Share the data of the single layer. Indexed and grayscale
+                    // tiles thereby stay in their 8 bit format without a copy.
+                    resultImage = *tile->image();
                 }
             }
     }
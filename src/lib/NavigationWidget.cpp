@@ -18,6 +18,7 @@
 #include "MarbleDebug.h"
 #include "MarbleModel.h"
 #include "MarbleWidget.h"
+#include "ViewportParams.h"
 #include "MarbleRunnerManager.h"
 #include "MarblePlacemarkModel.h"
 #include "GeoDataDocument.h"
@@ -191,7 +192,7 @@ void NavigationWidget::searchReturnPressed()
 {
     // do nothing if search term empty
     if ( !d->m_searchTerm.isEmpty() ) {
-        d->m_runnerManager->findPlacemarks( d->m_searchTerm );
+        d->m_runnerManager->findPlacemarks( d->m_searchTerm, d->m_widget->viewport()->viewLatLonAltBox() );
     }
 }
 
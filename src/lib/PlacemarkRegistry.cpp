@@ -0,0 +1,306 @@
+//
+// This file is part of the Marble Virtual Globe.
+//
+// This program is free software licensed under the GNU LGPL. You can
+// find a copy of this license in LICENSE.txt in the top directory of
+// the source code.
+//
+// Copyright 2026      agent <agent@local>
+//
+
+#include "PlacemarkRegistry.h"
+
+#include <QtCore/QDateTime>
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QSet>
+
+#include "GeoDataContainer.h"
+#include "GeoDataDocument.h"
+#include "GeoDataPlacemark.h"
+#include "GeoDataTreeModel.h"
+#include "GeoDataTypes.h"
+#include "MarbleDebug.h"
+#include "MarblePlacemarkModel.h"
+
+namespace Marble
+{
+
+class PlacemarkRegistryPrivate
+{
+public:
+    /** Cached properties of a placemark */
+    struct Entry
+    {
+        GeoDataCoordinates coordinate;
+        int popularityIndex;
+        GeoDataFeature::GeoDataVisualCategory visualCategory;
+        bool hasIcon;
+        bool timeDependent;
+    };
+
+    PlacemarkRegistryPrivate( PlacemarkRegistry *parent, GeoDataTreeModel *treeModel );
+
+    static Entry entry( const GeoDataPlacemark *placemark );
+
+    void collectPlacemarks( GeoDataObject *object, QVector<GeoDataPlacemark*> &placemarks ) const;
+
+    QVector<GeoDataPlacemark*> placemarksAt( const QModelIndex &parent, int first, int last ) const;
+
+    void append( const QVector<GeoDataPlacemark*> &placemarks );
+
+    void addRows( const QModelIndex &parent, int first, int last );
+
+    void removeRows( const QModelIndex &parent, int first, int last );
+
+    void updateRows( const QModelIndex &topLeft, const QModelIndex &bottomRight );
+
+    void clear();
+
+    void reset();
+
+    PlacemarkRegistry *const q;
+    GeoDataTreeModel *const m_treeModel;
+    MarblePlacemarkModel m_model;
+
+    /**
+     * Guards changes of m_placemarks against concurrent copies in copyPlacemarks().
+     * Placemarks are removed from m_placemarks before the tree model deletes them.
+     */
+    mutable QMutex m_mutex;
+    QVector<GeoDataPlacemark*> m_placemarks;
+    QVector<Entry> m_entries;
+};
+
+PlacemarkRegistryPrivate::PlacemarkRegistryPrivate( PlacemarkRegistry *parent, GeoDataTreeModel *treeModel ) :
+    q( parent ),
+    m_treeModel( treeModel )
+{
+    m_model.setPlacemarkContainer( &m_placemarks );
+}
+
+PlacemarkRegistryPrivate::Entry PlacemarkRegistryPrivate::entry( const GeoDataPlacemark *placemark )
+{
+    Entry result;
+    result.hasIcon = false;
+    result.coordinate = placemark->coordinate( QDateTime(), &result.hasIcon );
+    result.popularityIndex = placemark->popularityIndex();
+    result.visualCategory = placemark->visualCategory();
+    result.timeDependent = placemark->geometry()
+                           && placemark->geometry()->nodeType() == GeoDataTypes::GeoDataTrackType;
+    return result;
+}
+
+void PlacemarkRegistryPrivate::collectPlacemarks( GeoDataObject *object, QVector<GeoDataPlacemark*> &placemarks ) const
+{
+    if ( object->nodeType() == GeoDataTypes::GeoDataPlacemarkType ) {
+        placemarks << static_cast<GeoDataPlacemark*>( object );
+    } else if ( object->nodeType() == GeoDataTypes::GeoDataFolderType
+                || object->nodeType() == GeoDataTypes::GeoDataDocumentType ) {
+        GeoDataContainer *container = static_cast<GeoDataContainer*>( object );
+        QVector<GeoDataFeature*>::ConstIterator i = container->constBegin();
+        QVector<GeoDataFeature*>::ConstIterator const end = container->constEnd();
+        for (; i != end; ++i ) {
+            collectPlacemarks( *i, placemarks );
+        }
+    }
+}
+
+QVector<GeoDataPlacemark*> PlacemarkRegistryPrivate::placemarksAt( const QModelIndex &parent, int first, int last ) const
+{
+    QVector<GeoDataPlacemark*> placemarks;
+    for ( int row = first; row <= last; ++row ) {
+        const QModelIndex index = m_treeModel->index( row, 0, parent );
+        if ( GeoDataObject *object = static_cast<GeoDataObject*>( index.internalPointer() ) ) {
+            collectPlacemarks( object, placemarks );
+        }
+    }
+    return placemarks;
+}
+
+void PlacemarkRegistryPrivate::append( const QVector<GeoDataPlacemark*> &placemarks )
+{
+    if ( placemarks.isEmpty() ) {
+        return;
+    }
+
+    const int first = m_placemarks.size();
+    m_entries.reserve( first + placemarks.size() );
+    foreach( const GeoDataPlacemark *placemark, placemarks ) {
+        m_entries << entry( placemark );
+    }
+
+    {
+        QMutexLocker locker( &m_mutex );
+        m_placemarks += placemarks;
+    }
+
+    m_model.addPlacemarks( first, placemarks.size() );
+    emit q->placemarksAdded( first, m_placemarks.size() - 1 );
+}
+
+void PlacemarkRegistryPrivate::addRows( const QModelIndex &parent, int first, int last )
+{
+    append( placemarksAt( parent, first, last ) );
+}
+
+void PlacemarkRegistryPrivate::removeRows( const QModelIndex &parent, int first, int last )
+{
+    const QVector<GeoDataPlacemark*> removed = placemarksAt( parent, first, last );
+    if ( removed.isEmpty() ) {
+        return;
+    }
+
+    // Compact the arrays in a single pass, going backwards to report
+    // the removed ranges with valid indexes to the item model
+    const QSet<GeoDataPlacemark*> removedSet = removed.toList().toSet();
+    int index = m_placemarks.size() - 1;
+    while ( index >= 0 ) {
+        if ( !removedSet.contains( m_placemarks.at( index ) ) ) {
+            --index;
+            continue;
+        }
+
+        const int end = index + 1;
+        while ( index > 0 && removedSet.contains( m_placemarks.at( index - 1 ) ) ) {
+            --index;
+        }
+
+        m_model.removePlacemarks( "PlacemarkRegistry", index, end - index );
+        {
+            QMutexLocker locker( &m_mutex );
+            m_placemarks.remove( index, end - index );
+        }
+        m_entries.remove( index, end - index );
+        --index;
+    }
+
+    emit q->placemarksChanged();
+}
+
+void PlacemarkRegistryPrivate::updateRows( const QModelIndex &topLeft, const QModelIndex &bottomRight )
+{
+    if ( !topLeft.isValid() || !bottomRight.isValid() ) {
+        return;
+    }
+
+    const QVector<GeoDataPlacemark*> changed = placemarksAt( topLeft.parent(), topLeft.row(), bottomRight.row() );
+    if ( changed.isEmpty() ) {
+        return;
+    }
+
+    const QSet<GeoDataPlacemark*> changedSet = changed.toList().toSet();
+    for ( int i = 0; i < m_placemarks.size(); ++i ) {
+        if ( changedSet.contains( m_placemarks.at( i ) ) ) {
+            m_entries[i] = entry( m_placemarks.at( i ) );
+        }
+    }
+
+    emit q->placemarksChanged();
+}
+
+void PlacemarkRegistryPrivate::clear()
+{
+    m_model.removePlacemarks( "PlacemarkRegistry", 0, m_placemarks.size() );
+    {
+        QMutexLocker locker( &m_mutex );
+        m_placemarks.clear();
+    }
+    m_entries.clear();
+}
+
+void PlacemarkRegistryPrivate::reset()
+{
+    clear();
+
+    QVector<GeoDataPlacemark*> placemarks;
+    if ( m_treeModel->rootDocument() ) {
+        collectPlacemarks( m_treeModel->rootDocument(), placemarks );
+    }
+
+    append( placemarks );
+    emit q->placemarksChanged();
+}
+
+PlacemarkRegistry::PlacemarkRegistry( GeoDataTreeModel *treeModel, QObject *parent ) :
+    QObject( parent ),
+    d( new PlacemarkRegistryPrivate( this, treeModel ) )
+{
+    connect( treeModel, SIGNAL( rowsInserted( QModelIndex, int, int ) ),
+             this, SLOT( addRows( QModelIndex, int, int ) ) );
+    connect( treeModel, SIGNAL( rowsAboutToBeRemoved( QModelIndex, int, int ) ),
+             this, SLOT( removeRows( QModelIndex, int, int ) ) );
+    connect( treeModel, SIGNAL( dataChanged( QModelIndex, QModelIndex ) ),
+             this, SLOT( updateRows( QModelIndex, QModelIndex ) ) );
+    // The placemarks are deleted between these two signals
+    connect( treeModel, SIGNAL( modelAboutToBeReset() ),
+             this, SLOT( clear() ) );
+    connect( treeModel, SIGNAL( modelReset() ),
+             this, SLOT( reset() ) );
+
+    d->reset();
+}
+
+PlacemarkRegistry::~PlacemarkRegistry()
+{
+    delete d;
+}
+
+int PlacemarkRegistry::size() const
+{
+    return d->m_placemarks.size();
+}
+
+GeoDataPlacemark *PlacemarkRegistry::placemark( int index ) const
+{
+    return d->m_placemarks.at( index );
+}
+
+int PlacemarkRegistry::popularityIndex( int index ) const
+{
+    return d->m_entries.at( index ).popularityIndex;
+}
+
+GeoDataFeature::GeoDataVisualCategory PlacemarkRegistry::visualCategory( int index ) const
+{
+    return d->m_entries.at( index ).visualCategory;
+}
+
+const GeoDataCoordinates &PlacemarkRegistry::coordinate( int index ) const
+{
+    return d->m_entries.at( index ).coordinate;
+}
+
+bool PlacemarkRegistry::hasIcon( int index ) const
+{
+    return d->m_entries.at( index ).hasIcon;
+}
+
+bool PlacemarkRegistry::isTimeDependent( int index ) const
+{
+    return d->m_entries.at( index ).timeDependent;
+}
+
+QVector<GeoDataPlacemark*> PlacemarkRegistry::copyPlacemarks( const QString &namePrefix ) const
+{
+    QVector<GeoDataPlacemark*> result;
+
+    // Removing placemarks from the registry blocks until we are done
+    QMutexLocker locker( &d->m_mutex );
+    foreach( const GeoDataPlacemark *placemark, d->m_placemarks ) {
+        if ( placemark->name().startsWith( namePrefix, Qt::CaseInsensitive ) ) {
+            result << new GeoDataPlacemark( *placemark );
+        }
+    }
+
+    return result;
+}
+
+QAbstractItemModel *PlacemarkRegistry::model()
+{
+    return &d->m_model;
+}
+
+}
+
+#include "PlacemarkRegistry.moc"
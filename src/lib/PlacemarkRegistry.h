@@ -0,0 +1,111 @@
+//
+// This file is part of the Marble Virtual Globe.
+//
+// This program is free software licensed under the GNU LGPL. You can
+// find a copy of this license in LICENSE.txt in the top directory of
+// the source code.
+//
+// Copyright 2026      agent <agent@local>
+//
+
+#ifndef MARBLE_PLACEMARKREGISTRY_H
+#define MARBLE_PLACEMARKREGISTRY_H
+
+#include <QtCore/QObject>
+#include <QtCore/QVector>
+
+#include "GeoDataFeature.h"
+#include "marble_export.h"
+
+class QAbstractItemModel;
+class QModelIndex;
+
+namespace Marble
+{
+
+class GeoDataCoordinates;
+class GeoDataPlacemark;
+class GeoDataTreeModel;
+class PlacemarkRegistryPrivate;
+
+/**
+ * @brief A flat list of all placemarks in a GeoDataTreeModel
+ *
+ * The registry stores the placemarks in a contiguous array, together with their
+ * popularity index, visual category and coordinate. Layers iterate it directly
+ * instead of going through item model proxies. It is maintained incrementally
+ * from the signals of the tree model: Inserted placemarks are appended, removed
+ * ones are dropped and changed ones are refreshed. Placemarks keep the order in
+ * which they were inserted.
+ *
+ * Item views can access the placemarks through model().
+ */
+class MARBLE_EXPORT PlacemarkRegistry : public QObject
+{
+    Q_OBJECT
+
+ public:
+    explicit PlacemarkRegistry( GeoDataTreeModel *treeModel, QObject *parent = 0 );
+
+    ~PlacemarkRegistry();
+
+    /** Number of placemarks */
+    int size() const;
+
+    GeoDataPlacemark *placemark( int index ) const;
+
+    int popularityIndex( int index ) const;
+
+    GeoDataFeature::GeoDataVisualCategory visualCategory( int index ) const;
+
+    /**
+     * The coordinate at which the icon of the placemark is shown. If the
+     * position of the placemark depends on the time (e.g. a track), it is
+     * the coordinate at the time the placemark was inserted or changed.
+     * @see GeoDataPlacemark::coordinate()
+     */
+    const GeoDataCoordinates &coordinate( int index ) const;
+
+    /** Whether the placemark has an icon at coordinate() */
+    bool hasIcon( int index ) const;
+
+    /** Whether the coordinate of the placemark changes with time */
+    bool isTimeDependent( int index ) const;
+
+    /**
+     * Returns copies of the placemarks whose name starts with @p namePrefix,
+     * compared case insensitively. The caller takes ownership of the copies.
+     * Unlike the other methods, this one may be called from other threads.
+     * Placemarks are not deleted while they are copied.
+     */
+    QVector<GeoDataPlacemark*> copyPlacemarks( const QString &namePrefix ) const;
+
+    /**
+     * A list model of the placemarks for item views. It provides the roles of
+     * MarblePlacemarkModel.
+     */
+    QAbstractItemModel *model();
+
+ Q_SIGNALS:
+    /** The placemarks @p first to @p last were appended */
+    void placemarksAdded( int first, int last );
+
+    /** Placemarks were removed or changed. Indexes may refer to different placemarks now. */
+    void placemarksChanged();
+
+ private:
+    Q_PRIVATE_SLOT( d, void addRows( const QModelIndex &parent, int first, int last ) )
+    Q_PRIVATE_SLOT( d, void removeRows( const QModelIndex &parent, int first, int last ) )
+    Q_PRIVATE_SLOT( d, void updateRows( const QModelIndex &topLeft, const QModelIndex &bottomRight ) )
+    Q_PRIVATE_SLOT( d, void clear() )
+    Q_PRIVATE_SLOT( d, void reset() )
+
+    Q_DISABLE_COPY( PlacemarkRegistry )
+
+    friend class PlacemarkRegistryPrivate;
+    PlacemarkRegistryPrivate *const d;
+};
+
+}
+
+#endif
@@ -14,11 +14,22 @@
 #include "PluginManager.h"
 
 // Qt
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDataStream>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QHash>
 #include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
 #include <QtCore/QPluginLoader>
+#include <QtCore/QThread>
 #include <QtCore/QTime>
 
 // Local dir
+#include "global.h"
 #include "MarbleDirs.h"
 #include "MarbleDebug.h"
 #include "RenderPlugin.h"
@@ -30,44 +41,143 @@
 namespace Marble
 {
 
+/** The description of a plugin file, as stored in the plugin cache */
+class PluginFile
+{
+ public:
+    enum Type {
+        UnknownType, // Not loaded yet, or not a valid plugin
+        RenderType,
+        NetworkType,
+        PositionProviderType,
+        RunnerType
+    };
+
+    PluginFile()
+        : type( UnknownType ),
+          capabilities( 0 ),
+          instance( 0 )
+    {
+    }
+
+    QString path;
+    QDateTime lastModified;
+    Type type;
+    QString nameId;
+    /** The capabilities of runner plugins */
+    int capabilities;
+    /** The plugin object, or 0 if the file was not loaded yet */
+    QObject *instance;
+};
+
 class PluginManagerPrivate
 {
  public:
     PluginManagerPrivate()
-            : m_pluginsLoaded(false)
+            : m_pluginsScanned( false )
     {
     }
 
     ~PluginManagerPrivate();
 
-    void loadPlugins();
+    /**
+     * Collects the plugin files and looks up their description in the cache.
+     * Files not in the cache are loaded to determine their description.
+     */
+    void scanPlugins();
+
+    /** Loads the given plugin file and updates its description */
+    bool loadPlugin( PluginFile &file ) const;
+
+    /**
+     * Returns the plugins of the given type which have all the given capabilities.
+     * Only these plugins are loaded.
+     */
+    template<class T>
+    QList<T*> plugins( PluginFile::Type type, int capabilities = 0 );
+
+    static QString cacheFileName();
 
-    bool m_pluginsLoaded;
-    QList<RenderPlugin *> m_renderPluginTemplates;
-    QList<NetworkPlugin *> m_networkPluginTemplates;
-    QList<PositionProviderPlugin *> m_positionProviderPluginTemplates;
-    QList<RunnerPlugin *> m_runnerPlugins;
+    QHash<QString, PluginFile> readCache() const;
+
+    void writeCache() const;
+
+    /**
+     * Runner plugins are requested from runner and file loader threads, so the
+     * scan and the lazy loading are serialized.
+     */
+    QMutex m_mutex;
+    bool m_pluginsScanned;
+    QList<PluginFile> m_pluginFiles;
 };
 
+/**
+ * Identifies the plugin cache file, followed by the Marble version and the
+ * MarbleGlobal profiles it was written with. Some plugins report different
+ * capabilities depending on the profiles.
+ */
+static const quint32 s_pluginCacheMagic = 0x4d504c32;
+
 PluginManagerPrivate::~PluginManagerPrivate()
 {
-    qDeleteAll( m_renderPluginTemplates );
-    m_renderPluginTemplates.clear();
+    QList<PluginFile>::const_iterator i = m_pluginFiles.constBegin();
+    QList<PluginFile>::const_iterator const end = m_pluginFiles.constEnd();
+    for (; i != end; ++i) {
+        delete i->instance;
+    }
+    m_pluginFiles.clear();
+}
+
+template<class T>
+QList<T*> PluginManagerPrivate::plugins( PluginFile::Type type, int capabilities )
+{
+    QMutexLocker locker( &m_mutex );
+    scanPlugins();
+
+    QList<T*> result;
+    QList<PluginFile>::iterator i = m_pluginFiles.begin();
+    QList<PluginFile>::iterator const end = m_pluginFiles.end();
+    for (; i != end; ++i) {
+        if ( i->type != type || ( i->capabilities & capabilities ) != capabilities ) {
+            continue;
+        }
+
+        if ( !i->instance ) {
+            mDebug() << "Loading plugin" << i->nameId << "on first use";
+            if ( !loadPlugin( *i ) || i->type != type
+                 || ( i->capabilities & capabilities ) != capabilities ) {
+                // The cache was outdated
+                continue;
+            }
+        }
+
+        T* plugin = qobject_cast<T*>( i->instance );
+        Q_ASSERT( plugin ); // checked when loading
+        result << plugin;
+    }
 
-    qDeleteAll( m_networkPluginTemplates );
-    m_networkPluginTemplates.clear();
+    return result;
+}
 
-    qDeleteAll( m_positionProviderPluginTemplates );
-    m_positionProviderPluginTemplates.clear();
+/** Returns the plugin if obj inherits both T and U, 0 otherwise */
+template<class T, class U>
+T* castPlugin( QObject *obj )
+{
+    if ( qobject_cast<T*>( obj ) && qobject_cast<U*>( obj ) ) {
+        Q_ASSERT( obj->metaObject()->superClass() ); // all our plugins have a super class
+        return qobject_cast<T*>( obj );
+    }
 
-    qDeleteAll( m_runnerPlugins );
-    m_runnerPlugins.clear();
+    return 0;
 }
 
 PluginManager::PluginManager( QObject *parent )
     : QObject(parent),
       d( new PluginManagerPrivate() )
 {
+    // Scan in the constructing thread rather than in the first runner thread
+    QMutexLocker locker( &d->m_mutex );
+    d->scanPlugins();
 }
 
 PluginManager::~PluginManager()
@@ -76,12 +186,11 @@ PluginManager::~PluginManager()
 }
 
 template<class T>
-QList<T*> createPlugins( PluginManagerPrivate* d, const QList<T*> &loaders )
+QList<T*> createPlugins( const QList<T*> &templates )
 {
     QList<T*> result;
-    d->loadPlugins();
-    typename QList<T*>::const_iterator i = loaders.constBegin();
-    typename QList<T*>::const_iterator const end = loaders.constEnd();
+    typename QList<T*>::const_iterator i = templates.constBegin();
+    typename QList<T*>::const_iterator const end = templates.constEnd();
     for (; i != end; ++i) {
         T* instance = (*i)->newInstance();
         Q_ASSERT( instance && "Plugin returned null when requesting a new instance." );
@@ -92,100 +201,194 @@ QList<T*> createPlugins( PluginManagerPrivate* d, const QList<T*> &loaders )
 
 QList<RenderPlugin *> PluginManager::createRenderPlugins() const
 {
-    return createPlugins( d, d->m_renderPluginTemplates );
+    return createPlugins( d->plugins<RenderPlugin>( PluginFile::RenderType ) );
 }
 
 QList<NetworkPlugin *> PluginManager::createNetworkPlugins() const
 {
-    return createPlugins( d, d->m_networkPluginTemplates );
+    return createPlugins( d->plugins<NetworkPlugin>( PluginFile::NetworkType ) );
 }
 
 QList<PositionProviderPlugin *> PluginManager::createPositionProviderPlugins() const
 {
-    return createPlugins( d, d->m_positionProviderPluginTemplates );
+    return createPlugins( d->plugins<PositionProviderPlugin>( PluginFile::PositionProviderType ) );
 }
 
 QList<RunnerPlugin *> PluginManager::runnerPlugins() const
 {
-    d->loadPlugins();
-    return d->m_runnerPlugins;
+    return d->plugins<RunnerPlugin>( PluginFile::RunnerType );
 }
 
-/** Append obj to the given plugins list if it inherits both T and U */
-template<class T, class U>
-bool appendPlugin( QObject * obj, QPluginLoader* &loader, QList<T*> &plugins )
+QList<RunnerPlugin *> PluginManager::runnerPlugins( RunnerPlugin::Capability capability ) const
 {
-    if ( qobject_cast<T*>( obj ) && qobject_cast<U*>( obj ) ) {
-        Q_ASSERT( obj->metaObject()->superClass() ); // all our plugins have a super class
-        mDebug() <<  obj->metaObject()->superClass()->className()
-                << "plugin loaded from" << loader->fileName();
-        T* plugin = qobject_cast<T*>( obj );
-        Q_ASSERT( plugin ); // checked above
-        plugins << plugin;
-        return true;
+    return d->plugins<RunnerPlugin>( PluginFile::RunnerType, capability );
+}
+
+bool PluginManagerPrivate::loadPlugin( PluginFile &file ) const
+{
+    // Destroying the loader keeps the plugin loaded
+    QPluginLoader loader( file.path );
+    QObject * obj = loader.instance();
+    if ( !obj ) {
+        mDebug() << "Plugin failure:" << file.path << "is not a valid Marble Plugin:"
+                 << loader.errorString();
+        file.type = PluginFile::UnknownType;
+        return false;
+    }
+
+    file.capabilities = 0;
+    if ( RenderPlugin *plugin = castPlugin<RenderPlugin, RenderPluginInterface>( obj ) ) {
+        file.type = PluginFile::RenderType;
+        file.nameId = plugin->nameId();
+    } else if ( NetworkPlugin *plugin = castPlugin<NetworkPlugin, NetworkPluginInterface>( obj ) ) {
+        file.type = PluginFile::NetworkType;
+        file.nameId = plugin->nameId();
+    } else if ( PositionProviderPlugin *plugin = castPlugin<PositionProviderPlugin, PositionProviderPluginInterface>( obj ) ) {
+        file.type = PluginFile::PositionProviderType;
+        file.nameId = plugin->nameId();
+    } else if ( RunnerPlugin *plugin = castPlugin<RunnerPlugin, RunnerPlugin>( obj ) ) { // intentionally T==U
+        file.type = PluginFile::RunnerType;
+        file.nameId = plugin->nameId();
+        file.capabilities = plugin->capabilities();
+    } else {
+        mDebug() << "Plugin failure:" << file.path << "is a plugin, but it does not implement the "
+                << "right interfaces or it was compiled against an old version of Marble. Ignoring it.";
+        file.type = PluginFile::UnknownType;
+        return false;
+    }
+
+    // Plugins loaded lazily by a runner thread must outlive that thread
+    if ( QCoreApplication::instance() && obj->thread() != QCoreApplication::instance()->thread() ) {
+        obj->moveToThread( QCoreApplication::instance()->thread() );
     }
 
-    return false;
+    mDebug() << obj->metaObject()->superClass()->className()
+             << "plugin loaded from" << file.path;
+    file.instance = obj;
+    return true;
 }
 
-void PluginManagerPrivate::loadPlugins()
+void PluginManagerPrivate::scanPlugins()
 {
-    if (m_pluginsLoaded)
-    {
+    // Called with m_mutex locked
+    if ( m_pluginsScanned ) {
         return;
     }
+    m_pluginsScanned = true;
 
     QTime t;
     t.start();
-    mDebug() << "Starting to load Plugins.";
+    mDebug() << "Starting to scan Plugins.";
 
     QStringList pluginFileNameList = MarbleDirs::pluginEntryList( "", QDir::Files );
 
     MarbleDirs::debug();
 
-    qDeleteAll( m_renderPluginTemplates );
-    m_renderPluginTemplates.clear();
-
-    qDeleteAll( m_networkPluginTemplates );
-    m_networkPluginTemplates.clear();
-
-    qDeleteAll( m_positionProviderPluginTemplates );
-    m_positionProviderPluginTemplates.clear();
-
-    // No need to delete runner plugins
+    const QHash<QString, PluginFile> cache = readCache();
+    bool cacheOutdated = false;
+    int cacheHits = 0;
 
     foreach( const QString &fileName, pluginFileNameList ) {
-        // mDebug() << fileName << " - " << MarbleDirs::pluginPath( fileName );
-        QString const path = MarbleDirs::pluginPath( fileName );
-        QPluginLoader* loader = new QPluginLoader( path );
-
-        QObject * obj = loader->instance();
-
-        if ( obj ) {
-            bool isPlugin = appendPlugin<RenderPlugin, RenderPluginInterface>
-                       ( obj, loader, m_renderPluginTemplates );
-            isPlugin = isPlugin || appendPlugin<NetworkPlugin, NetworkPluginInterface>
-                       ( obj, loader, m_networkPluginTemplates );
-            isPlugin = isPlugin || appendPlugin<PositionProviderPlugin, PositionProviderPluginInterface>
-                       ( obj, loader, m_positionProviderPluginTemplates );
-            isPlugin = isPlugin || appendPlugin<RunnerPlugin, RunnerPlugin>
-                       ( obj, loader, m_runnerPlugins ); // intentionally T==U
-            if ( !isPlugin ) {
-                mDebug() << "Plugin failure:" << fileName << "is a plugin, but it does not implement the "
-                        << "right interfaces or it was compiled against an old version of Marble. Ignoring it.";
-                delete loader;
-            }
+        PluginFile file;
+        file.path = MarbleDirs::pluginPath( fileName );
+        file.lastModified = QFileInfo( file.path ).lastModified();
+
+        QHash<QString, PluginFile>::const_iterator cached = cache.constFind( file.path );
+        if ( cached != cache.constEnd() && cached->lastModified == file.lastModified ) {
+            file.type = cached->type;
+            file.nameId = cached->nameId;
+            file.capabilities = cached->capabilities;
+            ++cacheHits;
         } else {
-            mDebug() << "Plugin failure:" << fileName << "is not a valid Marble Plugin:"
-                     << loader->errorString();
+            // New or changed plugin file. Files which fail to load are not cached
+            // and therefore tried again next time.
+            cacheOutdated = loadPlugin( file ) || cacheOutdated;
         }
+
+        m_pluginFiles << file;
     }
 
-    m_pluginsLoaded = true;
+    if ( cacheOutdated || cacheHits != cache.size() ) {
+        writeCache();
+    }
 
     mDebug() << Q_FUNC_INFO << "Time elapsed:" << t.elapsed() << "ms";
 }
 
+QString PluginManagerPrivate::cacheFileName()
+{
+    return MarbleDirs::localPath() + "/plugins.cache";
+}
+
+QHash<QString, PluginFile> PluginManagerPrivate::readCache() const
+{
+    QHash<QString, PluginFile> result;
+
+    QFile file( cacheFileName() );
+    if ( !file.open( QIODevice::ReadOnly ) ) {
+        return result;
+    }
+
+    QDataStream stream( &file );
+    stream.setVersion( 8 );
+
+    quint32 magic;
+    QString version;
+    qint32 profiles;
+    stream >> magic >> version >> profiles;
+    if ( magic != s_pluginCacheMagic || version != MARBLE_VERSION_STRING ) {
+        mDebug() << "Ignoring plugin cache of a different Marble version";
+        return result;
+    }
+    if ( profiles != qint32( MarbleGlobal::getInstance()->profiles() ) ) {
+        mDebug() << "Ignoring plugin cache of different profiles";
+        return result;
+    }
+
+    qint32 count = 0;
+    stream >> count;
+    for ( int i = 0; i < count && stream.status() == QDataStream::Ok; ++i ) {
+        PluginFile plugin;
+        qint32 type;
+        qint32 capabilities;
+        stream >> plugin.path >> plugin.lastModified >> type >> plugin.nameId >> capabilities;
+        if ( stream.status() == QDataStream::Ok
+             && type > PluginFile::UnknownType && type <= PluginFile::RunnerType ) {
+            plugin.type = PluginFile::Type( type );
+            plugin.capabilities = capabilities;
+            result.insert( plugin.path, plugin );
+        }
+    }
+
+    return result;
+}
+
+void PluginManagerPrivate::writeCache() const
+{
+    QDir().mkpath( MarbleDirs::localPath() );
+    QFile file( cacheFileName() );
+    if ( !file.open( QIODevice::WriteOnly ) ) {
+        mDebug() << "Unable to write the plugin cache" << file.fileName();
+        return;
+    }
+
+    QList<PluginFile> plugins;
+    foreach( const PluginFile &plugin, m_pluginFiles ) {
+        if ( plugin.type != PluginFile::UnknownType ) {
+            plugins << plugin;
+        }
+    }
+
+    QDataStream stream( &file );
+    stream.setVersion( 8 );
+    stream << s_pluginCacheMagic << MARBLE_VERSION_STRING << qint32( MarbleGlobal::getInstance()->profiles() )
+           << qint32( plugins.size() );
+    foreach( const PluginFile &plugin, plugins ) {
+        stream << plugin.path << plugin.lastModified << qint32( plugin.type )
+               << plugin.nameId << qint32( plugin.capabilities );
+    }
+}
+
 }
 
 #include "PluginManager.moc"
@@ -15,6 +15,7 @@
 #include <QtCore/QList>
 #include <QtCore/QObject>
 #include "marble_export.h"
+#include "RunnerPlugin.h"
 
 
 namespace Marble
@@ -25,7 +26,6 @@ class NetworkPlugin;
 class PositionProviderPlugin;
 class AbstractFloatItem;
 class PluginManagerPrivate;
-class RunnerPlugin;
 
 /**
  * @short The class that handles Marble's plugins.
@@ -38,6 +38,11 @@ class RunnerPlugin;
  * the objects, the PluginManager internally has a list of the plugins
  * which are owned by the PluginManager and destroyed by it.
  *
+ * Plugins are loaded on first use, and only those of the requested type.
+ * The type, name id and capabilities of each plugin file are kept in a
+ * cache in the local Marble directory, so plugin files need not be loaded
+ * to find out what they provide. Cache entries are invalidated when the
+ * modification time of the plugin file changes.
  */
 
 class MARBLE_EXPORT PluginManager : public QObject
@@ -72,6 +77,13 @@ class MARBLE_EXPORT PluginManager : public QObject
      */
     QList<RunnerPlugin *> runnerPlugins() const;
 
+    /**
+     * Returns the runner plugins which support the given capability. Runner
+     * plugins without that capability are not loaded.
+     * @note: Runner plugins are owned by the PluginManager, do not delete them
+     */
+    QList<RunnerPlugin *> runnerPlugins( RunnerPlugin::Capability capability ) const;
+
  private:
     Q_DISABLE_COPY( PluginManager )
 
@@ -0,0 +1,415 @@
+//
+// This file is part of the Marble Virtual Globe.
+//
+// This program is free software licensed under the GNU LGPL. You can
+// find a copy of this license in LICENSE.txt in the top directory of
+// the source code.
+//
+// Copyright 2026      agent <agent@local>
+//
+
+#include "PositionTrackStore.h"
+
+#include "GeoDataLineString.h"
+#include "GeoDataMultiGeometry.h"
+#include "MarbleDebug.h"
+#include "global.h"
+
+#include <QtCore/QDataStream>
+#include <QtCore/QDir>
+#include <QtCore/QList>
+#include <QtCore/QPair>
+#include <QtCore/QStack>
+#include <QtCore/QTemporaryFile>
+#include <QtCore/QVector>
+
+#include <cmath>
+
+namespace Marble
+{
+
+/** Number of chunks of the same level that get merged into one of the next level */
+static const int MergeCount = 4;
+
+/** Chunks of this level are not merged anymore */
+static const int MaxLevel = 4;
+
+class PositionTrackStorePrivate
+{
+public:
+    struct Chunk
+    {
+        GeoDataLineString m_lineString;
+        int m_level;
+        int m_segment;
+    };
+
+    PositionTrackStorePrivate();
+
+    qreal tolerance( int level ) const;
+
+    /** Moves the first count recent positions to a new chunk */
+    void seal( int count );
+
+    /** Merges chunks at the end of the list as long as enough of the same level accumulated */
+    void merge();
+
+    void spill( const QVector<GeoDataCoordinates> &positions, int count ) const;
+
+    int m_recentSize;
+    int m_chunkSize;
+    qreal m_tolerance;
+    QTemporaryFile *m_spillFile;
+
+    QList<Chunk> m_chunks;
+    QVector<GeoDataCoordinates> m_recent;
+    int m_segment;
+
+    GeoDataLineString *m_currentLineString;
+};
+
+PositionTrackStorePrivate::PositionTrackStorePrivate()
+    : m_recentSize( 600 ),
+      m_chunkSize( 300 ),
+      m_tolerance( 5.0 ),
+      m_spillFile( 0 ),
+      m_segment( 0 ),
+      m_currentLineString( 0 )
+{
+}
+
+qreal PositionTrackStorePrivate::tolerance( int level ) const
+{
+    return m_tolerance * ( 1 << level );
+}
+
+void PositionTrackStorePrivate::seal( int count )
+{
+    Q_ASSERT( count > 0 && count <= m_recent.size() );
+    spill( m_recent, count );
+
+    // The chunk ends with the first position left in the recent ones to keep the track connected
+    GeoDataLineString lineString;
+    const int end = qMin( count + 1, m_recent.size() );
+    for ( int i = 0; i < end; ++i ) {
+        lineString.append( m_recent.at( i ) );
+    }
+
+    Chunk chunk;
+    chunk.m_lineString = PositionTrackStore::simplified( lineString, tolerance( 0 ) );
+    chunk.m_level = 0;
+    chunk.m_segment = m_segment;
+    m_chunks.append( chunk );
+
+    m_recent.remove( 0, count );
+    merge();
+}
+
+void PositionTrackStorePrivate::merge()
+{
+    forever {
+        if ( m_chunks.isEmpty() ) {
+            return;
+        }
+
+        const Chunk &last = m_chunks.last();
+        if ( last.m_level >= MaxLevel ) {
+            return;
+        }
+
+        int first = m_chunks.size() - 1;
+        while ( first > 0 && m_chunks.at( first - 1 ).m_level == last.m_level
+                && m_chunks.at( first - 1 ).m_segment == last.m_segment ) {
+            --first;
+        }
+
+        if ( m_chunks.size() - first < MergeCount ) {
+            return;
+        }
+
+        GeoDataLineString lineString;
+        for ( int i = first; i < m_chunks.size(); ++i ) {
+            const GeoDataLineString &part = m_chunks.at( i ).m_lineString;
+            // Subsequent chunks start with the last position of their predecessor
+            QVector<GeoDataCoordinates>::const_iterator it = part.constBegin();
+            if ( i > first && it != part.constEnd() ) {
+                ++it;
+            }
+            for ( ; it != part.constEnd(); ++it ) {
+                lineString.append( *it );
+            }
+        }
+
+        Chunk merged;
+        merged.m_level = last.m_level + 1;
+        merged.m_segment = last.m_segment;
+        merged.m_lineString = PositionTrackStore::simplified( lineString, tolerance( merged.m_level ) );
+
+        while ( m_chunks.size() > first ) {
+            m_chunks.removeLast();
+        }
+        m_chunks.append( merged );
+    }
+}
+
+void PositionTrackStorePrivate::spill( const QVector<GeoDataCoordinates> &positions, int count ) const
+{
+    if ( !m_spillFile ) {
+        return;
+    }
+
+    m_spillFile->seek( m_spillFile->size() );
+    QDataStream stream( m_spillFile );
+    stream << qint32( m_segment ) << qint32( count );
+    for ( int i = 0; i < count; ++i ) {
+        qreal lon, lat, alt;
+        positions.at( i ).geoCoordinates( lon, lat, alt, GeoDataCoordinates::Radian );
+        stream << double( lon ) << double( lat ) << double( alt );
+    }
+    m_spillFile->flush();
+}
+
+PositionTrackStore::PositionTrackStore()
+    : d( new PositionTrackStorePrivate )
+{
+}
+
+PositionTrackStore::~PositionTrackStore()
+{
+    delete d->m_spillFile;
+    delete d;
+}
+
+void PositionTrackStore::setRecentSize( int positions )
+{
+    d->m_recentSize = qMax( 1, positions );
+}
+
+void PositionTrackStore::setChunkSize( int positions )
+{
+    d->m_chunkSize = qMax( 2, positions );
+}
+
+void PositionTrackStore::setTolerance( qreal meters )
+{
+    d->m_tolerance = meters;
+}
+
+void PositionTrackStore::setSpillEnabled( bool enabled )
+{
+    delete d->m_spillFile;
+    d->m_spillFile = 0;
+
+    if ( enabled ) {
+        d->m_spillFile = new QTemporaryFile( QDir::tempPath() + "/marble-track-XXXXXX.dat" );
+        if ( !d->m_spillFile->open() ) {
+            mDebug() << "Unable to create a file for track positions in" << QDir::tempPath();
+            delete d->m_spillFile;
+            d->m_spillFile = 0;
+        }
+    }
+}
+
+QString PositionTrackStore::spillFile() const
+{
+    return d->m_spillFile ? d->m_spillFile->fileName() : QString();
+}
+
+bool PositionTrackStore::append( const GeoDataCoordinates &position )
+{
+    d->m_recent.append( position );
+    if ( d->m_recent.size() < d->m_recentSize + d->m_chunkSize ) {
+        if ( d->m_currentLineString ) {
+            d->m_currentLineString->append( position );
+        }
+        return false;
+    }
+
+    d->seal( d->m_chunkSize );
+    return true;
+}
+
+void PositionTrackStore::startSegment()
+{
+    if ( !d->m_recent.isEmpty() ) {
+        d->seal( d->m_recent.size() );
+    }
+    ++d->m_segment;
+}
+
+void PositionTrackStore::clear()
+{
+    d->m_chunks.clear();
+    d->m_recent.clear();
+    if ( d->m_spillFile ) {
+        d->m_spillFile->resize( 0 );
+    }
+}
+
+void PositionTrackStore::rebuild( GeoDataMultiGeometry *track )
+{
+    track->clear();
+    foreach( const PositionTrackStorePrivate::Chunk &chunk, d->m_chunks ) {
+        // Shares the data with the chunk
+        track->append( new GeoDataLineString( chunk.m_lineString ) );
+    }
+
+    d->m_currentLineString = new GeoDataLineString;
+    foreach( const GeoDataCoordinates &position, d->m_recent ) {
+        d->m_currentLineString->append( position );
+    }
+    track->append( d->m_currentLineString );
+}
+
+GeoDataLineString *PositionTrackStore::currentLineString()
+{
+    return d->m_currentLineString;
+}
+
+void PositionTrackStore::exportTrack( GeoDataMultiGeometry *track ) const
+{
+    QList<QPair<int, GeoDataLineString> > segments;
+
+    if ( d->m_spillFile ) {
+        d->m_spillFile->seek( 0 );
+        QDataStream stream( d->m_spillFile );
+        while ( !stream.atEnd() ) {
+            qint32 segment, count;
+            stream >> segment >> count;
+            if ( stream.status() != QDataStream::Ok ) {
+                break;
+            }
+
+            if ( segments.isEmpty() || segments.last().first != segment ) {
+                segments.append( qMakePair( int( segment ), GeoDataLineString() ) );
+            }
+
+            GeoDataLineString &lineString = segments.last().second;
+            for ( int i = 0; i < count && !stream.atEnd(); ++i ) {
+                double lon, lat, alt;
+                stream >> lon >> lat >> alt;
+                lineString.append( GeoDataCoordinates( lon, lat, alt ) );
+            }
+        }
+    } else {
+        foreach( const PositionTrackStorePrivate::Chunk &chunk, d->m_chunks ) {
+            if ( segments.isEmpty() || segments.last().first != chunk.m_segment ) {
+                segments.append( qMakePair( chunk.m_segment, GeoDataLineString() ) );
+            }
+
+            GeoDataLineString &lineString = segments.last().second;
+            QVector<GeoDataCoordinates>::const_iterator it = chunk.m_lineString.constBegin();
+            if ( !lineString.isEmpty() && it != chunk.m_lineString.constEnd() ) {
+                ++it;
+            }
+            for ( ; it != chunk.m_lineString.constEnd(); ++it ) {
+                lineString.append( *it );
+            }
+        }
+    }
+
+    if ( !d->m_recent.isEmpty() ) {
+        if ( segments.isEmpty() || segments.last().first != d->m_segment ) {
+            segments.append( qMakePair( d->m_segment, GeoDataLineString() ) );
+        }
+
+        GeoDataLineString &lineString = segments.last().second;
+        QVector<GeoDataCoordinates>::const_iterator it = d->m_recent.constBegin();
+        // Without spill file, the last chunk already contains the first recent position
+        if ( !d->m_spillFile && !lineString.isEmpty() ) {
+            ++it;
+        }
+        for ( ; it != d->m_recent.constEnd(); ++it ) {
+            lineString.append( *it );
+        }
+    }
+
+    for ( int i = 0; i < segments.size(); ++i ) {
+        track->append( new GeoDataLineString( segments.at( i ).second ) );
+    }
+}
+
+int PositionTrackStore::size() const
+{
+    int result = d->m_recent.size();
+    foreach( const PositionTrackStorePrivate::Chunk &chunk, d->m_chunks ) {
+        result += chunk.m_lineString.size();
+    }
+    return result;
+}
+
+bool PositionTrackStore::isEmpty() const
+{
+    return d->m_recent.isEmpty() && d->m_chunks.isEmpty();
+}
+
+GeoDataLineString PositionTrackStore::simplified( const GeoDataLineString &lineString, qreal tolerance )
+{
+    const int size = lineString.size();
+    if ( size < 3 ) {
+        return lineString;
+    }
+
+    QVector<bool> keep( size, false );
+    keep[0] = true;
+    keep[size-1] = true;
+
+    QStack<QPair<int, int> > ranges;
+    ranges.push( qMakePair( 0, size - 1 ) );
+    while ( !ranges.isEmpty() ) {
+        const QPair<int, int> range = ranges.pop();
+        if ( range.second - range.first < 2 ) {
+            continue;
+        }
+
+        // Distances are calculated in a local equirectangular projection around the first position
+        const GeoDataCoordinates &first = lineString.at( range.first );
+        const GeoDataCoordinates &last = lineString.at( range.second );
+        const qreal lon0 = first.longitude();
+        const qreal lat0 = first.latitude();
+        const qreal scale = cos( lat0 ) * EARTH_RADIUS;
+        qreal deltaLon = last.longitude() - lon0;
+        if ( fabs( deltaLon ) > M_PI ) {
+            deltaLon -= deltaLon > 0 ? 2 * M_PI : -2 * M_PI;
+        }
+        const qreal bx = deltaLon * scale;
+        const qreal by = ( last.latitude() - lat0 ) * EARTH_RADIUS;
+        const qreal length2 = bx * bx + by * by;
+
+        int farthest = -1;
+        qreal maxDistance = tolerance;
+        for ( int i = range.first + 1; i < range.second; ++i ) {
+            const GeoDataCoordinates &position = lineString.at( i );
+            qreal dLon = position.longitude() - lon0;
+            if ( fabs( dLon ) > M_PI ) {
+                dLon -= dLon > 0 ? 2 * M_PI : -2 * M_PI;
+            }
+            const qreal px = dLon * scale;
+            const qreal py = ( position.latitude() - lat0 ) * EARTH_RADIUS;
+            const qreal t = length2 > 0.0 ? qBound( qreal( 0.0 ), ( px * bx + py * by ) / length2, qreal( 1.0 ) ) : 0.0;
+            const qreal dx = px - t * bx;
+            const qreal dy = py - t * by;
+            const qreal distance = sqrt( dx * dx + dy * dy );
+            if ( distance > maxDistance ) {
+                maxDistance = distance;
+                farthest = i;
+            }
+        }
+
+        if ( farthest >= 0 ) {
+            keep[farthest] = true;
+            ranges.push( qMakePair( range.first, farthest ) );
+            ranges.push( qMakePair( farthest, range.second ) );
+        }
+    }
+
+    GeoDataLineString result( lineString.tessellationFlags() );
+    for ( int i = 0; i < size; ++i ) {
+        if ( keep.at( i ) ) {
+            result.append( lineString.at( i ) );
+        }
+    }
+    return result;
+}
+
+}
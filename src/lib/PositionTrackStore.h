@@ -0,0 +1,117 @@
+//
+// This file is part of the Marble Virtual Globe.
+//
+// This program is free software licensed under the GNU LGPL. You can
+// find a copy of this license in LICENSE.txt in the top directory of
+// the source code.
+//
+// Copyright 2026      agent <agent@local>
+//
+
+#ifndef MARBLE_POSITIONTRACKSTORE_H
+#define MARBLE_POSITIONTRACKSTORE_H
+
+#include "marble_export.h"
+
+#include <QtCore/QString>
+
+namespace Marble
+{
+
+class GeoDataCoordinates;
+class GeoDataLineString;
+class GeoDataMultiGeometry;
+class PositionTrackStorePrivate;
+
+/**
+ * @short Bounded storage of the positions recorded by position tracking.
+ *
+ * The most recent positions are kept at full resolution. Older positions are
+ * moved to chunks which are simplified with the Douglas-Peucker algorithm.
+ * Whenever a couple of chunks with the same tolerance accumulated, they are
+ * merged into a single chunk simplified with twice the tolerance. This keeps
+ * the number of positions in memory growing much slower than the track while
+ * the deviation of the simplified track stays below twice the tolerance of
+ * the coarsest level.
+ *
+ * If a spill file is set, the positions of each chunk are appended to it at
+ * full resolution before simplification, so the complete track can still be
+ * exported.
+ *
+ * The store mirrors its content to a GeoDataMultiGeometry with one line string
+ * per chunk and one for the recent positions. Chunks never change once created,
+ * so their screen coordinates can be cached across frames by the renderer.
+ */
+class MARBLE_EXPORT PositionTrackStore
+{
+public:
+    PositionTrackStore();
+
+    ~PositionTrackStore();
+
+    /** Number of positions kept at full resolution. Defaults to 600. */
+    void setRecentSize( int positions );
+
+    /** Number of positions moved to a new chunk at once. Defaults to 300. */
+    void setChunkSize( int positions );
+
+    /** Maximum deviation of the simplified chunks in meters. Defaults to 5 meters. */
+    void setTolerance( qreal meters );
+
+    /**
+     * Enables writing positions to a new temporary file before simplification.
+     * The file is removed when spilling is disabled or the store is destroyed.
+     */
+    void setSpillEnabled( bool enabled );
+
+    /** The name of the temporary file positions are written to, empty if disabled */
+    QString spillFile() const;
+
+    /**
+     * Appends the position to the current segment of the track. Returns true if
+     * chunks changed and the track geometry has to be updated using rebuild().
+     * Otherwise the position was appended to currentLineString() already.
+     */
+    bool append( const GeoDataCoordinates &position );
+
+    /**
+     * Ends the current segment, the next position starts a new one. Call rebuild()
+     * afterwards.
+     */
+    void startSegment();
+
+    /** Removes all positions, including those of the spill file. Call rebuild() afterwards. */
+    void clear();
+
+    /**
+     * Replaces the content of track with the chunks and the recent positions.
+     * The store keeps a pointer to the line string of the recent positions.
+     */
+    void rebuild( GeoDataMultiGeometry *track );
+
+    /** The line string of the recent positions in the track passed to rebuild() */
+    GeoDataLineString *currentLineString();
+
+    /** Appends one line string per segment with all positions at the best resolution available */
+    void exportTrack( GeoDataMultiGeometry *track ) const;
+
+    /** Number of positions held in memory */
+    int size() const;
+
+    bool isEmpty() const;
+
+    /**
+     * Simplifies the line string using the Douglas-Peucker algorithm, keeping
+     * the first and last position.
+     */
+    static GeoDataLineString simplified( const GeoDataLineString &lineString, qreal tolerance );
+
+private:
+    Q_DISABLE_COPY( PositionTrackStore )
+
+    PositionTrackStorePrivate *const d;
+};
+
+}
+
+#endif
@@ -35,13 +35,18 @@ void PositionTrackingPrivate::setPosition( GeoDataCoordinates position,
                                            GeoDataAccuracy accuracy )
 {
     m_accuracy = accuracy;
+    if ( !m_updatePending ) {
+        m_pendingUpdate.start();
+        m_updatePending = true;
+    }
+
     if ( m_positionProvider && m_positionProvider->status() ==
         PositionProviderStatusAvailable )
     {
         GeoDataPlacemark *placemark = static_cast<GeoDataPlacemark*>(m_document->child(m_document->size()-1));
 
-        if ( accuracy.horizontal < 250 ) {
-            m_currentLineString->append(position);
+        if ( accuracy.horizontal < 250 && m_trackStore.append( position ) ) {
+            rebuildTrack();
         }
 
         //if the position has moved then update the current position
@@ -61,17 +66,22 @@ void PositionTrackingPrivate::setStatus( PositionProviderStatus status )
 {
     if (status == PositionProviderStatusAvailable) {
         Q_ASSERT(m_document);
-        m_treeModel->removeDocument( m_document );
-        GeoDataPlacemark *placemark = static_cast<GeoDataPlacemark*>(m_document->child(m_document->size()-1));
-        GeoDataMultiGeometry *multiGeometry = static_cast<GeoDataMultiGeometry*>(placemark->geometry());
-        m_currentLineString = new GeoDataLineString;
-        multiGeometry->append(m_currentLineString);
-        m_treeModel->addDocument( m_document );
+        m_trackStore.startSegment();
+        rebuildTrack();
     }
 
     emit statusChanged( status );
 }
 
+void PositionTrackingPrivate::rebuildTrack()
+{
+    m_treeModel->removeDocument( m_document );
+    GeoDataPlacemark *placemark = static_cast<GeoDataPlacemark*>(m_document->child(m_document->size()-1));
+    GeoDataMultiGeometry *multiGeometry = static_cast<GeoDataMultiGeometry*>(placemark->geometry());
+    m_trackStore.rebuild( multiGeometry );
+    m_treeModel->addDocument( m_document );
+}
+
 PositionTracking::PositionTracking( GeoDataTreeModel *model )
      : QObject( model ), d (new PositionTrackingPrivate( model ))
 {
@@ -94,9 +104,8 @@ PositionTracking::PositionTracking( GeoDataTreeModel *model )
     // Second point is position track
     placemark = new GeoDataPlacemark;
     GeoDataMultiGeometry *multiGeometry = new GeoDataMultiGeometry;
-    d->m_currentLineString = new GeoDataLineString;
-
-    multiGeometry->append(d->m_currentLineString);
+    d->m_trackStore.setSpillEnabled( true );
+    d->m_trackStore.rebuild( multiGeometry );
     placemark->setGeometry(multiGeometry);
     placemark->setName("Current Track");
 
@@ -209,7 +218,11 @@ bool PositionTracking::saveTrack(QString& fileName)
         foreach( GeoDataStyleMap map, d->m_document->styleMaps() ) {
             document->addStyleMap( map );
         }
-        GeoDataFeature *track = new GeoDataFeature(d->m_document->last());
+        // The track is saved with all positions, not just those kept in memory
+        GeoDataPlacemark *track = new GeoDataPlacemark( *static_cast<GeoDataPlacemark*>( &d->m_document->last() ) );
+        GeoDataMultiGeometry *multiGeometry = new GeoDataMultiGeometry;
+        d->m_trackStore.exportTrack( multiGeometry );
+        track->setGeometry( multiGeometry );
         track->setName( "Track " + name );
         document->append( track );
 
@@ -224,28 +237,13 @@ bool PositionTracking::saveTrack(QString& fileName)
 
 void PositionTracking::clearTrack()
 {
-    GeoDataPlacemark *placemark = static_cast<GeoDataPlacemark*>(d->m_document->child(d->m_document->size()-1));
-    GeoDataMultiGeometry *multiGeometry = static_cast<GeoDataMultiGeometry*>(placemark->geometry());
-    d->m_currentLineString = new GeoDataLineString;
-    d->m_treeModel->removeDocument( d->m_document );
-    multiGeometry->clear();
-    multiGeometry->append(d->m_currentLineString);
-    d->m_treeModel->addDocument( d->m_document );
+    d->m_trackStore.clear();
+    d->rebuildTrack();
 }
 
 bool PositionTracking::isTrackEmpty() const
 {
-    GeoDataPlacemark *placemark = static_cast<GeoDataPlacemark*>(d->m_document->child(d->m_document->size()-1));
-    GeoDataMultiGeometry *multiGeometry = static_cast<GeoDataMultiGeometry*>(placemark->geometry());
-    if ( multiGeometry->size() < 1 ) {
-        return true;
-    }
-
-    if ( multiGeometry->size() == 1 ) {
-        return d->m_currentLineString->isEmpty();
-    }
-
-    return false;
+    return d->m_trackStore.isEmpty();
 }
 
 GeoDataAccuracy PositionTracking::accuracy() const
@@ -258,6 +256,16 @@ GeoDataCoordinates PositionTracking::currentLocation() const
     return d->m_gpsCurrentPosition;
 }
 
+int PositionTracking::takePendingUpdateAge()
+{
+    if ( !d->m_updatePending ) {
+        return -1;
+    }
+
+    d->m_updatePending = false;
+    return d->m_pendingUpdate.elapsed();
+}
+
 PositionProviderStatus PositionTracking::status() const
 {
     return d->m_positionProvider ? d->m_positionProvider->status() : PositionProviderStatusUnavailable;
@@ -79,6 +79,13 @@ public:
     /** @brief Returns true if there is no position in the track */
     bool isTrackEmpty() const;
 
+    /**
+     * @brief Returns the milliseconds passed since the oldest position update
+     * that was not rendered yet, or -1 if there is none. All position updates
+     * count as rendered afterwards. Called by MarbleMap after each frame.
+     */
+    int takePendingUpdateAge();
+
 public Q_SLOTS:
     /**
       * Toggles the visibility of the Position Tracking document
@@ -24,6 +24,9 @@
 #include "MarbleMath.h"
 #include "MarbleDebug.h"
 #include "PositionProviderPlugin.h"
+#include "PositionTrackStore.h"
+
+#include <QtCore/QTime>
 
 namespace Marble
 {
@@ -35,10 +38,14 @@ class PositionTrackingPrivate : public QObject
         : QObject( model ),
         m_document( 0 ),
         m_treeModel( model ),
-        m_positionProvider( 0 )
+        m_positionProvider( 0 ),
+        m_updatePending( false )
     {
     }
 
+    /** Replaces the track geometry with the content of m_trackStore */
+    void rebuildTrack();
+
     public Q_SLOTS:
     void setPosition( GeoDataCoordinates position,
                       GeoDataAccuracy accuracy );
@@ -56,11 +63,15 @@ class PositionTrackingPrivate : public QObject
 
     GeoDataCoordinates  m_gpsCurrentPosition;
     GeoDataCoordinates  m_gpsPreviousPosition;
-    GeoDataLineString  *m_currentLineString;
+    PositionTrackStore  m_trackStore;
 
     PositionProviderPlugin* m_positionProvider;
 
     GeoDataAccuracy m_accuracy;
+
+    /** Started with the oldest position update that was not rendered yet */
+    QTime m_pendingUpdate;
+    bool m_updatePending;
 };
 }
 
@@ -19,6 +19,7 @@
 
 // Marble
 #include "GeoDataLineString.h"
+#include "GeoDataLineString_p.h"
 #include "GeoDataLinearRing.h"
 #include "ViewportParams.h"
 
@@ -287,7 +288,7 @@ bool AbstractProjectionPrivate::lineStringToPolygon( const GeoDataLineString &li
                     tessellateLineSegment( previousCoords, previousX, previousY,
                                            currentCoords, x, y,
                                            polygon, viewport,
-                                           f );
+                                           f, &lineString, itPreviousCoords - itBegin );
 
                 }
                 else {
@@ -642,7 +643,9 @@ void AbstractProjectionPrivate::tessellateLineSegment( const GeoDataCoordinates
                                                 qreal bx, qreal by,
                                                 QPolygonF * polygon,
                                                 const ViewportParams *viewport,
-                                                TessellationFlags f ) const
+                                                TessellationFlags f,
+                                                const GeoDataLineString *lineString,
+                                                int segment ) const
 {
     // We take the manhattan length as a distance approximation
     // that can be too big by a factor of sqrt(2)
@@ -676,7 +679,7 @@ void AbstractProjectionPrivate::tessellateLineSegment( const GeoDataCoordinates
 
             *polygon << processTessellation( aCoords, bCoords,
                                         tessellatedNodes, viewport,
-                                        f );
+                                        f, lineString, segment );
         }
         else {
             QPolygonF path;
@@ -704,7 +707,9 @@ QPolygonF AbstractProjectionPrivate::processTessellation(  const GeoDataCoordina
                                                     const GeoDataCoordinates &currentCoords,
                                                     int tessellatedNodes,
                                                     const ViewportParams *viewport,
-                                                    TessellationFlags f ) const
+                                                    TessellationFlags f,
+                                                    const GeoDataLineString *lineString,
+                                                    int segment ) const
 {
     QPolygonF   path;
 
@@ -714,6 +719,17 @@ QPolygonF AbstractProjectionPrivate::processTessellation(  const GeoDataCoordina
     // Maximum amount of tessellation nodes.
     if ( tessellatedNodes > maxTessellationNodes ) tessellatedNodes = maxTessellationNodes;
 
+    // Cached segments are tessellated with a few fixed node counts, so that they
+    // remain valid while zooming: Round up to the next power of two.
+    const bool useCache = lineString && segment >= 0 && tessellatedNodes > 2;
+    if ( useCache ) {
+        int level = 4;
+        while ( level < tessellatedNodes ) {
+            level *= 2;
+        }
+        tessellatedNodes = qMin( level, maxTessellationNodes );
+    }
+
 //    mDebug() << "Creating tessellation nodes:" << tessellatedNodes;
 
     qreal previousAltitude = previousCoords.altitude();
@@ -771,8 +787,11 @@ QPolygonF AbstractProjectionPrivate::processTessellation(  const GeoDataCoordina
         path << QPointF( x, y );
     }
 
-    qreal  lon = 0.0;
-    qreal  lat = 0.0;
+    const QVector<QPointF> nodes = useCache
+        ? cachedTessellationNodes( *lineString, segment, previousCoords, currentCoords,
+                                   tessellatedNodes, followLatitudeCircle )
+        : tessellationNodes( previousCoords, currentCoords,
+                             tessellatedNodes, followLatitudeCircle );
 
     qreal altDiff = currentCoords.altitude() - previousAltitude;
 
@@ -786,20 +805,8 @@ QPolygonF AbstractProjectionPrivate::processTessellation(  const GeoDataCoordina
         // interpolate the altitude, too
         qreal altitude = clampToGround ? 0 : altDiff * t + previousAltitude;
 
-        if ( followLatitudeCircle ) {
-            // To tessellate along latitude circles use the 
-            // linear interpolation of the longitude.
-            lon = lonDiff * t + previousLongitude;
-            lat = previousLatitude;
-        }
-        else {
-            // To tessellate along great circles use the 
-            // normalized linear interpolation ("NLERP") for latitude and longitude.
-            const Quaternion itpos = Quaternion::nlerp( previousCoords.quaternion(), currentCoords.quaternion(), t );
-            itpos. getSpherical( lon, lat );
-        }
-
-        q->screenCoordinates( GeoDataCoordinates( lon, lat, altitude ), viewport, x, y, globeHidesPoint );
+        const QPointF &node = nodes.at( i - startNode );
+        q->screenCoordinates( GeoDataCoordinates( node.x(), node.y(), altitude ), viewport, x, y, globeHidesPoint );
 
         // No "else" here, as this would not add the current point that is required.
         if ( !globeHidesPoint ) {
@@ -829,6 +836,85 @@ QPolygonF AbstractProjectionPrivate::processTessellation(  const GeoDataCoordina
 }
 
 
+QVector<QPointF> AbstractProjectionPrivate::tessellationNodes( const GeoDataCoordinates &previousCoords,
+                                                               const GeoDataCoordinates &currentCoords,
+                                                               int tessellatedNodes,
+                                                               bool followLatitudeCircle ) const
+{
+    QVector<QPointF> nodes;
+    if ( tessellatedNodes < 3 ) {
+        return nodes;
+    }
+    nodes.reserve( tessellatedNodes - 2 );
+
+    qreal previousLongitude = 0.0;
+    qreal previousLatitude = 0.0;
+    qreal lonDiff = 0.0;
+
+    if ( followLatitudeCircle ) {
+        previousCoords.geoCoordinates( previousLongitude, previousLatitude );
+        lonDiff = currentCoords.longitude() - previousLongitude;
+    }
+
+    qreal  lon = 0.0;
+    qreal  lat = 0.0;
+
+    for ( int i = 1; i <= tessellatedNodes - 2; ++i ) {
+        qreal  t = (qreal)(i) / (qreal)( tessellatedNodes ) ;
+
+        if ( followLatitudeCircle ) {
+            // To tessellate along latitude circles use the 
+            // linear interpolation of the longitude.
+            lon = lonDiff * t + previousLongitude;
+            lat = previousLatitude;
+        }
+        else {
+            // To tessellate along great circles use the 
+            // normalized linear interpolation ("NLERP") for latitude and longitude.
+            const Quaternion itpos = Quaternion::nlerp( previousCoords.quaternion(), currentCoords.quaternion(), t );
+            itpos. getSpherical( lon, lat );
+        }
+
+        nodes << QPointF( lon, lat );
+    }
+
+    return nodes;
+}
+
+QVector<QPointF> AbstractProjectionPrivate::cachedTessellationNodes( const GeoDataLineString &lineString,
+                                                                     int segment,
+                                                                     const GeoDataCoordinates &previousCoords,
+                                                                     const GeoDataCoordinates &currentCoords,
+                                                                     int tessellatedNodes,
+                                                                     bool followLatitudeCircle ) const
+{
+    QHash<int, GeoDataLineStringPrivate::TessellatedSegment> &cache
+            = lineString.p()->m_tessellationCache;
+
+    // The nodes of a line string can also be modified through references
+    // without invalidating the cache, so check the end points, too.
+    QHash<int, GeoDataLineStringPrivate::TessellatedSegment>::const_iterator it
+            = cache.constFind( segment );
+    if ( it != cache.constEnd()
+         && it->m_tessellatedNodes == tessellatedNodes
+         && it->m_from == previousCoords && it->m_to == currentCoords ) {
+        return it->m_nodes;
+    }
+
+    // Replaces the nodes of the segment for another node count, so the cache
+    // never holds more entries than the line string has segments
+    GeoDataLineStringPrivate::TessellatedSegment tessellatedSegment;
+    tessellatedSegment.m_tessellatedNodes = tessellatedNodes;
+    tessellatedSegment.m_from = previousCoords;
+    tessellatedSegment.m_to = currentCoords;
+    tessellatedSegment.m_nodes = tessellationNodes( previousCoords, currentCoords,
+                                                    tessellatedNodes, followLatitudeCircle );
+    cache.insert( segment, tessellatedSegment );
+
+    return tessellatedSegment.m_nodes;
+}
+
+
 GeoDataCoordinates AbstractProjectionPrivate::findHorizon( const GeoDataCoordinates & previousCoords,
                                                     const GeoDataCoordinates & currentCoords,
                                                     const ViewportParams *viewport,
@@ -55,6 +55,9 @@ class AbstractProjectionPrivate
     // number of nodes generated for the polygon. If the
     // clampToGround flag is added the polygon contains count + 2
     // nodes as the clamped down start and end node get added.
+    // If a line string and the index of the segment inside it are passed,
+    // the geographic positions of the nodes are taken from the tessellation
+    // cache of the line string.
 
     void tessellateLineSegment( const GeoDataCoordinates &aCoords,
                                 qreal ax, qreal ay,
@@ -62,12 +65,28 @@ class AbstractProjectionPrivate
                                 qreal bx, qreal by,
                                 QPolygonF * polygon,
                                 const ViewportParams *viewport,
-                                TessellationFlags f = 0 ) const;
+                                TessellationFlags f = 0,
+                                const GeoDataLineString *lineString = 0,
+                                int segment = -1 ) const;
 
     QPolygonF processTessellation(  const GeoDataCoordinates &previousCoords,
                                     const GeoDataCoordinates &currentCoords,
                                     int count, const ViewportParams *viewport,
-                                    TessellationFlags f = 0 ) const;
+                                    TessellationFlags f = 0,
+                                    const GeoDataLineString *lineString = 0,
+                                    int segment = -1 ) const;
+
+    // Returns the longitude (x) and latitude (y) of the count - 2 nodes
+    // between previousCoords and currentCoords that processTessellation() needs.
+    QVector<QPointF> tessellationNodes( const GeoDataCoordinates &previousCoords,
+                                        const GeoDataCoordinates &currentCoords,
+                                        int count, bool followLatitudeCircle ) const;
+
+    QVector<QPointF> cachedTessellationNodes( const GeoDataLineString &lineString,
+                                              int segment,
+                                              const GeoDataCoordinates &previousCoords,
+                                              const GeoDataCoordinates &currentCoords,
+                                              int count, bool followLatitudeCircle ) const;
 
     bool lineStringToPolygon( const GeoDataLineString &lineString,
                               const ViewportParams *viewport,
@@ -171,6 +171,11 @@ bool RenderPlugin::visible() const
     return d->m_visible;
 }
 
+QString RenderPlugin::layerName() const
+{
+    return nameId();
+}
+
 QDialog *RenderPlugin::aboutDialog()
 {
     if ( !d->m_aboutDialog && !d->m_authors.isEmpty() && !d->m_years.isEmpty() && !d->m_version.isEmpty() ) {
@@ -121,6 +121,11 @@ class MARBLE_EXPORT RenderPlugin : public QObject, public RenderPluginInterface
      */
     virtual RenderType renderType() const;
 
+    /**
+     * @reimp
+     */
+    virtual QString layerName() const;
+
  public Q_SLOTS:
     void    setEnabled( bool enabled );
     void    setVisible( bool visible );
@@ -0,0 +1,331 @@
+//
+// This file is part of the Marble Virtual Globe.
+//
+// This program is free software licensed under the GNU LGPL. You can
+// find a copy of this license in LICENSE.txt in the top directory of
+// the source code.
+//
+// Copyright 2026      agent <agent@local>
+//
+
+#include "RenderStatistics.h"
+
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QVector>
+
+#include <cmath>
+
+namespace Marble
+{
+
+/** The per frame values of one stage or counter, kept in a ring buffer */
+class RenderStatisticsSeries
+{
+public:
+    RenderStatisticsSeries()
+        : m_next( 0 ),
+          m_total( 0.0 )
+    {
+    }
+
+    void append( qreal value, int windowSize )
+    {
+        if ( m_values.size() < windowSize ) {
+            m_values.append( value );
+        } else {
+            m_values[m_next] = value;
+            m_next = ( m_next + 1 ) % windowSize;
+        }
+        m_total += value;
+    }
+
+    qreal mean() const
+    {
+        if ( m_values.isEmpty() ) {
+            return 0.0;
+        }
+
+        qreal sum = 0.0;
+        foreach( qreal value, m_values ) {
+            sum += value;
+        }
+        return sum / m_values.size();
+    }
+
+    qreal percentile( qreal p ) const
+    {
+        if ( m_values.isEmpty() ) {
+            return 0.0;
+        }
+
+        QVector<qreal> sorted = m_values;
+        qSort( sorted );
+        const int rank = qBound( 0, int( ceil( p * sorted.size() ) ) - 1, sorted.size() - 1 );
+        return sorted.at( rank );
+    }
+
+    qreal total() const
+    {
+        return m_total;
+    }
+
+private:
+    QVector<qreal> m_values;
+    int m_next;
+    qreal m_total;
+};
+
+class RenderStatisticsPrivate
+{
+public:
+    RenderStatisticsPrivate()
+        : m_enabled( false ),
+          m_windowSize( 100 )
+    {
+    }
+
+    static void flush( QHash<QString, qreal> &current,
+                       QHash<QString, RenderStatisticsSeries> &series, int windowSize );
+
+    mutable QMutex m_mutex;
+    volatile bool m_enabled;
+    int m_windowSize;
+
+    QHash<QString, qreal> m_currentTimes;
+    QHash<QString, qreal> m_currentCounts;
+    QHash<QString, RenderStatisticsSeries> m_times;
+    QHash<QString, RenderStatisticsSeries> m_counts;
+    QHash<QString, RenderStatisticsSeries> m_latencies;
+};
+
+void RenderStatisticsPrivate::flush( QHash<QString, qreal> &current,
+                                     QHash<QString, RenderStatisticsSeries> &series, int windowSize )
+{
+    // Stages or counters that did not occur in a frame count as zero
+    QHash<QString, RenderStatisticsSeries>::iterator it = series.begin();
+    QHash<QString, RenderStatisticsSeries>::iterator const end = series.end();
+    for (; it != end; ++it ) {
+        it.value().append( current.take( it.key() ), windowSize );
+    }
+
+    QHash<QString, qreal>::const_iterator newIt = current.constBegin();
+    QHash<QString, qreal>::const_iterator const newEnd = current.constEnd();
+    for (; newIt != newEnd; ++newIt ) {
+        series[newIt.key()].append( newIt.value(), windowSize );
+    }
+
+    current.clear();
+}
+
+RenderStatistics::RenderStatistics( QObject *parent )
+    : QObject( parent ),
+      d( new RenderStatisticsPrivate )
+{
+}
+
+RenderStatistics::~RenderStatistics()
+{
+    delete d;
+}
+
+bool RenderStatistics::isEnabled() const
+{
+    return d->m_enabled;
+}
+
+void RenderStatistics::setEnabled( bool enabled )
+{
+    QMutexLocker locker( &d->m_mutex );
+    d->m_enabled = enabled;
+    d->m_currentTimes.clear();
+    d->m_currentCounts.clear();
+}
+
+int RenderStatistics::windowSize() const
+{
+    QMutexLocker locker( &d->m_mutex );
+    return d->m_windowSize;
+}
+
+void RenderStatistics::setWindowSize( int frames )
+{
+    QMutexLocker locker( &d->m_mutex );
+    if ( frames > 0 && frames != d->m_windowSize ) {
+        d->m_windowSize = frames;
+        d->m_times.clear();
+        d->m_counts.clear();
+        d->m_latencies.clear();
+    }
+}
+
+void RenderStatistics::addTime( const QString &stage, qreal milliseconds )
+{
+    if ( !d->m_enabled ) {
+        return;
+    }
+
+    QMutexLocker locker( &d->m_mutex );
+    d->m_currentTimes[stage] += milliseconds;
+}
+
+void RenderStatistics::addCount( const QString &counter, int count )
+{
+    if ( !d->m_enabled ) {
+        return;
+    }
+
+    QMutexLocker locker( &d->m_mutex );
+    d->m_currentCounts[counter] += count;
+}
+
+void RenderStatistics::addLatency( const QString &event, qreal milliseconds )
+{
+    if ( !d->m_enabled ) {
+        return;
+    }
+
+    QMutexLocker locker( &d->m_mutex );
+    d->m_latencies[event].append( milliseconds, d->m_windowSize );
+}
+
+void RenderStatistics::finishFrame( qreal milliseconds )
+{
+    if ( !d->m_enabled ) {
+        return;
+    }
+
+    QMutexLocker locker( &d->m_mutex );
+    d->m_currentTimes["frame"] = milliseconds;
+    RenderStatisticsPrivate::flush( d->m_currentTimes, d->m_times, d->m_windowSize );
+    RenderStatisticsPrivate::flush( d->m_currentCounts, d->m_counts, d->m_windowSize );
+}
+
+void RenderStatistics::reset()
+{
+    QMutexLocker locker( &d->m_mutex );
+    d->m_currentTimes.clear();
+    d->m_currentCounts.clear();
+    d->m_times.clear();
+    d->m_counts.clear();
+    d->m_latencies.clear();
+}
+
+QStringList RenderStatistics::stages() const
+{
+    QMutexLocker locker( &d->m_mutex );
+    QStringList result = d->m_times.keys();
+    qSort( result );
+    return result;
+}
+
+QStringList RenderStatistics::counters() const
+{
+    QMutexLocker locker( &d->m_mutex );
+    QStringList result = d->m_counts.keys();
+    qSort( result );
+    return result;
+}
+
+qreal RenderStatistics::mean( const QString &stage ) const
+{
+    QMutexLocker locker( &d->m_mutex );
+    return d->m_times.value( stage ).mean();
+}
+
+qreal RenderStatistics::percentile( const QString &stage, qreal p ) const
+{
+    QMutexLocker locker( &d->m_mutex );
+    return d->m_times.value( stage ).percentile( p );
+}
+
+qreal RenderStatistics::counterMean( const QString &counter ) const
+{
+    QMutexLocker locker( &d->m_mutex );
+    return d->m_counts.value( counter ).mean();
+}
+
+qlonglong RenderStatistics::counterTotal( const QString &counter ) const
+{
+    QMutexLocker locker( &d->m_mutex );
+    return qRound64( d->m_counts.value( counter ).total() );
+}
+
+QStringList RenderStatistics::latencies() const
+{
+    QMutexLocker locker( &d->m_mutex );
+    QStringList result = d->m_latencies.keys();
+    qSort( result );
+    return result;
+}
+
+qreal RenderStatistics::latencyMean( const QString &event ) const
+{
+    QMutexLocker locker( &d->m_mutex );
+    return d->m_latencies.value( event ).mean();
+}
+
+qreal RenderStatistics::latencyPercentile( const QString &event, qreal p ) const
+{
+    QMutexLocker locker( &d->m_mutex );
+    return d->m_latencies.value( event ).percentile( p );
+}
+
+QString RenderStatistics::report() const
+{
+    QString result = "stage\tmean\tp50\tp90\tp99\n";
+    foreach( const QString &stage, stages() ) {
+        result += QString( "%1\t%2\t%3\t%4\t%5\n" ).arg( stage ).arg( mean( stage ) )
+                  .arg( percentile( stage, 0.5 ) ).arg( percentile( stage, 0.9 ) )
+                  .arg( percentile( stage, 0.99 ) );
+    }
+
+    result += "counter\tmean\ttotal\n";
+    foreach( const QString &counter, counters() ) {
+        result += QString( "%1\t%2\t%3\n" ).arg( counter ).arg( counterMean( counter ) )
+                  .arg( counterTotal( counter ) );
+    }
+
+    result += "latency\tmean\tp50\tp90\tp99\n";
+    foreach( const QString &event, latencies() ) {
+        result += QString( "%1\t%2\t%3\t%4\t%5\n" ).arg( event ).arg( latencyMean( event ) )
+                  .arg( latencyPercentile( event, 0.5 ) ).arg( latencyPercentile( event, 0.9 ) )
+                  .arg( latencyPercentile( event, 0.99 ) );
+    }
+
+    return result;
+}
+
+RenderStatisticsTimer::RenderStatisticsTimer( RenderStatistics *statistics, const QString &stage )
+    : m_statistics( statistics && statistics->isEnabled() ? statistics : 0 ),
+      m_stage( m_statistics ? stage : QString() )
+{
+    if ( m_statistics ) {
+        m_timer.start();
+    }
+}
+
+RenderStatisticsTimer::RenderStatisticsTimer( RenderStatistics *statistics, const char *stage )
+    : m_statistics( statistics && statistics->isEnabled() ? statistics : 0 ),
+      m_stage( m_statistics ? QString::fromLatin1( stage ) : QString() )
+{
+    if ( m_statistics ) {
+        m_timer.start();
+    }
+}
+
+RenderStatisticsTimer::~RenderStatisticsTimer()
+{
+    if ( m_statistics ) {
+#if QT_VERSION >= 0x040800
+        m_statistics->addTime( m_stage, m_timer.nsecsElapsed() / 1000000.0 );
+#else
+        m_statistics->addTime( m_stage, m_timer.elapsed() );
+#endif
+    }
+}
+
+}
+
+#include "RenderStatistics.moc"
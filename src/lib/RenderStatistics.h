@@ -0,0 +1,171 @@
+//
+// This file is part of the Marble Virtual Globe.
+//
+// This program is free software licensed under the GNU LGPL. You can
+// find a copy of this license in LICENSE.txt in the top directory of
+// the source code.
+//
+// Copyright 2026      agent <agent@local>
+//
+
+#ifndef MARBLE_RENDERSTATISTICS_H
+#define MARBLE_RENDERSTATISTICS_H
+
+#include <QtCore/QObject>
+#include <QtCore/QStringList>
+#include <QtCore/QTime>
+
+#if QT_VERSION >= 0x040800
+#include <QtCore/QElapsedTimer>
+#endif
+
+#include "marble_export.h"
+
+namespace Marble
+{
+
+class RenderStatisticsPrivate;
+
+/**
+ * @short Collects timings and counters of the render pipeline per frame.
+ *
+ * Stages (e.g. a layer or a step of the texture pipeline) report the time
+ * they needed with addTime(), and events like loaded tiles are counted with
+ * addCount(). Both are summed up per frame until finishFrame() is called.
+ * Latencies of events like position updates are recorded with addLatency().
+ * The per frame values of the last windowSize() frames are kept to provide
+ * the mean and percentiles of each stage and counter, and likewise for the
+ * last windowSize() latencies of each event.
+ *
+ * Collecting is disabled by default and all methods are thread safe. The
+ * object is exported on D-Bus as /MarbleMap/RenderStatistics.
+ */
+class MARBLE_EXPORT RenderStatistics : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY( bool enabled READ isEnabled WRITE setEnabled )
+    Q_PROPERTY( int windowSize READ windowSize WRITE setWindowSize )
+
+ public:
+    explicit RenderStatistics( QObject *parent = 0 );
+    ~RenderStatistics();
+
+    bool isEnabled() const;
+
+    int windowSize() const;
+
+    /**
+     * @brief Adds @p milliseconds to the time spent in @p stage in the current frame
+     */
+    void addTime( const QString &stage, qreal milliseconds );
+
+    /**
+     * @brief Adds @p count to the counter named @p counter in the current frame
+     */
+    void addCount( const QString &counter, int count = 1 );
+
+    /**
+     * @brief Records a single latency of @p milliseconds of the event @p event
+     *
+     * Unlike times and counters, latencies are not summed up per frame but
+     * kept for each occurrence.
+     */
+    void addLatency( const QString &event, qreal milliseconds );
+
+    /**
+     * @brief Closes the current frame, which took @p milliseconds in total
+     */
+    void finishFrame( qreal milliseconds );
+
+ public Q_SLOTS:
+    void setEnabled( bool enabled );
+
+    void setWindowSize( int frames );
+
+    /**
+     * @brief Forgets all frames recorded so far
+     */
+    void reset();
+
+    /**
+     * @brief The stages recorded so far. "frame" is the time of the whole frame.
+     */
+    QStringList stages() const;
+
+    QStringList counters() const;
+
+    /**
+     * @brief Mean time per frame in milliseconds spent in @p stage
+     */
+    qreal mean( const QString &stage ) const;
+
+    /**
+     * @brief The @p p quantile (0.0 to 1.0) of the per frame times of @p stage
+     */
+    qreal percentile( const QString &stage, qreal p ) const;
+
+    /**
+     * @brief Mean value per frame of @p counter
+     */
+    qreal counterMean( const QString &counter ) const;
+
+    /**
+     * @brief Sum of @p counter over all frames since the last reset
+     */
+    qlonglong counterTotal( const QString &counter ) const;
+
+    QStringList latencies() const;
+
+    /**
+     * @brief Mean of the last windowSize() latencies of @p event in milliseconds
+     */
+    qreal latencyMean( const QString &event ) const;
+
+    /**
+     * @brief The @p p quantile (0.0 to 1.0) of the last windowSize() latencies of @p event
+     */
+    qreal latencyPercentile( const QString &event, qreal p ) const;
+
+    /**
+     * @brief All stages, counters and latencies as tab separated values, one per line
+     */
+    QString report() const;
+
+ private:
+    Q_DISABLE_COPY( RenderStatistics )
+
+    RenderStatisticsPrivate *const d;
+};
+
+/**
+ * @short Adds the time until it goes out of scope to a stage of RenderStatistics.
+ *
+ * Does nothing if the statistics are null or disabled.
+ */
+class MARBLE_EXPORT RenderStatisticsTimer
+{
+ public:
+    RenderStatisticsTimer( RenderStatistics *statistics, const QString &stage );
+
+    /**
+     * Takes the stage name as a Latin-1 literal which is only converted to a
+     * QString if the statistics are enabled, to keep hot paths cheap otherwise.
+     */
+    RenderStatisticsTimer( RenderStatistics *statistics, const char *stage );
+    ~RenderStatisticsTimer();
+
+ private:
+    Q_DISABLE_COPY( RenderStatisticsTimer )
+
+    RenderStatistics *const m_statistics;
+    const QString m_stage;
+#if QT_VERSION >= 0x040800
+    QElapsedTimer m_timer;
+#else
+    QTime m_timer;
+#endif
+};
+
+}
+
+#endif
@@ -14,15 +14,44 @@
 #include "MarbleDebug.h"
 #include "routing/RouteRequest.h"
 
+#include <QtCore/QMutex>
+#include <QtCore/QSet>
 #include <QtCore/QTimer>
 
 namespace Marble
 {
 
+/** Tasks that were not deleted yet. Tasks are deleted by the thread pool at any time after run(). */
+static QMutex s_taskMutex;
+static QSet<RunnerTask*> s_tasks;
+
 RunnerTask::RunnerTask( MarbleAbstractRunner* runner ) :
-        m_runner( runner )
+        m_runner( runner ),
+        m_localEventLoop( 0 ),
+        m_cancelled( false )
 {
-    // nothing to do
+    QMutexLocker locker( &s_taskMutex );
+    s_tasks.insert( this );
+}
+
+RunnerTask::~RunnerTask()
+{
+    QMutexLocker locker( &s_taskMutex );
+    s_tasks.remove( this );
+}
+
+void RunnerTask::cancel( RunnerTask* task )
+{
+    QMutexLocker locker( &s_taskMutex );
+    if ( !s_tasks.contains( task ) ) {
+        return;
+    }
+
+    task->m_cancelled = true;
+    if ( task->m_localEventLoop ) {
+        // The event loop lives in the thread of the task
+        QMetaObject::invokeMethod( task->m_localEventLoop, "quit", Qt::QueuedConnection );
+    }
 }
 
 void RunnerTask::run()
@@ -30,13 +59,34 @@ void RunnerTask::run()
     QTimer watchdog;
     watchdog.setSingleShot( true );
     QEventLoop localEventLoop;
+
+    s_taskMutex.lock();
+    const bool cancelled = m_cancelled;
+    if ( !cancelled ) {
+        m_localEventLoop = &localEventLoop;
+    }
+    s_taskMutex.unlock();
+
+    if ( cancelled ) {
+        // Cancelled while waiting in the thread pool
+        runner()->deleteLater();
+        emit finished( this );
+        return;
+    }
+
     QObject::connect( &watchdog, SIGNAL( timeout() ), &localEventLoop, SLOT( quit() ) );
     runTask( &localEventLoop );
     watchdog.start( 30 * 1000 );
     QObject::connect( QCoreApplication::instance(), SIGNAL( aboutToQuit() ), &localEventLoop, SLOT( quit() ) );
     localEventLoop.exec();
 
-    if( watchdog.isActive() ) {
+    s_taskMutex.lock();
+    m_localEventLoop = 0;
+    s_taskMutex.unlock();
+
+    if ( m_cancelled ) {
+        mDebug() << "Task was cancelled. Killing the runner.";
+    } else if( watchdog.isActive() ) {
         watchdog.stop(); // completed within timeout
     } else {
         mDebug() << "Timeout reached while waiting for result. Killing the runner.";
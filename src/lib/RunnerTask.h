@@ -17,6 +17,8 @@
 #include <QtCore/QRunnable>
 #include <QtCore/QString>
 
+class QEventLoop;
+
 namespace Marble
 {
 
@@ -36,9 +38,18 @@ public:
     /** Constructor. The runner instance given will be used to execute the actual task */
     explicit RunnerTask( MarbleAbstractRunner* runner );
 
+    ~RunnerTask();
+
     /** Overriding QRunnable to execute the runner task in a local event loop */
     virtual void run();
 
+    /**
+      * Stops waiting for the result of the task's runner. The task finishes soon
+      * afterwards, or right away if it was not started yet. It is safe to call
+      * this for tasks that already finished and were deleted by the thread pool.
+      */
+    static void cancel( RunnerTask* task );
+
 Q_SIGNALS:
     void finished( RunnerTask* task );
 
@@ -51,6 +62,11 @@ protected:
 
 private:
     MarbleAbstractRunner* m_runner;
+
+    /** The event loop waiting for the runner, if running. Guarded by a global mutex. */
+    QEventLoop* m_localEventLoop;
+
+    bool m_cancelled;
 };
 
 /** A RunnerTask that executes a placemark search */
@@ -44,8 +44,9 @@ ScanlineTextureMapperContext::ScanlineTextureMapperContext( StackedTileLoader *
 {
 }
 
+template<typename T>
 void ScanlineTextureMapperContext::pixelValueF( const qreal lon, const qreal lat,
-                                                QRgb* const scanLine )
+                                                T* const scanLine )
 {
     // The same method using integers performs about 33% faster.
     // However we need the qreal version to create the high quality mode.
@@ -80,8 +81,9 @@ void ScanlineTextureMapperContext::pixelValueF( const qreal lon, const qreal lat
     m_prevLat = lat; // preparing for interpolation
 }
 
+template<typename T>
 void ScanlineTextureMapperContext::pixelValue( const qreal lon, const qreal lat,
-                                               QRgb* const scanLine )
+                                               T* const scanLine )
 {
     // The same method using integers performs about 33% faster.
     // However we need the qreal version to create the high quality mode.
@@ -127,8 +129,9 @@ void ScanlineTextureMapperContext::pixelValue( const qreal lon, const qreal lat,
 // This method will do by far most of the calculations for the 
 // texturemapping, so we move towards integer math to improve speed.
 
+template<typename T>
 void ScanlineTextureMapperContext::pixelValueApproxF( const qreal lon, const qreal lat,
-                                                      QRgb *scanLine, const int n )
+                                                      T *scanLine, const int n )
 {
     // stepLon/Lat: Distance between two subsequent approximated positions
 
@@ -161,7 +164,7 @@ void ScanlineTextureMapperContext::pixelValueApproxF( const qreal lon, const qre
         // int oldG = 0;
         // int oldB = 0;
 
-        QRgb oldRgb = qRgb( 0, 0, 0 );
+        T oldRgb = static_cast<T>( qRgb( 0, 0, 0 ) );
 
         qreal oldPosX = -1;
         qreal oldPosY = 0;
@@ -273,8 +276,9 @@ bool ScanlineTextureMapperContext::isOutOfTileRangeF( const qreal itLon, const q
 }
 
 
+template<typename T>
 void ScanlineTextureMapperContext::pixelValueApprox( const qreal lon, const qreal lat,
-                                                     QRgb *scanLine, const int n )
+                                                     T *scanLine, const int n )
 {
     // stepLon/Lat: Distance between two subsequent approximated positions
 
@@ -438,6 +442,16 @@ QImage::Format ScanlineTextureMapperContext::optimalCanvasImageFormat( const Vie
 }
 
 
+QImage::Format ScanlineTextureMapperContext::optimalCanvasImageFormat( const ViewportParams *viewport, bool colorized )
+{
+    if ( colorized ) {
+        return QImage::Format_Indexed8;
+    }
+
+    return optimalCanvasImageFormat( viewport );
+}
+
+
 void ScanlineTextureMapperContext::nextTile( int &posX, int &posY )
 {
     // Move from tile coordinates to global texture coordinates 
@@ -521,3 +535,15 @@ void ScanlineTextureMapperContext::nextTile( qreal &posX, qreal &posY )
     m_toTileCoordinatesLat = (qreal)(0.5 * m_globalHeight - m_tilePosY);
     posY = lat - m_tilePosY;
 }
+
+
+// The texture mappers render to 32 bit and to 8 bit canvas images
+template void ScanlineTextureMapperContext::pixelValueF<QRgb>( const qreal, const qreal, QRgb* const );
+template void ScanlineTextureMapperContext::pixelValue<QRgb>( const qreal, const qreal, QRgb* const );
+template void ScanlineTextureMapperContext::pixelValueApproxF<QRgb>( const qreal, const qreal, QRgb*, const int );
+template void ScanlineTextureMapperContext::pixelValueApprox<QRgb>( const qreal, const qreal, QRgb*, const int );
+
+template void ScanlineTextureMapperContext::pixelValueF<uchar>( const qreal, const qreal, uchar* const );
+template void ScanlineTextureMapperContext::pixelValue<uchar>( const qreal, const qreal, uchar* const );
+template void ScanlineTextureMapperContext::pixelValueApproxF<uchar>( const qreal, const qreal, uchar*, const int );
+template void ScanlineTextureMapperContext::pixelValueApprox<uchar>( const qreal, const qreal, uchar*, const int );
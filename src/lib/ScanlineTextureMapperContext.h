@@ -32,20 +32,33 @@ class ScanlineTextureMapperContext
 public:
     ScanlineTextureMapperContext( StackedTileLoader * const tileLoader, int tileLevel );
 
+    // The pixel value methods write to 32 bit canvas images (QRgb) as well as
+    // to 8 bit ones (uchar). The latter receive the gray value of grayscale
+    // tiles, which is the blue channel of colored ones.
+    template<typename T>
     void pixelValueF( const qreal lon, const qreal lat,
-                      QRgb* const scanLine );
+                      T* const scanLine );
+    template<typename T>
     void pixelValue( const qreal lon, const qreal lat,
-                     QRgb* const scanLine );
+                     T* const scanLine );
 
+    template<typename T>
     void pixelValueApproxF( const qreal lon, const qreal lat,
-                            QRgb *scanLine, const int n );
+                            T *scanLine, const int n );
+    template<typename T>
     void pixelValueApprox( const qreal lon, const qreal lat,
-                           QRgb *scanLine, const int n );
+                           T *scanLine, const int n );
 
     static int interpolationStep( const ViewportParams *viewport, MapQuality mapQuality );
 
     static QImage::Format optimalCanvasImageFormat( const ViewportParams *viewport );
 
+    /**
+     * The format of the canvas image the texture is mapped to. Maps which get
+     * colorized afterwards only need the gray value, so they use 8 bit images.
+     */
+    static QImage::Format optimalCanvasImageFormat( const ViewportParams *viewport, bool colorized );
+
     int globalWidth() const;
     int globalHeight() const;
 
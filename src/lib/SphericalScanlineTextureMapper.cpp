@@ -37,6 +37,9 @@ public:
     virtual void run();
 
 private:
+    template<typename T>
+    void render();
+
     StackedTileLoader *const m_tileLoader;
     const int m_tileLevel;
     QImage *const m_canvasImage;
@@ -76,9 +79,9 @@ void SphericalScanlineTextureMapper::mapTexture( GeoPainter *painter,
                                                  const QRect &dirtyRect,
                                                  TextureColorizer *texColorizer )
 {
-    if ( m_canvasImage.size() != viewport->size() || m_radius != viewport->radius() ) {
-        const QImage::Format optimalFormat = ScanlineTextureMapperContext::optimalCanvasImageFormat( viewport );
+    const QImage::Format optimalFormat = ScanlineTextureMapperContext::optimalCanvasImageFormat( viewport, texColorizer != 0 );
 
+    if ( m_canvasImage.size() != viewport->size() || m_canvasImage.format() != optimalFormat || m_radius != viewport->radius() ) {
         if ( m_canvasImage.size() != viewport->size() || m_canvasImage.format() != optimalFormat ) {
             m_canvasImage = QImage( viewport->size(), optimalFormat );
         }
@@ -87,6 +90,20 @@ void SphericalScanlineTextureMapper::mapTexture( GeoPainter *painter,
             m_canvasImage.fill( 0 );
         }
 
+        if ( texColorizer ) {
+            const QImage::Format colorizedFormat = ScanlineTextureMapperContext::optimalCanvasImageFormat( viewport );
+            if ( m_colorizedImage.size() != viewport->size() || m_colorizedImage.format() != colorizedFormat ) {
+                m_colorizedImage = QImage( viewport->size(), colorizedFormat );
+            }
+
+            if ( !viewport->mapCoversViewport() ) {
+                m_colorizedImage.fill( 0 );
+            }
+        }
+        else {
+            m_colorizedImage = QImage();
+        }
+
         m_radius = viewport->radius();
         m_repaintNeeded = true;
     }
@@ -95,7 +112,7 @@ void SphericalScanlineTextureMapper::mapTexture( GeoPainter *painter,
         mapTexture( viewport, painter->mapQuality() );
 
         if ( texColorizer ) {
-            texColorizer->colorize( &m_canvasImage, viewport, painter->mapQuality() );
+            texColorizer->colorize( &m_canvasImage, &m_colorizedImage, viewport, painter->mapQuality() );
         }
 
         m_repaintNeeded = false;
@@ -106,7 +123,7 @@ void SphericalScanlineTextureMapper::mapTexture( GeoPainter *painter,
     QRect rect( viewport->width() / 2 - radius, viewport->height() / 2 - radius,
                 2 * radius, 2 * radius);
     rect = rect.intersect( dirtyRect );
-    painter->drawImage( rect, m_canvasImage, rect );
+    painter->drawImage( rect, texColorizer ? m_colorizedImage : m_canvasImage, rect );
 }
 
 void SphericalScanlineTextureMapper::setRepaintNeeded()
@@ -147,6 +164,17 @@ void SphericalScanlineTextureMapper::mapTexture( const ViewportParams *viewport,
 }
 
 void SphericalScanlineTextureMapper::RenderJob::run()
+{
+    if ( m_canvasImage->depth() == 8 ) {
+        render<uchar>();
+    }
+    else {
+        render<QRgb>();
+    }
+}
+
+template<typename T>
+void SphericalScanlineTextureMapper::RenderJob::render()
 {
     const int imageHeight = m_canvasImage->height();
     const int imageWidth  = m_canvasImage->width();
@@ -209,7 +237,7 @@ void SphericalScanlineTextureMapper::RenderJob::run()
         const int xRight = ( ( imageWidth / 2 - rx > 0 )
                              ? xLeft + rx + rx : imageWidth );
 
-        QRgb * scanLine = (QRgb*)( m_canvasImage->scanLine( y ) ) + xLeft;
+        T * scanLine = (T*)( m_canvasImage->scanLine( y ) ) + xLeft;
 
         const int xIpLeft  = ( imageWidth / 2 - rx > 0 ) ? n * (int)( xLeft / n + 1 )
                                                          : 1;
@@ -298,7 +326,7 @@ void SphericalScanlineTextureMapper::RenderJob::run()
         // copy scanline to improve performance
         if ( interlaced && y + 1 < m_yBottom ) { 
 
-            const int pixelByteSize = m_canvasImage->bytesPerLine() / imageWidth;
+            const int pixelByteSize = sizeof( T );
 
             memcpy( m_canvasImage->scanLine( y + 1 ) + xLeft * pixelByteSize, 
                     m_canvasImage->scanLine( y ) + xLeft * pixelByteSize, 
@@ -57,6 +57,8 @@ class SphericalScanlineTextureMapper : public TextureMapperInterface
     bool m_repaintNeeded;
     int m_radius;
     QImage m_canvasImage;
+    /// The colored map if the canvas image holds the gray values to be colorized
+    QImage m_colorizedImage;
     QThreadPool m_threadPool;
 };
 
@@ -215,8 +215,13 @@ int StackedTilePrivate::calcByteCount( const QImage &resultImage, const QVector<
 
     QVector<QSharedPointer<TextureTile> >::const_iterator pos = tiles.constBegin();
     QVector<QSharedPointer<TextureTile> >::const_iterator const end = tiles.constEnd();
-    for (; pos != end; ++pos )
+    for (; pos != end; ++pos ) {
+        // The result image may share its data with a single layer
+        if ( (*pos)->image()->cacheKey() == resultImage.cacheKey() ) {
+            byteCount -= resultImage.numBytes();
+        }
         byteCount += (*pos)->byteCount();
+    }
 
     return byteCount;
 }
@@ -27,22 +27,40 @@
 #include "GeoSceneTexture.h"
 #include "MarbleDebug.h"
 #include "MergedLayerDecorator.h"
+#include "RenderStatistics.h"
 #include "StackedTile.h"
 #include "TextureTile.h"
 #include "TileLoader.h"
 #include "TileLoaderHelper.h"
 #include "global.h"
 
-#include <QtCore/QCache>
+#include <cmath>
+
 #include <QtCore/QDateTime>
 #include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QMultiMap>
 #include <QtCore/QReadWriteLock>
+#include <QtCore/QTime>
 #include <QtGui/QImage>
 
 
 namespace Marble
 {
 
+// Eviction distance of tiles one level away from the view, in tiles
+const qreal LEVEL_DISTANCE_WEIGHT = 4.0;
+
+// How long (in milliseconds) prefetched tiles are kept regardless of their
+// distance from the view, and which part of the cache they may take up
+const int PREFETCH_PROTECTION_TIME = 10000;
+const int PREFETCH_PROTECTION_SHARE = 2;
+
+// How long (in milliseconds) a tile queued for download by prefetchTile() is
+// considered pending, and how many tiles may be pending at the same time
+const int PREFETCH_PENDING_TIME = 60000;
+const int PREFETCH_MAX_PENDING = 64;
+
 class StackedTileLoaderPrivate
 {
 public:
@@ -51,14 +69,40 @@ public:
         : m_tileLoader( tileLoader ),
           m_blendingFactory( sunLocator ),
           m_layerDecorator( m_tileLoader, sunLocator ),
-          m_maxTileLevel( 0 )
+          m_maxTileLevel( 0 ),
+          m_cacheLimit( 20000 * 1024 ), // Cache size measured in bytes
+          m_decodedBytes( 0 ),
+          m_compressedBytes( 0 ),
+          m_viewLevel( 0 ),
+          m_viewX( 0.0 ),
+          m_viewY( 0.0 ),
+          m_evictionOrderValid( false ),
+          m_prefetchedBytes( 0 ),
+          m_statistics( 0 )
     {
-        m_tileCache.setMaxCost( 20000 * 1024 ); // Cache size measured in bytes
+        m_prefetchClock.start();
     }
 
     void detectMaxTileLevel();
     QVector<GeoSceneTexture const *>
         findRelevantTextureLayers( TileId const & stackedTileId ) const;
+    StackedTile *createTile( TileId const & stackedTileId, DownloadUsage usage );
+
+    void insertDecoded( StackedTile *stackedTile );
+    StackedTile *takeDecoded( TileId const & stackedTileId );
+    void insertCompressed( TileId const & stackedTileId, QVector<QByteArray> const & layers );
+    void removeCompressed( TileId const & stackedTileId );
+    void clearCache();
+
+    void updateViewCenter();
+    qreal evictionDistance( TileId const & stackedTileId ) const;
+    void invalidateEvictionOrder();
+    void protectPrefetched( StackedTile const *stackedTile );
+    void unprotectPrefetched( TileId const & stackedTileId );
+    void expirePrefetched();
+    void trimCache();
+    void cancelPrefetch( TileId const & stackedTileId );
+    void expirePrefetchPending();
 
     TileLoader *const m_tileLoader;
     BlendingFactory m_blendingFactory;
@@ -66,8 +110,43 @@ public:
     int         m_maxTileLevel;
     QVector<GeoSceneTexture const *> m_textureLayers;
     QHash <TileId, StackedTile*>  m_tilesOnDisplay;
-    QCache <TileId, StackedTile>  m_tileCache;
+
+    // Tiles whose missing layers were queued for download by prefetchTile(),
+    // with the time they were queued. Downloads which fail or take longer than
+    // PREFETCH_PENDING_TIME are given up by expirePrefetchPending().
+    QHash <TileId, int>  m_prefetchPending;
+
+    // The tile cache has two tiers that share the budget m_cacheLimit: Decoded
+    // tiles which are not displayed anymore, ready to be displayed again, and
+    // the encoded file contents of the layers of recently loaded tiles, which
+    // save the disk access when a tile is needed again. A tile may be in both.
+    quint64 m_cacheLimit;
+    QHash <TileId, StackedTile*>  m_decodedCache;
+    quint64 m_decodedBytes;
+    QHash <TileId, QVector<QByteArray> >  m_compressedCache;
+    quint64 m_compressedBytes;
+
+    // The tile level and center of the current view in tiles of that level
+    int m_viewLevel;
+    qreal m_viewX;
+    qreal m_viewY;
+
+    // Cached tiles ordered by their eviction distance from the current view,
+    // rebuilt lazily by trimCache() after the view center moved
+    QMultiMap<qreal, TileId> m_decodedOrder;
+    QMultiMap<qreal, TileId> m_compressedOrder;
+    bool m_evictionOrderValid;
+
+    // Decoded tiles from prefetchTile() with the time they were prefetched.
+    // They are far from the current view by intention (e.g. the target of
+    // flyTo()), so trimCache() keeps them until they get displayed or
+    // PREFETCH_PROTECTION_TIME passed.
+    QHash <TileId, int>  m_prefetched;
+    quint64 m_prefetchedBytes;
+    QTime m_prefetchClock;
+
     QReadWriteLock m_cacheLock;
+    RenderStatistics *m_statistics;
 };
 
 StackedTileLoader::StackedTileLoader( TileLoader *tileLoader,
@@ -79,6 +158,7 @@ StackedTileLoader::StackedTileLoader( TileLoader *tileLoader,
 StackedTileLoader::~StackedTileLoader()
 {
     qDeleteAll( d->m_tilesOnDisplay );
+    qDeleteAll( d->m_decodedCache );
     delete d;
 }
 
@@ -125,6 +205,11 @@ void StackedTileLoader::setShowTileId( bool show )
     d->m_layerDecorator.setShowTileId( show );
 }
 
+void StackedTileLoader::setRenderStatistics( RenderStatistics *statistics )
+{
+    d->m_statistics = statistics;
+}
+
 int StackedTileLoader::tileColumnCount( int level ) const
 {
     Q_ASSERT( !d->m_textureLayers.isEmpty() );
@@ -175,13 +260,13 @@ void StackedTileLoader::cleanupTilehash()
     while ( it.hasNext() ) {
         it.next();
         if ( !it.value()->used() ) {
-            // If insert call result is false then the cache is too small to store the tile
-            // but the item will get deleted nevertheless and the pointer we have
-            // doesn't get set to zero (so don't delete it in this case or it will crash!)
-            d->m_tileCache.insert( it.key(), it.value(), it.value()->numBytes() );
+            d->insertDecoded( it.value() );
             d->m_tilesOnDisplay.remove( it.key() );
         }
     }
+
+    d->updateViewCenter();
+    d->trimCache();
 }
 
 const StackedTile* StackedTileLoader::loadTile( TileId const & stackedTileId )
@@ -209,8 +294,11 @@ const StackedTile* StackedTileLoader::loadTile( TileId const & stackedTileId )
     mDebug() << "StackedTileLoader::loadTile" << stackedTileId.toString();
 
     // the tile was not in the hash so check if it is in the cache
-    stackedTile = d->m_tileCache.take( stackedTileId );
+    stackedTile = d->takeDecoded( stackedTileId );
     if ( stackedTile ) {
+        if ( d->m_statistics && d->m_statistics->isEnabled() ) {
+            d->m_statistics->addCount( "tiles/cacheHits" );
+        }
         stackedTile->setUsed( true );
         d->m_tilesOnDisplay[ stackedTileId ] = stackedTile;
         d->m_cacheLock.unlock();
@@ -222,28 +310,10 @@ const StackedTile* StackedTileLoader::loadTile( TileId const & stackedTileId )
 
     // mDebug() << "load Tile from Disk: " << stackedTileId.toString();
 
-    QVector<QSharedPointer<TextureTile> > tiles;
-    QVector<GeoSceneTexture const *> const textureLayers = d->findRelevantTextureLayers( stackedTileId );
-    QVector<GeoSceneTexture const *>::const_iterator pos = textureLayers.constBegin();
-    QVector<GeoSceneTexture const *>::const_iterator const end = textureLayers.constEnd();
-    for (; pos != end; ++pos ) {
-        GeoSceneTexture const * const textureLayer = *pos;
-        TileId const tileId( textureLayer->sourceDir(), stackedTileId.zoomLevel(),
-                             stackedTileId.x(), stackedTileId.y() );
-        mDebug() << "StackedTileLoader::loadTile: tile" << textureLayer->sourceDir()
-                 << tileId.toString() << textureLayer->tileSize();
-        const QImage tileImage = d->m_tileLoader->loadTile( tileId, DownloadBrowse );
-        const Blending *blending = d->m_blendingFactory.findBlending( textureLayer->blending() );
-        if ( blending == 0 && !textureLayer->blending().isEmpty() ) {
-            mDebug() << Q_FUNC_INFO << "could not find blending" << textureLayer->blending();
-        }
-        QSharedPointer<TextureTile> tile( new TextureTile( tileId, tileImage, blending ) );
-        tiles.append( tile );
+    stackedTile = d->createTile( stackedTileId, DownloadBrowse );
+    if ( d->m_statistics && d->m_statistics->isEnabled() ) {
+        d->m_statistics->addCount( "tiles/loaded" );
     }
-    Q_ASSERT( !tiles.isEmpty() );
-
-    const QImage resultImage = d->m_layerDecorator.merge( stackedTileId, tiles );
-    stackedTile = new StackedTile( stackedTileId, resultImage, tiles );
     stackedTile->setUsed( true );
 
     d->m_tilesOnDisplay[ stackedTileId ] = stackedTile;
@@ -251,6 +321,70 @@ const StackedTile* StackedTileLoader::loadTile( TileId const & stackedTileId )
     return stackedTile;
 }
 
+StackedTileLoader::PrefetchResult StackedTileLoader::prefetchTile( TileId const & stackedTileId )
+{
+    d->m_cacheLock.lockForWrite();
+    d->expirePrefetchPending();
+    const bool inMemory = d->m_tilesOnDisplay.contains( stackedTileId )
+                          || d->m_decodedCache.contains( stackedTileId );
+    bool available = d->m_compressedCache.contains( stackedTileId );
+    const bool pending = d->m_prefetchPending.contains( stackedTileId );
+    d->m_cacheLock.unlock();
+    if ( inMemory ) {
+        return TileInMemory;
+    }
+    if ( pending ) {
+        return TilePending;
+    }
+
+    // Missing tiles are downloaded with low priority only. Decoding them now
+    // would just cache the scaled replacement tiles.
+    if ( !available ) {
+        available = true;
+        QVector<GeoSceneTexture const *> const textureLayers = d->findRelevantTextureLayers( stackedTileId );
+        QVector<GeoSceneTexture const *>::const_iterator pos = textureLayers.constBegin();
+        QVector<GeoSceneTexture const *>::const_iterator const end = textureLayers.constEnd();
+        for (; pos != end; ++pos ) {
+            GeoSceneTexture const * const textureLayer = *pos;
+            TileId const tileId( textureLayer->sourceDir(), stackedTileId.zoomLevel(),
+                                 stackedTileId.x(), stackedTileId.y() );
+            if ( !d->m_tileLoader->tileAvailable( tileId ) ) {
+                // Unlike downloadTile(), this reports the downloaded tile to updateTile()
+                d->m_tileLoader->reloadTile( tileId, DownloadBulk );
+                available = false;
+            }
+        }
+    }
+    if ( !available ) {
+        d->m_cacheLock.lockForWrite();
+        d->m_prefetchPending.insert( stackedTileId, d->m_prefetchClock.elapsed() );
+        d->m_cacheLock.unlock();
+        return TileDownloading;
+    }
+
+    d->m_cacheLock.lockForWrite();
+    if ( !d->m_tilesOnDisplay.contains( stackedTileId ) && !d->m_decodedCache.contains( stackedTileId ) ) {
+        StackedTile *const stackedTile = d->createTile( stackedTileId, DownloadBulk );
+        if ( d->m_statistics && d->m_statistics->isEnabled() ) {
+            d->m_statistics->addCount( "tiles/prefetched" );
+        }
+        d->insertDecoded( stackedTile );
+        d->protectPrefetched( stackedTile );
+        d->trimCache();
+    }
+    d->m_cacheLock.unlock();
+    return TileDecoded;
+}
+
+void StackedTileLoader::cancelPrefetch()
+{
+    d->m_cacheLock.lockForWrite();
+    foreach ( const TileId &stackedTileId, d->m_prefetchPending.keys() ) {
+        d->cancelPrefetch( stackedTileId );
+    }
+    d->m_cacheLock.unlock();
+}
+
 void StackedTileLoader::downloadTile( TileId const & stackedTileId )
 {
     QVector<GeoSceneTexture const *> const textureLayers = d->findRelevantTextureLayers( stackedTileId );
@@ -266,7 +400,7 @@ void StackedTileLoader::downloadTile( TileId const & stackedTileId )
 
 quint64 StackedTileLoader::volatileCacheLimit() const
 {
-    return d->m_tileCache.maxCost() / 1024;
+    return d->m_cacheLimit / 1024;
 }
 
 void StackedTileLoader::reloadVisibleTiles()
@@ -303,7 +437,8 @@ void StackedTileLoaderPrivate::detectMaxTileLevel()
 void StackedTileLoader::setVolatileCacheLimit( quint64 kiloBytes )
 {
     mDebug() << QString("Setting tile cache to %1 kilobytes.").arg( kiloBytes );
-    d->m_tileCache.setMaxCost( kiloBytes * 1024 );
+    d->m_cacheLimit = kiloBytes * 1024;
+    d->trimCache();
 }
 
 void StackedTileLoader::updateTile( TileId const &tileId, QImage const &tileImage )
@@ -314,9 +449,13 @@ void StackedTileLoader::updateTile( TileId const &tileId, QImage const &tileImag
 
     const TileId stackedTileId( 0, tileId.zoomLevel(), tileId.x(), tileId.y() );
 
+    // The encoded layers are outdated now
+    d->removeCompressed( stackedTileId );
+    d->m_prefetchPending.remove( stackedTileId );
+
     StackedTile * displayedTile = d->m_tilesOnDisplay.take( stackedTileId );
     if ( displayedTile ) {
-        Q_ASSERT( !d->m_tileCache.contains( stackedTileId ) );
+        Q_ASSERT( !d->m_decodedCache.contains( stackedTileId ) );
 
         QVector<QSharedPointer<TextureTile> > tiles = displayedTile->tiles();
         delete displayedTile;
@@ -335,7 +474,7 @@ void StackedTileLoader::updateTile( TileId const &tileId, QImage const &tileImag
 
         emit tileUpdateAvailable( stackedTileId );
     } else {
-        d->m_tileCache.remove( stackedTileId );
+        delete d->takeDecoded( stackedTileId );
     }
 }
 
@@ -344,7 +483,325 @@ void StackedTileLoader::clear()
     mDebug() << "StackedTileLoader::clear()";
     qDeleteAll( d->m_tilesOnDisplay );
     d->m_tilesOnDisplay.clear();
-    d->m_tileCache.clear(); // clear the tile cache in physical memory
+    d->m_prefetchPending.clear();
+    d->clearCache(); // clear the tile cache in physical memory
+}
+
+StackedTile *StackedTileLoaderPrivate::createTile( TileId const & stackedTileId, DownloadUsage usage )
+{
+    QVector<GeoSceneTexture const *> const textureLayers = findRelevantTextureLayers( stackedTileId );
+
+    // The encoded layers are only usable if the set of layers did not change
+    QVector<QByteArray> encodedLayers = m_compressedCache.value( stackedTileId );
+    const bool compressedHit = encodedLayers.size() == textureLayers.size();
+    if ( m_statistics && m_statistics->isEnabled() ) {
+        m_statistics->addCount( compressedHit ? "tiles/compressedCacheHits" : "tiles/cacheMisses" );
+    }
+    if ( !compressedHit ) {
+        encodedLayers.fill( QByteArray(), textureLayers.size() );
+    }
+
+    bool complete = true;
+    QVector<QSharedPointer<TextureTile> > tiles;
+    for ( int i = 0; i < textureLayers.size(); ++i ) {
+        GeoSceneTexture const * const textureLayer = textureLayers.at( i );
+        TileId const tileId( textureLayer->sourceDir(), stackedTileId.zoomLevel(),
+                             stackedTileId.x(), stackedTileId.y() );
+        mDebug() << "StackedTileLoader::loadTile: tile" << textureLayer->sourceDir()
+                 << tileId.toString() << textureLayer->tileSize();
+        QImage tileImage;
+        {
+            RenderStatisticsTimer timer( m_statistics, "texture/load" );
+            if ( compressedHit ) {
+                tileImage = QImage::fromData( encodedLayers.at( i ) );
+                m_tileLoader->updateExpiredTile( tileId, usage );
+            } else {
+                tileImage = m_tileLoader->loadTile( tileId, usage, &encodedLayers[i] );
+                complete &= !encodedLayers.at( i ).isEmpty();
+            }
+        }
+        const Blending *blending = m_blendingFactory.findBlending( textureLayer->blending() );
+        if ( blending == 0 && !textureLayer->blending().isEmpty() ) {
+            mDebug() << Q_FUNC_INFO << "could not find blending" << textureLayer->blending();
+        }
+        QSharedPointer<TextureTile> tile( new TextureTile( tileId, tileImage, blending ) );
+        tiles.append( tile );
+    }
+    Q_ASSERT( !tiles.isEmpty() );
+
+    // Scaled replacements are not worth keeping, they are updated on download
+    if ( !compressedHit && complete ) {
+        insertCompressed( stackedTileId, encodedLayers );
+    }
+
+    QImage resultImage;
+    {
+        RenderStatisticsTimer timer( m_statistics, "texture/merge" );
+        resultImage = m_layerDecorator.merge( stackedTileId, tiles );
+    }
+    if ( m_statistics && m_statistics->isEnabled() ) {
+        m_statistics->addCount( "tiles/decoded", tiles.size() );
+    }
+    return new StackedTile( stackedTileId, resultImage, tiles );
+}
+
+void StackedTileLoaderPrivate::insertDecoded( StackedTile *stackedTile )
+{
+    m_decodedCache.insert( stackedTile->id(), stackedTile );
+    m_decodedBytes += stackedTile->numBytes();
+    if ( m_evictionOrderValid ) {
+        m_decodedOrder.insert( evictionDistance( stackedTile->id() ) + 0.5, stackedTile->id() );
+    }
+}
+
+StackedTile *StackedTileLoaderPrivate::takeDecoded( TileId const & stackedTileId )
+{
+    unprotectPrefetched( stackedTileId );
+    StackedTile *const stackedTile = m_decodedCache.take( stackedTileId );
+    if ( stackedTile ) {
+        m_decodedBytes -= stackedTile->numBytes();
+        if ( m_evictionOrderValid ) {
+            m_decodedOrder.remove( evictionDistance( stackedTileId ) + 0.5, stackedTileId );
+        }
+    }
+    return stackedTile;
+}
+
+void StackedTileLoaderPrivate::insertCompressed( TileId const & stackedTileId, QVector<QByteArray> const & layers )
+{
+    removeCompressed( stackedTileId );
+    m_compressedCache.insert( stackedTileId, layers );
+    foreach ( const QByteArray &layer, layers ) {
+        m_compressedBytes += layer.size();
+    }
+    if ( m_evictionOrderValid ) {
+        m_compressedOrder.insert( evictionDistance( stackedTileId ), stackedTileId );
+    }
+}
+
+void StackedTileLoaderPrivate::removeCompressed( TileId const & stackedTileId )
+{
+    if ( !m_compressedCache.contains( stackedTileId ) ) {
+        return;
+    }
+
+    foreach ( const QByteArray &layer, m_compressedCache.take( stackedTileId ) ) {
+        m_compressedBytes -= layer.size();
+    }
+    if ( m_evictionOrderValid ) {
+        m_compressedOrder.remove( evictionDistance( stackedTileId ), stackedTileId );
+    }
+}
+
+void StackedTileLoaderPrivate::clearCache()
+{
+    qDeleteAll( m_decodedCache );
+    m_decodedCache.clear();
+    m_decodedBytes = 0;
+    m_compressedCache.clear();
+    m_compressedBytes = 0;
+    m_prefetched.clear();
+    m_prefetchedBytes = 0;
+    invalidateEvictionOrder();
+}
+
+void StackedTileLoaderPrivate::updateViewCenter()
+{
+    if ( m_tilesOnDisplay.isEmpty() ) {
+        return;
+    }
+
+    int level = 0;
+    foreach ( const TileId &id, m_tilesOnDisplay.keys() ) {
+        level = qMax( level, id.zoomLevel() );
+    }
+
+    qreal x = 0.0;
+    qreal y = 0.0;
+    foreach ( const TileId &id, m_tilesOnDisplay.keys() ) {
+        const qreal scale = ldexp( 1.0, level - id.zoomLevel() );
+        x += ( id.x() + 0.5 ) * scale;
+        y += ( id.y() + 0.5 ) * scale;
+    }
+
+    x /= m_tilesOnDisplay.size();
+    y /= m_tilesOnDisplay.size();
+    if ( level != m_viewLevel || x != m_viewX || y != m_viewY ) {
+        m_viewLevel = level;
+        m_viewX = x;
+        m_viewY = y;
+        invalidateEvictionOrder();
+    }
+}
+
+qreal StackedTileLoaderPrivate::evictionDistance( TileId const & stackedTileId ) const
+{
+    const int levelDistance = qAbs( stackedTileId.zoomLevel() - m_viewLevel );
+
+    // Distance of the tile center from the view center in tiles of the view level
+    const qreal scale = ldexp( 1.0, m_viewLevel - stackedTileId.zoomLevel() );
+    qreal dx = qAbs( ( stackedTileId.x() + 0.5 ) * scale - m_viewX );
+    const qreal dy = qAbs( ( stackedTileId.y() + 0.5 ) * scale - m_viewY );
+    if ( !m_textureLayers.isEmpty() ) {
+        // The map wraps around at the date line
+        const int columns = TileLoaderHelper::levelToColumn( m_textureLayers.at( 0 )->levelZeroColumns(),
+                                                             m_viewLevel );
+        dx = qMin( dx, qAbs( columns - dx ) );
+    }
+
+    return levelDistance * LEVEL_DISTANCE_WEIGHT + qMax( dx, dy );
+}
+
+void StackedTileLoaderPrivate::invalidateEvictionOrder()
+{
+    m_decodedOrder.clear();
+    m_compressedOrder.clear();
+    m_evictionOrderValid = false;
+}
+
+void StackedTileLoaderPrivate::protectPrefetched( StackedTile const *stackedTile )
+{
+    unprotectPrefetched( stackedTile->id() );
+    m_prefetched.insert( stackedTile->id(), m_prefetchClock.elapsed() );
+    m_prefetchedBytes += stackedTile->numBytes();
+}
+
+void StackedTileLoaderPrivate::unprotectPrefetched( TileId const & stackedTileId )
+{
+    if ( m_prefetched.remove( stackedTileId ) ) {
+        StackedTile const *const stackedTile = m_decodedCache.value( stackedTileId );
+        if ( stackedTile ) {
+            m_prefetchedBytes -= stackedTile->numBytes();
+        }
+    }
+}
+
+void StackedTileLoaderPrivate::expirePrefetched()
+{
+    const int now = m_prefetchClock.elapsed();
+    foreach ( const TileId &id, m_prefetched.keys() ) {
+        const int age = now - m_prefetched.value( id );
+        // A negative age means that the clock wrapped around after a day
+        if ( age < 0 || age > PREFETCH_PROTECTION_TIME ) {
+            unprotectPrefetched( id );
+        }
+    }
+
+    // Prefetching must not push out everything else, drop the oldest first
+    while ( m_prefetchedBytes > m_cacheLimit / PREFETCH_PROTECTION_SHARE ) {
+        QHash<TileId, int>::const_iterator oldest = m_prefetched.constBegin();
+        QHash<TileId, int>::const_iterator i = m_prefetched.constBegin();
+        for (; i != m_prefetched.constEnd(); ++i ) {
+            if ( i.value() < oldest.value() ) {
+                oldest = i;
+            }
+        }
+        unprotectPrefetched( oldest.key() );
+    }
+}
+
+void StackedTileLoaderPrivate::cancelPrefetch( TileId const & stackedTileId )
+{
+    m_prefetchPending.remove( stackedTileId );
+
+    // Displayed and cached tiles may wait for the same layers, leave their downloads alone
+    if ( m_tilesOnDisplay.contains( stackedTileId ) || m_decodedCache.contains( stackedTileId ) ) {
+        return;
+    }
+
+    QVector<GeoSceneTexture const *> const textureLayers = findRelevantTextureLayers( stackedTileId );
+    QVector<GeoSceneTexture const *>::const_iterator pos = textureLayers.constBegin();
+    QVector<GeoSceneTexture const *>::const_iterator const end = textureLayers.constEnd();
+    for (; pos != end; ++pos ) {
+        GeoSceneTexture const * const textureLayer = *pos;
+        TileId const tileId( textureLayer->sourceDir(), stackedTileId.zoomLevel(),
+                             stackedTileId.x(), stackedTileId.y() );
+        m_tileLoader->cancelDownload( tileId, DownloadBulk );
+    }
+}
+
+void StackedTileLoaderPrivate::expirePrefetchPending()
+{
+    // Failed downloads never reach updateTile(), give them up after a while so
+    // that they can be tried again. A negative age means that the clock wrapped.
+    const int now = m_prefetchClock.elapsed();
+    QList<TileId> expired;
+    QHash<TileId, int>::const_iterator i = m_prefetchPending.constBegin();
+    QHash<TileId, int>::const_iterator const end = m_prefetchPending.constEnd();
+    for (; i != end; ++i ) {
+        const int age = now - i.value();
+        if ( age < 0 || age > PREFETCH_PENDING_TIME ) {
+            expired.append( i.key() );
+        }
+    }
+    foreach ( const TileId &id, expired ) {
+        cancelPrefetch( id );
+    }
+
+    // Older prefetches are about views the animation has passed already, drop
+    // them so that the bulk queue does not grow without bounds
+    while ( m_prefetchPending.count() >= PREFETCH_MAX_PENDING ) {
+        QHash<TileId, int>::const_iterator oldest = m_prefetchPending.constBegin();
+        for ( i = m_prefetchPending.constBegin(); i != m_prefetchPending.constEnd(); ++i ) {
+            if ( i.value() < oldest.value() ) {
+                oldest = i;
+            }
+        }
+        const TileId oldestId = oldest.key();
+        cancelPrefetch( oldestId );
+    }
+}
+
+void StackedTileLoaderPrivate::trimCache()
+{
+    if ( m_decodedBytes + m_compressedBytes <= m_cacheLimit ) {
+        return;
+    }
+
+    expirePrefetched();
+
+    if ( !m_evictionOrderValid ) {
+        foreach ( const TileId &id, m_decodedCache.keys() ) {
+            m_decodedOrder.insert( evictionDistance( id ) + 0.5, id );
+        }
+        foreach ( const TileId &id, m_compressedCache.keys() ) {
+            m_compressedOrder.insert( evictionDistance( id ), id );
+        }
+        m_evictionOrderValid = true;
+    }
+
+    // Evict the tiles farthest from the current view first. A decoded tile goes
+    // before the encoded layers of the same tile, which take less memory and
+    // keep the tile available without disk access.
+    while ( m_decodedBytes + m_compressedBytes > m_cacheLimit ) {
+        // The encoded layers of displayed tiles are kept
+        QMultiMap<qreal, TileId>::const_iterator compressed = m_compressedOrder.constEnd();
+        bool hasCompressed = false;
+        while ( !hasCompressed && compressed != m_compressedOrder.constBegin() ) {
+            --compressed;
+            hasCompressed = !m_tilesOnDisplay.contains( compressed.value() );
+        }
+        // Recently prefetched tiles are kept, too
+        QMultiMap<qreal, TileId>::const_iterator decoded = m_decodedOrder.constEnd();
+        bool hasDecoded = false;
+        while ( !hasDecoded && decoded != m_decodedOrder.constBegin() ) {
+            --decoded;
+            hasDecoded = !m_prefetched.contains( decoded.value() );
+        }
+        if ( !hasDecoded && !hasCompressed ) {
+            break;
+        }
+
+        const bool evictDecoded = !hasCompressed
+                                  || ( hasDecoded && decoded.key() >= compressed.key() );
+        if ( evictDecoded ) {
+            const TileId id = decoded.value();
+            delete takeDecoded( id );
+        } else {
+            const TileId id = compressed.value();
+            removeCompressed( id );
+        }
+    }
 }
 
 // 
@@ -38,6 +38,7 @@ class QString;
 namespace Marble
 {
 
+class RenderStatistics;
 class StackedTile;
 class TileLoader;
 class SunLocator;
@@ -62,6 +63,13 @@ class StackedTileLoader : public QObject
     Q_OBJECT
 
     public:
+        enum PrefetchResult {
+            TileInMemory,    ///< The tile is displayed or cached already
+            TileDecoded,     ///< The tile was loaded from disk into the cache
+            TileDownloading, ///< Some of its layers are missing and were queued for download
+            TilePending      ///< Its missing layers were queued for download by an earlier call
+        };
+
         /**
          * Creates a new tile loader.
          *
@@ -82,6 +90,11 @@ class StackedTileLoader : public QObject
 
         void setShowTileId( bool show );
 
+        /**
+         * Sets the statistics that tile loading and merging is accounted to.
+         */
+        void setRenderStatistics( RenderStatistics *statistics );
+
         int tileColumnCount( int level ) const;
 
         int tileRowCount( int level ) const;
@@ -99,6 +112,23 @@ class StackedTileLoader : public QObject
         const StackedTile* loadTile( TileId const &stackedTileId );
         void downloadTile( TileId const & stackedTileId );
 
+        /**
+         * Prepares a tile that is likely to be displayed soon. If all its layers
+         * are available on disk, the tile is decoded into the tile cache where
+         * loadTile() finds it. Otherwise the missing layers are downloaded with
+         * low priority, using the bulk download queues. The tile is not checked
+         * again until one of its layers was downloaded, or the download was
+         * given up after a while. Only a limited number of tiles are pending,
+         * the oldest downloads are dropped in favor of new ones.
+         */
+        PrefetchResult prefetchTile( TileId const &stackedTileId );
+
+        /**
+         * Drops the downloads queued by prefetchTile() which have not been
+         * started yet, e.g. because the view is heading somewhere else now.
+         */
+        void cancelPrefetch();
+
         /**
          * Resets the internal tile hash.
          */
@@ -113,6 +143,10 @@ class StackedTileLoader : public QObject
 
         /**
          * @brief  Returns the limit of the volatile (in RAM) cache.
+         *
+         * The limit is shared by the decoded tiles which are not displayed
+         * anymore and the encoded image data of recently loaded tiles. Tiles
+         * far away from the current view are evicted first.
          * @return the cache limit in kilobytes
          */
         quint64 volatileCacheLimit() const;
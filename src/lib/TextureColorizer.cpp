@@ -24,6 +24,7 @@
 #include "global.h"
 #include "GeoPainter.h"
 #include "MarbleDebug.h"
+#include "RenderStatistics.h"
 #include "VectorComposer.h"
 #include "ViewParams.h"
 #include "ViewportParams.h"
@@ -68,6 +69,7 @@ TextureColorizer::TextureColorizer( const QString &seafile,
                                     QObject *parent )
     : QObject( parent )
     , m_veccomposer( veccomposer )
+    , m_statistics( 0 )
 {
     connect( m_veccomposer, SIGNAL( datasetLoaded() ), SIGNAL( datasetLoaded() ) );
 
@@ -157,21 +159,31 @@ void TextureColorizer::setShowRelief( bool show )
 //  - The coast image, which has a number of colors where each color
 //    represents a sort of terrain (ex: land/sea)
 //  - The canvas image, which has a gray scale image, often
-//    representing a height field.
+//    representing a height field. It has either 8 bit pixels or
+//    32 bit ones, where the gray value is stored in the first byte.
 //
 // It then uses the values of the pixels in the coast image to select
 // a color map.  The value of the pixel in the canvas image is used as
 // an index into the selected color map and the resulting color is
-// written back to the canvas image.  This way we can have different
-// color schemes for land and water.
+// written to the 32 bit target image, which may be the canvas image
+// itself.  This way we can have different color schemes for land and
+// water.
 //
 // In addition to this, a simple form of bump mapping is performed to
 // increase the illusion of height differences (see the variable
 // showRelief).
 // 
 
-void TextureColorizer::colorize( QImage *origimg, const ViewportParams *viewport, MapQuality mapQuality )
+void TextureColorizer::setRenderStatistics( RenderStatistics *statistics )
 {
+    m_statistics = statistics;
+}
+
+void TextureColorizer::colorize( const QImage *grayImage, QImage *targetImage,
+                                 const ViewportParams *viewport, MapQuality mapQuality )
+{
+    RenderStatisticsTimer timer( m_statistics, "texture/colorize" );
+
     if ( m_coastImage.size() != viewport->size() )
         m_coastImage = QImage( viewport->size(), QImage::Format_RGB32 );
 
@@ -202,8 +214,9 @@ void TextureColorizer::colorize( QImage *origimg, const ViewportParams *viewport
 
     const qint64   radius   = viewport->radius();
 
-    const int  imgheight = origimg->height();
-    const int  imgwidth  = origimg->width();
+    const int  imgheight = grayImage->height();
+    const int  imgwidth  = grayImage->width();
+    const int  grayStep  = grayImage->depth() / 8;
     const int  imgrx     = imgwidth / 2;
     const int  imgry     = imgheight / 2;
     // This variable is not used anywhere..
@@ -244,23 +257,34 @@ void TextureColorizer::colorize( QImage *origimg, const ViewportParams *viewport
 
         const int itEnd = yBottom;
 
+        // Unlike the canvas image, a separate target image is not cleared
+        // by the texture mapper outside of the map
+        if ( targetImage != grayImage ) {
+            for ( int y = 0; y < yTop; ++y ) {
+                memset( targetImage->scanLine( y ), 0, targetImage->bytesPerLine() );
+            }
+            for ( int y = itEnd; y < imgheight; ++y ) {
+                memset( targetImage->scanLine( y ), 0, targetImage->bytesPerLine() );
+            }
+        }
+
         for (int y = yTop; y < itEnd; ++y) {
 
-            QRgb  *writeData         = (QRgb*)( origimg->scanLine( y ) );
+            QRgb  *writeData         = (QRgb*)( targetImage->scanLine( y ) );
             const QRgb  *coastData   = (QRgb*)( m_coastImage.scanLine( y ) );
 
-            uchar *readDataStart     = origimg->scanLine( y );
-            const uchar *readDataEnd = readDataStart + imgwidth*4;
+            const uchar *readDataStart = grayImage->scanLine( y );
+            const uchar *readDataEnd   = readDataStart + imgwidth * grayStep;
 
             EmbossFifo  emboss;
 
-            for ( uchar* readData = readDataStart; 
+            for ( const uchar* readData = readDataStart;
                   readData < readDataEnd;
-                  readData += 4, ++writeData, ++coastData )
+                  readData += grayStep, ++writeData, ++coastData )
             {
 
                 // Cheap Emboss / Bumpmapping
-                uchar&  grey = *readData; // qBlue(*data);
+                const uchar grey = *readData; // qBlue(*data);
 
                 if ( m_showRelief ) {
                     emboss << grey;
@@ -336,20 +360,20 @@ void TextureColorizer::colorize( QImage *origimg, const ViewportParams *viewport
                 xRight = imgrx + rx;
             }
 
-            QRgb  *writeData         = (QRgb*)( origimg->scanLine( y ) )  + xLeft;
+            QRgb  *writeData         = (QRgb*)( targetImage->scanLine( y ) )  + xLeft;
             const QRgb *coastData    = (QRgb*)( m_coastImage.scanLine( y ) ) + xLeft;
 
-            uchar *readDataStart     = origimg->scanLine( y ) + xLeft * 4;
-            const uchar *readDataEnd = origimg->scanLine( y ) + xRight * 4;
+            const uchar *readDataStart = grayImage->scanLine( y ) + xLeft * grayStep;
+            const uchar *readDataEnd   = grayImage->scanLine( y ) + xRight * grayStep;
 
  
-            for ( uchar* readData = readDataStart;
+            for ( const uchar* readData = readDataStart;
                   readData < readDataEnd;
-                  readData += 4, ++writeData, ++coastData )
+                  readData += grayStep, ++writeData, ++coastData )
             {
                 // Cheap Emboss / Bumpmapping
 
-                uchar& grey = *readData; // qBlue(*data);
+                const uchar grey = *readData; // qBlue(*data);
 
                 if ( m_showRelief ) {
                     emboss << grey;
@@ -26,6 +26,7 @@
 namespace Marble
 {
 
+class RenderStatistics;
 class VectorComposer;
 class ViewportParams;
 
@@ -43,7 +44,14 @@ class TextureColorizer : public QObject
 
     void setShowRelief( bool show );
 
-    void colorize( QImage *origimg, const ViewportParams *viewport, MapQuality mapQuality );
+    void setRenderStatistics( RenderStatistics *statistics );
+
+    /**
+     * Colors the gray values of @p grayImage, which has 8 or 32 bit pixels,
+     * and writes the result to the 32 bit @p targetImage. Both may be the same.
+     */
+    void colorize( const QImage *grayImage, QImage *targetImage,
+                   const ViewportParams *viewport, MapQuality mapQuality );
 
  Q_SIGNALS:
     void datasetLoaded();
@@ -55,6 +63,7 @@ class TextureColorizer : public QObject
     QImage m_coastImage;
     uint texturepalette[16][512];
     bool m_showRelief;
+    RenderStatistics *m_statistics;
 };
 
 }
@@ -16,6 +16,7 @@
 #include "TileLoader.h"
 
 #include <QtCore/QDateTime>
+#include <QtCore/QFile>
 #include <QtCore/QFileInfo>
 #include <QtCore/QMetaType>
 #include <QtGui/QImage>
@@ -36,6 +37,8 @@ TileLoader::TileLoader( HttpDownloadManager * const downloadManager )
     qRegisterMetaType<DownloadUsage>( "DownloadUsage" );
     connect( this, SIGNAL( downloadTile( QUrl, QString, QString, DownloadUsage )),
              downloadManager, SLOT( addJob( QUrl, QString, QString, DownloadUsage )));
+    connect( this, SIGNAL( cancelDownload( QUrl, QString, DownloadUsage )),
+             downloadManager, SLOT( removeQueuedJob( QUrl, QString, DownloadUsage )));
     connect( downloadManager, SIGNAL( downloadComplete( QByteArray, QString )),
              SLOT( updateTile( QByteArray, QString )));
 }
@@ -52,11 +55,16 @@ void TileLoader::setTextureLayers( const QVector<const GeoSceneTexture *> &textu
 //     - if not expired: create TextureTile, set state to "uptodate", return it => done
 //     - if expired: create TextureTile, state is set to Expired by default, trigger dl,
 
-QImage TileLoader::loadTile( TileId const & tileId, DownloadUsage const usage )
+QImage TileLoader::loadTile( TileId const & tileId, DownloadUsage const usage, QByteArray *encodedData )
 {
     GeoSceneTexture const * const textureLayer = findTextureLayer( tileId );
     QString const fileName = tileFileName( textureLayer, tileId );
-    QImage const image( fileName );
+    QByteArray data;
+    QFile file( fileName );
+    if ( file.open( QIODevice::ReadOnly ) ) {
+        data = file.readAll();
+    }
+    QImage const image = QImage::fromData( data );
     if ( !image.isNull() ) {
         // file is there, so create and return a tile object in any case,
         // but check if an update should be triggered
@@ -73,6 +81,9 @@ QImage TileLoader::loadTile( TileId const & tileId, DownloadUsage const usage )
             triggerDownload( tileId, usage );
         }
 
+        if ( encodedData ) {
+            *encodedData = data;
+        }
         return image;
     }
 
@@ -84,6 +95,9 @@ QImage TileLoader::loadTile( TileId const & tileId, DownloadUsage const usage )
     m_waitingForUpdate.insert( tileId );
     triggerDownload( tileId, usage );
 
+    if ( encodedData ) {
+        encodedData->clear();
+    }
     return replacementTile;
 }
 
@@ -102,11 +116,42 @@ void TileLoader::reloadTile( TileId const &tileId, DownloadUsage const usage )
     triggerDownload( tileId, usage );
 }
 
+void TileLoader::cancelDownload( TileId const &tileId, DownloadUsage const usage )
+{
+    if ( !m_waitingForUpdate.remove( tileId ) )
+        return;
+
+    GeoSceneTexture const * const textureLayer = findTextureLayer( tileId );
+    QUrl const sourceUrl = textureLayer->downloadUrl( tileId );
+    QString const destFileName = textureLayer->relativeTileFileName( tileId );
+    emit cancelDownload( sourceUrl, destFileName, usage );
+}
+
+void TileLoader::updateExpiredTile( TileId const &tileId, DownloadUsage const usage )
+{
+    if ( m_waitingForUpdate.contains( tileId ) )
+        return;
+
+    GeoSceneTexture const * const textureLayer = findTextureLayer( tileId );
+    const QDateTime lastModified = QFileInfo( tileFileName( textureLayer, tileId ) ).lastModified();
+    const bool isExpired = lastModified.secsTo( QDateTime::currentDateTime() ) >= textureLayer->expire();
+    if ( isExpired ) {
+        mDebug() << "TileLoader::updateExpiredTile" << tileId.toString() << "StateExpired";
+        m_waitingForUpdate.insert( tileId );
+        triggerDownload( tileId, usage );
+    }
+}
+
 void TileLoader::downloadTile( TileId const & tileId )
 {
     triggerDownload( tileId, DownloadBulk );
 }
 
+bool TileLoader::tileAvailable( TileId const & tileId ) const
+{
+    return QFile::exists( tileFileName( findTextureLayer( tileId ), tileId ) );
+}
+
 int TileLoader::maximumTileLevel( GeoSceneTexture const & texture )
 {
     // if maximum tile level is configured in the DGML files,
@@ -43,10 +43,33 @@ class TileLoader: public QObject
 
     void setTextureLayers( const QVector<GeoSceneTexture const *> &textureLayers );
 
-    QImage loadTile( TileId const & tileId, DownloadUsage const );
+    /**
+     * Loads the tile from disk, or a scaled replacement if it is not available.
+     * If @p encodedData is given, it is set to the file content of the tile, or
+     * to an empty array if a replacement was returned.
+     */
+    QImage loadTile( TileId const & tileId, DownloadUsage const, QByteArray *encodedData = 0 );
     void reloadTile( TileId const &tileId, DownloadUsage const );
+
+    /**
+     * Triggers a download of the tile if the file on disk is expired. This
+     * keeps tiles up to date which are decoded from memory instead of loadTile().
+     */
+    void updateExpiredTile( TileId const &tileId, DownloadUsage const );
     void downloadTile( TileId const & tileId );
 
+    /**
+     * Drops the download of the tile if it has not been started yet, so
+     * that requests which are no longer needed do not hold up others. A
+     * later loadTile() or reloadTile() triggers the download again.
+     */
+    void cancelDownload( TileId const &tileId, DownloadUsage const );
+
+    /**
+     * Returns whether the tile is stored on disk, regardless of its expiration.
+     */
+    bool tileAvailable( TileId const & tileId ) const;
+
     static int maximumTileLevel( GeoSceneTexture const & texture );
 
     /**
@@ -61,6 +84,8 @@ class TileLoader: public QObject
  Q_SIGNALS:
     void downloadTile( QUrl const & sourceUrl, QString const & destinationFileName,
                        QString const & id, DownloadUsage );
+    void cancelDownload( QUrl const & sourceUrl, QString const & destinationFileName,
+                         DownloadUsage );
 
     void tileCompleted( TileId const & tileId, QImage const & tileImage );
 
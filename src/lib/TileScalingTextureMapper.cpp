@@ -154,7 +154,7 @@ void TileScalingTextureMapper::mapTexture( GeoPainter *painter, const ViewportPa
         }
 
         if ( texColorizer ) {
-            texColorizer->colorize( &m_canvasImage, viewport, painter->mapQuality() );
+            texColorizer->colorize( &m_canvasImage, &m_canvasImage, viewport, painter->mapQuality() );
         }
     } else {
         painter->save();
@@ -259,6 +259,7 @@ void GeoDataContainer::unpack( QDataStream& stream )
                 {
                 GeoDataFolder *folder = new GeoDataFolder;
                 folder->unpack( stream );
+                folder->setParent( this );
                 p()->m_vector.append( folder );
                 }
                 break;
@@ -266,6 +267,7 @@ void GeoDataContainer::unpack( QDataStream& stream )
                 {
                 GeoDataPlacemark *placemark = new GeoDataPlacemark;
                 placemark->unpack( stream );
+                placemark->setParent( this );
                 p()->m_vector.append( placemark );
                 }
                 break;
@@ -100,11 +100,30 @@ GeoDataSimpleArrayData* GeoDataExtendedData::simpleArrayData( const QString& key
 void GeoDataExtendedData::pack( QDataStream& stream ) const
 {
     GeoDataObject::pack( stream );
+
+    stream << d->hash.size();
+    QHash< QString, GeoDataData >::const_iterator it = d->hash.constBegin();
+    QHash< QString, GeoDataData >::const_iterator const end = d->hash.constEnd();
+    for (; it != end; ++it ) {
+        stream << it.key();
+        it.value().pack( stream );
+    }
 }
 
 void GeoDataExtendedData::unpack( QDataStream& stream )
 {
     GeoDataObject::unpack( stream );
+
+    int size = 0;
+    stream >> size;
+    for ( int i = 0; i < size; ++i ) {
+        QString key;
+        GeoDataData data;
+        stream >> key;
+        data.unpack( stream );
+        data.setName( key );
+        d->hash.insert( key, data );
+    }
 }
 
 }
@@ -740,11 +740,26 @@ void GeoDataFeature::pack( QDataStream& stream ) const
     stream << d->m_address;
     stream << d->m_phoneNumber;
     stream << d->m_description;
+    stream << d->m_descriptionCDATA;
     stream << d->m_visible;
 //    stream << d->m_visualCategory;
     stream << d->m_role;
     stream << d->m_popularity;
     stream << d->m_popularityIndex;
+    stream << d->m_styleUrl;
+    stream << (int)d->m_visualCategory;
+    d->m_extendedData.pack( stream );
+    d->m_abstractView.pack( stream );
+    d->m_timeSpan.pack( stream );
+    d->m_timeStamp.pack( stream );
+    d->m_region.pack( stream );
+
+    // Only inline styles are stored, shared ones are resolved again via the styleUrl
+    const bool inlineStyle = d->m_style && d->m_styleUrl.isEmpty();
+    stream << inlineStyle;
+    if ( inlineStyle ) {
+        d->m_style->pack( stream );
+    }
 }
 
 void GeoDataFeature::unpack( QDataStream& stream )
@@ -756,11 +771,29 @@ void GeoDataFeature::unpack( QDataStream& stream )
     stream >> d->m_address;
     stream >> d->m_phoneNumber;
     stream >> d->m_description;
+    stream >> d->m_descriptionCDATA;
     stream >> d->m_visible;
 //    stream >> (int)d->m_visualCategory;
     stream >> d->m_role;
     stream >> d->m_popularity;
     stream >> d->m_popularityIndex;
+    stream >> d->m_styleUrl;
+    int visualCategory;
+    stream >> visualCategory;
+    d->m_visualCategory = (GeoDataVisualCategory)visualCategory;
+    d->m_extendedData.unpack( stream );
+    d->m_abstractView.unpack( stream );
+    d->m_timeSpan.unpack( stream );
+    d->m_timeStamp.unpack( stream );
+    d->m_region.unpack( stream );
+
+    bool inlineStyle;
+    stream >> inlineStyle;
+    if ( inlineStyle ) {
+        GeoDataStyle *style = new GeoDataStyle;
+        style->unpack( stream );
+        d->m_style = style;
+    }
 }
 
 GeoDataFeature::GeoDataVisualCategory GeoDataFeature::OsmVisualCategory(const QString &keyValue )
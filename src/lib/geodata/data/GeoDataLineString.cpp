@@ -139,6 +139,7 @@ int GeoDataLineString::size() const
 GeoDataCoordinates& GeoDataLineString::at( int pos )
 {
     GeoDataGeometry::detach();
+    ++p()->m_revision;
     return p()->m_vector[ pos ];
 }
 
@@ -150,6 +151,7 @@ const GeoDataCoordinates& GeoDataLineString::at( int pos ) const
 GeoDataCoordinates& GeoDataLineString::operator[]( int pos )
 {
     GeoDataGeometry::detach();
+    ++p()->m_revision;
     return p()->m_vector[ pos ];
 }
 
@@ -161,12 +163,14 @@ const GeoDataCoordinates& GeoDataLineString::operator[]( int pos ) const
 GeoDataCoordinates& GeoDataLineString::last()
 {
     GeoDataGeometry::detach();
+    ++p()->m_revision;
     return p()->m_vector.last();
 }
 
 GeoDataCoordinates& GeoDataLineString::first()
 {
     GeoDataGeometry::detach();
+    ++p()->m_revision;
     return p()->m_vector.first();
 }
 
@@ -183,12 +187,14 @@ const GeoDataCoordinates& GeoDataLineString::first() const
 QVector<GeoDataCoordinates>::Iterator GeoDataLineString::begin()
 {
     GeoDataGeometry::detach();
+    ++p()->m_revision;
     return p()->m_vector.begin();
 }
 
 QVector<GeoDataCoordinates>::Iterator GeoDataLineString::end()
 {
     GeoDataGeometry::detach();
+    ++p()->m_revision;
     return p()->m_vector.end();
 }
 
@@ -210,9 +216,28 @@ void GeoDataLineString::append ( const GeoDataCoordinates& value )
     d->m_rangeCorrected.clear();
     d->m_dirtyRange = true;
     d->m_dirtyBox = true;
+    d->m_tessellationCache.clear();
+    ++d->m_revision;
     d->m_vector.append( value );
 }
 
+void GeoDataLineString::append ( const QVector<GeoDataCoordinates>& values )
+{
+    GeoDataGeometry::detach();
+    GeoDataLineStringPrivate* d = p();
+    qDeleteAll( d->m_rangeCorrected );
+    d->m_rangeCorrected.clear();
+    d->m_dirtyRange = true;
+    d->m_dirtyBox = true;
+    d->m_tessellationCache.clear();
+    ++d->m_revision;
+    if ( d->m_vector.isEmpty() ) {
+        d->m_vector = values;
+    } else {
+        d->m_vector += values;
+    }
+}
+
 GeoDataLineString& GeoDataLineString::operator << ( const GeoDataCoordinates& value )
 {
     GeoDataGeometry::detach();
@@ -221,6 +246,8 @@ GeoDataLineString& GeoDataLineString::operator << ( const GeoDataCoordinates& va
     d->m_rangeCorrected.clear();
     d->m_dirtyRange = true;
     d->m_dirtyBox = true;
+    d->m_tessellationCache.clear();
+    ++d->m_revision;
     d->m_vector.append( value );
     return *this;
 }
@@ -233,6 +260,8 @@ GeoDataLineString& GeoDataLineString::operator << ( const GeoDataLineString& val
     d->m_rangeCorrected.clear();
     d->m_dirtyRange = true;
     d->m_dirtyBox = true;
+    d->m_tessellationCache.clear();
+    ++d->m_revision;
 
     QVector<GeoDataCoordinates>::const_iterator itCoords = value.constBegin();
     QVector<GeoDataCoordinates>::const_iterator itEnd = value.constEnd();
@@ -252,6 +281,8 @@ void GeoDataLineString::clear()
     d->m_rangeCorrected.clear();
     d->m_dirtyRange = true;
     d->m_dirtyBox = true;
+    d->m_tessellationCache.clear();
+    ++d->m_revision;
 
     d->m_vector.clear();
 }
@@ -274,6 +305,9 @@ void GeoDataLineString::setTessellate( bool tessellate )
     // the same latitude the latitude circles are followed. Our Tesselate and RespectLatitude
     // Flags provide this behaviour. For true polygons the latitude circles don't get considered.
 
+    p()->m_tessellationCache.clear();
+    ++p()->m_revision;
+
     if ( tessellate ) {
         p()->m_tessellationFlags |= Tessellate;
         p()->m_tessellationFlags |= RespectLatitudeCircle;
@@ -290,6 +324,8 @@ TessellationFlags GeoDataLineString::tessellationFlags() const
 
 void GeoDataLineString::setTessellationFlags( TessellationFlags f )
 {
+    p()->m_tessellationCache.clear();
+    ++p()->m_revision;
     p()->m_tessellationFlags = f;
 }
 
@@ -570,6 +606,8 @@ QVector<GeoDataCoordinates>::Iterator GeoDataLineString::erase ( QVector<GeoData
     d->m_rangeCorrected.clear();
     d->m_dirtyRange = true;
     d->m_dirtyBox = true;
+    d->m_tessellationCache.clear();
+    ++d->m_revision;
     return d->m_vector.erase( pos );
 }
 
@@ -581,6 +619,8 @@ QVector<GeoDataCoordinates>::Iterator GeoDataLineString::erase ( QVector<GeoData
     d->m_rangeCorrected.clear();
     d->m_dirtyRange = true;
     d->m_dirtyBox = true;
+    d->m_tessellationCache.clear();
+    ++d->m_revision;
     return d->m_vector.erase( begin, end );
 }
 
@@ -590,6 +630,8 @@ void GeoDataLineString::remove ( int i )
     GeoDataLineStringPrivate* d = p();
     d->m_dirtyRange = true;
     d->m_dirtyBox = true;
+    d->m_tessellationCache.clear();
+    ++d->m_revision;
     d->m_vector.remove( i );
 }
 
@@ -614,6 +656,7 @@ void GeoDataLineString::pack( QDataStream& stream ) const
 void GeoDataLineString::unpack( QDataStream& stream )
 {
     GeoDataGeometry::detach();
+    ++p()->m_revision;
     GeoDataGeometry::unpack( stream );
     qint32 size;
     qint32 tessellationFlags;
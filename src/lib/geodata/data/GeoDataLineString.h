@@ -29,6 +29,8 @@ namespace Marble
 {
 
 class GeoDataLineStringPrivate;
+class AbstractProjectionPrivate;
+class GeoLineStringGraphicsItem;
 
 /*!
     \class GeoDataLineString
@@ -279,6 +281,13 @@ class GEODATA_EXPORT GeoDataLineString : public GeoDataGeometry
     void append ( const GeoDataCoordinates& position );
 
 
+/*!
+    \brief Appends the given geodesic positions as new nodes to the LineString.
+    Cached data is invalidated once instead of once per node.
+*/
+    void append ( const QVector<GeoDataCoordinates>& positions );
+
+
 /*!
     \brief Appends a given geodesic position as a new node to the LineString.
 */
@@ -358,6 +367,12 @@ class GEODATA_EXPORT GeoDataLineString : public GeoDataGeometry
  protected:
     GeoDataLineStringPrivate *p() const;
     GeoDataLineString(GeoDataLineStringPrivate* priv);
+
+ private:
+    // Accesses the tessellation cache
+    friend class AbstractProjectionPrivate;
+    // Accesses the revision to cache screen coordinates
+    friend class GeoLineStringGraphicsItem;
 };
 
 }
@@ -15,6 +15,9 @@
 
 #include "GeoDataTypes.h"
 
+#include <QtCore/QHash>
+#include <QtCore/QPointF>
+
 namespace Marble
 {
 
@@ -24,13 +27,15 @@ class GeoDataLineStringPrivate : public GeoDataGeometryPrivate
     GeoDataLineStringPrivate( TessellationFlags f )
          : m_dirtyRange( true ),
            m_dirtyBox( true ),
-           m_tessellationFlags( f )
+           m_tessellationFlags( f ),
+           m_revision( 0 )
     {
     }
 
     GeoDataLineStringPrivate()
          : m_dirtyRange( true ),
-           m_dirtyBox( true )
+           m_dirtyBox( true ),
+           m_revision( 0 )
     {
     }
 
@@ -52,6 +57,9 @@ class GeoDataLineStringPrivate : public GeoDataGeometryPrivate
         m_latLonAltBox = other.m_latLonAltBox;
         m_dirtyBox = other.m_dirtyBox;
         m_tessellationFlags = other.m_tessellationFlags;
+        // A copy is usually made to be modified, so don't take the cache over
+        m_tessellationCache.clear();
+        m_revision = other.m_revision + 1;
     }
 
 
@@ -97,6 +105,30 @@ class GeoDataLineStringPrivate : public GeoDataGeometryPrivate
                                             // GeoDataPoints since the LatLonAltBox has 
                                             // been calculated. Saves performance. 
     TessellationFlags           m_tessellationFlags;
+
+    /**
+     * The geographic positions (longitude as x, latitude as y, in radian) of the nodes
+     * that get interpolated between two subsequent nodes of the line string when it is
+     * tessellated. They don't depend on the viewport, so projections only need to
+     * calculate them once for each segment and node count.
+     */
+    struct TessellatedSegment
+    {
+        int                m_tessellatedNodes;
+        GeoDataCoordinates m_from;
+        GeoDataCoordinates m_to;
+        QVector<QPointF>   m_nodes;
+    };
+
+    // Keyed by the index of the first node of the segment, holding the nodes
+    // of the node count used last. Cleared whenever the nodes or the
+    // tessellation flags change.
+    QHash<int, TessellatedSegment> m_tessellationCache;
+
+    // Incremented on each change of the nodes or the tessellation flags, including
+    // potential ones through non-const references. Lets renderers cache screen
+    // coordinates of line strings that did not change.
+    quint32 m_revision;
 };
 
 } // namespace Marble
@@ -107,4 +107,21 @@ void GeoDataLookAt::detach()
     qAtomicDetach( d );
 }
 
+void GeoDataLookAt::pack( QDataStream& stream ) const
+{
+    GeoDataAbstractView::pack( stream );
+
+    d->m_coordinates.pack( stream );
+    stream << d->m_range;
+}
+
+void GeoDataLookAt::unpack( QDataStream& stream )
+{
+    detach();
+    GeoDataAbstractView::unpack( stream );
+
+    d->m_coordinates.unpack( stream );
+    stream >> d->m_range;
+}
+
 }
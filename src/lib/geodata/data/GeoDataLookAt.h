@@ -107,6 +107,18 @@ namespace Marble
         /// Provides type information for downcasting a GeoNode
         virtual const char* nodeType() const;
 
+        /**
+         * @brief Serialize the look at to a stream
+         * @param  stream  the stream
+         */
+        virtual void pack( QDataStream& stream ) const;
+
+        /**
+         * @brief  Unserialize the look at from a stream
+         * @param  stream  the stream
+         */
+        virtual void unpack( QDataStream& stream );
+
         void detach();
     private:
         GeoDataLookAtPrivate *d;
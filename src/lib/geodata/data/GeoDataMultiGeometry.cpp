@@ -274,6 +274,10 @@ void GeoDataMultiGeometry::unpack( QDataStream& stream )
             default: break;
         };
     }
+
+    foreach ( GeoDataGeometry *geometry, p()->m_vector ) {
+        geometry->setParent( this );
+    }
 }
 
 }
@@ -188,6 +188,10 @@ void GeoDataPlacemark::pack( QDataStream& stream ) const
     stream << p()->m_countrycode;
     stream << p()->m_area;
     stream << p()->m_population;
+    stream << bool( p()->m_lookAt );
+    if ( p()->m_lookAt ) {
+        p()->m_lookAt->pack( stream );
+    }
     if ( p()->m_geometry )
     {
         stream << p()->m_geometry->geometryId();
@@ -221,6 +225,14 @@ void GeoDataPlacemark::unpack( QDataStream& stream )
     stream >> p()->m_countrycode;
     stream >> p()->m_area;
     stream >> p()->m_population;
+    bool hasLookAt;
+    stream >> hasLookAt;
+    if ( hasLookAt ) {
+        GeoDataLookAt *lookAt = new GeoDataLookAt;
+        lookAt->unpack( stream );
+        delete p()->m_lookAt;
+        p()->m_lookAt = lookAt;
+    }
     int geometryId;
     stream >> geometryId;
     switch( geometryId ) {
@@ -270,6 +282,9 @@ void GeoDataPlacemark::unpack( QDataStream& stream )
             break;
         default: break;
     };
+    if ( p()->m_geometry ) {
+        p()->m_geometry->setParent( this );
+    }
 }
 
 }
@@ -131,8 +131,15 @@ void GeoDataRegion::pack( QDataStream& stream ) const
 {
     GeoDataObject::pack( stream );
 
-    d->m_lod->pack( stream );
-    d->m_latLonAltBox->pack( stream );
+    // Both are created on demand, so only store the ones that exist
+    stream << bool( d->m_lod );
+    if ( d->m_lod ) {
+        d->m_lod->pack( stream );
+    }
+    stream << bool( d->m_latLonAltBox );
+    if ( d->m_latLonAltBox ) {
+        d->m_latLonAltBox->pack( stream );
+    }
 }
 
 
@@ -140,8 +147,16 @@ void GeoDataRegion::unpack( QDataStream& stream )
 {
     GeoDataObject::unpack( stream );
 
-    d->m_lod->unpack( stream );
-    d->m_latLonAltBox->unpack( stream );
+    bool hasLod;
+    stream >> hasLod;
+    if ( hasLod ) {
+        lod().unpack( stream );
+    }
+    bool hasLatLonAltBox;
+    stream >> hasLatLonAltBox;
+    if ( hasLatLonAltBox ) {
+        latLonAltBox().unpack( stream );
+    }
 }
 
 GeoDataRegion &GeoDataRegion::operator=( const GeoDataRegion& other )
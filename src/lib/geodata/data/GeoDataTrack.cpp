@@ -247,8 +247,8 @@ void GeoDataTrack::removeAfter( const QDateTime &when )
 GeoDataLineString *GeoDataTrack::lineString() const
 {
     if ( d->m_lineStringNeedsUpdate ) {
-        delete d->m_lineString;
-        d->m_lineString = new GeoDataLineString();
+        // Updated in place, so that its revision keeps increasing
+        d->m_lineString->clear();
         foreach ( const GeoDataCoordinates &coordinates, coordinatesList() ) {
             d->m_lineString->append( coordinates );
         }
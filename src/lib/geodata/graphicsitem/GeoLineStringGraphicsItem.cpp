@@ -13,19 +13,32 @@
 #include "GeoPainter.h"
 #include "ViewportParams.h"
 #include "GeoDataStyle.h"
+#include "GeoDataLineString_p.h"
 
 namespace Marble
 {
 
 GeoLineStringGraphicsItem::GeoLineStringGraphicsItem( const GeoDataLineString* lineString )
         : GeoGraphicsItem(),
-          m_lineString( lineString )
+          m_lineString( lineString ),
+          m_polygonsValid( false ),
+          m_revision( 0 ),
+          m_projection( Spherical ),
+          m_radius( 0 ),
+          m_centerLongitude( 0.0 ),
+          m_centerLatitude( 0.0 )
 {
 }
 
+GeoLineStringGraphicsItem::~GeoLineStringGraphicsItem()
+{
+    clearPolygons();
+}
+
 void GeoLineStringGraphicsItem::setLineString( const GeoDataLineString* lineString )
 {
     m_lineString = lineString;
+    clearPolygons();
     setCoordinate( lineString->latLonAltBox().center() );
     setLatLonAltBox( lineString->latLonAltBox() );
 }
@@ -40,7 +53,9 @@ void GeoLineStringGraphicsItem::paint( GeoPainter* painter, ViewportParams* view
     {
         painter->save();
         painter->setPen( QPen() );
-        painter->drawPolyline( *m_lineString );
+        foreach( const QPolygonF* polygon, polygons( viewport ) ) {
+            painter->drawPolyline( *polygon );
+        }
         painter->restore();
         return;
     }
@@ -88,11 +103,60 @@ void GeoLineStringGraphicsItem::paint( GeoPainter* painter, ViewportParams* view
         bgPen.setStyle( Qt::SolidLine );
         bgPen.setCapStyle( Qt::RoundCap );
         painter->setPen( bgPen );
-        painter->drawPolyline( *m_lineString );
+        foreach( const QPolygonF* polygon, polygons( viewport ) ) {
+            painter->drawPolyline( *polygon );
+        }
         painter->restore();
     }
-    painter->drawPolyline( *m_lineString );
+    foreach( const QPolygonF* polygon, polygons( viewport ) ) {
+        painter->drawPolyline( *polygon );
+    }
     painter->restore();
 }
 
+quint32 GeoLineStringGraphicsItem::lineStringRevision() const
+{
+    return m_lineString->p()->m_revision;
+}
+
+const QVector<QPolygonF*> &GeoLineStringGraphicsItem::polygons( const ViewportParams *viewport )
+{
+    const quint32 revision = m_lineString->p()->m_revision;
+    if ( m_polygonsValid
+         && m_revision == revision
+         && m_projection == viewport->projection()
+         && m_radius == viewport->radius()
+         && m_size == viewport->size()
+         && m_planetAxis == viewport->planetAxis()
+         && m_centerLongitude == viewport->centerLongitude()
+         && m_centerLatitude == viewport->centerLatitude() ) {
+        return m_polygons;
+    }
+
+    clearPolygons();
+    m_polygonsValid = true;
+    m_revision = revision;
+    m_projection = viewport->projection();
+    m_radius = viewport->radius();
+    m_size = viewport->size();
+    m_planetAxis = viewport->planetAxis();
+    m_centerLongitude = viewport->centerLongitude();
+    m_centerLatitude = viewport->centerLatitude();
+
+    // Same checks as GeoPainter::drawPolyline()
+    if ( viewport->viewLatLonAltBox().intersects( m_lineString->latLonAltBox() ) &&
+         viewport->resolves( m_lineString->latLonAltBox() ) ) {
+        viewport->screenCoordinates( *m_lineString, m_polygons );
+    }
+
+    return m_polygons;
+}
+
+void GeoLineStringGraphicsItem::clearPolygons()
+{
+    qDeleteAll( m_polygons );
+    m_polygons.clear();
+    m_polygonsValid = false;
+}
+
 }
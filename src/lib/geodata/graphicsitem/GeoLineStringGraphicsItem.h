@@ -13,8 +13,14 @@
 
 #include "GeoDataLineString.h"
 #include "GeoGraphicsItem.h"
+#include "Quaternion.h"
 #include "marble_export.h"
 
+#include <QtCore/QSize>
+#include <QtCore/QVector>
+
+class QPolygonF;
+
 namespace Marble
 {
 class GeoDataLineStyle;
@@ -23,13 +29,38 @@ class MARBLE_EXPORT GeoLineStringGraphicsItem : public GeoGraphicsItem
 public:
     GeoLineStringGraphicsItem( const GeoDataLineString *lineString );
 
+    ~GeoLineStringGraphicsItem();
+
     void setLineString( const GeoDataLineString* lineString );
 
     virtual void paint( GeoPainter* painter, ViewportParams *viewport,
                         const QString &renderPos, GeoSceneLayer *layer );
 
 protected:
+    /** Changes whenever the line string is modified */
+    quint32 lineStringRevision() const;
+
     const GeoDataLineString *m_lineString;
+
+private:
+    /**
+     * Returns the screen polygons of the line string. They are reused as long as
+     * neither the line string nor the viewport changed, which saves projecting
+     * line strings again when e.g. only the position track grew.
+     */
+    const QVector<QPolygonF*> &polygons( const ViewportParams *viewport );
+
+    void clearPolygons();
+
+    QVector<QPolygonF*> m_polygons;
+    bool m_polygonsValid;
+    quint32 m_revision;
+    Projection m_projection;
+    Quaternion m_planetAxis;
+    int m_radius;
+    QSize m_size;
+    qreal m_centerLongitude;
+    qreal m_centerLatitude;
 };
 
 }
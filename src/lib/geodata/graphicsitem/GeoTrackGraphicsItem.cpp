@@ -16,7 +16,8 @@
 using namespace Marble;
 
 GeoTrackGraphicsItem::GeoTrackGraphicsItem( const GeoDataTrack *track )
-    : GeoLineStringGraphicsItem( new GeoDataLineString() )
+    : GeoLineStringGraphicsItem( new GeoDataLineString() ),
+      m_revision( 0 )
 {
     setTrack( track );
 }
@@ -29,7 +30,11 @@ void GeoTrackGraphicsItem::setTrack( const GeoDataTrack* track )
 
 void GeoTrackGraphicsItem::paint( GeoPainter *painter, ViewportParams *viewport, const QString &renderPos, GeoSceneLayer *layer )
 {
-    update();
+    // The track rebuilds its line string in place when it changed
+    m_track->lineString();
+    if ( lineStringRevision() != m_revision ) {
+        update();
+    }
 
     GeoLineStringGraphicsItem::paint( painter, viewport, renderPos, layer );
 }
@@ -38,4 +43,5 @@ void GeoTrackGraphicsItem::update()
 {
     setLineString( m_track->lineString() );
     setCoordinate( GeoDataCoordinates(0, 0) );
+    m_revision = lineStringRevision();
 }
@@ -30,6 +30,7 @@ public:
 
 private:
     const GeoDataTrack *m_track;
+    quint32 m_revision;
     void update();
 };
 
@@ -21,8 +21,7 @@
 
 #include "KmlCoordinatesTagHandler.h"
 
-#include <QtCore/QStringList>
-#include <QtCore/QRegExp>
+#include <QtCore/QVector>
 
 #include "MarbleDebug.h"
 #include "KmlElementDictionary.h"
@@ -32,6 +31,7 @@
 #include "GeoDataLineString.h"
 #include "GeoDataLinearRing.h"
 #include "GeoDataMultiGeometry.h"
+#include "GeoFloatParser.h"
 #include "GeoParser.h"
 #include "global.h"
 
@@ -46,6 +46,131 @@ KML_DEFINE_TAG_HANDLER( coordinates )
 static GeoTagHandlerRegistrar s_handlercoordkmlTag_nameSpaceGx22(GeoParser::QualifiedName(kmlTag_coord, kmlTag_nameSpaceGx22 ),
                                                                  new KmlcoordinatesTagHandler());
 
+namespace
+{
+
+GeoDataCoordinates coordinates( const qreal values[3], int count )
+{
+    if ( count == 2 ) {
+        return GeoDataCoordinates( values[0], values[1], 0.0, GeoDataCoordinates::Degree );
+    } else if ( count == 3 ) {
+        return GeoDataCoordinates( values[0], values[1], values[2], GeoDataCoordinates::Degree );
+    }
+
+    return GeoDataCoordinates();
+}
+
+/**
+ * Converts the whitespace separated tokens of a coordinates element. In KML
+ * each token is a tuple "lon,lat[,alt]" (degrees and meters). The gx:coord
+ * element of tracks has a single tuple whose values are separated by spaces.
+ */
+class CoordinatesCollector
+{
+public:
+    CoordinatesCollector( QVector<GeoDataCoordinates> &result, bool spaceSeparated )
+        : m_result( result ),
+          m_spaceSeparated( spaceSeparated ),
+          m_count( 0 )
+    {
+    }
+
+    void addToken( const QChar* begin, const QChar* end )
+    {
+        if ( m_spaceSeparated ) {
+            if ( m_count < 3 && GeoFloatParser::parse( begin, end, m_values[m_count] ) ) {
+                ++m_count;
+            }
+            return;
+        }
+
+        m_count = 0;
+        const QChar* position = begin;
+        while ( m_count < 3 && GeoFloatParser::parse( position, end, m_values[m_count] ) ) {
+            ++m_count;
+            if ( position == end || *position != QChar( ',' ) ) {
+                break;
+            }
+            ++position;
+        }
+        if ( m_count > 1 ) {
+            m_result.append( coordinates( m_values, m_count ) );
+        }
+    }
+
+    void finish()
+    {
+        if ( m_spaceSeparated ) {
+            m_result.append( coordinates( m_values, m_count ) );
+        }
+    }
+
+private:
+    QVector<GeoDataCoordinates> &m_result;
+    bool const m_spaceSeparated;
+    qreal m_values[3];
+    int m_count;
+};
+
+/**
+ * Reads the text of the current element and hands its whitespace separated
+ * tokens to @p collector. The text is tokenized in place, chunk by chunk as
+ * delivered by the reader, without creating intermediate strings. Only a token
+ * that is split between two chunks is copied. The reader is positioned at the
+ * end element afterwards, like after readElementText().
+ */
+void readCoordinates( GeoParser &parser, CoordinatesCollector &collector )
+{
+    QString pending;
+
+    while ( !parser.atEnd() ) {
+        parser.readNext();
+        if ( parser.isEndElement() ) {
+            break;
+        } else if ( parser.isStartElement() ) {
+            parser.raiseWarning( QString( "Unexpected element %1 in coordinates" ).arg( parser.name().toString() ) );
+            parser.skipCurrentElement();
+            continue;
+        } else if ( !parser.isCharacters() ) {
+            continue;
+        }
+
+        const QStringRef text = parser.text();
+        const QChar* position = text.unicode();
+        const QChar* const end = position + text.size();
+
+        while ( position < end ) {
+            const QChar* tokenEnd = position;
+            while ( tokenEnd < end && !GeoFloatParser::isSpace( *tokenEnd ) ) {
+                ++tokenEnd;
+            }
+
+            if ( tokenEnd == end ) {
+                // The token may continue in the next chunk
+                pending.append( position, tokenEnd - position );
+            } else if ( !pending.isEmpty() ) {
+                pending.append( position, tokenEnd - position );
+                collector.addToken( pending.constData(), pending.constData() + pending.size() );
+                pending.clear();
+            } else if ( tokenEnd > position ) {
+                collector.addToken( position, tokenEnd );
+            }
+
+            position = tokenEnd;
+            while ( position < end && GeoFloatParser::isSpace( *position ) ) {
+                ++position;
+            }
+        }
+    }
+
+    if ( !pending.isEmpty() ) {
+        collector.addToken( pending.constData(), pending.constData() + pending.size() );
+    }
+    collector.finish();
+}
+
+}
+
 GeoNode* KmlcoordinatesTagHandler::parse( GeoParser& parser ) const
 {
     Q_ASSERT( parser.isStartElement()
@@ -58,93 +183,35 @@ GeoNode* KmlcoordinatesTagHandler::parse( GeoParser& parser ) const
      || parentItem.represents( kmlTag_LineString )
      || parentItem.represents( kmlTag_MultiGeometry )
      || parentItem.represents( kmlTag_LinearRing ) ) {
-        QStringList  coordinatesLines;// = parser.readElementText().trimmed().split( QRegExp("\\s"), QString::SkipEmptyParts );
-        // Splitting using the "\\s" regexp is slow, split manually instead.
-        QString const text = parser.readElementText().trimmed();
-        int index = 0;
-        bool inside = true;
-        int const size = text.size();
-        for ( int i=0; i<size; ++i ) {
-            if ( text[i].isSpace() ) {
-                if ( inside ) {
-                    coordinatesLines.append( text.mid( index, i-index ) );
-                    inside = false;
-                }
-                index = i+1;
-            } else {
-                inside = true;
+        QVector<GeoDataCoordinates> coordinatesList;
+        CoordinatesCollector collector( coordinatesList, false );
+        readCoordinates( parser, collector );
+
+        if ( parentItem.represents( kmlTag_LineString ) ) {
+            parentItem.nodeAs<GeoDataLineString>()->append( coordinatesList );
+        } else if ( parentItem.represents( kmlTag_LinearRing ) ) {
+            parentItem.nodeAs<GeoDataLinearRing>()->append( coordinatesList );
+        } else if ( parentItem.represents( kmlTag_MultiGeometry ) ) {
+            foreach( const GeoDataCoordinates &coord, coordinatesList ) {
+                parentItem.nodeAs<GeoDataMultiGeometry>()->append( new GeoDataPoint( coord ) );
             }
-        }
-        coordinatesLines.append( text.mid( index ) );
-        Q_FOREACH( const QString& line, coordinatesLines ) {
-            QStringList coordinates = line.trimmed().split( ',' );
-            if ( parentItem.represents( kmlTag_Point ) && parentItem.is<GeoDataFeature>() ) {
-                GeoDataPoint coord;
-                if ( coordinates.size() == 2 ) {
-                    coord.set( DEG2RAD * coordinates.at( 0 ).toDouble(),
-                              DEG2RAD * coordinates.at( 1 ).toDouble() );
-                } else if( coordinates.size() == 3 ) {
-                    coord.set( DEG2RAD * coordinates.at( 0 ).toDouble(),
-                              DEG2RAD * coordinates.at( 1 ).toDouble(),
-                              coordinates.at( 2 ).toDouble() );
-                }
-                parentItem.nodeAs<GeoDataPlacemark>()->setCoordinate( coord );
-            } else {
-                GeoDataCoordinates coord;
-                if ( coordinates.size() == 2 ) {
-                    coord.set( DEG2RAD * coordinates.at( 0 ).toDouble(),
-                              DEG2RAD * coordinates.at( 1 ).toDouble() );
-                } else if( coordinates.size() == 3 ) {
-                    coord.set( DEG2RAD * coordinates.at( 0 ).toDouble(),
-                              DEG2RAD * coordinates.at( 1 ).toDouble(),
-                              coordinates.at( 2 ).toDouble() );
-                }
-
-                if ( parentItem.represents( kmlTag_LineString ) ) {
-                    parentItem.nodeAs<GeoDataLineString>()->append( coord );
-                } else if ( parentItem.represents( kmlTag_LinearRing ) ) {
-                    parentItem.nodeAs<GeoDataLinearRing>()->append( coord );
-                } else if ( parentItem.represents( kmlTag_MultiGeometry ) ) {
-                    GeoDataPoint *point = new GeoDataPoint;
-                    if ( coordinates.size() == 2 ) {
-                        point->set( DEG2RAD * coordinates.at( 0 ).toDouble(),
-                                   DEG2RAD * coordinates.at( 1 ).toDouble() );
-                    } else if ( coordinates.size() == 3 ) {
-                        point->set( DEG2RAD * coordinates.at( 0 ).toDouble(),
-                                   DEG2RAD * coordinates.at( 1 ).toDouble(),
-                                   coordinates.at( 2 ).toDouble() );
-                    }
-                    parentItem.nodeAs<GeoDataMultiGeometry>()->append( point );
-                } else if ( parentItem.represents( kmlTag_Point ) ) {
-/*                  mDebug() << "found a free Point!";
-                    qreal lon, lat;
-                    coord.geoCoordinates(lon, lat);
-                    parentItem.nodeAs<GeoDataPoint>()->set(lon, lat, coord.altitude());*/
-                } else {
-                    // raise warning as coordinates out of valid parents found
-                }
+        } else if ( parentItem.represents( kmlTag_Point ) && parentItem.is<GeoDataFeature>() ) {
+            if ( !coordinatesList.isEmpty() ) {
+                parentItem.nodeAs<GeoDataPlacemark>()->setCoordinate( GeoDataPoint( coordinatesList.last() ) );
             }
+        }
 #ifdef DEBUG_TAGS
         mDebug() << "Parsed <" << parser.name()
-                 << ">" << coordinatesLines
+                 << "> with" << coordinatesList.size() << "coordinates"
                  << " parent item name: " << parentItem.qualifiedName().first;
 #endif // DEBUG_TAGS
-
-        }
     }
 
     if( parentItem.represents( kmlTag_Track ) ) {
-        QStringList coordinates = parser.readElementText().trimmed().split( ' ' );
-        GeoDataCoordinates coord;
-        if ( coordinates.size() == 2 ) {
-            coord.set( DEG2RAD * coordinates.at( 0 ).toDouble(),
-                       DEG2RAD * coordinates.at( 1 ).toDouble() );
-        } else if( coordinates.size() == 3 ) {
-            coord.set( DEG2RAD * coordinates.at( 0 ).toDouble(),
-                       DEG2RAD * coordinates.at( 1 ).toDouble(),
-                       coordinates.at( 2 ).toDouble() );
-        }
-        parentItem.nodeAs<GeoDataTrack>()->appendCoordinates( coord );
+        QVector<GeoDataCoordinates> coordinatesList;
+        CoordinatesCollector collector( coordinatesList, true );
+        readCoordinates( parser, collector );
+        parentItem.nodeAs<GeoDataTrack>()->appendCoordinates( coordinatesList.first() );
     }
 
     return 0;
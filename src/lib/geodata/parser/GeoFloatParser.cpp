@@ -0,0 +1,141 @@
+//
+// This file is part of the Marble Virtual Globe.
+//
+// This program is free software licensed under the GNU LGPL. You can
+// find a copy of this license in LICENSE.txt in the top directory of
+// the source code.
+//
+// Copyright 2026      agent <agent@local>
+//
+
+#include "GeoFloatParser.h"
+
+#include <QtCore/QString>
+
+namespace Marble
+{
+
+namespace
+{
+
+// All powers of ten that are exactly representable as double
+const double s_powersOfTen[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+const int s_maxExactPower = 22;
+
+// Mantissas up to 2^53 are exactly representable as double
+const quint64 s_maxExactMantissa = Q_UINT64_C( 9007199254740992 );
+
+inline int digit( const QChar* position )
+{
+    return position->unicode() - '0';
+}
+
+inline bool isDigit( const QChar* position )
+{
+    return ushort( position->unicode() - '0' ) < 10;
+}
+
+}
+
+bool GeoFloatParser::parse( const QChar* &position, const QChar* end, qreal &value )
+{
+    const QChar* current = position;
+    bool negative = false;
+    if ( current < end && ( current->unicode() == '-' || current->unicode() == '+' ) ) {
+        negative = current->unicode() == '-';
+        ++current;
+    }
+
+    quint64 mantissa = 0;
+    int significantDigits = 0;
+    int exponent = 0;
+    bool hasDigits = false;
+
+    for ( ; current < end && isDigit( current ); ++current ) {
+        hasDigits = true;
+        if ( significantDigits < 19 ) {
+            mantissa = 10 * mantissa + digit( current );
+            significantDigits += mantissa > 0 ? 1 : 0;
+        } else {
+            ++exponent;
+        }
+    }
+
+    if ( current < end && current->unicode() == '.' ) {
+        for ( ++current; current < end && isDigit( current ); ++current ) {
+            hasDigits = true;
+            if ( significantDigits < 19 ) {
+                mantissa = 10 * mantissa + digit( current );
+                significantDigits += mantissa > 0 ? 1 : 0;
+                --exponent;
+            }
+        }
+    }
+
+    if ( !hasDigits ) {
+        return false;
+    }
+
+    if ( current < end && ( current->unicode() == 'e' || current->unicode() == 'E' ) ) {
+        const QChar* exponentPosition = current + 1;
+        bool negativeExponent = false;
+        if ( exponentPosition < end && ( exponentPosition->unicode() == '-' || exponentPosition->unicode() == '+' ) ) {
+            negativeExponent = exponentPosition->unicode() == '-';
+            ++exponentPosition;
+        }
+
+        // The exponent is only part of the number if it has digits
+        if ( exponentPosition < end && isDigit( exponentPosition ) ) {
+            int explicitExponent = 0;
+            for ( ; exponentPosition < end && isDigit( exponentPosition ); ++exponentPosition ) {
+                if ( explicitExponent < 10000 ) {
+                    explicitExponent = 10 * explicitExponent + digit( exponentPosition );
+                }
+            }
+            exponent += negativeExponent ? -explicitExponent : explicitExponent;
+            current = exponentPosition;
+        }
+    }
+
+    if ( mantissa <= s_maxExactMantissa && exponent >= -s_maxExactPower && exponent <= s_maxExactPower ) {
+        // Both operands are exact, so the single rounding step gives the correctly rounded result
+        const double result = exponent < 0 ? double( mantissa ) / s_powersOfTen[-exponent]
+                                           : double( mantissa ) * s_powersOfTen[exponent];
+        value = negative ? -result : result;
+        position = current;
+        return true;
+    }
+
+    bool ok = false;
+    const double result = QString::fromRawData( position, current - position ).toDouble( &ok );
+    if ( ok ) {
+        value = result;
+        position = current;
+    }
+    return ok;
+}
+
+qreal GeoFloatParser::toDouble( const QStringRef &text, bool *ok )
+{
+    const QChar* position = text.unicode();
+    const QChar* end = position + text.size();
+    while ( position < end && isSpace( *position ) ) {
+        ++position;
+    }
+    while ( end > position && isSpace( *( end - 1 ) ) ) {
+        --end;
+    }
+
+    qreal value = 0.0;
+    const bool valid = parse( position, end, value ) && position == end;
+    if ( ok ) {
+        *ok = valid;
+    }
+    return valid ? value : 0.0;
+}
+
+}
@@ -0,0 +1,57 @@
+//
+// This file is part of the Marble Virtual Globe.
+//
+// This program is free software licensed under the GNU LGPL. You can
+// find a copy of this license in LICENSE.txt in the top directory of
+// the source code.
+//
+// Copyright 2026      agent <agent@local>
+//
+
+#ifndef MARBLE_GEOFLOATPARSER_H
+#define MARBLE_GEOFLOATPARSER_H
+
+#include <QtCore/QChar>
+#include <QtCore/QStringRef>
+
+#include "geodata_export.h"
+
+namespace Marble
+{
+
+/**
+ * @brief Locale independent conversion of XML number text to floating point values
+ *
+ * Tag handlers use it to convert numbers in place, without creating temporary
+ * strings. Numbers with up to 15 significant digits and small exponents, which
+ * covers all coordinates and elevations found in practice, are converted
+ * exactly by a fast path. Everything else is handed over to QString::toDouble().
+ */
+class GEODATA_EXPORT GeoFloatParser
+{
+public:
+    /**
+     * Converts the number starting at @p position. Leading whitespace is not
+     * skipped. On success, @p value is set and @p position is moved behind the
+     * last character of the number.
+     * @return true if a number was found at @p position
+     */
+    static bool parse( const QChar* &position, const QChar* end, qreal &value );
+
+    /**
+     * Converts the complete string @p text, which may be surrounded by whitespace,
+     * like QString::toDouble() does.
+     * Returns 0.0 and sets @p ok to false if @p text is not a number.
+     */
+    static qreal toDouble( const QStringRef &text, bool *ok = 0 );
+
+    static bool isSpace( const QChar &c )
+    {
+        const ushort u = c.unicode();
+        return u == ' ' || u == '\n' || u == '\t' || u == '\r' || ( u > 127 && c.isSpace() );
+    }
+};
+
+}
+
+#endif
@@ -139,14 +139,14 @@ void GeoParser::parseDocument()
     }
 
     bool processChildren = true;
-    QualifiedName qName( name().toString(), namespaceUri().toString() );
+    const TagCacheEntry tag = currentTag();
 
     if( tokenType() == QXmlStreamReader::Invalid )
         raiseWarning( QString( "%1: %2" ).arg( error() ).arg( errorString() ) );
 
-    GeoStackItem stackItem( qName, 0 );
+    GeoStackItem stackItem( tag.name, 0 );
 
-    if ( const GeoTagHandler* handler = GeoTagHandler::recognizes( qName )) {
+    if ( const GeoTagHandler* handler = tag.handler ) {
         stackItem.assignNode( handler->parse( *this ));
         processChildren = !isEndElement();
     }
@@ -190,6 +190,38 @@ void GeoParser::parseDocument()
 #endif
 }
 
+GeoParser::TagCacheEntry GeoParser::currentTag()
+{
+    const QStringRef tagName = name();
+    const QStringRef tagNamespace = namespaceUri();
+
+    // Namespaces are long and few, their length is enough to tell them apart in the hash
+    uint hash = tagNamespace.size();
+    const QChar* const begin = tagName.unicode();
+    const QChar* const end = begin + tagName.size();
+    for ( const QChar* c = begin; c != end; ++c ) {
+        hash = 31 * hash + c->unicode();
+    }
+
+    QMultiHash<uint, TagCacheEntry>::const_iterator iter = m_tagCache.constFind( hash );
+    for ( ; iter != m_tagCache.constEnd() && iter.key() == hash; ++iter ) {
+        if ( iter.value().name.first == tagName && iter.value().name.second == tagNamespace ) {
+            return iter.value();
+        }
+    }
+
+    TagCacheEntry tag;
+    tag.name = QualifiedName( tagName.toString(), tagNamespace.toString() );
+    tag.handler = GeoTagHandler::recognizes( tag.name );
+
+    // Documents with generated element names must not let the cache grow without bounds
+    if ( m_tagCache.size() < 1024 ) {
+        m_tagCache.insert( hash, tag );
+    }
+
+    return tag;
+}
+
 void GeoParser::raiseWarning( const QString& warning )
 {
     // TODO: Maybe introduce a strict parsing mode where we feed the warning to
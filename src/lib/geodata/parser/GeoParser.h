@@ -22,6 +22,7 @@
 #ifndef MARBLE_GEOPARSER_H
 #define MARBLE_GEOPARSER_H
 
+#include <QtCore/QMultiHash>
 #include <QtCore/QPair>
 #include <QtCore/QStack>
 #include <QtXml/QXmlStreamReader>
@@ -36,6 +37,7 @@ typedef int GeoDataGenericSourceType;
 class GeoDocument;
 class GeoNode;
 class GeoStackItem;
+class GeoTagHandler;
 
 class GEODATA_EXPORT GeoParser : public QXmlStreamReader
 {
@@ -91,7 +93,22 @@ protected:
 
 private:
     void parseDocument();
+
+    struct TagCacheEntry
+    {
+        QualifiedName name;
+        const GeoTagHandler* handler;
+    };
+
+    /**
+     * Returns the qualified name and the tag handler of the current element.
+     * Names are interned: Each distinct name is only created once, later
+     * occurrences share it without constructing any strings.
+     */
+    TagCacheEntry currentTag();
+
     QStack<GeoStackItem> m_nodeStack;
+    QMultiHash<uint, TagCacheEntry> m_tagCache;
 };
 
 class GeoStackItem
@@ -112,7 +129,7 @@ class GeoStackItem
     // Fast path for tag handlers
     bool represents( const char* tagName ) const
     {
-        return m_node && tagName == m_qualifiedName.first;
+        return m_node && m_qualifiedName.first == QLatin1String( tagName );
     }
 
     // Helper for tag handlers. Does NOT guard against miscasting. Use with care.
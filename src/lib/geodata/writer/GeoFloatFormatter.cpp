@@ -0,0 +1,131 @@
+//
+// This file is part of the Marble Virtual Globe.
+//
+// This program is free software licensed under the GNU LGPL. You can
+// find a copy of this license in LICENSE.txt in the top directory of
+// the source code.
+//
+// Copyright 2026      agent <agent@local>
+//
+
+#include "GeoFloatFormatter.h"
+
+#include <cfloat>
+#include <cmath>
+
+namespace Marble
+{
+
+namespace
+{
+
+const quint64 s_powersOfTen[] = {
+    Q_UINT64_C( 1 ),
+    Q_UINT64_C( 10 ),
+    Q_UINT64_C( 100 ),
+    Q_UINT64_C( 1000 ),
+    Q_UINT64_C( 10000 ),
+    Q_UINT64_C( 100000 ),
+    Q_UINT64_C( 1000000 ),
+    Q_UINT64_C( 10000000 ),
+    Q_UINT64_C( 100000000 ),
+    Q_UINT64_C( 1000000000 ),
+    Q_UINT64_C( 10000000000 ),
+    Q_UINT64_C( 100000000000 ),
+    Q_UINT64_C( 1000000000000 ),
+    Q_UINT64_C( 10000000000000 ),
+    Q_UINT64_C( 100000000000000 ),
+    Q_UINT64_C( 1000000000000000 )
+};
+
+const int s_maxPrecision = 15;
+
+// Integers up to 2^53 are exactly representable as double
+const double s_maxExactInteger = 9007199254740992.0;
+
+}
+
+int GeoFloatFormatter::format( qreal value, int precision, char *buffer )
+{
+    if ( precision < 0 || precision > s_maxPrecision ) {
+        return 0;
+    }
+
+    const bool negative = value < 0.0;
+    const double scaled = ( negative ? -value : value ) * s_powersOfTen[precision];
+
+    // Also rejects NaN
+    if ( !( scaled < s_maxExactInteger ) ) {
+        return 0;
+    }
+
+    // The scaling is exact up to a few units in the last place. Leave values
+    // that are too close to a rounding tie to QString::number() which rounds
+    // the exact decimal expansion
+    const double rounded = floor( scaled + 0.5 );
+    if ( fabs( scaled - floor( scaled ) - 0.5 ) <= 4 * DBL_EPSILON * scaled ) {
+        return 0;
+    }
+
+    quint64 digits = static_cast<quint64>( rounded );
+
+    // QString::number() keeps the sign of negative zero and of negative
+    // values rounded to zero
+    if ( digits == 0 && ( negative || 1.0 / value < 0.0 ) ) {
+        return 0;
+    }
+
+    // Write the digits backwards into a scratch buffer
+    char reversed[MaxLength];
+    int length = 0;
+    for ( int i = 0; i < precision; ++i ) {
+        reversed[length++] = '0' + digits % 10;
+        digits /= 10;
+    }
+    if ( precision > 0 ) {
+        reversed[length++] = '.';
+    }
+    do {
+        reversed[length++] = '0' + digits % 10;
+        digits /= 10;
+    } while ( digits > 0 );
+    if ( negative ) {
+        reversed[length++] = '-';
+    }
+
+    for ( int i = 0; i < length; ++i ) {
+        buffer[i] = reversed[length - 1 - i];
+    }
+    return length;
+}
+
+void GeoFloatFormatter::append( QString &target, qreal value, int precision )
+{
+    char buffer[MaxLength];
+    const int length = format( value, precision, buffer );
+    if ( length == 0 ) {
+        target += QString::number( value, 'f', precision );
+        return;
+    }
+
+    const int size = target.size();
+    target.resize( size + length );
+    QChar *out = target.data() + size;
+    for ( int i = 0; i < length; ++i ) {
+        out[i] = QLatin1Char( buffer[i] );
+    }
+}
+
+void GeoFloatFormatter::append( QByteArray &target, qreal value, int precision )
+{
+    char buffer[MaxLength];
+    const int length = format( value, precision, buffer );
+    if ( length == 0 ) {
+        target += QByteArray::number( value, 'f', precision );
+        return;
+    }
+
+    target.append( buffer, length );
+}
+
+}
@@ -0,0 +1,57 @@
+//
+// This file is part of the Marble Virtual Globe.
+//
+// This program is free software licensed under the GNU LGPL. You can
+// find a copy of this license in LICENSE.txt in the top directory of
+// the source code.
+//
+// Copyright 2026      agent <agent@local>
+//
+
+#ifndef MARBLE_GEOFLOATFORMATTER_H
+#define MARBLE_GEOFLOATFORMATTER_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+
+#include "geodata_export.h"
+
+namespace Marble
+{
+
+/**
+ * @brief Locale independent conversion of floating point values to XML number text
+ *
+ * The counterpart of GeoFloatParser for tag writers. Numbers are written in fixed
+ * point notation with the given number of decimals, with the same result as
+ * QString::number( value, 'f', precision ). Values below 1e15 with up to 15
+ * decimals, which covers all coordinates and elevations found in practice, are
+ * converted by a fast path without creating temporary strings. Everything else
+ * is handed over to QString::number().
+ */
+class GEODATA_EXPORT GeoFloatFormatter
+{
+public:
+    /** The size of the buffer passed to format() */
+    enum { MaxLength = 32 };
+
+    /**
+     * Writes @p value with @p precision decimals to @p buffer, which must hold
+     * at least MaxLength characters. No terminating null character is written.
+     * @return the number of characters written, or 0 if the value is not covered
+     * by the fast path
+     */
+    static int format( qreal value, int precision, char *buffer );
+
+    /**
+     * Appends @p value with @p precision decimals to @p target. Appending does
+     * not allocate memory if @p target has reserved enough capacity.
+     */
+    static void append( QString &target, qreal value, int precision );
+
+    static void append( QByteArray &target, qreal value, int precision );
+};
+
+}
+
+#endif
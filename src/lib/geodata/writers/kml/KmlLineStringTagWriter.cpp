@@ -12,12 +12,21 @@
 
 #include "GeoDataLineString.h"
 #include "GeoDataTypes.h"
+#include "GeoFloatFormatter.h"
 #include "GeoWriter.h"
 #include "KmlElementDictionary.h"
 
 namespace Marble
 {
 
+namespace
+{
+
+// Number of characters passed to the writer at once
+const int ChunkSize = 16 * 1024;
+
+}
+
 static GeoTagWriterRegistrar s_writerLookAt(
     GeoTagWriter::QualifiedName( GeoDataTypes::GeoDataLineStringType,
                                  kml::kmlTag_nameSpace22 ),
@@ -32,35 +41,7 @@ bool KmlLineStringTagWriter::write( const GeoNode *node, GeoWriter& writer ) con
         writer.writeStartElement( kml::kmlTag_LineString );
         writer.writeStartElement( "coordinates" );
 
-        // Write altitude for *all* elements, if *any* element
-        // has altitude information (!= 0.0)
-        bool hasAltitude = false;
-        for ( int i = 0; i < lineString->size(); ++i ) {
-            if ( lineString->at( i ).altitude() ) {
-                hasAltitude = true;
-                break;
-            }
-        }
-
-        for ( int i = 0; i < lineString->size(); ++i ) {
-            GeoDataCoordinates coordinates = lineString->at( i );
-            if ( i > 0 )
-            {
-                writer.writeCharacters( " " );
-            }
-
-            qreal lon = coordinates.longitude( GeoDataCoordinates::Degree );
-            writer.writeCharacters( QString::number( lon, 'f', 10 ) );
-            writer.writeCharacters( "," );
-            qreal lat = coordinates.latitude( GeoDataCoordinates::Degree );
-            writer.writeCharacters( QString::number( lat, 'f', 10 ) );
-
-            if ( hasAltitude ) {
-                qreal alt = coordinates.altitude();
-                writer.writeCharacters( "," );
-                writer.writeCharacters( QString::number( alt, 'f', 2 ) );
-            }
-        }
+        writeCoordinates( lineString, writer );
 
         writer.writeEndElement();
         writer.writeEndElement();
@@ -71,4 +52,46 @@ bool KmlLineStringTagWriter::write( const GeoNode *node, GeoWriter& writer ) con
     return false;
 }
 
+void KmlLineStringTagWriter::writeCoordinates( const GeoDataLineString *lineString, GeoWriter& writer )
+{
+    // Write altitude for *all* elements, if *any* element
+    // has altitude information (!= 0.0)
+    bool hasAltitude = false;
+    for ( int i = 0; i < lineString->size(); ++i ) {
+        if ( lineString->at( i ).altitude() ) {
+            hasAltitude = true;
+            break;
+        }
+    }
+
+    QString buffer;
+    buffer.reserve( ChunkSize + 3 * GeoFloatFormatter::MaxLength + 3 );
+
+    for ( int i = 0; i < lineString->size(); ++i ) {
+        const GeoDataCoordinates &coordinates = lineString->at( i );
+        if ( i > 0 ) {
+            buffer += QLatin1Char( ' ' );
+        }
+
+        GeoFloatFormatter::append( buffer, coordinates.longitude( GeoDataCoordinates::Degree ), 10 );
+        buffer += QLatin1Char( ',' );
+        GeoFloatFormatter::append( buffer, coordinates.latitude( GeoDataCoordinates::Degree ), 10 );
+
+        if ( hasAltitude ) {
+            buffer += QLatin1Char( ',' );
+            GeoFloatFormatter::append( buffer, coordinates.altitude(), 2 );
+        }
+
+        if ( buffer.size() >= ChunkSize ) {
+            writer.writeCharacters( buffer );
+            // Keeps the reserved capacity
+            buffer.resize( 0 );
+        }
+    }
+
+    if ( !buffer.isEmpty() ) {
+        writer.writeCharacters( buffer );
+    }
+}
+
 }
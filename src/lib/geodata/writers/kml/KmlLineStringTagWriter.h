@@ -16,10 +16,20 @@
 namespace Marble
 {
 
+class GeoDataLineString;
+
 class KmlLineStringTagWriter : public GeoTagWriter
 {
 public:
     virtual bool write( const GeoNode *node, GeoWriter& writer ) const;
+
+    /**
+     * Writes the coordinate tuples of @p lineString as character data. The
+     * altitude is written for all coordinates if any of them has one. The
+     * tuples are formatted into a buffer that is passed to the writer in
+     * chunks rather than number by number.
+     */
+    static void writeCoordinates( const GeoDataLineString *lineString, GeoWriter& writer );
 };
 
 }
@@ -14,6 +14,7 @@
 #include "GeoDataTypes.h"
 #include "GeoWriter.h"
 #include "KmlElementDictionary.h"
+#include "KmlLineStringTagWriter.h"
 
 namespace Marble
 {
@@ -32,20 +33,7 @@ bool KmlLinearRingTagWriter::write( const GeoNode *node, GeoWriter& writer ) con
         writer.writeStartElement( kml::kmlTag_LinearRing );
         writer.writeStartElement( "coordinates" );
 
-        for ( int i = 0; i < ring->size(); ++i )
-        {
-            GeoDataCoordinates coordinates = ring->at( i );
-            if ( i > 0 )
-            {
-                writer.writeCharacters( " " );
-            }
-
-            qreal lon = coordinates.longitude( GeoDataCoordinates::Degree );
-            writer.writeCharacters( QString::number( lon, 'f', 10 ) );
-            writer.writeCharacters( "," );
-            qreal lat = coordinates.latitude( GeoDataCoordinates::Degree );
-            writer.writeCharacters( QString::number( lat, 'f', 10 ) );
-        }
+        KmlLineStringTagWriter::writeCoordinates( ring, writer );
 
         writer.writeEndElement();
         writer.writeEndElement();
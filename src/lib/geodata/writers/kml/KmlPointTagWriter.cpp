@@ -12,6 +12,7 @@
 
 #include "GeoDataPoint.h"
 #include "GeoDataTypes.h"
+#include "GeoFloatFormatter.h"
 #include "GeoWriter.h"
 #include "KmlElementDictionary.h"
 
@@ -37,13 +38,13 @@ bool KmlPointTagWriter::write( const GeoNode *node,
     //FIXME: this should be using the GeoDataCoordinates::toString but currently
     // it is not including the altitude and is adding an extra space after commas
 
-    coordinateString += QString::number( point->longitude( GeoDataCoordinates::Degree ), 'f', 10 );
+    GeoFloatFormatter::append( coordinateString, point->longitude( GeoDataCoordinates::Degree ), 10 );
     coordinateString += ',' ;
-    coordinateString += QString::number( point->latitude( GeoDataCoordinates::Degree ) , 'f', 10 );
+    GeoFloatFormatter::append( coordinateString, point->latitude( GeoDataCoordinates::Degree ), 10 );
 
     if( point->altitude() ) {
         coordinateString += ',';
-        coordinateString += QString::number( point->altitude() , 'f' , 10);
+        GeoFloatFormatter::append( coordinateString, point->altitude(), 10 );
     }
 
     writer.writeCharacters( coordinateString );
@@ -12,6 +12,7 @@
 
 #include "GeoDataTrack.h"
 #include "GeoDataTypes.h"
+#include "GeoFloatFormatter.h"
 #include "GeoWriter.h"
 #include "KmlElementDictionary.h"
 
@@ -27,14 +28,22 @@ bool KmlTrackWriter::write( const GeoNode *node, GeoWriter &writer ) const
 
     writer.writeStartElement( kml::kmlTag_Track );
 
+    // Reused for all points to avoid an allocation per coordinate
+    QString coord;
+    coord.reserve( 3 * GeoFloatFormatter::MaxLength + 2 );
+
     int points = track->size();
     for ( int i = 0; i < points; i++ ) {
         writer.writeElement( "when", track->whenList().at( i ).toString( Qt::ISODate ) );
 
         qreal lon, lat, alt;
         track->coordinatesList().at( i ).geoCoordinates( lon, lat, alt, GeoDataCoordinates::Degree );
-        QString coord = QString::number( lon, 'f', 10 ) + ' '
-                        + QString::number( lat, 'f', 10 ) + ' ' + QString::number( alt, 'f', 10 );
+        coord.resize( 0 );
+        GeoFloatFormatter::append( coord, lon, 10 );
+        coord += QLatin1Char( ' ' );
+        GeoFloatFormatter::append( coord, lat, 10 );
+        coord += QLatin1Char( ' ' );
+        GeoFloatFormatter::append( coord, alt, 10 );
 
         writer.writeElement( kml::kmlTag_nameSpaceGx22, "gx:coord", coord );
     }
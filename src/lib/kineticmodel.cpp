@@ -88,6 +88,11 @@ QPointF KineticModel::position() const
     return d_ptr->position;
 }
 
+QPointF KineticModel::velocity() const
+{
+    return d_ptr->velocity;
+}
+
 void KineticModel::setPosition(QPointF position)
 {
     setPosition( position.x(), position.y() );
@@ -49,6 +49,7 @@ public:
 
     int duration() const;
     QPointF position() const;
+    QPointF velocity() const;
     int updateInterval() const;
 
 public slots:
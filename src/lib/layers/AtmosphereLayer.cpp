@@ -25,6 +25,11 @@ QStringList AtmosphereLayer::renderPosition() const
     return QStringList() << "SURFACE";
 }
 
+QString AtmosphereLayer::layerName() const
+{
+    return "AtmosphereLayer";
+}
+
 bool AtmosphereLayer::render( GeoPainter *painter,
                               ViewportParams *viewParams,
                               const QString &renderPos,
@@ -22,6 +22,8 @@ class AtmosphereLayer : public LayerInterface
 public:
     virtual QStringList renderPosition() const;
 
+    virtual QString layerName() const;
+
     virtual bool render( GeoPainter *painter, ViewportParams *viewport,
        const QString& renderPos = "NONE", GeoSceneLayer * layer = 0 );
 
@@ -24,6 +24,11 @@ QStringList FogLayer::renderPosition() const
     return QStringList() << "ATMOSPHERE";
 }
 
+QString FogLayer::layerName() const
+{
+    return "FogLayer";
+}
+
 bool FogLayer::render( GeoPainter *painter,
                        ViewportParams *viewParams,
                        const QString &renderPos,
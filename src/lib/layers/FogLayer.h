@@ -24,6 +24,8 @@ class FogLayer : public LayerInterface
 public:
     virtual QStringList renderPosition() const;
 
+    virtual QString layerName() const;
+
     virtual bool render( GeoPainter *painter, ViewportParams *viewport,
        const QString& renderPos = "NONE", GeoSceneLayer * layer = 0 );
 };
@@ -12,19 +12,23 @@
 
 #include "FpsLayer.h"
 
+#include <QtCore/QMap>
 #include <QtCore/QPoint>
+#include <QtCore/QStringList>
 #include <QtCore/QTime>
 #include <QtGui/QFont>
 
 #include <limits>
 
 #include <GeoPainter.h>
+#include <RenderStatistics.h>
 
 namespace Marble
 {
 
-FpsLayer::FpsLayer( QTime *time )
-    : m_time( time )
+FpsLayer::FpsLayer( QTime *time, const RenderStatistics *statistics )
+    : m_time( time ),
+      m_statistics( statistics )
 {
 }
 
@@ -43,19 +47,45 @@ bool FpsLayer::render( GeoPainter *painter,
     Q_UNUSED( layer );
 
     const qreal fps = 1000.0 / (qreal)( m_time->elapsed() );
-    const QString fpsString = QString( "Speed: %1 fps" ).arg( fps, 5, 'f', 1, QChar(' ') );
-
-    const QPoint fpsLabelPos( 10, 20 );
+    QStringList lines;
+    lines << QString( "Speed: %1 fps" ).arg( fps, 5, 'f', 1, QChar(' ') );
+
+    if ( m_statistics && m_statistics->isEnabled() ) {
+        // The slowest stages first, layers and texture steps alike
+        QMultiMap<qreal, QString> stages;
+        foreach( const QString &stage, m_statistics->stages() ) {
+            if ( stage != "frame" ) {
+                stages.insert( -m_statistics->mean( stage ), stage );
+            }
+        }
+
+        QMultiMap<qreal, QString>::const_iterator it = stages.constBegin();
+        for ( int i = 0; i < 8 && it != stages.constEnd(); ++i, ++it ) {
+            lines << QString( "%1: %2 ms (p90 %3 ms)" ).arg( it.value() )
+                     .arg( -it.key(), 0, 'f', 1 )
+                     .arg( m_statistics->percentile( it.value(), 0.9 ), 0, 'f', 1 );
+        }
+
+        foreach( const QString &counter, m_statistics->counters() ) {
+            lines << QString( "%1: %2" ).arg( counter ).arg( m_statistics->counterMean( counter ), 0, 'f', 1 );
+        }
+    }
 
     painter->setFont( QFont( "Sans Serif", 10 ) );
+    const int lineHeight = painter->fontMetrics().height();
+
+    QPoint labelPos( 10, 20 );
+    foreach( const QString &line, lines ) {
+        painter->setPen( Qt::black );
+        painter->setBrush( Qt::black );
+        painter->drawText( labelPos, line );
 
-    painter->setPen( Qt::black );
-    painter->setBrush( Qt::black );
-    painter->drawText( fpsLabelPos, fpsString );
+        painter->setPen( Qt::white );
+        painter->setBrush( Qt::white );
+        painter->drawText( labelPos.x() - 1, labelPos.y() - 1, line );
 
-    painter->setPen( Qt::white );
-    painter->setBrush( Qt::white );
-    painter->drawText( fpsLabelPos.x() - 1, fpsLabelPos.y() - 1, fpsString );
+        labelPos.ry() += lineHeight;
+    }
 
     return true;
 }
@@ -18,10 +18,16 @@ class QTime;
 namespace Marble
 {
 
+class RenderStatistics;
+
+/**
+ * Shows the frame rate and, if the render statistics are enabled,
+ * the slowest stages and the counters of the recent frames.
+ */
 class FpsLayer : public LayerInterface
 {
 public:
-    explicit FpsLayer( QTime *time );
+    explicit FpsLayer( QTime *time, const RenderStatistics *statistics = 0 );
 
     /**
      * @reimp
@@ -41,6 +47,7 @@ public:
 
 private:
     QTime *const m_time;
+    const RenderStatistics *const m_statistics;
 };
 
 }
@@ -24,6 +24,8 @@
 #include "GeoDataTrack.h"
 #include "GeoDataTypes.h"
 #include "MarbleDebug.h"
+#include "PlacemarkRegistry.h"
+#include "RenderStatistics.h"
 #include "GeoDataFeature.h"
 #include "GeoPainter.h"
 #include "ViewportParams.h"
@@ -36,7 +38,6 @@
 
 // Qt
 #include <QtCore/QTime>
-#include <QtCore/QAbstractItemModel>
 
 namespace Marble
 {
@@ -56,44 +57,41 @@ QVector< int > GeometryLayer::s_weightfilter = QVector<int>()
 class GeometryLayerPrivate
 {
 public:
-    GeometryLayerPrivate( const QAbstractItemModel *model );
+    GeometryLayerPrivate( const PlacemarkRegistry *registry );
 
-    void createGraphicsItems( const GeoDataObject *object );
+    void createGraphicsItems( int first, int last );
     void createGraphicsItemFromGeometry( const GeoDataGeometry *object, const GeoDataPlacemark *placemark );
 
     QBrush m_currentBrush;
     QPen m_currentPen;
     GeoGraphicsScene m_scene;
-    const QAbstractItemModel *const m_model;
+    const PlacemarkRegistry *const m_registry;
+    RenderStatistics *m_statistics;
 };
 
-GeometryLayerPrivate::GeometryLayerPrivate( const QAbstractItemModel *model )
-    : m_model( model )
+GeometryLayerPrivate::GeometryLayerPrivate( const PlacemarkRegistry *registry )
+    : m_registry( registry ),
+      m_statistics( 0 )
 {
 }
 
-GeometryLayer::GeometryLayer( const QAbstractItemModel *model )
-        : d( new GeometryLayerPrivate( model ) )
+GeometryLayer::GeometryLayer( const PlacemarkRegistry *registry )
+        : d( new GeometryLayerPrivate( registry ) )
 {
     if ( !s_defaultValuesInitialized )
         initializeDefaultValues();
 
-    const GeoDataObject *object = static_cast<GeoDataObject*>( d->m_model->index( 0, 0, QModelIndex() ).internalPointer() );
-    if ( object && object->parent() )
-        d->createGraphicsItems( object->parent() );
+    d->createGraphicsItems( 0, registry->size() - 1 );
 
-    connect( model, SIGNAL( dataChanged( QModelIndex, QModelIndex ) ),
-             this, SLOT( invalidateScene() ) );
-    connect( model, SIGNAL( rowsInserted(const QModelIndex&, int, int) ),
-             this, SLOT( invalidateScene() ) );
-    connect( model, SIGNAL( rowsRemoved(const QModelIndex&, int, int) ),
-             this, SLOT( invalidateScene() ) );
-    connect( model, SIGNAL( modelReset() ),
+    connect( registry, SIGNAL( placemarksAdded( int, int ) ),
+             this, SLOT( addGraphicsItems( int, int ) ) );
+    connect( registry, SIGNAL( placemarksChanged() ),
              this, SLOT( invalidateScene() ) );
 }
 
 GeometryLayer::~GeometryLayer()
 {
+    qDeleteAll( d->m_scene.items() );
     delete d;
 }
 
@@ -102,6 +100,11 @@ QStringList GeometryLayer::renderPosition() const
     return QStringList( "HOVERS_ABOVE_SURFACE" );
 }
 
+QString GeometryLayer::layerName() const
+{
+    return "GeometryLayer";
+}
+
 void GeometryLayer::initializeDefaultValues()
 {
     for ( int i = 0; i < GeoDataFeature::LastIndex; i++ )
@@ -217,30 +220,33 @@ bool GeometryLayer::render( GeoPainter *painter, ViewportParams *viewport,
         maxZoomLevel++;
     
     QList<GeoGraphicsItem*> items = d->m_scene.items( viewport->viewLatLonAltBox(), maxZoomLevel );
+    int painted = 0;
     foreach( GeoGraphicsItem* item, items )
     {
-        if ( item->visible() )
+        if ( item->visible() ) {
             item->paint( painter, viewport, renderPos, layer );
+            ++painted;
+        }
     }
     painter->restore();
+
+    if ( d->m_statistics ) {
+        d->m_statistics->addCount( "geometries/painted", painted );
+    }
     return true;
 }
 
-void GeometryLayerPrivate::createGraphicsItems( const GeoDataObject *object )
+void GeometryLayer::setRenderStatistics( RenderStatistics *statistics )
 {
-    if ( const GeoDataPlacemark *placemark = dynamic_cast<const GeoDataPlacemark*>( object ) )
-    {
-        createGraphicsItemFromGeometry( placemark->geometry(), placemark );
-    }
+    d->m_statistics = statistics;
+}
 
-    // parse all child objects of the container
-    if ( const GeoDataContainer *container = dynamic_cast<const GeoDataContainer*>( object ) )
+void GeometryLayerPrivate::createGraphicsItems( int first, int last )
+{
+    for ( int i = first; i <= last; ++i )
     {
-        int rowCount = container->size();
-        for ( int row = 0; row < rowCount; ++row )
-        {
-            createGraphicsItems( container->child( row ) );
-        }
+        const GeoDataPlacemark *placemark = m_registry->placemark( i );
+        createGraphicsItemFromGeometry( placemark->geometry(), placemark );
     }
 }
 
@@ -285,22 +291,18 @@ void GeometryLayerPrivate::createGraphicsItemFromGeometry( const GeoDataGeometry
     m_scene.addIdem( item );
 }
 
+void GeometryLayer::addGraphicsItems( int first, int last )
+{
+    d->createGraphicsItems( first, last );
+    emit repaintNeeded();
+}
+
 void GeometryLayer::invalidateScene()
 {
-    QList<GeoGraphicsItem*> items = d->m_scene.items();
-    QList<GeoGraphicsItem*> deletedItems;
-    foreach( GeoGraphicsItem* item, items )
-    {
-        if( qBinaryFind( deletedItems, item ) != deletedItems.constEnd() )
-        {
-            delete item;
-            deletedItems.insert( qLowerBound( deletedItems.begin(), deletedItems.end(), item ), item );
-        }
-    }
+    qDeleteAll( d->m_scene.items() );
     d->m_scene.clear();
-    const GeoDataObject *object = static_cast<GeoDataObject*>( d->m_model->index( 0, 0, QModelIndex() ).internalPointer() );
-    if ( object && object->parent() )
-        d->createGraphicsItems( object->parent() );
+
+    d->createGraphicsItems( 0, d->m_registry->size() - 1 );
     emit repaintNeeded();
 }
 
@@ -19,12 +19,12 @@
 // Qt
 #include <QVector>
 
-class QAbstractItemModel;
-
 namespace Marble
 {
 class GeoDataDocument;
 class GeoPainter;
+class PlacemarkRegistry;
+class RenderStatistics;
 class ViewportParams;
 class GeometryLayerPrivate;
 
@@ -32,13 +32,20 @@ class GeometryLayer : public QObject, public LayerInterface
 {
     Q_OBJECT
 public:
-    GeometryLayer( const QAbstractItemModel *model );
+    GeometryLayer( const PlacemarkRegistry *registry );
     ~GeometryLayer();
 
     virtual QStringList renderPosition() const;
 
+    virtual QString layerName() const;
+
     virtual bool render( GeoPainter *painter, ViewportParams *viewport,
                          const QString& renderPos = "NONE", GeoSceneLayer * layer = 0 );
+
+    /**
+     * @brief Sets the statistics that the number of painted geometries is counted in
+     */
+    void setRenderStatistics( RenderStatistics *statistics );
     
     static int s_defaultZValues[GeoDataFeature::LastIndex];
     static int s_defaultMinZoomLevels[GeoDataFeature::LastIndex];
@@ -48,6 +55,12 @@ public:
 public Q_SLOTS:
     void invalidateScene();
 
+    /**
+     * Creates the graphics items of the placemarks @p first to @p last of the
+     * registry, leaving the rest of the scene untouched.
+     */
+    void addGraphicsItems( int first, int last );
+
 Q_SIGNALS:
     void repaintNeeded();
 
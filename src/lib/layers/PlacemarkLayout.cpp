@@ -29,7 +29,9 @@
 #include "PlacemarkPainter.h"
 #include "MarbleClock.h"
 #include "MarblePlacemarkModel.h"
+#include "PlacemarkRegistry.h"
 #include "MarbleDirs.h"
+#include "RenderStatistics.h"
 #include "ViewportParams.h"
 #include "TileId.h"
 #include "TileCoordsPyramid.h"
@@ -38,34 +40,32 @@
 
 using namespace Marble;
 
-PlacemarkLayout::PlacemarkLayout( QAbstractItemModel  *placemarkModel,
+static bool morePopular( const GeoDataPlacemark *left, const GeoDataPlacemark *right )
+{
+    return left->popularityIndex() > right->popularityIndex();
+}
+
+PlacemarkLayout::PlacemarkLayout( const PlacemarkRegistry *registry,
                                   QItemSelectionModel *selectionModel,
                                   MarbleClock *clock,
                                   QObject* parent )
     : QObject( parent ),
+      m_registry( registry ),
       m_selectionModel( selectionModel ),
       m_clock( clock ),
       m_placemarkPainter( 0 ),
       m_showPlaces( true ),
       m_maxLabelHeight( 0 ),
-      m_styleResetRequested( true )
+      m_styleResetRequested( true ),
+      m_statistics( 0 )
 {
-    m_placemarkModel.setSourceModel( placemarkModel );
-    m_placemarkModel.setDynamicSortFilter( true );
-    m_placemarkModel.setSortRole( MarblePlacemarkModel::PopularityIndexRole );
-    m_placemarkModel.sort( 0, Qt::DescendingOrder );
-
     connect( m_selectionModel,  SIGNAL( selectionChanged( QItemSelection,
                                                            QItemSelection) ),
              this,               SLOT( requestStyleReset() ) );
 
-    connect( &m_placemarkModel, SIGNAL( dataChanged( QModelIndex, QModelIndex ) ),
-             this, SLOT( setCacheData() ) );
-    connect( &m_placemarkModel, SIGNAL( rowsInserted(const QModelIndex&, int, int) ),
-             this, SLOT( setCacheData() ) );
-    connect( &m_placemarkModel, SIGNAL( rowsRemoved(const QModelIndex&, int, int) ),
-             this, SLOT( setCacheData() ) );
-    connect( &m_placemarkModel, SIGNAL( modelReset() ),
+    connect( m_registry, SIGNAL( placemarksAdded( int, int ) ),
+             this, SLOT( addPlacemarks( int, int ) ) );
+    connect( m_registry, SIGNAL( placemarksChanged() ),
              this, SLOT( setCacheData() ) );
 
 //  Old weightfilter array. Still here
@@ -302,16 +302,12 @@ int PlacemarkLayout::maxLabelHeight() const
             maxLabelHeight = textHeight; 
     }
 
-    for ( int i = 0; i < m_placemarkModel.rowCount(); ++i ) {
-        QModelIndex index = m_placemarkModel.index( i, 0 );
-        const GeoDataPlacemark *placemark = dynamic_cast<GeoDataPlacemark*>(qvariant_cast<GeoDataObject*>(index.data( MarblePlacemarkModel::ObjectPointerRole ) ));
-        if ( placemark ) {
-            const GeoDataStyle* style = placemark->style();
-            QFont labelFont = style->labelStyle().font();
-            int textHeight = QFontMetrics( labelFont ).height();
-            if ( textHeight > maxLabelHeight )
-                maxLabelHeight = textHeight;
-        }
+    for ( int i = 0; i < m_registry->size(); ++i ) {
+        const GeoDataStyle* style = m_registry->placemark( i )->style();
+        QFont labelFont = style->labelStyle().font();
+        int textHeight = QFontMetrics( labelFont ).height();
+        if ( textHeight > maxLabelHeight )
+            maxLabelHeight = textHeight;
     }
 
     //mDebug() <<"Detected maxLabelHeight: " << maxLabelHeight;
@@ -354,31 +350,46 @@ TileId PlacemarkLayout::placemarkToTileId( const GeoDataCoordinates& coords, int
 
 void PlacemarkLayout::setCacheData()
 {
-    const int rowCount = m_placemarkModel.rowCount();
+    const int size = m_registry->size();
 
     m_placemarkCache.clear();
     requestStyleReset();
-    for ( int i = 0; i != rowCount; ++i )
-    {
-        const QModelIndex& index = m_placemarkModel.index( i, 0 );
-        if( !index.isValid() ) {
-            mDebug() << "invalid index!!!";
-            continue;
+    for ( int i = 0; i < size; ++i ) {
+        bool ok;
+        const TileId key = placemarkTileId( i, &ok );
+        if ( ok ) {
+            m_placemarkCache[key].append( m_registry->placemark( i ) );
         }
+    }
 
-        const GeoDataPlacemark *placemark = static_cast<GeoDataPlacemark*>(qvariant_cast<GeoDataObject*>(index.data( MarblePlacemarkModel::ObjectPointerRole ) ));
+    // Most popular placemarks first, in insertion order otherwise
+    QMap<TileId, QList<const GeoDataPlacemark*> >::Iterator i = m_placemarkCache.begin();
+    QMap<TileId, QList<const GeoDataPlacemark*> >::Iterator const end = m_placemarkCache.end();
+    for (; i != end; ++i ) {
+        qStableSort( i.value().begin(), i.value().end(), morePopular );
+    }
 
-        bool ok;
-        GeoDataCoordinates coordinates = placemarkIconCoordinates( placemark, &ok );
+    emit repaintNeeded();
+}
+
+void PlacemarkLayout::addPlacemarks( int first, int last )
+{
+    Q_ASSERT( first <= last );
 
+    for ( int i = first; i <= last; ++i ) {
+        bool ok;
+        const TileId key = placemarkTileId( i, &ok );
         if ( !ok ) {
             continue;
         }
 
-        int popularity = (20 - placemark->popularityIndex())/2;
-        TileId key = placemarkToTileId( coordinates, popularity );
-        m_placemarkCache[key].append( placemark );
+        // Keep the placemarks of a tile sorted, most popular placemarks first
+        const GeoDataPlacemark *placemark = m_registry->placemark( i );
+        QList<const GeoDataPlacemark*> &placemarks = m_placemarkCache[key];
+        placemarks.insert( qUpperBound( placemarks.begin(), placemarks.end(), placemark, morePopular ), placemark );
     }
+
+    requestStyleReset();
     emit repaintNeeded();
 }
 
@@ -387,6 +398,11 @@ QStringList PlacemarkLayout::renderPosition() const
     return QStringList() << "HOVERS_ABOVE_SURFACE";
 }
 
+QString PlacemarkLayout::layerName() const
+{
+    return "PlacemarkLayout";
+}
+
 qreal PlacemarkLayout::zValue() const
 {
     return 2.0;
@@ -455,6 +471,11 @@ QList<const GeoDataPlacemark*> PlacemarkLayout::visiblePlacemarks( ViewportParam
     return placemarkList;
 }
 
+void PlacemarkLayout::setRenderStatistics( RenderStatistics *statistics )
+{
+    m_statistics = statistics;
+}
+
 bool PlacemarkLayout::render( GeoPainter *painter,
                               ViewportParams *viewport,
                               const QString &renderPos,
@@ -467,7 +488,7 @@ bool PlacemarkLayout::render( GeoPainter *painter,
          !m_showLandingSites && !m_showCraters && !m_showMaria )
         return true;
 
-    if ( m_placemarkModel.rowCount() <= 0 )
+    if ( m_registry->size() <= 0 )
         return true;
 
     if ( m_styleResetRequested ) {
@@ -620,6 +641,10 @@ bool PlacemarkLayout::render( GeoPainter *painter,
         }
     }
 
+    if ( m_statistics ) {
+        m_statistics->addCount( "labels/placed", m_paintOrder.size() );
+    }
+
     m_placemarkPainter.drawPlacemarks( painter, m_paintOrder, viewport );
 
     return true;
@@ -680,6 +705,22 @@ GeoDataCoordinates PlacemarkLayout::placemarkIconCoordinates( const GeoDataPlace
     return coordinates;
 }
 
+TileId PlacemarkLayout::placemarkTileId( int index, bool *ok ) const
+{
+    GeoDataCoordinates coordinates;
+    if ( m_registry->isTimeDependent( index ) ) {
+        coordinates = placemarkIconCoordinates( m_registry->placemark( index ), ok );
+    } else {
+        coordinates = m_registry->coordinate( index );
+        *ok = m_registry->hasIcon( index )
+              || qBinaryFind( m_acceptedVisualCategories, m_registry->visualCategory( index ) )
+                 != m_acceptedVisualCategories.constEnd();
+    }
+
+    const int popularity = ( 20 - m_registry->popularityIndex( index ) ) / 2;
+    return placemarkToTileId( coordinates, popularity );
+}
+
 QRect PlacemarkLayout::roomForLabel( const GeoDataStyle * style,
                                       const QVector<VisiblePlacemark*> &currentsec,
                                       const int x, const int y,
@@ -23,12 +23,10 @@
 #include <QtCore/QModelIndex>
 #include <QtCore/QRect>
 #include <QtCore/QVector>
-#include <QtGui/QSortFilterProxyModel>
 
 #include "GeoDataFeature.h"
 #include "PlacemarkPainter.h"
 
-class QAbstractItemModel;
 class QItemSelectionModel;
 class QPoint;
 
@@ -43,6 +41,8 @@ class GeoPainter;
 class GeoSceneLayer;
 class MarbleClock;
 class PlacemarkPainter;
+class PlacemarkRegistry;
+class RenderStatistics;
 class TileId;
 class VisiblePlacemark;
 class ViewportParams;
@@ -61,7 +61,7 @@ class PlacemarkLayout : public QObject, public LayerInterface
     /**
      * Creates a new place mark layout.
      */
-    PlacemarkLayout( QAbstractItemModel  *placemarkModel,
+    PlacemarkLayout( const PlacemarkRegistry *registry,
                      QItemSelectionModel *selectionModel,
                      MarbleClock *clock,
                      QObject *parent = 0 );
@@ -76,6 +76,11 @@ class PlacemarkLayout : public QObject, public LayerInterface
      */
     virtual QStringList renderPosition() const;
 
+    /**
+     * @reimp
+     */
+    virtual QString layerName() const;
+
     /**
      * @reimp
      */
@@ -89,6 +94,11 @@ class PlacemarkLayout : public QObject, public LayerInterface
 
     void setDefaultLabelColor( const QColor &color );
 
+    /**
+     * @brief Sets the statistics that the number of placed labels is counted in
+     */
+    void setRenderStatistics( RenderStatistics *statistics );
+
     /**
      * Returns a the maximum height of all possible labels.
      * WARNING: This is a really slow method as it traverses all placemarks
@@ -121,6 +131,12 @@ class PlacemarkLayout : public QObject, public LayerInterface
     void requestStyleReset();
     void setCacheData();
 
+    /**
+     * Adds the placemarks @p first to @p last of the registry to the cache. Cheaper
+     * than setCacheData() when placemarks are inserted in batches.
+     */
+    void addPlacemarks( int first, int last );
+
  Q_SIGNALS:
     void repaintNeeded();
 
@@ -137,6 +153,13 @@ class PlacemarkLayout : public QObject, public LayerInterface
      */
     GeoDataCoordinates placemarkIconCoordinates( const GeoDataPlacemark *placemark, bool *ok ) const;
 
+    /**
+     * Returns the cache tile of the placemark at @p index in the registry. Uses the
+     * coordinate cached by the registry unless it depends on the time. @p ok is set
+     * like in placemarkIconCoordinates().
+     */
+    TileId placemarkTileId( int index, bool *ok ) const;
+
     QRect  roomForLabel( const GeoDataStyle * style,
                          const QVector<VisiblePlacemark*> &currentsec,
                          const int x, const int y,
@@ -146,7 +169,7 @@ class PlacemarkLayout : public QObject, public LayerInterface
 
  private:
     Q_DISABLE_COPY( PlacemarkLayout )
-    QSortFilterProxyModel  m_placemarkModel;
+    const PlacemarkRegistry *const m_registry;
     QItemSelectionModel *const m_selectionModel;
     MarbleClock *const m_clock;
 
@@ -175,6 +198,8 @@ class PlacemarkLayout : public QObject, public LayerInterface
 
     int     m_maxLabelHeight;
     bool    m_styleResetRequested;
+
+    RenderStatistics *m_statistics;
 };
 
 }
@@ -12,8 +12,11 @@
 
 #include "TextureLayer.h"
 
+#include <cmath>
+
 #include <QtCore/qmath.h>
 #include <QtCore/QCache>
+#include <QtCore/QMultiMap>
 #include <QtCore/QPointer>
 #include <QtCore/QTimer>
 
@@ -25,6 +28,8 @@
 #include "GeoSceneGroup.h"
 #include "MarbleDebug.h"
 #include "MarbleDirs.h"
+#include "MathHelper.h"
+#include "RenderStatistics.h"
 #include "StackedTile.h"
 #include "StackedTileLoader.h"
 #include "SunLocator.h"
@@ -37,6 +42,11 @@ namespace Marble
 
 const int REPAINT_SCHEDULING_INTERVAL = 1000;
 
+// Maximum number of tiles decoded by prefetchTiles() per rendered frame, and
+// of tile downloads queued per call
+const int PREFETCH_DECODE_BUDGET = 2;
+const int PREFETCH_DOWNLOAD_BUDGET = 8;
+
 class TextureLayer::Private
 {
 public:
@@ -48,6 +58,10 @@ public:
     void updateTextureLayers();
     void updateTile( const TileId &tileId, const QImage &tileImage );
 
+    int tileLevel( int radius ) const;
+    int tileX( qreal lon, int level ) const;
+    int tileY( qreal lat, int level ) const;
+
 public:
     TextureLayer  *const m_parent;
     const SunLocator *const m_sunLocator;
@@ -58,6 +72,10 @@ public:
     QPointer<TextureColorizer> m_texcolorizer;
     QVector<const GeoSceneTexture *> m_textures;
     GeoSceneGroup *m_textureLayerSettings;
+    RenderStatistics *m_statistics;
+
+    // Tiles decoded by prefetchTiles() since the last rendered frame
+    int m_prefetchDecodes;
 
     // For scheduling repaints
     QTimer           m_repaintTimer;
@@ -74,6 +92,8 @@ TextureLayer::Private::Private( HttpDownloadManager *downloadManager,
     , m_texmapper( 0 )
     , m_texcolorizer( 0 )
     , m_textureLayerSettings( 0 )
+    , m_statistics( 0 )
+    , m_prefetchDecodes( 0 )
     , m_repaintTimer()
 {
 }
@@ -123,7 +143,51 @@ void TextureLayer::Private::updateTile( const TileId &tileId, const QImage &tile
     m_tileLoader.updateTile( tileId, tileImage );
 }
 
+int TextureLayer::Private::tileLevel( int radius ) const
+{
+    // choose the smaller dimension for selecting the tile level, leading to higher-resolution results
+    const int levelZeroWidth = m_tileLoader.tileSize().width() * m_tileLoader.tileColumnCount( 0 );
+    const int levelZeroHight = m_tileLoader.tileSize().height() * m_tileLoader.tileRowCount( 0 );
+    const int levelZeroMinDimension = qMin( levelZeroWidth, levelZeroHight );
+
+    qreal linearLevel = ( 4.0 * (qreal)( radius ) / (qreal)( levelZeroMinDimension ) );
+
+    if ( linearLevel < 1.0 )
+        linearLevel = 1.0; // Dirty fix for invalid entry linearLevel
+
+    // As our tile resolution doubles with each level we calculate
+    // the tile level from tilesize and the globe radius via log(2)
+
+    qreal tileLevelF = qLn( linearLevel ) / qLn( 2.0 );
+    int tileLevel = (int)( tileLevelF * 1.00001 ); // snap to the sharper tile level a tiny bit earlier
+                                                   // to work around rounding errors when the radius
+                                                   // roughly equals the global texture width
+
+//    mDebug() << "tileLevelF: " << tileLevelF << " tileLevel: " << tileLevel;
+
+    if ( tileLevel > m_tileLoader.maximumTileLevel() )
+        tileLevel = m_tileLoader.maximumTileLevel();
+
+    return tileLevel;
+}
+
+int TextureLayer::Private::tileX( qreal lon, int level ) const
+{
+    const int columns = m_tileLoader.tileColumnCount( level );
+    const int x = (int)( ( lon + M_PI ) / ( 2 * M_PI ) * columns );
+    return qBound( 0, x, columns - 1 );
+}
 
+int TextureLayer::Private::tileY( qreal lat, int level ) const
+{
+    const int rows = m_tileLoader.tileRowCount( level );
+    qreal position = ( M_PI / 2 - lat ) / M_PI;
+    if ( m_tileLoader.tileProjection() == GeoSceneTexture::Mercator ) {
+        const qreal maxLat = 85.05113 * DEG2RAD;
+        position = ( 1 - atanh( sin( qBound( -maxLat, lat, maxLat ) ) ) / M_PI ) / 2;
+    }
+    return qBound( 0, (int)( position * rows ), rows - 1 );
+}
 
 TextureLayer::TextureLayer( HttpDownloadManager *downloadManager,
                             const SunLocator *sunLocator )
@@ -150,6 +214,11 @@ QStringList TextureLayer::renderPosition() const
     return QStringList() << "SURFACE";
 }
 
+QString TextureLayer::layerName() const
+{
+    return "TextureLayer";
+}
+
 bool TextureLayer::showSunShading() const
 {
     return d->m_tileLoader.showSunShading();
@@ -169,34 +238,15 @@ bool TextureLayer::render( GeoPainter *painter, ViewportParams *viewport,
     // Stop repaint timer if it is already running
     d->m_repaintTimer.stop();
 
+    d->m_prefetchDecodes = 0;
+
     if ( d->m_textures.isEmpty() )
         return false;
 
     if ( !d->m_texmapper )
         return false;
 
-    // choose the smaller dimension for selecting the tile level, leading to higher-resolution results
-    const int levelZeroWidth = d->m_tileLoader.tileSize().width() * d->m_tileLoader.tileColumnCount( 0 );
-    const int levelZeroHight = d->m_tileLoader.tileSize().height() * d->m_tileLoader.tileRowCount( 0 );
-    const int levelZeroMinDimension = qMin( levelZeroWidth, levelZeroHight );
-
-    qreal linearLevel = ( 4.0 * (qreal)( viewport->radius() ) / (qreal)( levelZeroMinDimension ) );
-
-    if ( linearLevel < 1.0 )
-        linearLevel = 1.0; // Dirty fix for invalid entry linearLevel
-
-    // As our tile resolution doubles with each level we calculate
-    // the tile level from tilesize and the globe radius via log(2)
-
-    qreal tileLevelF = qLn( linearLevel ) / qLn( 2.0 );
-    int tileLevel = (int)( tileLevelF * 1.00001 ); // snap to the sharper tile level a tiny bit earlier
-                                                   // to work around rounding errors when the radius
-                                                   // roughly equals the global texture width
-
-//    mDebug() << "tileLevelF: " << tileLevelF << " tileLevel: " << tileLevel;
-
-    if ( tileLevel > d->m_tileLoader.maximumTileLevel() )
-        tileLevel = d->m_tileLoader.maximumTileLevel();
+    const int tileLevel = d->tileLevel( viewport->radius() );
 
     const bool changedTileLevel = tileLevel != d->m_texmapper->tileZoomLevel();
 
@@ -208,11 +258,67 @@ bool TextureLayer::render( GeoPainter *painter, ViewportParams *viewport,
     }
 
     const QRect dirtyRect = QRect( QPoint( 0, 0), viewport->size() );
+    RenderStatisticsTimer timer( d->m_statistics, "texture/map" );
     d->m_texmapper->mapTexture( painter, viewport, dirtyRect, d->m_texcolorizer );
 
     return true;
 }
 
+void TextureLayer::prefetchTiles( const ViewportParams *viewport, qreal lon, qreal lat, int radius )
+{
+    if ( d->m_textures.isEmpty() || !d->m_texmapper )
+        return;
+
+    const int level = d->tileLevel( radius );
+    const int columns = d->m_tileLoader.tileColumnCount( level );
+    const int rows = d->m_tileLoader.tileRowCount( level );
+    const int centerX = d->tileX( lon, level );
+    const int centerY = d->tileY( lat, level );
+
+    // The tiles covering the screen around the center of the view, which is
+    // where they are displayed approximately at their native resolution
+    const QSize tileSize = d->m_tileLoader.tileSize();
+    const int rangeX = qMin( viewport->width() / ( 2 * tileSize.width() ) + 1, columns / 2 );
+    const int rangeY = viewport->height() / ( 2 * tileSize.height() ) + 1;
+
+    // Visit them from the center outwards, the center is what the user looks at first
+    QMultiMap<int, TileId> tiles;
+    for ( int y = qMax( 0, centerY - rangeY ); y <= qMin( rows - 1, centerY + rangeY ); ++y ) {
+        for ( int dx = -rangeX; dx <= rangeX; ++dx ) {
+            const int x = ( centerX + dx + columns ) % columns;
+            const int dy = y - centerY;
+            tiles.insert( dx * dx + dy * dy, TileId( 0, level, x, y ) );
+        }
+    }
+
+    int downloads = 0;
+    QMultiMap<int, TileId>::const_iterator it = tiles.constBegin();
+    QMultiMap<int, TileId>::const_iterator const end = tiles.constEnd();
+    for (; it != end; ++it ) {
+        switch ( d->m_tileLoader.prefetchTile( it.value() ) ) {
+        case StackedTileLoader::TileInMemory:
+        case StackedTileLoader::TilePending:
+            break;
+        case StackedTileLoader::TileDecoded:
+            ++d->m_prefetchDecodes;
+            break;
+        case StackedTileLoader::TileDownloading:
+            ++downloads;
+            break;
+        }
+
+        // Leave the rest for later frames to not delay rendering the current view
+        if ( d->m_prefetchDecodes >= PREFETCH_DECODE_BUDGET || downloads >= PREFETCH_DOWNLOAD_BUDGET ) {
+            break;
+        }
+    }
+}
+
+void TextureLayer::cancelPrefetch()
+{
+    d->m_tileLoader.cancelPrefetch();
+}
+
 void TextureLayer::setShowSunShading( bool show )
 {
     disconnect( d->m_sunLocator, SIGNAL( positionChanged( qreal, qreal ) ),
@@ -242,6 +348,15 @@ void TextureLayer::setShowTileId( bool show )
     update();
 }
 
+void TextureLayer::setRenderStatistics( RenderStatistics *statistics )
+{
+    d->m_statistics = statistics;
+    d->m_tileLoader.setRenderStatistics( statistics );
+    if ( d->m_texcolorizer ) {
+        d->m_texcolorizer->setRenderStatistics( statistics );
+    }
+}
+
 void TextureLayer::setTextureColorizer( TextureColorizer *texcolorizer )
 {
     if ( d->m_texcolorizer ) {
@@ -251,6 +366,7 @@ void TextureLayer::setTextureColorizer( TextureColorizer *texcolorizer )
     d->m_texcolorizer = texcolorizer;
 
     if ( d->m_texcolorizer ) {
+        d->m_texcolorizer->setRenderStatistics( d->m_statistics );
         connect( d->m_texcolorizer, SIGNAL( datasetLoaded() ), SLOT( mapChanged() ) );
     }
 }
@@ -29,6 +29,7 @@ namespace Marble
 class GeoPainter;
 class GeoSceneGroup;
 class HttpDownloadManager;
+class RenderStatistics;
 class SunLocator;
 class TextureColorizer;
 class ViewportParams;
@@ -45,6 +46,8 @@ class TextureLayer : public QObject, public LayerInterface
 
     QStringList renderPosition() const;
 
+    QString layerName() const;
+
     bool showSunShading() const;
     bool showCityLights() const;
 
@@ -66,6 +69,30 @@ class TextureLayer : public QObject, public LayerInterface
     int preferredRadiusCeil( int radius ) const;
     int preferredRadiusFloor( int radius ) const;
 
+    /**
+     * @brief Sets the statistics that the steps of the texture pipeline are accounted to
+     */
+    void setRenderStatistics( RenderStatistics *statistics );
+
+    /**
+     * @brief Prepares the tiles of a view that the map is about to show
+     *
+     * The view is centered on @p lon, @p lat (in radian) with the given @p radius,
+     * and has the size and projection of @p viewport. Its tiles are decoded into
+     * the tile cache if they are available on disk and downloaded with low
+     * priority otherwise. Only a few tiles are decoded per rendered frame,
+     * shared by all calls, so that the tiles of the current view are never
+     * delayed: Call it repeatedly while the view is moving.
+     */
+    void prefetchTiles( const ViewportParams *viewport, qreal lon, qreal lat, int radius );
+
+    /**
+     * @brief Drops the downloads of prefetchTiles() which have not been started yet
+     *
+     * Call it when the view starts moving somewhere else than before.
+     */
+    void cancelPrefetch();
+
  public Q_SLOTS:
     bool render( GeoPainter *painter, ViewportParams *viewport,
                  const QString &renderPos = "NONE", GeoSceneLayer *layer = 0 );
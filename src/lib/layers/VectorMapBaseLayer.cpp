@@ -25,6 +25,11 @@ QStringList VectorMapBaseLayer::renderPosition() const
     return QStringList() << "SURFACE";
 }
 
+QString VectorMapBaseLayer::layerName() const
+{
+    return "VectorMapBaseLayer";
+}
+
 bool VectorMapBaseLayer::render( GeoPainter *painter,
                                  ViewportParams *viewport,
                                  const QString &renderPos,
@@ -25,6 +25,11 @@ QStringList VectorMapLayer::renderPosition() const
     return QStringList() << "SURFACE";
 }
 
+QString VectorMapLayer::layerName() const
+{
+    return "VectorMapLayer";
+}
+
 bool VectorMapLayer::render( GeoPainter *painter,
                              ViewportParams *viewport,
                              const QString &renderPos,
@@ -28,6 +28,11 @@ public:
      */
     virtual QStringList renderPosition() const;
 
+    /**
+     * @reimp
+     */
+    virtual QString layerName() const;
+
     /**
      * @reimp
      */
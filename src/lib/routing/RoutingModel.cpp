@@ -24,6 +24,7 @@
 #include "MarbleWidget.h"
 #include "global.h"
 #include "GeoDataExtendedData.h"
+#include "GeoFloatFormatter.h"
 
 #include <QtCore/QBuffer>
 #include <QtCore/QPointer>
@@ -256,7 +257,10 @@ bool RoutingModel::setCurrentRoute( GeoDataDocument* document )
 
 void RoutingModel::exportGpx( QIODevice *device ) const
 {
-    QString content( "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"no\" ?>\n" );
+    // Written to the device in chunks to keep the memory usage of long routes low
+    const int chunkSize = 64 * 1024;
+    QByteArray content( "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"no\" ?>\n" );
+    content.reserve( chunkSize + 1024 );
     content += "<gpx xmlns=\"http://www.topografix.com/GPX/1/1\" creator=\"Marble\" version=\"1.1\" ";
     content += "xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\" ";
     content += "xsi:schemaLocation=\"http://www.topografix.com/GPX/1/1 ";
@@ -270,21 +274,39 @@ void RoutingModel::exportGpx( QIODevice *device ) const
         qreal lon = segment.maneuver().position().longitude( GeoDataCoordinates::Degree );
         qreal lat = segment.maneuver().position().latitude( GeoDataCoordinates::Degree );
         QString const text = segment.maneuver().instructionText();
-        content += QString( "    <rtept lat=\"%1\" lon=\"%2\"><name>%3</name></rtept>\n" ).arg( lat, 0, 'f', 7 ).arg( lon, 0, 'f', 7 ).arg( text );
+        content += "    <rtept lat=\"";
+        GeoFloatFormatter::append( content, lat, 7 );
+        content += "\" lon=\"";
+        GeoFloatFormatter::append( content, lon, 7 );
+        content += "\"><name>";
+        content += text.toUtf8();
+        content += "</name></rtept>\n";
+        if ( content.size() >= chunkSize ) {
+            device->write( content );
+            content.resize( 0 ); // keeps the reserved buffer, unlike clear()
+        }
     }
     content += "  </rte>\n";
 
     content += "<trk>\n  <name>Route</name>\n    <trkseg>\n";
-    GeoDataLineString points = d->m_route.path();
+    const GeoDataLineString &points = d->m_route.path();
     for ( int i=0; i<points.size(); ++i ) {
         qreal lon = points[i].longitude( GeoDataCoordinates::Degree );
         qreal lat = points[i].latitude( GeoDataCoordinates::Degree );
-        content += QString( "      <trkpt lat=\"%1\" lon=\"%2\"></trkpt>\n" ).arg( lat, 0, 'f', 7 ).arg( lon, 0, 'f', 7 );
+        content += "      <trkpt lat=\"";
+        GeoFloatFormatter::append( content, lat, 7 );
+        content += "\" lon=\"";
+        GeoFloatFormatter::append( content, lon, 7 );
+        content += "\"></trkpt>\n";
+        if ( content.size() >= chunkSize ) {
+            device->write( content );
+            content.resize( 0 );
+        }
     }
     content += "    </trkseg>\n  </trk>\n";
     content += "</gpx>\n";
 
-    device->write( content.toUtf8() );
+    device->write( content );
 }
 
 void RoutingModel::clear()
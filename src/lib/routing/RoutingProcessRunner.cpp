@@ -0,0 +1,143 @@
+//
+// This file is part of the Marble Virtual Globe.
+//
+// This program is free software licensed under the GNU LGPL. You can
+// find a copy of this license in LICENSE.txt in the top directory of
+// the source code.
+//
+// Copyright 2026      agent <agent@local>
+//
+
+#include "RoutingProcessRunner.h"
+
+#include "MarbleDebug.h"
+
+#include <QtCore/QMultiHash>
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QProcess>
+#include <QtCore/QTime>
+
+namespace Marble
+{
+
+/** How often running jobs check whether they got cancelled, in milliseconds */
+static const int PollInterval = 50;
+
+class RoutingProcessRunnerPrivate
+{
+public:
+    /** A job that is running right now */
+    struct RunningJob
+    {
+        RunningJob() : cancelled( false ) {}
+
+        bool cancelled;
+    };
+
+    void add( const void *owner, RunningJob *job );
+
+    void remove( const void *owner, RunningJob *job );
+
+    bool isCancelled( const RunningJob *job ) const;
+
+    mutable QMutex m_mutex;
+
+    /** The running jobs of each owner. Owners are removed once their jobs finished. */
+    QMultiHash<const void*, RunningJob*> m_runningJobs;
+};
+
+RoutingProcessJob::RoutingProcessJob()
+    : environment( QProcessEnvironment::systemEnvironment() ),
+      timeout( 30 * 1000 ),
+      owner( 0 )
+{
+}
+
+void RoutingProcessRunnerPrivate::add( const void *owner, RunningJob *job )
+{
+    QMutexLocker locker( &m_mutex );
+    m_runningJobs.insert( owner, job );
+}
+
+void RoutingProcessRunnerPrivate::remove( const void *owner, RunningJob *job )
+{
+    QMutexLocker locker( &m_mutex );
+    m_runningJobs.remove( owner, job );
+}
+
+bool RoutingProcessRunnerPrivate::isCancelled( const RunningJob *job ) const
+{
+    QMutexLocker locker( &m_mutex );
+    return job->cancelled;
+}
+
+RoutingProcessRunner::RoutingProcessRunner()
+    : d( new RoutingProcessRunnerPrivate )
+{
+}
+
+RoutingProcessRunner::~RoutingProcessRunner()
+{
+    delete d;
+}
+
+RoutingProcessRunner* RoutingProcessRunner::instance()
+{
+    static RoutingProcessRunner runner;
+    return &runner;
+}
+
+RoutingProcessRunner::Result RoutingProcessRunner::execute( const RoutingProcessJob &job, QByteArray *output )
+{
+    Q_ASSERT( output );
+
+    RoutingProcessRunnerPrivate::RunningJob runningJob;
+    d->add( job.owner, &runningJob );
+
+    QProcess process;
+    process.setProcessEnvironment( job.environment );
+    process.setWorkingDirectory( job.workingDirectory );
+    process.start( job.program, job.arguments );
+    if ( !process.waitForStarted( 5000 ) ) {
+        mDebug() << "Couldn't start" << job.program << "from the current PATH.";
+        d->remove( job.owner, &runningJob );
+        return Failed;
+    }
+
+    QTime timer;
+    timer.start();
+    Result result = Finished;
+    while ( !process.waitForFinished( PollInterval ) ) {
+        if ( d->isCancelled( &runningJob ) ) {
+            result = Cancelled;
+        } else if ( timer.elapsed() > job.timeout ) {
+            mDebug() << "Couldn't stop" << job.program;
+            result = Failed;
+        }
+
+        if ( result != Finished ) {
+            process.kill();
+            process.waitForFinished( PollInterval );
+            break;
+        }
+    }
+
+    d->remove( job.owner, &runningJob );
+
+    if ( result == Finished ) {
+        *output = process.readAllStandardOutput();
+    }
+
+    return result;
+}
+
+void RoutingProcessRunner::cancel( const void *owner )
+{
+    QMutexLocker locker( &d->m_mutex );
+    foreach( RoutingProcessRunnerPrivate::RunningJob *job, d->m_runningJobs.values( owner ) ) {
+        job->cancelled = true;
+    }
+}
+
+}
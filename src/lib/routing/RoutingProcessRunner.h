@@ -0,0 +1,90 @@
+//
+// This file is part of the Marble Virtual Globe.
+//
+// This program is free software licensed under the GNU LGPL. You can
+// find a copy of this license in LICENSE.txt in the top directory of
+// the source code.
+//
+// Copyright 2026      agent <agent@local>
+//
+
+#ifndef MARBLE_ROUTINGPROCESSRUNNER_H
+#define MARBLE_ROUTINGPROCESSRUNNER_H
+
+#include "marble_export.h"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QProcessEnvironment>
+#include <QtCore/QStringList>
+
+namespace Marble
+{
+
+class RoutingProcessRunnerPrivate;
+
+/** Describes one invocation of an external routing backend */
+class MARBLE_EXPORT RoutingProcessJob
+{
+public:
+    RoutingProcessJob();
+
+    /** Name or path of the backend executable */
+    QString program;
+
+    QStringList arguments;
+
+    QProcessEnvironment environment;
+
+    QString workingDirectory;
+
+    /** Milliseconds to wait for the result */
+    int timeout;
+
+    /** Jobs of the same owner (usually the RouteRequest) are cancelled together */
+    const void *owner;
+};
+
+/**
+ * @short Runs external routing backends for runner plugins.
+ *
+ * Each job starts a backend process that answers just this request and exits.
+ * Running jobs can be cancelled when their route request changes, which kills
+ * their processes instead of waiting for obsolete results. All methods are
+ * thread safe and meant to be called from runner threads.
+ */
+class MARBLE_EXPORT RoutingProcessRunner
+{
+public:
+    enum Result {
+        Finished,  ///< The process finished, its stdout is returned
+        Failed,    ///< The backend could not be started or timed out
+        Cancelled  ///< The job was cancelled while running
+    };
+
+    static RoutingProcessRunner* instance();
+
+    /**
+     * Runs the job, blocking until it finished, failed or got cancelled.
+     * The output of the backend is stored in output.
+     */
+    Result execute( const RoutingProcessJob &job, QByteArray *output );
+
+    /**
+     * Stops all jobs of the given owner that are running right now. Jobs started
+     * afterwards are not affected.
+     */
+    void cancel( const void *owner );
+
+    ~RoutingProcessRunner();
+
+private:
+    RoutingProcessRunner();
+
+    Q_DISABLE_COPY( RoutingProcessRunner )
+
+    RoutingProcessRunnerPrivate* const d;
+};
+
+}
+
+#endif
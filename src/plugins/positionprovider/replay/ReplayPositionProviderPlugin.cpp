@@ -0,0 +1,365 @@
+//
+// This file is part of the Marble Virtual Globe.
+//
+// This program is free software licensed under the GNU LGPL. You can
+// find a copy of this license in LICENSE.txt in the top directory of
+// the source code.
+//
+// Copyright 2026      agent <agent@local>
+//
+
+#include "ReplayPositionProviderPlugin.h"
+
+#include "ReplayTrackReader.h"
+
+#include "GeoDataAccuracy.h"
+#include "MarbleDebug.h"
+#include "MarbleDirs.h"
+#include "MarbleMath.h"
+
+#include <QtCore/QTime>
+#include <QtCore/QTimer>
+#include <QtGui/QIcon>
+
+#include <cmath>
+#include <cstdlib>
+
+namespace Marble
+{
+
+/** Positions emitted at most in one go, to keep the event loop responsive at extreme rates */
+static const int MaxBatchSize = 1000;
+
+/** Interval of the replay statistics in the debug output, in milliseconds */
+static const int ReportInterval = 10000;
+
+class ReplayPositionProviderPluginPrivate
+{
+public:
+    ReplayPositionProviderPluginPrivate();
+
+    ~ReplayPositionProviderPluginPrivate();
+
+    void readConfiguration();
+
+    /** Reads the next position of the file into m_next, starting over if looping */
+    void readNext();
+
+    /** Milliseconds since the start of the replay when the position is due */
+    qreal dueTime( const ReplayFix &fix ) const;
+
+    /** Updates the current position. Returns false if it got dropped. */
+    bool update( const ReplayFix &fix );
+
+    GeoDataCoordinates addNoise( const GeoDataCoordinates &position ) const;
+
+    /** A normal distributed random number with mean 0 and standard deviation 1 */
+    static qreal gaussian();
+
+    static qreal random();
+
+    QString m_fileName;
+    qreal m_speedup;
+    qreal m_rate;
+    qreal m_noise;
+    qreal m_dropout;
+    bool m_loop;
+
+    ReplayTrackReader *m_reader;
+    QTimer m_timer;
+    QTime m_clock;
+
+    ReplayFix m_next;
+    bool m_hasNext;
+    int m_index;
+    QDateTime m_firstTime;
+    qreal m_passStart;
+
+    PositionProviderStatus m_status;
+    ReplayFix m_previous;
+    bool m_hasPrevious;
+    GeoDataCoordinates m_position;
+    qreal m_speed;
+    qreal m_direction;
+
+    int m_emitted;
+    int m_dropped;
+    QTime m_reportClock;
+};
+
+ReplayPositionProviderPluginPrivate::ReplayPositionProviderPluginPrivate() :
+    m_speedup( 1.0 ),
+    m_rate( 0.0 ),
+    m_noise( 0.0 ),
+    m_dropout( 0.0 ),
+    m_loop( false ),
+    m_reader( 0 ),
+    m_hasNext( false ),
+    m_index( -1 ),
+    m_passStart( 0.0 ),
+    m_status( PositionProviderStatusUnavailable ),
+    m_hasPrevious( false ),
+    m_speed( 0.0 ),
+    m_direction( 0.0 ),
+    m_emitted( 0 ),
+    m_dropped( 0 )
+{
+}
+
+ReplayPositionProviderPluginPrivate::~ReplayPositionProviderPluginPrivate()
+{
+    delete m_reader;
+}
+
+void ReplayPositionProviderPluginPrivate::readConfiguration()
+{
+    m_fileName = QString::fromLocal8Bit( qgetenv( "MARBLE_REPLAY_FILE" ) );
+    if ( m_fileName.isEmpty() ) {
+        m_fileName = MarbleDirs::path( "routing" ) + "/route.kml";
+    }
+
+    bool ok = false;
+    const qreal speedup = qgetenv( "MARBLE_REPLAY_SPEED" ).toDouble( &ok );
+    m_speedup = ok && speedup > 0.0 ? speedup : 1.0;
+    const qreal rate = qgetenv( "MARBLE_REPLAY_RATE" ).toDouble( &ok );
+    m_rate = ok && rate > 0.0 ? rate : 0.0;
+    m_noise = qMax<qreal>( 0.0, qgetenv( "MARBLE_REPLAY_NOISE" ).toDouble() );
+    m_dropout = qBound<qreal>( 0.0, qgetenv( "MARBLE_REPLAY_DROPOUT" ).toDouble(), 1.0 );
+    m_loop = qgetenv( "MARBLE_REPLAY_LOOP" ) == "1";
+
+    mDebug() << "Replaying" << m_fileName << "speed" << m_speedup << "rate" << m_rate
+             << "noise" << m_noise << "dropout" << m_dropout << "loop" << m_loop;
+}
+
+void ReplayPositionProviderPluginPrivate::readNext()
+{
+    m_hasNext = m_reader->readFix( &m_next );
+    if ( !m_hasNext && m_loop && m_index >= 0 && m_reader->rewind() ) {
+        m_passStart = m_clock.elapsed();
+        m_index = -1;
+        m_hasNext = m_reader->readFix( &m_next );
+    }
+
+    if ( m_hasNext ) {
+        ++m_index;
+        if ( m_index == 0 ) {
+            m_firstTime = m_next.time;
+        }
+    }
+}
+
+qreal ReplayPositionProviderPluginPrivate::dueTime( const ReplayFix &fix ) const
+{
+    if ( m_rate > 0.0 ) {
+        return m_passStart + m_index * 1000.0 / m_rate;
+    }
+
+    if ( fix.time.isValid() && m_firstTime.isValid() ) {
+        return m_passStart + m_firstTime.msecsTo( fix.time ) / m_speedup;
+    }
+
+    return m_passStart + m_index * 1000.0 / m_speedup;
+}
+
+bool ReplayPositionProviderPluginPrivate::update( const ReplayFix &fix )
+{
+    const ReplayFix previous = m_previous;
+    const bool hasPrevious = m_hasPrevious;
+    m_previous = fix;
+    m_hasPrevious = true;
+
+    if ( m_dropout > 0.0 && random() < m_dropout ) {
+        ++m_dropped;
+        return false;
+    }
+
+    qreal lon1, lat1, lon2, lat2;
+    previous.position.geoCoordinates( lon1, lat1 );
+    fix.position.geoCoordinates( lon2, lat2 );
+
+    if ( fix.speed >= 0.0 ) {
+        m_speed = fix.speed;
+    } else if ( hasPrevious && previous.time.isValid() && fix.time.isValid() && previous.time < fix.time ) {
+        const qreal distance = distanceSphere( lon1, lat1, lon2, lat2 ) * EARTH_RADIUS;
+        m_speed = distance * 1000.0 / previous.time.msecsTo( fix.time );
+    }
+
+    if ( fix.direction >= 0.0 ) {
+        m_direction = fix.direction;
+    } else if ( hasPrevious && ( lon1 != lon2 || lat1 != lat2 ) ) {
+        const qreal deltaLon = lon2 - lon1;
+        const qreal bearing = atan2( sin( deltaLon ) * cos( lat2 ),
+                                     cos( lat1 ) * sin( lat2 ) - sin( lat1 ) * cos( lat2 ) * cos( deltaLon ) );
+        m_direction = fmod( bearing * RAD2DEG + 360.0, 360.0 );
+    }
+
+    m_position = m_noise > 0.0 ? addNoise( fix.position ) : fix.position;
+    ++m_emitted;
+    return true;
+}
+
+GeoDataCoordinates ReplayPositionProviderPluginPrivate::addNoise( const GeoDataCoordinates &position ) const
+{
+    qreal lon, lat, alt;
+    position.geoCoordinates( lon, lat, alt );
+    const qreal north = gaussian() * m_noise;
+    const qreal east = gaussian() * m_noise;
+    lat += north / EARTH_RADIUS;
+    lon += east / ( EARTH_RADIUS * qMax<qreal>( 0.01, cos( lat ) ) );
+    return GeoDataCoordinates( lon, lat, alt + gaussian() * m_noise );
+}
+
+qreal ReplayPositionProviderPluginPrivate::gaussian()
+{
+    // Box-Muller transform
+    const qreal u = qMax<qreal>( random(), 1e-12 );
+    const qreal v = random();
+    return sqrt( -2.0 * log( u ) ) * cos( 2.0 * M_PI * v );
+}
+
+qreal ReplayPositionProviderPluginPrivate::random()
+{
+    return qrand() / ( RAND_MAX + 1.0 );
+}
+
+QString ReplayPositionProviderPlugin::name() const
+{
+    return tr( "Replay Position Provider Plugin" );
+}
+
+QString ReplayPositionProviderPlugin::nameId() const
+{
+    return "ReplayPositionProviderPlugin";
+}
+
+QString ReplayPositionProviderPlugin::guiString() const
+{
+    return tr( "GPS Position Simulation (Replay)" );
+}
+
+QString ReplayPositionProviderPlugin::description() const
+{
+    return tr( "Replays a recorded GPX, KML or NMEA track at a configurable rate." );
+}
+
+QIcon ReplayPositionProviderPlugin::icon() const
+{
+    return QIcon();
+}
+
+PositionProviderPlugin* ReplayPositionProviderPlugin::newInstance() const
+{
+    return new ReplayPositionProviderPlugin;
+}
+
+PositionProviderStatus ReplayPositionProviderPlugin::status() const
+{
+    return d->m_status;
+}
+
+GeoDataCoordinates ReplayPositionProviderPlugin::position() const
+{
+    return d->m_position;
+}
+
+GeoDataAccuracy ReplayPositionProviderPlugin::accuracy() const
+{
+    GeoDataAccuracy result;
+
+    // faked values
+    result.level = GeoDataAccuracy::Detailed;
+    result.horizontal = qMax<qreal>( 10.0, 2.0 * d->m_noise );
+    result.vertical = qMax<qreal>( 10.0, 2.0 * d->m_noise );
+
+    return result;
+}
+
+ReplayPositionProviderPlugin::ReplayPositionProviderPlugin() :
+    d( new ReplayPositionProviderPluginPrivate )
+{
+    d->m_timer.setSingleShot( true );
+    connect( &d->m_timer, SIGNAL( timeout() ), this, SLOT( replay() ) );
+}
+
+ReplayPositionProviderPlugin::~ReplayPositionProviderPlugin()
+{
+    delete d;
+}
+
+void ReplayPositionProviderPlugin::initialize()
+{
+    d->readConfiguration();
+
+    delete d->m_reader;
+    d->m_reader = new ReplayTrackReader( d->m_fileName );
+    if ( !d->m_reader->rewind() ) {
+        d->m_status = PositionProviderStatusError;
+        emit statusChanged( d->m_status );
+        return;
+    }
+
+    d->m_status = PositionProviderStatusAcquiring;
+    d->m_index = -1;
+    d->m_passStart = 0.0;
+    d->m_emitted = 0;
+    d->m_dropped = 0;
+    d->m_hasPrevious = false;
+    d->readNext();
+
+    d->m_clock.start();
+    d->m_reportClock.start();
+    d->m_timer.start( 0 );
+}
+
+bool ReplayPositionProviderPlugin::isInitialized() const
+{
+    return d->m_reader != 0;
+}
+
+qreal ReplayPositionProviderPlugin::speed() const
+{
+    return d->m_speed;
+}
+
+qreal ReplayPositionProviderPlugin::direction() const
+{
+    return d->m_direction;
+}
+
+void ReplayPositionProviderPlugin::replay()
+{
+    const qreal now = d->m_clock.elapsed();
+
+    int batch = 0;
+    while ( d->m_hasNext && d->dueTime( d->m_next ) <= now && batch < MaxBatchSize ) {
+        if ( d->update( d->m_next ) ) {
+            if ( d->m_status != PositionProviderStatusAvailable ) {
+                d->m_status = PositionProviderStatusAvailable;
+                emit statusChanged( d->m_status );
+            }
+            emit positionChanged( position(), accuracy() );
+        }
+        d->readNext();
+        ++batch;
+    }
+
+    if ( d->m_reportClock.elapsed() >= ReportInterval || !d->m_hasNext ) {
+        mDebug() << "Replayed" << d->m_emitted << "positions with" << d->m_emitted * 1000.0 / qMax( 1, d->m_reportClock.elapsed() )
+                 << "Hz," << d->m_dropped << "dropped";
+        d->m_emitted = 0;
+        d->m_dropped = 0;
+        d->m_reportClock.restart();
+    }
+
+    if ( d->m_hasNext ) {
+        d->m_timer.start( qMax( 0, qRound( d->dueTime( d->m_next ) - d->m_clock.elapsed() ) ) );
+    } else {
+        mDebug() << "Replay of" << d->m_fileName << "finished";
+    }
+}
+
+} // namespace Marble
+
+Q_EXPORT_PLUGIN2( ReplayPositionProviderPlugin, Marble::ReplayPositionProviderPlugin )
+
+#include "ReplayPositionProviderPlugin.moc"
@@ -0,0 +1,77 @@
+//
+// This file is part of the Marble Virtual Globe.
+//
+// This program is free software licensed under the GNU LGPL. You can
+// find a copy of this license in LICENSE.txt in the top directory of
+// the source code.
+//
+// Copyright 2026      agent <agent@local>
+//
+
+#ifndef MARBLE_REPLAYPOSITIONPROVIDERPLUGIN_H
+#define MARBLE_REPLAYPOSITIONPROVIDERPLUGIN_H
+
+#include "PositionProviderPlugin.h"
+
+namespace Marble
+{
+
+class ReplayPositionProviderPluginPrivate;
+
+/**
+ * @short Replays a recorded track for testing, possibly much faster than real time.
+ *
+ * The replay is configured with environment variables:
+ * - MARBLE_REPLAY_FILE: GPX, KML or NMEA file to replay. Defaults to the route
+ *   saved by Marble (routing/route.kml in the local Marble directory).
+ * - MARBLE_REPLAY_SPEED: Time multiplier applied to the timestamps of the file.
+ *   Defaults to 1. Positions without timestamps are one second apart.
+ * - MARBLE_REPLAY_RATE: Replays with this fixed rate in Hz instead, ignoring
+ *   the timestamps.
+ * - MARBLE_REPLAY_NOISE: Standard deviation in meters of random noise added
+ *   to each position.
+ * - MARBLE_REPLAY_DROPOUT: Probability (0 to 1) that a position is dropped.
+ * - MARBLE_REPLAY_LOOP: Starts again at the end of the file if set to 1.
+ *
+ * The latency from a position update to the next rendered frame is recorded
+ * as position/update-to-frame in the render statistics of the map.
+ */
+class ReplayPositionProviderPlugin: public PositionProviderPlugin
+{
+    Q_OBJECT
+    Q_INTERFACES( Marble::PositionProviderPluginInterface )
+
+public:
+    ReplayPositionProviderPlugin();
+    virtual ~ReplayPositionProviderPlugin();
+
+    // Implementing PluginInterface
+    virtual QString name() const;
+    virtual QString nameId() const;
+    virtual QString guiString() const;
+    virtual QString description() const;
+    virtual QIcon icon() const;
+    virtual void initialize();
+    virtual bool isInitialized() const;
+    virtual qreal speed() const;
+    virtual qreal direction() const;
+
+    // Implementing PositionProviderPlugin
+    virtual PositionProviderPlugin * newInstance() const;
+
+    // Implementing PositionProviderPluginInterface
+    virtual PositionProviderStatus status() const;
+    virtual GeoDataCoordinates position() const;
+    virtual GeoDataAccuracy accuracy() const;
+
+private Q_SLOTS:
+    /** Emits all positions that are due and schedules the next one */
+    void replay();
+
+private:
+    ReplayPositionProviderPluginPrivate* const d;
+};
+
+}
+
+#endif // MARBLE_REPLAYPOSITIONPROVIDERPLUGIN_H
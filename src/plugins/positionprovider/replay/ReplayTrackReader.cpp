@@ -0,0 +1,322 @@
+//
+// This file is part of the Marble Virtual Globe.
+//
+// This program is free software licensed under the GNU LGPL. You can
+// find a copy of this license in LICENSE.txt in the top directory of
+// the source code.
+//
+// Copyright 2026      agent <agent@local>
+//
+
+#include "ReplayTrackReader.h"
+
+#include "MarbleDebug.h"
+
+#include <QtCore/QFileInfo>
+#include <QtCore/QRegExp>
+#include <QtCore/QStringList>
+
+namespace Marble
+{
+
+ReplayFix::ReplayFix()
+    : speed( -1.0 ),
+      direction( -1.0 )
+{
+}
+
+ReplayTrackReader::ReplayTrackReader( const QString &fileName )
+    : m_file( fileName ),
+      m_format( Kml ),
+      m_inPoint( false ),
+      m_pointLon( 0.0 ),
+      m_pointLat( 0.0 ),
+      m_pointAlt( 0.0 ),
+      m_inLineString( false ),
+      m_inCoordinates( false ),
+      m_placemarkFixes( 0 ),
+      m_finished( false ),
+      m_nmeaValid( false )
+{
+    const QString suffix = QFileInfo( fileName ).suffix().toLower();
+    if ( suffix == "gpx" ) {
+        m_format = Gpx;
+    } else if ( suffix == "nmea" || suffix == "txt" || suffix == "log" ) {
+        m_format = Nmea;
+    }
+}
+
+bool ReplayTrackReader::rewind()
+{
+    m_file.close();
+    m_xml.clear();
+    m_inPoint = false;
+    m_coordinatesText.clear();
+    m_inLineString = false;
+    m_inCoordinates = false;
+    m_placemarkFixes = 0;
+    m_finished = false;
+    m_whens.clear();
+    m_pending.clear();
+    m_nmeaEpoch.clear();
+    m_nmeaValid = false;
+    m_nmeaDate = QDate( 2000, 1, 1 );
+
+    if ( !m_file.open( QIODevice::ReadOnly ) ) {
+        mDebug() << "Cannot open track file" << m_file.fileName();
+        return false;
+    }
+
+    if ( m_format != Nmea ) {
+        m_xml.setDevice( &m_file );
+    }
+    return true;
+}
+
+bool ReplayTrackReader::readFix( ReplayFix *fix )
+{
+    if ( !m_pending.isEmpty() ) {
+        *fix = m_pending.takeFirst();
+        return true;
+    }
+
+    if ( !m_file.isOpen() || m_finished ) {
+        return false;
+    }
+
+    return m_format == Nmea ? readNmeaFix( fix ) : readXmlFix( fix );
+}
+
+bool ReplayTrackReader::readXmlFix( ReplayFix *fix )
+{
+    while ( !m_xml.atEnd() ) {
+        const QXmlStreamReader::TokenType token = m_xml.readNext();
+        const QStringRef name = m_xml.name();
+
+        if ( token == QXmlStreamReader::StartElement ) {
+            if ( m_format == Gpx && ( name == "trkpt" || name == "rtept" ) ) {
+                m_inPoint = true;
+                m_pointElement = name.toString();
+                m_pointFix = ReplayFix();
+                m_pointLon = m_xml.attributes().value( "lon" ).toString().toDouble();
+                m_pointLat = m_xml.attributes().value( "lat" ).toString().toDouble();
+                m_pointAlt = 0.0;
+            } else if ( m_format == Gpx && m_inPoint ) {
+                if ( name == "ele" ) {
+                    m_pointAlt = m_xml.readElementText().toDouble();
+                } else if ( name == "time" ) {
+                    m_pointFix.time = QDateTime::fromString( m_xml.readElementText(), Qt::ISODate );
+                } else if ( name == "speed" ) {
+                    m_pointFix.speed = m_xml.readElementText().toDouble();
+                } else if ( name == "course" ) {
+                    m_pointFix.direction = m_xml.readElementText().toDouble();
+                }
+            } else if ( m_format == Kml && name == "LineString" ) {
+                m_inLineString = true;
+            } else if ( m_format == Kml && m_inLineString && name == "coordinates" ) {
+                m_inCoordinates = true;
+                m_coordinatesText.clear();
+            } else if ( m_format == Kml && name == "when" ) {
+                // gx:Track lists all timestamps before the coordinates
+                m_whens << QDateTime::fromString( m_xml.readElementText(), Qt::ISODate );
+            } else if ( m_format == Kml && name == "coord" ) {
+                const QStringList values = m_xml.readElementText().split( ' ', QString::SkipEmptyParts );
+                if ( values.size() >= 2 ) {
+                    ReplayFix result;
+                    result.position = GeoDataCoordinates( values.at( 0 ).toDouble(), values.at( 1 ).toDouble(),
+                                                          values.size() > 2 ? values.at( 2 ).toDouble() : 0.0,
+                                                          GeoDataCoordinates::Degree );
+                    if ( !m_whens.isEmpty() ) {
+                        result.time = m_whens.takeFirst();
+                    }
+                    ++m_placemarkFixes;
+                    *fix = result;
+                    return true;
+                }
+            }
+        } else if ( token == QXmlStreamReader::Characters && m_inCoordinates ) {
+            // Large coordinate lists are delivered in several parts
+            m_coordinatesText += m_xml.text();
+            parseKmlCoordinates( false );
+            if ( !m_pending.isEmpty() ) {
+                *fix = m_pending.takeFirst();
+                return true;
+            }
+        } else if ( token == QXmlStreamReader::EndElement ) {
+            if ( m_format == Gpx && m_inPoint && name == m_pointElement ) {
+                m_inPoint = false;
+                m_pointFix.position = GeoDataCoordinates( m_pointLon, m_pointLat, m_pointAlt,
+                                                          GeoDataCoordinates::Degree );
+                *fix = m_pointFix;
+                return true;
+            } else if ( m_format == Kml && m_inCoordinates && name == "coordinates" ) {
+                m_inCoordinates = false;
+                parseKmlCoordinates( true );
+                if ( !m_pending.isEmpty() ) {
+                    *fix = m_pending.takeFirst();
+                    return true;
+                }
+            } else if ( m_format == Kml && name == "LineString" ) {
+                m_inLineString = false;
+            } else if ( m_format == Kml && name == "Placemark" && m_placemarkFixes > 0 ) {
+                // Only the first placemark with a track is replayed
+                m_finished = true;
+                return false;
+            }
+        }
+    }
+
+    if ( m_xml.hasError() ) {
+        mDebug() << "Error reading" << m_file.fileName() << ":" << m_xml.errorString();
+    }
+
+    return false;
+}
+
+void ReplayTrackReader::parseKmlCoordinates( bool final )
+{
+    const bool complete = final || m_coordinatesText.isEmpty()
+                          || m_coordinatesText.at( m_coordinatesText.size() - 1 ).isSpace();
+    QStringList tuples = m_coordinatesText.split( QRegExp( "\\s+" ), QString::SkipEmptyParts );
+
+    // The last tuple may continue in the next part of the text
+    m_coordinatesText.clear();
+    if ( !complete && !tuples.isEmpty() ) {
+        m_coordinatesText = tuples.takeLast();
+    }
+
+    foreach( const QString &tuple, tuples ) {
+        const QStringList values = tuple.split( ',' );
+        if ( values.size() >= 2 ) {
+            ReplayFix result;
+            result.position = GeoDataCoordinates( values.at( 0 ).toDouble(), values.at( 1 ).toDouble(),
+                                                  values.size() > 2 ? values.at( 2 ).toDouble() : 0.0,
+                                                  GeoDataCoordinates::Degree );
+            m_pending << result;
+            ++m_placemarkFixes;
+        }
+    }
+}
+
+bool ReplayTrackReader::readNmeaFix( ReplayFix *fix )
+{
+    while ( !m_file.atEnd() ) {
+        const QByteArray line = m_file.readLine().trimmed();
+        if ( parseNmeaSentence( line, fix ) ) {
+            return true;
+        }
+    }
+
+    if ( m_nmeaValid ) {
+        *fix = m_nmeaFix;
+        m_nmeaValid = false;
+        return true;
+    }
+
+    return false;
+}
+
+bool ReplayTrackReader::parseNmeaSentence( const QByteArray &sentence, ReplayFix *completed )
+{
+    if ( !sentence.startsWith( '$' ) ) {
+        return false;
+    }
+
+    QByteArray data = sentence.mid( 1 );
+    const int checksumIndex = data.indexOf( '*' );
+    if ( checksumIndex >= 0 ) {
+        quint8 checksum = 0;
+        for ( int i = 0; i < checksumIndex; ++i ) {
+            checksum ^= quint8( data.at( i ) );
+        }
+        bool ok = false;
+        if ( data.mid( checksumIndex + 1, 2 ).toUInt( &ok, 16 ) != checksum || !ok ) {
+            return false;
+        }
+        data.truncate( checksumIndex );
+    }
+
+    const QList<QByteArray> fields = data.split( ',' );
+    if ( fields.isEmpty() || fields.at( 0 ).size() < 5 ) {
+        return false;
+    }
+
+    const QByteArray type = fields.at( 0 ).mid( 2 );
+    const bool isRmc = type == "RMC" && fields.size() >= 10;
+    const bool isGga = type == "GGA" && fields.size() >= 10;
+    if ( !isRmc && !isGga ) {
+        return false;
+    }
+
+    if ( ( isRmc && fields.at( 2 ) != "A" ) || ( isGga && fields.at( 6 ).toInt() == 0 ) ) {
+        // No fix
+        return false;
+    }
+
+    // Sentences with the same time belong to the same fix
+    bool result = false;
+    const QByteArray epoch = fields.at( 1 );
+    const QTime previousTime = m_nmeaFix.time.time();
+    if ( epoch != m_nmeaEpoch ) {
+        if ( m_nmeaValid ) {
+            *completed = m_nmeaFix;
+            result = true;
+        }
+        m_nmeaEpoch = epoch;
+        m_nmeaFix = ReplayFix();
+        m_nmeaValid = false;
+    }
+
+    QTime time = QTime::fromString( QString::fromLatin1( epoch.left( 6 ) ), "hhmmss" );
+    const int fractionIndex = epoch.indexOf( '.' );
+    if ( time.isValid() && fractionIndex >= 0 ) {
+        time = time.addMSecs( qRound( epoch.mid( fractionIndex ).toDouble() * 1000 ) );
+    }
+
+    if ( isRmc ) {
+        const QDate date = QDate::fromString( QString::fromLatin1( fields.at( 9 ) ), "ddMMyy" );
+        if ( date.isValid() ) {
+            m_nmeaDate = date.year() < 1980 ? date.addYears( 100 ) : date;
+        }
+    } else if ( previousTime.isValid() && time.isValid() && time < previousTime ) {
+        // Midnight passed without a sentence carrying the date
+        m_nmeaDate = m_nmeaDate.addDays( 1 );
+    }
+
+    if ( time.isValid() ) {
+        m_nmeaFix.time = QDateTime( m_nmeaDate, time, Qt::UTC );
+    }
+
+    const int latIndex = isRmc ? 3 : 2;
+    const qreal lat = parseNmeaAngle( fields.at( latIndex ), fields.at( latIndex + 1 ) );
+    const qreal lon = parseNmeaAngle( fields.at( latIndex + 2 ), fields.at( latIndex + 3 ) );
+    const qreal alt = isGga ? fields.at( 9 ).toDouble() : m_nmeaFix.position.altitude();
+    m_nmeaFix.position = GeoDataCoordinates( lon, lat, alt, GeoDataCoordinates::Degree );
+
+    if ( isRmc ) {
+        if ( !fields.at( 7 ).isEmpty() ) {
+            m_nmeaFix.speed = fields.at( 7 ).toDouble() * 0.514444; // knots
+        }
+        if ( !fields.at( 8 ).isEmpty() ) {
+            m_nmeaFix.direction = fields.at( 8 ).toDouble();
+        }
+    }
+
+    m_nmeaValid = true;
+    return result;
+}
+
+qreal ReplayTrackReader::parseNmeaAngle( const QByteArray &value, const QByteArray &hemisphere )
+{
+    // (d)ddmm.mmmm
+    const int dot = value.indexOf( '.' );
+    const int degreeDigits = ( dot < 0 ? value.size() : dot ) - 2;
+    if ( degreeDigits < 1 ) {
+        return 0.0;
+    }
+
+    const qreal degrees = value.left( degreeDigits ).toDouble() + value.mid( degreeDigits ).toDouble() / 60.0;
+    return ( hemisphere == "S" || hemisphere == "W" ) ? -degrees : degrees;
+}
+
+}
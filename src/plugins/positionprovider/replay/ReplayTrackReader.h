@@ -0,0 +1,104 @@
+//
+// This file is part of the Marble Virtual Globe.
+//
+// This program is free software licensed under the GNU LGPL. You can
+// find a copy of this license in LICENSE.txt in the top directory of
+// the source code.
+//
+// Copyright 2026      agent <agent@local>
+//
+
+#ifndef MARBLE_REPLAYTRACKREADER_H
+#define MARBLE_REPLAYTRACKREADER_H
+
+#include "GeoDataCoordinates.h"
+
+#include <QtCore/QDateTime>
+#include <QtCore/QFile>
+#include <QtCore/QList>
+#include <QtCore/QXmlStreamReader>
+
+namespace Marble
+{
+
+/** A single position read from a track file */
+struct ReplayFix
+{
+    ReplayFix();
+
+    GeoDataCoordinates position;
+    QDateTime time;      ///< Invalid if the file has no timestamps
+    qreal speed;         ///< Meters per second, negative if unknown
+    qreal direction;     ///< Degrees clockwise from north, negative if unknown
+};
+
+/**
+ * @short Reads the positions of a GPX, KML or NMEA file one after another.
+ *
+ * The file is read incrementally while positions are requested, so even huge
+ * track logs can be replayed with constant memory. GPX track and route points,
+ * the line string or gx:Track of the first KML placemark that has one (like
+ * the route saved by Marble), and NMEA RMC and GGA sentences are supported.
+ * The format is determined by the file extension.
+ */
+class ReplayTrackReader
+{
+public:
+    explicit ReplayTrackReader( const QString &fileName );
+
+    /** Opens the file or starts reading it again from the beginning */
+    bool rewind();
+
+    /** Reads the next position. Returns false at the end of the file. */
+    bool readFix( ReplayFix *fix );
+
+private:
+    enum Format {
+        Gpx,
+        Kml,
+        Nmea
+    };
+
+    bool readXmlFix( ReplayFix *fix );
+
+    bool readNmeaFix( ReplayFix *fix );
+
+    /** Parses complete "lon,lat[,alt]" tuples of KML coordinates text */
+    void parseKmlCoordinates( bool final );
+
+    /** Merges the sentence into m_nmeaFix. Returns true if a previous fix was completed. */
+    bool parseNmeaSentence( const QByteArray &sentence, ReplayFix *completed );
+
+    static qreal parseNmeaAngle( const QByteArray &value, const QByteArray &hemisphere );
+
+    QFile m_file;
+    Format m_format;
+    QXmlStreamReader m_xml;
+
+    // GPX state
+    bool m_inPoint;
+    QString m_pointElement;
+    ReplayFix m_pointFix;
+    qreal m_pointLon;
+    qreal m_pointLat;
+    qreal m_pointAlt;
+
+    // KML state
+    QString m_coordinatesText;
+    bool m_inLineString;
+    bool m_inCoordinates;
+    int m_placemarkFixes;
+    bool m_finished;
+    QList<QDateTime> m_whens;
+    QList<ReplayFix> m_pending;
+
+    // NMEA state
+    ReplayFix m_nmeaFix;
+    QByteArray m_nmeaEpoch;
+    bool m_nmeaValid;
+    QDate m_nmeaDate;
+};
+
+}
+
+#endif
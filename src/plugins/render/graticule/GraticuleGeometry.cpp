@@ -0,0 +1,248 @@
+//
+// This file is part of the Marble Virtual Globe.
+//
+// This program is free software licensed under the GNU LGPL. You can
+// find a copy of this license in LICENSE.txt in the top directory of
+// the source code.
+//
+// Copyright 2026      agent <agent@local>
+//
+
+#include "GraticuleGeometry.h"
+
+#include <cmath>
+
+#include "AbstractProjection.h"
+#include "MathHelper.h"
+#include "Quaternion.h"
+#include "ViewportParams.h"
+
+namespace Marble
+{
+
+namespace
+{
+
+// Chords of at most this length (in pixel) deviate less than a pixel
+// from the ellipse arcs of the globe for all but the tiniest radii
+const qreal MaxSegmentLength = 10.0;
+
+const int MaxSegments = 1000;
+
+}
+
+GraticuleGeometry::GraticuleGeometry()
+    : m_projection( Spherical ),
+      m_width( 0.0 ),
+      m_height( 0.0 ),
+      m_radius( 0.0 ),
+      m_centerLon( 0.0 ),
+      m_centerY( 0.0 ),
+      m_minLat( -M_PI / 2 ),
+      m_maxLat( +M_PI / 2 ),
+      m_repeatX( false )
+{
+    for ( int i = 0; i < 3; ++i ) {
+        for ( int j = 0; j < 3; ++j ) {
+            m_axes[i][j] = i == j ? 1.0 : 0.0;
+        }
+    }
+}
+
+void GraticuleGeometry::setViewport( const ViewportParams *viewport )
+{
+    m_projection = viewport->projection();
+    m_width = viewport->width();
+    m_height = viewport->height();
+    m_radius = viewport->radius();
+    m_centerLon = viewport->centerLongitude();
+
+    const AbstractProjection *projection = viewport->currentProjection();
+    m_minLat = projection->minLat();
+    m_maxLat = projection->maxLat();
+    m_repeatX = projection->repeatX();
+
+    m_centerY = projectedLatitude( viewport->centerLatitude() );
+
+    // Rotating a point on the globe is linear, so rotating the axes once
+    // is enough to rotate any point given in spherical coordinates
+    const Quaternion inverseAxis = viewport->planetAxis().inverse();
+    for ( int i = 0; i < 3; ++i ) {
+        Quaternion axis( 0.0, i == Q_X ? 1.0 : 0.0, i == Q_Y ? 1.0 : 0.0, i == Q_Z ? 1.0 : 0.0 );
+        axis.rotateAroundAxis( inverseAxis );
+        for ( int j = 0; j < 3; ++j ) {
+            m_axes[i][j] = axis.v[j];
+        }
+    }
+}
+
+void GraticuleGeometry::latitudeLine( qreal latitude, qreal west, qreal east,
+                                      QVector<QPolygonF> &polylines ) const
+{
+    const qreal lat = latitude * DEG2RAD;
+
+    if ( m_projection == Spherical ) {
+        // Quaternion::fromSpherical( lon, lat ) is
+        // cos( lat ) * ( sin( lon ) * x + cos( lon ) * z ) + sin( lat ) * y
+        const qreal cosLat = cos( lat );
+        const qreal sinLat = sin( lat );
+        qreal center[3];
+        qreal cosAxis[3];
+        qreal sinAxis[3];
+        for ( int i = 0; i < 3; ++i ) {
+            center[i] = sinLat * m_axes[Q_Y][i];
+            cosAxis[i] = cosLat * m_axes[Q_Z][i];
+            sinAxis[i] = cosLat * m_axes[Q_X][i];
+        }
+        sphericalArc( center, cosAxis, sinAxis, west * DEG2RAD, east * DEG2RAD, polylines );
+        return;
+    }
+
+    if ( lat < m_minLat || lat > m_maxLat ) {
+        return;
+    }
+
+    // The center point gives labels at the line center a sensible position
+    const qreal y = flatY( lat );
+    QPolygonF polyline;
+    polyline << QPointF( flatX( west * DEG2RAD ), y )
+             << QPointF( flatX( ( west + east ) / 2 * DEG2RAD ), y )
+             << QPointF( flatX( east * DEG2RAD ), y );
+    appendRepeated( polyline, polylines );
+}
+
+void GraticuleGeometry::longitudeLine( qreal longitude, qreal south, qreal north,
+                                       QVector<QPolygonF> &polylines ) const
+{
+    const qreal lon = longitude * DEG2RAD;
+
+    if ( m_projection == Spherical ) {
+        const qreal cosLon = cos( lon );
+        const qreal sinLon = sin( lon );
+        const qreal center[3] = { 0.0, 0.0, 0.0 };
+        qreal cosAxis[3];
+        for ( int i = 0; i < 3; ++i ) {
+            cosAxis[i] = sinLon * m_axes[Q_X][i] + cosLon * m_axes[Q_Z][i];
+        }
+        sphericalArc( center, cosAxis, m_axes[Q_Y], south * DEG2RAD, north * DEG2RAD, polylines );
+        return;
+    }
+
+    const qreal southLat = qMax( south * DEG2RAD, m_minLat );
+    const qreal northLat = qMin( north * DEG2RAD, m_maxLat );
+    if ( southLat >= northLat ) {
+        return;
+    }
+
+    const qreal x = flatX( lon );
+    QPolygonF polyline;
+    polyline << QPointF( x, flatY( southLat ) )
+             << QPointF( x, flatY( ( southLat + northLat ) / 2 ) )
+             << QPointF( x, flatY( northLat ) );
+    appendRepeated( polyline, polylines );
+}
+
+qreal GraticuleGeometry::flatX( qreal lon ) const
+{
+    const qreal rad2Pixel = 2 * m_radius / M_PI;
+    return m_width / 2 + ( lon - m_centerLon ) * rad2Pixel;
+}
+
+qreal GraticuleGeometry::flatY( qreal lat ) const
+{
+    const qreal rad2Pixel = 2 * m_radius / M_PI;
+    return m_height / 2 - ( projectedLatitude( lat ) - m_centerY ) * rad2Pixel;
+}
+
+qreal GraticuleGeometry::projectedLatitude( qreal lat ) const
+{
+    return m_projection == Mercator ? atanh( sin( lat ) ) : lat;
+}
+
+void GraticuleGeometry::appendRepeated( const QPolygonF &polyline, QVector<QPolygonF> &polylines ) const
+{
+    const QRectF bounds = polyline.boundingRect();
+    if ( bounds.bottom() < 0 || bounds.top() > m_height ) {
+        return;
+    }
+
+    if ( !m_repeatX ) {
+        if ( isOnScreen( polyline ) ) {
+            polylines << polyline;
+        }
+        return;
+    }
+
+    // The map repeats every 360 degree
+    const qreal interval = 4 * m_radius;
+    const int first = static_cast<int>( ceil( -bounds.right() / interval ) );
+    const int last = static_cast<int>( floor( ( m_width - bounds.left() ) / interval ) );
+    for ( int i = first; i <= last; ++i ) {
+        polylines << polyline.translated( i * interval, 0.0 );
+    }
+}
+
+void GraticuleGeometry::sphericalArc( const qreal center[3], const qreal cosAxis[3], const qreal sinAxis[3],
+                                      qreal from, qreal to, QVector<QPolygonF> &polylines ) const
+{
+    // The circle is on the front side of the globe where its view z coordinate
+    // center[Q_Z] + amplitude * cos( t - phase ) is positive
+    const qreal amplitude = sqrt( cosAxis[Q_Z] * cosAxis[Q_Z] + sinAxis[Q_Z] * sinAxis[Q_Z] );
+
+    if ( center[Q_Z] >= amplitude ) {
+        appendArc( center, cosAxis, sinAxis, from, to, polylines );
+        return;
+    }
+
+    if ( center[Q_Z] <= -amplitude ) {
+        return;
+    }
+
+    const qreal phase = atan2( sinAxis[Q_Z], cosAxis[Q_Z] );
+    const qreal halfWidth = acos( -center[Q_Z] / amplitude );
+
+    // from and to are within [-pi, +pi], so neighboring periods suffice
+    for ( int period = -1; period <= 1; ++period ) {
+        const qreal offset = period * 2 * M_PI;
+        const qreal start = qMax( from, phase - halfWidth + offset );
+        const qreal end = qMin( to, phase + halfWidth + offset );
+        if ( start < end ) {
+            appendArc( center, cosAxis, sinAxis, start, end, polylines );
+        }
+    }
+}
+
+void GraticuleGeometry::appendArc( const qreal center[3], const qreal cosAxis[3], const qreal sinAxis[3],
+                                   qreal from, qreal to, QVector<QPolygonF> &polylines ) const
+{
+    const qreal cosAxisLength = sqrt( cosAxis[Q_X] * cosAxis[Q_X] + cosAxis[Q_Y] * cosAxis[Q_Y] );
+    const qreal sinAxisLength = sqrt( sinAxis[Q_X] * sinAxis[Q_X] + sinAxis[Q_Y] * sinAxis[Q_Y] );
+    const qreal screenRadius = m_radius * qMax( cosAxisLength, sinAxisLength );
+    const int segments = qBound( 1, static_cast<int>( ( to - from ) * screenRadius / MaxSegmentLength ) + 1,
+                                 MaxSegments );
+
+    QPolygonF polyline;
+    polyline.reserve( segments + 1 );
+    for ( int i = 0; i <= segments; ++i ) {
+        const qreal t = from + ( to - from ) * i / segments;
+        const qreal cosT = cos( t );
+        const qreal sinT = sin( t );
+        const qreal x = center[Q_X] + cosAxis[Q_X] * cosT + sinAxis[Q_X] * sinT;
+        const qreal y = center[Q_Y] + cosAxis[Q_Y] * cosT + sinAxis[Q_Y] * sinT;
+        polyline << QPointF( m_width / 2 + m_radius * x, m_height / 2 - m_radius * y );
+    }
+
+    if ( isOnScreen( polyline ) ) {
+        polylines << polyline;
+    }
+}
+
+bool GraticuleGeometry::isOnScreen( const QPolygonF &polyline ) const
+{
+    // Not QRectF::intersects(), straight lines have empty bounding rects
+    const QRectF bounds = polyline.boundingRect();
+    return bounds.right() >= 0 && bounds.left() <= m_width
+        && bounds.bottom() >= 0 && bounds.top() <= m_height;
+}
+
+}
@@ -0,0 +1,100 @@
+//
+// This file is part of the Marble Virtual Globe.
+//
+// This program is free software licensed under the GNU LGPL. You can
+// find a copy of this license in LICENSE.txt in the top directory of
+// the source code.
+//
+// Copyright 2026      agent <agent@local>
+//
+
+#ifndef MARBLE_GRATICULEGEOMETRY_H
+#define MARBLE_GRATICULEGEOMETRY_H
+
+#include <QtCore/QVector>
+#include <QtGui/QPolygonF>
+
+#include "global.h"
+
+namespace Marble
+{
+
+class ViewportParams;
+
+/**
+ * @brief Computes the screen shape of latitude circles and meridians
+ *
+ * Coordinate lines are straight lines in the flat projections and ellipse
+ * arcs in the spherical projection. Their screen coordinates are calculated
+ * directly from the projection parameters instead of tessellating line
+ * strings. Parts of lines on the far side of the globe or outside of the
+ * screen are culled. All angles are measured in degree.
+ */
+class GraticuleGeometry
+{
+ public:
+    GraticuleGeometry();
+
+    /**
+     * @brief Takes over the projection parameters of the given viewport
+     */
+    void setViewport( const ViewportParams *viewport );
+
+    /**
+     * @brief Appends the visible parts of a latitude circle to @p polylines
+     * @param west the longitude the line starts at
+     * @param east the longitude the line ends at, must be greater than @p west
+     */
+    void latitudeLine( qreal latitude, qreal west, qreal east,
+                       QVector<QPolygonF> &polylines ) const;
+
+    /**
+     * @brief Appends the visible parts of a meridian to @p polylines
+     * @param south the latitude the line starts at
+     * @param north the latitude the line ends at, must be greater than @p south
+     */
+    void longitudeLine( qreal longitude, qreal south, qreal north,
+                        QVector<QPolygonF> &polylines ) const;
+
+ private:
+    /** Screen x coordinate of a longitude (in radian) in the flat projections */
+    qreal flatX( qreal lon ) const;
+
+    /** Screen y coordinate of a latitude (in radian) in the flat projections */
+    qreal flatY( qreal lat ) const;
+
+    /** The latitude (in radian) mapped to the y axis of the flat projections, up to scale */
+    qreal projectedLatitude( qreal lat ) const;
+
+    /** Appends the visible copies of a polyline, taking repetitions of the map into account */
+    void appendRepeated( const QPolygonF &polyline, QVector<QPolygonF> &polylines ) const;
+
+    /**
+     * Appends the front side parts of the circle center + cosAxis * cos( t ) + sinAxis * sin( t )
+     * on the globe for t in [from, to] (in radian). The vectors are given in view coordinates.
+     */
+    void sphericalArc( const qreal center[3], const qreal cosAxis[3], const qreal sinAxis[3],
+                       qreal from, qreal to, QVector<QPolygonF> &polylines ) const;
+
+    void appendArc( const qreal center[3], const qreal cosAxis[3], const qreal sinAxis[3],
+                    qreal from, qreal to, QVector<QPolygonF> &polylines ) const;
+
+    bool isOnScreen( const QPolygonF &polyline ) const;
+
+    Projection m_projection;
+    qreal m_width;
+    qreal m_height;
+    qreal m_radius;
+    qreal m_centerLon;
+    /** The projected latitude of the center of the viewport in the flat projections */
+    qreal m_centerY;
+    qreal m_minLat;
+    qreal m_maxLat;
+    bool m_repeatX;
+    /** The x, y and z axis of the globe rotated into view coordinates */
+    qreal m_axes[3][3];
+};
+
+}
+
+#endif
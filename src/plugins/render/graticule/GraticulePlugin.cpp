@@ -14,7 +14,6 @@
 #include "MarbleDebug.h"
 #include "MarbleDirs.h"
 #include "GeoPainter.h"
-#include "GeoDataLineString.h"
 #include "Planet.h"
 #include "MarbleModel.h"
 #include "PluginAboutDialog.h"
@@ -41,7 +40,12 @@ GraticulePlugin::GraticulePlugin()
     : m_isInitialized( false ),
       m_settings(),
       ui_configWidget( 0 ),
-      m_configDialog( 0 )
+      m_configDialog( 0 ),
+      m_gridValid( false ),
+      m_gridProjection( Spherical ),
+      m_gridRadius( 0 ),
+      m_gridBold( false ),
+      m_gridAxialTilt( 0.0 )
 {
     setVersion( "1.0" );
     setCopyrightYear( 2009 );
@@ -281,12 +285,16 @@ bool GraticulePlugin::render( GeoPainter *painter, ViewportParams *viewport,
 
     painter->setFont( gridFont );
 
+    const bool boldGrid = painter->mapQuality() == HighQuality
+                          || painter->mapQuality() == PrintQuality;
+    updateGrid( viewport, boldGrid );
+
     if ( m_shadowPen != Qt::NoPen ) {
         painter->translate( +1.0, +1.0 );
-        renderGrid( painter, viewport, m_shadowPen, m_shadowPen, m_shadowPen );
+        renderGrid( painter, m_shadowPen, m_shadowPen, m_shadowPen );
         painter->translate( -1.0, -1.0 );
     }
-    renderGrid( painter, viewport, m_equatorCirclePen, m_tropicsCirclePen, m_gridCirclePen );
+    renderGrid( painter, m_equatorCirclePen, m_tropicsCirclePen, m_gridCirclePen );
 
     painter->restore();
 
@@ -298,59 +306,108 @@ qreal GraticulePlugin::zValue() const
     return 1.0;
 }
 
-void GraticulePlugin::renderGrid( GeoPainter *painter, ViewportParams *viewport,
-                                  const QPen& equatorCirclePen,
-                                  const QPen& tropicsCirclePen,
-                                  const QPen& gridCirclePen )
+void GraticulePlugin::updateGrid( const ViewportParams *viewport, bool boldGrid )
 {
-    // Render the normal grid
+    // Determine the planet's axial tilt
+    qreal axialTilt = RAD2DEG * marbleModel()->planet()->epsilon();
 
-    painter->setPen( gridCirclePen );
-    // painter->setPen( QPen( QBrush( Qt::white ), 0.75 ) );
+    if ( m_gridValid
+         && m_gridProjection == viewport->projection()
+         && m_gridRadius == viewport->radius()
+         && m_gridSize == viewport->size()
+         && m_gridPlanetAxis == viewport->planetAxis()
+         && m_gridBold == boldGrid
+         && m_gridAxialTilt == axialTilt ) {
+        return;
+    }
+
+    m_gridValid = true;
+    m_gridProjection = viewport->projection();
+    m_gridRadius = viewport->radius();
+    m_gridSize = viewport->size();
+    m_gridPlanetAxis = viewport->planetAxis();
+    m_gridBold = boldGrid;
+    m_gridAxialTilt = axialTilt;
+
+    for ( int i = 0; i < LineStyleCount; ++i ) {
+        m_screenLines[i].clear();
+    }
+    m_geometry.setViewport( viewport );
+
+    // The normal grid
 
     // calculate the angular distance between coordinate lines of the normal grid
     qreal normalDegreeStep = 360.0 / m_normalLineMap.lowerBound(viewport->radius()).value();
 
     GeoDataLatLonAltBox viewLatLonAltBox = viewport->viewLatLonAltBox();
 
-    renderLongitudeLines( painter, viewLatLonAltBox,
-                          normalDegreeStep, normalDegreeStep,
-                          LineStart | IgnoreXMargin );
-    renderLatitudeLines(  painter, viewLatLonAltBox, normalDegreeStep,
-                          LineStart | IgnoreYMargin );
+    addLongitudeLines( GridLineStyle, viewLatLonAltBox,
+                       normalDegreeStep, normalDegreeStep,
+                       LineStart | IgnoreXMargin );
+    addLatitudeLines(  GridLineStyle, viewLatLonAltBox, normalDegreeStep,
+                       LineStart | IgnoreYMargin );
 
-    // Render some non-cut off longitude lines ..
-    renderLongitudeLine( painter, +90.0, viewLatLonAltBox );
-    renderLongitudeLine( painter, -90.0, viewLatLonAltBox );
+    // Add some non-cut off longitude lines ..
+    addLongitudeLine( GridLineStyle, +90.0, viewLatLonAltBox );
+    addLongitudeLine( GridLineStyle, -90.0, viewLatLonAltBox );
 
-    // Render the bold grid
+    // The bold grid
 
-    if (    painter->mapQuality() == HighQuality
-         || painter->mapQuality() == PrintQuality ) {
+    if ( boldGrid ) {
+        // calculate the angular distance between coordinate lines of the bold grid
+        qreal boldDegreeStep = 360.0 / m_boldLineMap.lowerBound(viewport->radius()).value();
 
+        addLongitudeLines( BoldGridLineStyle, viewLatLonAltBox,
+                           boldDegreeStep, normalDegreeStep,
+                           NoLabel
+                           );
+        addLatitudeLines(  BoldGridLineStyle, viewLatLonAltBox, boldDegreeStep,
+                           NoLabel );
+    }
+
+    // The equator
+    addLatitudeLine( EquatorLineStyle, 0.0, viewLatLonAltBox, tr( "Equator" ) );
+
+    // The Prime Meridian and Antimeridian
+    addLongitudeLine( EquatorLineStyle, 0.0, viewLatLonAltBox, 0.0, tr( "Prime Meridian" ) );
+    addLongitudeLine( EquatorLineStyle, 180.0, viewLatLonAltBox, 0.0, tr( "Antimeridian" ) );
+
+    if ( axialTilt > 0 ) {
+        // The tropics
+        addLatitudeLine( TropicsLineStyle, +axialTilt, viewLatLonAltBox, tr( "Tropic of Cancer" )  );
+        addLatitudeLine( TropicsLineStyle, -axialTilt, viewLatLonAltBox, tr( "Tropic of Capricorn" ) );
+
+        // The arctics
+        addLatitudeLine( TropicsLineStyle, +90.0 - axialTilt, viewLatLonAltBox, tr( "Arctic Circle" ) );
+        addLatitudeLine( TropicsLineStyle, -90.0 + axialTilt, viewLatLonAltBox, tr( "Antarctic Circle" ) );
+    }
+}
+
+void GraticulePlugin::renderGrid( GeoPainter *painter,
+                                  const QPen& equatorCirclePen,
+                                  const QPen& tropicsCirclePen,
+                                  const QPen& gridCirclePen ) const
+{
+    // Render the normal grid
+
+    painter->setPen( gridCirclePen );
+    renderLines( painter, GridLineStyle );
+
+    // Render the bold grid
+
+    if ( !m_screenLines[BoldGridLineStyle].isEmpty() ) {
         QPen boldPen = gridCirclePen;
         boldPen.setWidthF( 1.5 );
         painter->setPen( boldPen );
-    
-        // calculate the angular distance between coordinate lines of the bold grid
-        qreal boldDegreeStep = 360.0 / m_boldLineMap.lowerBound(viewport->radius()).value();
-
-        renderLongitudeLines( painter, viewLatLonAltBox,
-                            boldDegreeStep, normalDegreeStep,
-                            NoLabel
-                            );
-        renderLatitudeLines(  painter, viewLatLonAltBox, boldDegreeStep,
-                            NoLabel );
+        renderLines( painter, BoldGridLineStyle );
     }
-                            
-    painter->setPen( equatorCirclePen );
 
-    // Render the equator
-    renderLatitudeLine( painter, 0.0, viewLatLonAltBox, tr( "Equator" ) );
+    // Render the equator and the meridians
+
+    painter->setPen( equatorCirclePen );
+    renderLines( painter, EquatorLineStyle );
 
-    // Render the Prime Meridian and Antimeridian
-    renderLongitudeLine( painter, 0.0, viewLatLonAltBox, 0.0, tr( "Prime Meridian" ) );
-    renderLongitudeLine( painter, 180.0, viewLatLonAltBox, 0.0, tr( "Antimeridian" ) );
+    // Render the tropics and the arctics
 
     QPen tropicsPen = tropicsCirclePen;
     if (   painter->mapQuality() != OutlineQuality
@@ -358,25 +415,22 @@ void GraticulePlugin::renderGrid( GeoPainter *painter, ViewportParams *viewport,
         tropicsPen.setStyle( Qt::DotLine );
     }
     painter->setPen( tropicsPen );
+    renderLines( painter, TropicsLineStyle );
+}
 
-    // Determine the planet's axial tilt
-    qreal axialTilt = RAD2DEG * marbleModel()->planet()->epsilon();
-
-    if ( axialTilt > 0 ) {
-        // Render the tropics
-        renderLatitudeLine( painter, +axialTilt, viewLatLonAltBox, tr( "Tropic of Cancer" )  );
-        renderLatitudeLine( painter, -axialTilt, viewLatLonAltBox, tr( "Tropic of Capricorn" ) );
-
-        // Render the arctics
-        renderLatitudeLine( painter, +90.0 - axialTilt, viewLatLonAltBox, tr( "Arctic Circle" ) );
-        renderLatitudeLine( painter, -90.0 + axialTilt, viewLatLonAltBox, tr( "Antarctic Circle" ) );
-    }    
+void GraticulePlugin::renderLines( GeoPainter *painter, LineStyle style ) const
+{
+    foreach( const ScreenLine &line, m_screenLines[style] ) {
+        foreach( const QPolygonF &polyline, line.polylines ) {
+            painter->drawPolyline( polyline, line.label, line.labelPositionFlags );
+        }
+    }
 }
 
-void GraticulePlugin::renderLatitudeLine( GeoPainter *painter, qreal latitude,
-                                          const GeoDataLatLonAltBox& viewLatLonAltBox,
-                                          const QString& lineLabel,
-                                          LabelPositionFlags labelPositionFlags )
+void GraticulePlugin::addLatitudeLine( LineStyle style, qreal latitude,
+                                       const GeoDataLatLonAltBox& viewLatLonAltBox,
+                                       const QString& lineLabel,
+                                       LabelPositionFlags labelPositionFlags )
 {
     qreal fromSouthLat = viewLatLonAltBox.south( GeoDataCoordinates::Degree );
     qreal toNorthLat   = viewLatLonAltBox.north( GeoDataCoordinates::Degree );
@@ -387,40 +441,31 @@ void GraticulePlugin::renderLatitudeLine( GeoPainter *painter, qreal latitude,
         return;
     }
 
-    GeoDataLineString line( Tessellate | RespectLatitudeCircle ) ;
+    ScreenLine line;
+    line.label = lineLabel;
+    line.labelPositionFlags = labelPositionFlags;
 
     qreal fromWestLon = viewLatLonAltBox.west( GeoDataCoordinates::Degree );
     qreal toEastLon   = viewLatLonAltBox.east( GeoDataCoordinates::Degree );
 
     if ( fromWestLon < toEastLon ) {
-        qreal step = ( toEastLon - fromWestLon ) * 0.25;
-
-        for ( int i = 0; i < 5; ++i ) {
-            line << GeoDataCoordinates( fromWestLon + i * step, latitude, 0.0, GeoDataCoordinates::Degree );
-        }
+        m_geometry.latitudeLine( latitude, fromWestLon, toEastLon, line.polylines );
     }
     else {
-        qreal step = ( +180.0 - toEastLon ) * 0.25;
-
-        for ( int i = 0; i < 5; ++i ) {
-            line << GeoDataCoordinates( toEastLon + i * step, latitude, 0.0, GeoDataCoordinates::Degree );
-        }
-
-        step = ( +180 + fromWestLon ) * 0.25;
-
-        for ( int i = 0; i < 5; ++i ) {
-            line << GeoDataCoordinates( -180 + i * step, latitude, 0.0, GeoDataCoordinates::Degree );
-        }
+        m_geometry.latitudeLine( latitude, fromWestLon, +180.0, line.polylines );
+        m_geometry.latitudeLine( latitude, -180.0, toEastLon, line.polylines );
     }
 
-    painter->drawPolyline( line, lineLabel, labelPositionFlags );     
+    if ( !line.polylines.isEmpty() ) {
+        m_screenLines[style] << line;
+    }
 }
 
-void GraticulePlugin::renderLongitudeLine( GeoPainter *painter, qreal longitude,
-                                           const GeoDataLatLonAltBox& viewLatLonAltBox, 
-                                           qreal polarGap,
-                                           const QString& lineLabel,
-                                           LabelPositionFlags labelPositionFlags )
+void GraticulePlugin::addLongitudeLine( LineStyle style, qreal longitude,
+                                        const GeoDataLatLonAltBox& viewLatLonAltBox, 
+                                        qreal polarGap,
+                                        const QString& lineLabel,
+                                        LabelPositionFlags labelPositionFlags )
 {
     qreal fromWestLon = viewLatLonAltBox.west( GeoDataCoordinates::Degree );
     qreal toEastLon   = viewLatLonAltBox.east( GeoDataCoordinates::Degree );
@@ -442,28 +487,25 @@ void GraticulePlugin::renderLongitudeLine( GeoPainter *painter, qreal longitude,
     qreal southLat = ( fromSouthLat < -90.0 + polarGap ) ? -90.0 + polarGap : fromSouthLat;
     qreal northLat = ( toNorthLat   > +90.0 - polarGap ) ? +90.0 - polarGap : toNorthLat;
 
-    GeoDataCoordinates n1( longitude, southLat, 0.0, GeoDataCoordinates::Degree );
-    GeoDataCoordinates n3( longitude, northLat, 0.0, GeoDataCoordinates::Degree );
+    if ( southLat >= northLat ) {
+        return;
+    }
 
-    GeoDataLineString line( Tessellate );
+    ScreenLine line;
+    line.label = lineLabel;
+    line.labelPositionFlags = labelPositionFlags;
+    m_geometry.longitudeLine( longitude, southLat, northLat, line.polylines );
 
-    if ( northLat > 0 && southLat < 0 )
-    {
-        GeoDataCoordinates n2( longitude, 0.0, 0.0, GeoDataCoordinates::Degree );
-        line << n1 << n2 << n3;
-    }
-    else {
-        line << n1 << n3;
+    if ( !line.polylines.isEmpty() ) {
+        m_screenLines[style] << line;
     }
-
-    painter->drawPolyline( line, lineLabel, labelPositionFlags );     
 }
 
-void GraticulePlugin::renderLatitudeLines( GeoPainter *painter,
-                                           const GeoDataLatLonAltBox& viewLatLonAltBox,
-                                           qreal step,
-                                           LabelPositionFlags labelPositionFlags
-                                         )
+void GraticulePlugin::addLatitudeLines( LineStyle style,
+                                        const GeoDataLatLonAltBox& viewLatLonAltBox,
+                                        qreal step,
+                                        LabelPositionFlags labelPositionFlags
+                                      )
 {
     if ( step <= 0 ) {
         return;
@@ -493,18 +535,18 @@ void GraticulePlugin::renderLatitudeLines( GeoPainter *painter,
 
         // Paint all latitude coordinate lines except for the equator
         if ( itStep != 0.0 ) {
-            renderLatitudeLine( painter, itStep, viewLatLonAltBox, label, labelPositionFlags );
+            addLatitudeLine( style, itStep, viewLatLonAltBox, label, labelPositionFlags );
         }
 
         itStep += step;
     }
 }
 
-void GraticulePlugin::renderLongitudeLines( GeoPainter *painter, 
-                                            const GeoDataLatLonAltBox& viewLatLonAltBox, 
-                                            qreal step, qreal polarGap,
-                                            LabelPositionFlags labelPositionFlags
-                                           )
+void GraticulePlugin::addLongitudeLines( LineStyle style,
+                                         const GeoDataLatLonAltBox& viewLatLonAltBox, 
+                                         qreal step, qreal polarGap,
+                                         LabelPositionFlags labelPositionFlags
+                                        )
 {
     if ( step <= 0 ) {
         return;
@@ -539,8 +581,8 @@ void GraticulePlugin::renderLongitudeLines( GeoPainter *painter,
 
             // Paint all longitude coordinate lines except for the meridians
             if ( itStep != 0.0 && itStep != 180.0 && itStep != -180.0 ) {
-                renderLongitudeLine( painter, itStep, viewLatLonAltBox, polarGap, 
-                                    label, labelPositionFlags );           
+                addLongitudeLine( style, itStep, viewLatLonAltBox, polarGap, 
+                                  label, labelPositionFlags );           
             }
 
             itStep += step;
@@ -565,8 +607,8 @@ void GraticulePlugin::renderLongitudeLines( GeoPainter *painter,
 
             // Paint all longitude coordinate lines except for the meridians
             if ( itStep != 0.0 && itStep != 180.0 && itStep != -180.0 ) {
-                renderLongitudeLine( painter, itStep, viewLatLonAltBox, polarGap, 
-                                    label, labelPositionFlags );           
+                addLongitudeLine( style, itStep, viewLatLonAltBox, polarGap, 
+                                  label, labelPositionFlags );           
             }
             itStep += step;
         }
@@ -587,8 +629,8 @@ void GraticulePlugin::renderLongitudeLines( GeoPainter *painter,
 
             // Paint all longitude coordinate lines except for the meridians
             if ( itStep != 0.0 && itStep != 180.0 && itStep != -180.0 ) {
-                renderLongitudeLine( painter, itStep, viewLatLonAltBox, polarGap, 
-                                    label, labelPositionFlags );           
+                addLongitudeLine( style, itStep, viewLatLonAltBox, polarGap, 
+                                  label, labelPositionFlags );           
             }
             itStep += step;
         }
@@ -654,6 +696,7 @@ void GraticulePlugin::initLineMaps( GeoDataCoordinates::Notation notation)
     m_boldLineMap[999999999]   = m_boldLineMap.value(262144000);     //  last
 
     m_currentNotation = notation;
+    m_gridValid = false;
 }
 
 }
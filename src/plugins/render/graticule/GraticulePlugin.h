@@ -19,7 +19,9 @@
 #include <QtCore/QObject>
 #include <QtCore/QVector>
 #include <QtCore/QHash>
+#include <QtCore/QSize>
 #include <QtGui/QPen>
+#include <QtGui/QPolygonF>
 #include <QtGui/QIcon>
 #include <QtGui/QColorDialog>
 #include <QtGui/QAbstractButton>
@@ -32,6 +34,8 @@
 
 #include "GeoDataCoordinates.h"
 #include "GeoDataLatLonAltBox.h"
+#include "GraticuleGeometry.h"
+#include "Quaternion.h"
 
 
 namespace Ui 
@@ -108,30 +112,56 @@ class GraticulePlugin : public RenderPlugin
 
 
  private:
+    /** The pens the coordinate lines are painted with */
+    enum LineStyle {
+        GridLineStyle,
+        BoldGridLineStyle,
+        EquatorLineStyle,
+        TropicsLineStyle,
+        LineStyleCount
+    };
+
+    /** A coordinate line in screen coordinates */
+    struct ScreenLine
+    {
+        QVector<QPolygonF> polylines;
+        QString label;
+        LabelPositionFlags labelPositionFlags;
+    };
+
+    /**
+     * @brief Computes the screen geometry of the coordinate grid for the viewport.
+     * The geometry is kept until the viewport changes.
+     * @param viewport the viewport
+     * @param boldGrid whether the bold grid is shown
+     */
+    void updateGrid( const ViewportParams *viewport, bool boldGrid );
+
      /**
-     * @brief Renders the coordinate grid within the defined view bounding box.
+     * @brief Paints the coordinate grid computed by updateGrid().
      * @param painter the painter used to draw the grid
-     * @param viewport the viewport
      */
-    void renderGrid( GeoPainter *painter, ViewportParams *viewport,
+    void renderGrid( GeoPainter *painter,
                      const QPen& equatorCirclePen,    
                      const QPen& tropicsCirclePen,
-                     const QPen& gridCirclePen );
+                     const QPen& gridCirclePen ) const;
+
+    void renderLines( GeoPainter *painter, LineStyle style ) const;
 
      /**
-     * @brief Renders a latitude line within the defined view bounding box.
-     * @param painter the painter used to draw the latitude line
+     * @brief Adds a latitude line within the defined view bounding box to the grid.
+     * @param style the pen the line is painted with
      * @param latitude the latitude of the coordinate line measured in degree .
      * @param viewLatLonAltBox the latitude longitude bounding box that is covered by the view.
      */
-    void renderLatitudeLine(  GeoPainter *painter, qreal latitude,
-                              const GeoDataLatLonAltBox& viewLatLonAltBox = GeoDataLatLonAltBox(),
-                              const QString& lineLabel = QString(), 
-                              LabelPositionFlags labelPositionFlags = LineCenter );
+    void addLatitudeLine( LineStyle style, qreal latitude,
+                          const GeoDataLatLonAltBox& viewLatLonAltBox = GeoDataLatLonAltBox(),
+                          const QString& lineLabel = QString(), 
+                          LabelPositionFlags labelPositionFlags = LineCenter );
 
     /**
-     * @brief Renders a longitude line within the defined view bounding box.
-     * @param painter the painter used to draw the latitude line
+     * @brief Adds a longitude line within the defined view bounding box to the grid.
+     * @param style the pen the line is painted with
      * @param longitude the longitude of the coordinate line measured in degree .
      * @param viewLatLonAltBox the latitude longitude bounding box that is covered by the view.
      * @param polarGap the area around the poles in which most longitude lines are not drawn
@@ -140,27 +170,27 @@ class GraticulePlugin : public RenderPlugin
      *        The radius of the polarGap area is measured in degrees. 
      * @param lineLabel draws a label using the font and color properties set for the painter.
      */
-    void renderLongitudeLine( GeoPainter *painter, qreal longitude,                         
-                              const GeoDataLatLonAltBox& viewLatLonAltBox = GeoDataLatLonAltBox(),
-                              qreal polarGap = 0.0,
-                              const QString& lineLabel = QString(),
-                              LabelPositionFlags labelPositionFlags = LineCenter );
+    void addLongitudeLine( LineStyle style, qreal longitude,
+                           const GeoDataLatLonAltBox& viewLatLonAltBox = GeoDataLatLonAltBox(),
+                           qreal polarGap = 0.0,
+                           const QString& lineLabel = QString(),
+                           LabelPositionFlags labelPositionFlags = LineCenter );
 
     /**
-     * @brief Renders the latitude lines that are visible within the defined view bounding box.
-     * @param painter the painter used to draw the latitude lines
+     * @brief Adds the latitude lines that are visible within the defined view bounding box to the grid.
+     * @param style the pen the lines are painted with
      * @param viewLatLonAltBox the latitude longitude bounding box that is covered by the view.
      * @param step the angular distance between the lines measured in degrees .
      */
-    void renderLatitudeLines( GeoPainter *painter, 
-                              const GeoDataLatLonAltBox& viewLatLonAltBox,
-                              qreal step,
-                              LabelPositionFlags labelPositionFlags = LineCenter
-                            );
+    void addLatitudeLines( LineStyle style,
+                           const GeoDataLatLonAltBox& viewLatLonAltBox,
+                           qreal step,
+                           LabelPositionFlags labelPositionFlags = LineCenter
+                         );
 
     /**
-     * @brief Renders the latitude lines that are visible within the defined view bounding box.
-     * @param painter the painter used to draw the latitude lines
+     * @brief Adds the longitude lines that are visible within the defined view bounding box to the grid.
+     * @param style the pen the lines are painted with
      * @param viewLatLonAltBox the latitude longitude bounding box that is covered by the view.
      * @param step the angular distance between the lines measured in degrees .
      * @param polarGap the area around the poles in which most longitude lines are not drawn
@@ -168,12 +198,12 @@ class GraticulePlugin : public RenderPlugin
      *        concurring lines around the poles which obstruct the view onto the surface.
      *        The radius of the polarGap area is measured in degrees. 
      */
-    void renderLongitudeLines( GeoPainter *painter, 
-                              const GeoDataLatLonAltBox& viewLatLonAltBox, 
-                              qreal step, 
-                              qreal polarGap = 0.0,
-                              LabelPositionFlags labelPositionFlags = LineCenter
-                             );
+    void addLongitudeLines( LineStyle style,
+                            const GeoDataLatLonAltBox& viewLatLonAltBox, 
+                            qreal step, 
+                            qreal polarGap = 0.0,
+                            LabelPositionFlags labelPositionFlags = LineCenter
+                          );
 
     /**
      * @brief Maps the number of coordinate lines per 360 deg against the globe radius on the screen.
@@ -202,6 +232,18 @@ class GraticulePlugin : public RenderPlugin
         
     Ui::GraticuleConfigWidget *ui_configWidget;
     QDialog *m_configDialog;
+
+    GraticuleGeometry m_geometry;
+    QVector<ScreenLine> m_screenLines[LineStyleCount];
+
+    // The view m_screenLines were computed for
+    bool m_gridValid;
+    Projection m_gridProjection;
+    int m_gridRadius;
+    QSize m_gridSize;
+    Quaternion m_gridPlanetAxis;
+    bool m_gridBold;
+    qreal m_gridAxialTilt;
 };
 
 }
@@ -23,6 +23,7 @@
 #include "sgp4/sgp4ext.h"
 
 #include <QtCore/QDateTime>
+#include <QtCore/QtAlgorithms>
 #include <QtGui/QAction>
 #include <QtGui/QLabel>
 #include <QtGui/QVBoxLayout>
@@ -39,13 +40,16 @@ SatellitesItem::SatellitesItem( const QString &name, elsetrec satrec, const Marb
     : TrackerPluginItem( name ),
       m_showOrbit( false ),
       m_satrec( satrec ),
+      m_epoch( 0 ),
       m_track( new GeoDataTrack() ),
-      m_clock( clock )
+      m_clock( clock ),
+      m_prepared( false )
 {
     double tumin, mu, xke, j2, j3, j4, j3oj2;
     double radiusearthkm;
     getgravconst( wgs84, tumin, mu, radiusearthkm, xke, j2, j3, j4, j3oj2 );
     m_earthSemiMajorAxis = radiusearthkm;
+    m_epoch = timeAtEpoch().toTime_t();
 
     setDescription();
 
@@ -58,8 +62,6 @@ SatellitesItem::SatellitesItem( const QString &name, elsetrec satrec, const Marb
     placemark()->style()->lineStyle().setColor( oxygenBrickRed4 );
     placemark()->style()->lineStyle().setPenStyle( Qt::NoPen );
     placemark()->style()->labelStyle().setGlow( true );
-
-    update();
 }
 
 void SatellitesItem::setDescription()
@@ -77,44 +79,129 @@ void SatellitesItem::setDescription()
      placemark()->setDescription( description );
 }
 
-void SatellitesItem::update()
+void SatellitesItem::prepareUpdate()
 {
-    QDateTime startTime = m_clock->dateTime().addSecs( - 2 * 60 );
+    collectSampleTimes();
+    propagateSamples();
+    m_prepared = true;
+}
 
-    QDateTime endTime = startTime.addSecs( period() );
+void SatellitesItem::update()
+{
+    if ( !m_prepared ) {
+        prepareUpdate();
+    }
+    m_prepared = false;
+
+    m_track->removeBefore( m_startTime );
+    m_track->removeAfter( m_endTime );
+
+    for ( int i = 0; i < m_sampleWhen.size(); ++i ) {
+        const QDateTime &when = m_sampleWhen.at( i );
+        const GeoDataCoordinates coordinates( m_sampleLon.at( i ), m_sampleLat.at( i ),
+                                              m_sampleAlt.at( i ) );
+        // Most samples extend the track, avoid the sorted insertion for those
+        if ( m_track->size() == 0 || m_track->lastWhen() < when ) {
+            m_track->appendCoordinates( coordinates );
+            m_track->appendWhen( when );
+        } else {
+            m_track->addPoint( when, coordinates );
+        }
+    }
+}
 
-    m_track->removeBefore( startTime );
-    m_track->removeAfter( endTime );
+void SatellitesItem::collectSampleTimes()
+{
+    const QDateTime now = m_clock->dateTime();
+    m_startTime = now.addSecs( - 2 * 60 );
+    m_endTime = m_startTime.addSecs( period() );
+
+    // The part of the track within [m_startTime, m_endTime] survives the
+    // trimming in update() and does not need to be propagated again.
+    uint first = now.toTime_t();
+    uint last = first;
+    const QList<QDateTime> whenList = m_track->whenList();
+    QList<QDateTime>::const_iterator begin = qLowerBound( whenList.constBegin(),
+                                                          whenList.constEnd(), m_startTime );
+    QList<QDateTime>::const_iterator end = qUpperBound( begin, whenList.constEnd(), m_endTime );
+    if ( begin != end ) {
+        first = qMin( first, begin->toTime_t() );
+        last = qMax( last, ( end - 1 )->toTime_t() );
+    }
 
-    addPointAt( m_clock->dateTime() );
+    m_sampleWhen.clear();
+    m_sampleMinutes.clear();
 
     // time interval between each point in the track, in seconds
-    double step = period() / 100.0;
+    const double step = period() / 100.0;
+    const double endTime = m_endTime.toTime_t();
 
-    for ( double i = startTime.toTime_t(); i < endTime.toTime_t(); i += step ) {
+    bool nowAdded = false;
+    for ( double i = m_startTime.toTime_t(); i < endTime; i += step ) {
         // No need to add points in this interval
-        if ( i >= m_track->firstWhen().toTime_t() ) {
-            i = m_track->lastWhen().toTime_t() + step;
+        if ( i >= first ) {
+            m_sampleWhen.append( now );
+            nowAdded = true;
+            i = last + step;
+            if ( i >= endTime ) {
+                break;
+            }
         }
 
-        addPointAt( QDateTime::fromTime_t( i ) );
+        m_sampleWhen.append( QDateTime::fromTime_t( i ) );
+    }
+
+    if ( !nowAdded ) {
+        m_sampleWhen.append( now );
+    }
+
+    m_sampleMinutes.reserve( m_sampleWhen.size() );
+    foreach ( const QDateTime &when, m_sampleWhen ) {
+        m_sampleMinutes.append( ( (double)when.toTime_t() - m_epoch ) / 60.0 );
     }
 }
 
-void SatellitesItem::addPointAt( const QDateTime &dateTime )
+void SatellitesItem::propagateSamples()
 {
-    // in minutes
-    double timeSinceEpoch = (double)( dateTime.toTime_t() - timeAtEpoch().toTime_t() ) / 60.0;
-
-    double r[3], v[3];
-    sgp4( wgs84, m_satrec, timeSinceEpoch, r, v );
+    const int count = m_sampleWhen.size();
+    m_sampleX.resize( count );
+    m_sampleY.resize( count );
+    m_sampleZ.resize( count );
+
+    // SGP4 has to run sample by sample as it updates m_satrec, keep the
+    // valid results packed at the front of the arrays.
+    int valid = 0;
+    for ( int i = 0; i < count; ++i ) {
+        double r[3], v[3];
+        sgp4( wgs84, m_satrec, m_sampleMinutes.at( i ), r, v );
+        if ( m_satrec.error != 0 ) {
+            continue;
+        }
 
-    GeoDataCoordinates coordinates = fromTEME( r[0], r[1], r[2], gmst( timeSinceEpoch ) );
-    if ( m_satrec.error != 0 ) {
-        return;
+        m_sampleWhen[valid] = m_sampleWhen.at( i );
+        m_sampleMinutes[valid] = m_sampleMinutes.at( i );
+        m_sampleX[valid] = r[0];
+        m_sampleY[valid] = r[1];
+        m_sampleZ[valid] = r[2];
+        ++valid;
     }
 
-    m_track->addPoint( dateTime, coordinates);
+    m_sampleWhen.resize( valid );
+    m_sampleMinutes.resize( valid );
+    m_sampleLon.resize( valid );
+    m_sampleLat.resize( valid );
+    m_sampleAlt.resize( valid );
+
+    const double *minutes = m_sampleMinutes.constData();
+    const double *x = m_sampleX.constData();
+    const double *y = m_sampleY.constData();
+    const double *z = m_sampleZ.constData();
+    double *lon = m_sampleLon.data();
+    double *lat = m_sampleLat.data();
+    double *alt = m_sampleAlt.data();
+    for ( int i = 0; i < valid; ++i ) {
+        fromTEME( x[i], y[i], z[i], gmst( minutes[i] ), lon[i], lat[i], alt[i] );
+    }
 }
 
 QDateTime SatellitesItem::timeAtEpoch()
@@ -159,13 +246,14 @@ double SatellitesItem::inclination()
     return m_satrec.inclo / M_PI * 180;
 }
 
-GeoDataCoordinates SatellitesItem::fromTEME( double x, double y, double z, double gmst )
+void SatellitesItem::fromTEME( double x, double y, double z, double gmst,
+                               double &lon, double &lat, double &alt ) const
 {
-    double lon = atan2( y, x );
+    lon = atan2( y, x );
     // Rotate the angle by gmst (the origin goes from the vernal equinox point to the Greenwich Meridian)
     lon = GeoDataCoordinates::normalizeLon( fmod(lon - gmst, 2 * M_PI) );
 
-    double lat = atan2( z, sqrt( x*x + y*y ) );
+    lat = atan2( z, sqrt( x*x + y*y ) );
 
     //TODO: determine if this is worth the extra precision
     // Algorithm from http://celestrak.com/columns/v02n03/
@@ -179,11 +267,9 @@ GeoDataCoordinates SatellitesItem::fromTEME( double x, double y, double z, doubl
         lat = atan2( z + a * C * square( m_satrec.ecco ) * sin( latp ), R );
     }
 
-    double alt = R / cos( lat ) - a * C;
+    alt = ( R / cos( lat ) - a * C ) * 1000;
 
     lat = GeoDataCoordinates::normalizeLat( lat );
-
-    return GeoDataCoordinates( lon, lat, alt * 1000 );
 }
 
 double SatellitesItem::gmst( double minutesP )
@@ -193,7 +279,7 @@ double SatellitesItem::gmst( double minutesP )
     return fmod( m_satrec.gsto + rptim * minutesP, 2 * M_PI );
 }
 
-double SatellitesItem::square( double x )
+double SatellitesItem::square( double x ) const
 {
     return x * x;
 }
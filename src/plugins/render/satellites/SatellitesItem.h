@@ -18,6 +18,9 @@
 
 #include "sgp4/sgp4unit.h"
 
+#include <QtCore/QDateTime>
+#include <QtCore/QVector>
+
 namespace Marble {
 
 class GeoDataTrack;
@@ -29,6 +32,8 @@ class SatellitesItem : public TrackerPluginItem
 public:
     SatellitesItem( const QString &name, elsetrec satrec, const MarbleClock *clock );
 
+    void prepareUpdate();
+
     void update();
 
     void showOrbit( bool show );
@@ -37,26 +42,49 @@ private:
     bool m_showOrbit;
     double m_earthSemiMajorAxis; // in km
     elsetrec m_satrec;
+    uint m_epoch; // seconds since 1970-01-01T00:00:00 UTC
 
     GeoDataTrack *m_track;
 
     const MarbleClock *m_clock;
 
+    // Samples computed by prepareUpdate() and not yet added to m_track,
+    // kept as separate arrays so that the conversion loop stays tight.
+    bool m_prepared;
+    QDateTime m_startTime;
+    QDateTime m_endTime;
+    QVector<QDateTime> m_sampleWhen;
+    QVector<double> m_sampleMinutes; // since epoch
+    QVector<double> m_sampleX;
+    QVector<double> m_sampleY;
+    QVector<double> m_sampleZ;
+    QVector<double> m_sampleLon;
+    QVector<double> m_sampleLat;
+    QVector<double> m_sampleAlt;
+
     void setDescription();
 
     /**
-     * Add a point in the GeoDataTrack geometry of the placemark with time
-     * dateTime and coordinates of the satellite determined from m_satrec.
+     * Collect the times in the current orbit window which are not covered
+     * by m_track yet, including the current time, into m_sampleWhen.
+     */
+    void collectSampleTimes();
+
+    /**
+     * Propagate m_satrec to all times in m_sampleWhen and convert the
+     * results to geodetic coordinates. Samples for which SGP4 reports an
+     * error are dropped.
      */
-    void addPointAt( const QDateTime &dateTime );
+    void propagateSamples();
 
     /**
-     * Create a GeoDataCoordinates object from the cartesian coordinates
-     * @p x, @p y and @p z in km in the Earth-centered inertial frame known
-     * as TEME (True equator, Mean equinox) with Greenwich Mean Sidereal Time
-     * @p gmst in radians at time of observation.
+     * Convert the cartesian coordinates @p x, @p y and @p z in km in the
+     * Earth-centered inertial frame known as TEME (True equator, Mean equinox)
+     * with Greenwich Mean Sidereal Time @p gmst in radians at time of
+     * observation to longitude and latitude in radians and altitude in meters.
      */
-    GeoDataCoordinates fromTEME( double x, double y, double z, double gmst );
+    void fromTEME( double x, double y, double z, double gmst,
+                   double &lon, double &lat, double &alt ) const;
 
     /**
      * @return The time at the satellite epoch determined from m_satrec
@@ -95,7 +123,7 @@ private:
     /**
      * @return The square of @p x
      */
-    double square( double x );
+    double square( double x ) const;
 };
 
 }
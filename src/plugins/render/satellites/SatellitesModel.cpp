@@ -54,7 +54,7 @@ void SatellitesModel::parseFile( const QString &id, const QByteArray &file )
                     startmfe, stopmfe, deltamin, satrec );
         if ( satrec.error != 0 ) {
             mDebug() << "Error: " << satrec.error;
-            return;
+            break;
         }
 
         SatellitesItem *item = new SatellitesItem( satelliteName, satrec, m_clock );
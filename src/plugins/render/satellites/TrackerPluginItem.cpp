@@ -42,4 +42,8 @@ GeoDataPlacemark* TrackerPluginItem::placemark()
     return d->m_placemark;
 }
 
+void TrackerPluginItem::prepareUpdate()
+{
+}
+
 }
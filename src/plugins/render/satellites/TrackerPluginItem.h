@@ -42,6 +42,14 @@ public:
      */
     GeoDataPlacemark *placemark();
 
+    /**
+     * Reimplement this method to do the expensive part of an update, for example to
+     * compute new positions. If this item is in a TrackerPluginModel, this method is
+     * called on a worker thread for all items in parallel right before update().
+     * It must not modify the placemark, only state private to this item.
+     */
+    virtual void prepareUpdate();
+
     /**
      * Reimplement this method to update the placemark, for example to change its coordinates.
      * If this item is in a TrackerPluginModel, this method will be called regularly.
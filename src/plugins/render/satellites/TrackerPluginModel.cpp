@@ -22,10 +22,16 @@
 #include "TrackerPluginItem.h"
 
 #include <QtCore/QTimer>
+#include <QtCore/QtConcurrentMap>
 
 namespace Marble
 {
 
+static void prepareItemUpdate( TrackerPluginItem *item )
+{
+    item->prepareUpdate();
+}
+
 class TrackerPluginModelPrivate
 {
 public:
@@ -54,6 +60,9 @@ public:
 
     void update()
     {
+        // Compute all items in parallel, then publish the results on this thread in one go
+        QtConcurrent::blockingMap( m_itemVector, prepareItemUpdate );
+
         foreach( TrackerPluginItem *item, m_itemVector ) {
             item->update();
         }
@@ -123,6 +132,9 @@ void TrackerPluginModel::beginUpdateItems()
 
 void TrackerPluginModel::endUpdateItems()
 {
+    // Bring new items up to date in one parallel pass
+    d->update();
+
     if( d->m_enabled ) {
         d->m_treeModel->addDocument( d->m_document );
     }
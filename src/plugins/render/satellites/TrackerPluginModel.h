@@ -67,7 +67,7 @@ public:
      * End a series of add or remove items operations on the model.
      *
      * Always call this method once you're finished adding and removing items
-     * to the model.
+     * to the model. All items are updated before they are shown.
      * @see beginUpdateItems(), addItem(), removeItem()
      */
     void endUpdateItems();
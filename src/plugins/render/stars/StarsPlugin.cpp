@@ -15,6 +15,8 @@
 #include <QtCore/QDateTime>
 #include <QtGui/QRegion>
 
+#include <cmath>
+
 #include "MarbleClock.h"
 #include "MarbleDebug.h"
 #include "MarbleDirs.h"
@@ -26,6 +28,19 @@
 namespace Marble
 {
 
+// Number of cells along each edge of a cube face in the sky index
+static const int skyGridSize = 8;
+
+// Diameters of the star images per magnitude class, in pixels
+static const qreal starSizes[] = { 6.5, 5.5, 4.5, 4.0, 3.0, 2.0, 1.0, 0.5 };
+static const int starClassCount = 8;
+static const int starImageSize = 8;
+
+static bool lessMagnitude( const StarPoint &star1, const StarPoint &star2 )
+{
+    return star1.magnitude() < star2.magnitude();
+}
+
 StarsPlugin::StarsPlugin()
     : m_renderStars( false ),
       m_starsLoaded( false )
@@ -120,9 +135,123 @@ void StarsPlugin::loadStars() {
         m_stars << star;
 //        mDebug() << "RA:" << ra << "DE:" << de << "MAG:" << mag;
     }
+
+    createSkyIndex();
+
     m_starsLoaded = true;
 }
 
+void StarsPlugin::createSkyIndex()
+{
+    const int cellCount = 6 * skyGridSize * skyGridSize;
+    QVector<QVector<StarPoint> > buckets( cellCount );
+
+    foreach ( const StarPoint &star, m_stars ) {
+        const Quaternion &q = star.quaternion();
+        buckets[cellIndex( q.v[Q_X], q.v[Q_Y], q.v[Q_Z] )].append( star );
+    }
+
+    m_stars.clear();
+    m_cells.clear();
+
+    for ( int i = 0; i < cellCount; ++i ) {
+        QVector<StarPoint> &bucket = buckets[i];
+        if ( bucket.isEmpty() ) {
+            continue;
+        }
+
+        // Brightest stars first, so that rendering can stop at the magnitude limit
+        qSort( bucket.begin(), bucket.end(), lessMagnitude );
+
+        SkyCell cell;
+        foreach ( const StarPoint &star, bucket ) {
+            cell.m_center[0] += star.quaternion().v[Q_X];
+            cell.m_center[1] += star.quaternion().v[Q_Y];
+            cell.m_center[2] += star.quaternion().v[Q_Z];
+        }
+        const qreal length = sqrt( cell.m_center[0] * cell.m_center[0]
+                                   + cell.m_center[1] * cell.m_center[1]
+                                   + cell.m_center[2] * cell.m_center[2] );
+        cell.m_center[0] /= length;
+        cell.m_center[1] /= length;
+        cell.m_center[2] /= length;
+
+        foreach ( const StarPoint &star, bucket ) {
+            const qreal dot = cell.m_center[0] * star.quaternion().v[Q_X]
+                              + cell.m_center[1] * star.quaternion().v[Q_Y]
+                              + cell.m_center[2] * star.quaternion().v[Q_Z];
+            cell.m_radius = qMax( cell.m_radius, acos( qBound( qreal( -1.0 ), dot, qreal( 1.0 ) ) ) );
+        }
+
+        cell.m_begin = m_stars.size();
+        m_stars += bucket;
+        cell.m_end = m_stars.size();
+
+        m_cells.append( cell );
+    }
+
+    mDebug() << "Sorted" << m_stars.size() << "stars into" << m_cells.size() << "sky cells";
+}
+
+void StarsPlugin::createStarPixmap()
+{
+    m_starPixmap = QPixmap( starClassCount * starImageSize, starImageSize );
+    m_starPixmap.fill( Qt::transparent );
+
+    QPainter painter( &m_starPixmap );
+    painter.setRenderHint( QPainter::Antialiasing, true );
+    painter.setPen( Qt::NoPen );
+    painter.setBrush( Qt::white );
+
+    for ( int i = 0; i < starClassCount; ++i ) {
+        const qreal size = starSizes[i];
+        const qreal offset = ( starImageSize - size ) / 2.0;
+        painter.drawEllipse( QRectF( i * starImageSize + offset, offset, size, size ) );
+    }
+}
+
+int StarsPlugin::cellIndex( qreal x, qreal y, qreal z )
+{
+    const qreal absX = fabs( x );
+    const qreal absY = fabs( y );
+    const qreal absZ = fabs( z );
+
+    // Project onto the cube face of the dominant axis
+    int face;
+    qreal u;
+    qreal v;
+    if ( absX >= absY && absX >= absZ ) {
+        face = x > 0 ? 0 : 1;
+        u = y / absX;
+        v = z / absX;
+    } else if ( absY >= absZ ) {
+        face = y > 0 ? 2 : 3;
+        u = x / absY;
+        v = z / absY;
+    } else {
+        face = z > 0 ? 4 : 5;
+        u = x / absZ;
+        v = y / absZ;
+    }
+
+    const int column = qBound( 0, (int)( ( u + 1.0 ) / 2.0 * skyGridSize ), skyGridSize - 1 );
+    const int row = qBound( 0, (int)( ( v + 1.0 ) / 2.0 * skyGridSize ), skyGridSize - 1 );
+
+    return ( face * skyGridSize + row ) * skyGridSize + column;
+}
+
+int StarsPlugin::magnitudeClass( qreal magnitude )
+{
+    if ( magnitude < -1 ) return 0;
+    else if ( magnitude < 0 ) return 1;
+    else if ( magnitude < 1 ) return 2;
+    else if ( magnitude < 2 ) return 3;
+    else if ( magnitude < 3 ) return 4;
+    else if ( magnitude < 4 ) return 5;
+    else if ( magnitude < 5 ) return 6;
+    else return 7;
+}
+
 bool StarsPlugin::render( GeoPainter *painter, ViewportParams *viewport,
                           const QString& renderPos, GeoSceneLayer * layer )
 {
@@ -140,12 +269,6 @@ bool StarsPlugin::render( GeoPainter *painter, ViewportParams *viewport,
 
         painter->autoMapQuality();
 
-        QPen starPen( Qt::NoPen );
-        QBrush starBrush( Qt::white );
-
-        painter->setPen( starPen );
-        painter->setBrush( starBrush );
-
         QDateTime currentDateTime = marbleModel()->clockDateTime();
 
         qreal gmst = siderealTime( currentDateTime );
@@ -170,54 +293,101 @@ bool StarsPlugin::render( GeoPainter *painter, ViewportParams *viewport,
                 m_starsLoaded = true;
             }
 
+            if ( m_starPixmap.isNull() ) {
+                createStarPixmap();
+            }
+
             int x, y;
 
             const qreal  skyRadius      = 0.6 * sqrt( (qreal)viewport->width() * viewport->width() + viewport->height() * viewport->height() );
             const qreal  earthRadius    = viewport->radius();
 
-            QVector<StarPoint>::const_iterator i = m_stars.constBegin();
-            QVector<StarPoint>::const_iterator itEnd = m_stars.constEnd();
-            for (; i != itEnd; ++i)
-            {
-                Quaternion  qpos = (*i).quaternion();
-
-                qpos.rotateAroundAxis( skyAxisMatrix );
-
-                if ( qpos.v[Q_Z] > 0 ) {
-                   continue;
-                }
+            // Stars are visible where the rotated sky faces the viewer (z <= 0),
+            // i.e. within a cone around the negative z axis of the rotated sky
+            // which reaches the corners of the viewport.
+            const qreal  skyAxisX       = -skyAxisMatrix[0][2];
+            const qreal  skyAxisY       = -skyAxisMatrix[1][2];
+            const qreal  skyAxisZ       = -skyAxisMatrix[2][2];
+            const qreal  halfDiagonal   = 0.5 * sqrt( (qreal)viewport->width() * viewport->width() + viewport->height() * viewport->height() );
+            const qreal  coneAngle      = asin( qMin( qreal( 1.0 ), halfDiagonal / skyRadius ) );
+
+            // Faint stars are the vast majority of a catalog but can hardly be
+            // seen next to a close globe, so only show them as the view zooms
+            // out and the globe covers less of the field of view.
+            const qreal  zoomOut        = halfDiagonal / qMax( qreal( 1.0 ), earthRadius );
+            qreal magnitudeLimit = qBound( qreal( 4.0 ), 5.0 + 2.0 * log( zoomOut ) / log( 2.0 ), qreal( 9.0 ) );
+            if ( painter->mapQuality() < NormalQuality ) {
+                magnitudeLimit = qMin( magnitudeLimit, qreal( 5.0 ) );
+            }
 
-                qreal  earthCenteredX = qpos.v[Q_X] * skyRadius;
-                qreal  earthCenteredY = qpos.v[Q_Y] * skyRadius;
+#if QT_VERSION >= 0x040700
+            m_fragments.clear();
+#endif
 
-                // Don't draw high placemarks (e.g. satellites) that aren't visible.
-                if ( qpos.v[Q_Z] < 0
-                    && ( ( earthCenteredX * earthCenteredX
-                            + earthCenteredY * earthCenteredY )
-                        < earthRadius * earthRadius ) ) {
+            QVector<SkyCell>::const_iterator cell = m_cells.constBegin();
+            QVector<SkyCell>::const_iterator cellEnd = m_cells.constEnd();
+            for (; cell != cellEnd; ++cell )
+            {
+                const qreal dot = skyAxisX * (*cell).m_center[0]
+                                  + skyAxisY * (*cell).m_center[1]
+                                  + skyAxisZ * (*cell).m_center[2];
+                if ( acos( qBound( qreal( -1.0 ), dot, qreal( 1.0 ) ) ) > coneAngle + (*cell).m_radius ) {
                     continue;
                 }
 
-                // Let (x, y) be the position on the screen of the placemark..
-                x = (int)(viewport->width()  / 2 + skyRadius * qpos.v[Q_X]);
-                y = (int)(viewport->height() / 2 - skyRadius * qpos.v[Q_Y]);
-
-                // Skip placemarks that are outside the screen area
-                if ( x < 0 || x >= viewport->width()
-    		 || y < 0 || y >= viewport->height() )
-                    continue;
-
-                qreal size;
-                if ( (*i).magnitude() < -1 ) size = 6.5;
-                else if ( (*i).magnitude() < 0 ) size = 5.5;
-                else if ( (*i).magnitude() < 1 ) size = 4.5;
-                else if ( (*i).magnitude() < 2 ) size = 4.0;
-                else if ( (*i).magnitude() < 3 ) size = 3.0;
-                else if ( (*i).magnitude() < 4 ) size = 2.0;
-                else if ( (*i).magnitude() < 5 ) size = 1.0;
-                else size = 0.5;
-                painter->drawEllipse( QRectF( x, y, size, size ) );
+                QVector<StarPoint>::const_iterator i = m_stars.constBegin() + (*cell).m_begin;
+                QVector<StarPoint>::const_iterator itEnd = m_stars.constBegin() + (*cell).m_end;
+                for (; i != itEnd; ++i)
+                {
+                    // Stars are sorted by magnitude within each cell
+                    if ( (*i).magnitude() > magnitudeLimit ) {
+                        break;
+                    }
+
+                    Quaternion  qpos = (*i).quaternion();
+
+                    qpos.rotateAroundAxis( skyAxisMatrix );
+
+                    if ( qpos.v[Q_Z] > 0 ) {
+                       continue;
+                    }
+
+                    qreal  earthCenteredX = qpos.v[Q_X] * skyRadius;
+                    qreal  earthCenteredY = qpos.v[Q_Y] * skyRadius;
+
+                    // Don't draw high placemarks (e.g. satellites) that aren't visible.
+                    if ( qpos.v[Q_Z] < 0
+                        && ( ( earthCenteredX * earthCenteredX
+                                + earthCenteredY * earthCenteredY )
+                            < earthRadius * earthRadius ) ) {
+                        continue;
+                    }
+
+                    // Let (x, y) be the position on the screen of the placemark..
+                    x = (int)(viewport->width()  / 2 + skyRadius * qpos.v[Q_X]);
+                    y = (int)(viewport->height() / 2 - skyRadius * qpos.v[Q_Y]);
+
+                    // Skip placemarks that are outside the screen area
+                    if ( x < 0 || x >= viewport->width()
+                         || y < 0 || y >= viewport->height() )
+                        continue;
+
+                    const int starClass = magnitudeClass( (*i).magnitude() );
+                    const qreal size = starSizes[starClass];
+                    const QPointF center( x + size / 2.0, y + size / 2.0 );
+                    const QRectF source( starClass * starImageSize, 0, starImageSize, starImageSize );
+#if QT_VERSION >= 0x040700
+                    m_fragments.append( QPainter::PixmapFragment::create( center, source ) );
+#else
+                    painter->QPainter::drawPixmap( center - QPointF( starImageSize / 2.0, starImageSize / 2.0 ),
+                                                   m_starPixmap, source );
+#endif
+                }
             }
+
+#if QT_VERSION >= 0x040700
+            painter->drawPixmapFragments( m_fragments.constData(), m_fragments.size(), m_starPixmap );
+#endif
         }
 
         if ( renderStars != m_renderStars ) {
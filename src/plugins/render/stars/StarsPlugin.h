@@ -17,6 +17,8 @@
 
 #include <QtCore/QObject>
 #include <QtCore/QVector>
+#include <QtGui/QPainter>
+#include <QtGui/QPixmap>
 
 #include "RenderPlugin.h"
 #include "Quaternion.h"
@@ -57,6 +59,30 @@ class StarPoint
     Quaternion  m_q;
 };
 
+/**
+ * A square of a cube face projected onto the celestial sphere. The stars
+ * inside of it are stored in the range [begin, end) of the star catalog,
+ * sorted by increasing magnitude.
+ */
+class SkyCell
+{
+ public:
+    SkyCell()
+        : m_radius( 0.0 ),
+          m_begin( 0 ),
+          m_end( 0 )
+    {
+        m_center[0] = 0.0;
+        m_center[1] = 0.0;
+        m_center[2] = 0.0;
+    }
+
+    qreal m_center[3];  // unit vector
+    qreal m_radius;     // angular distance from the center to the farthest star
+    int   m_begin;
+    int   m_end;
+};
+
 
 /**
  * @short The class that specifies the Marble layer interface of a plugin.
@@ -101,9 +127,36 @@ class StarsPlugin : public RenderPlugin
 
  private:
     void loadStars();
+
+    /**
+     * Sort the star catalog into m_cells.
+     */
+    void createSkyIndex();
+
+    /**
+     * Render the star images of all magnitude classes into m_starPixmap.
+     */
+    void createStarPixmap();
+
+    /**
+     * @return the cell index of the star at the unit vector (@p x, @p y, @p z)
+     */
+    static int cellIndex( qreal x, qreal y, qreal z );
+
+    /**
+     * @return the magnitude class of a star with magnitude @p magnitude,
+     * starting at 0 for the brightest stars
+     */
+    static int magnitudeClass( qreal magnitude );
+
     bool m_renderStars;
     bool m_starsLoaded;
     QVector<StarPoint> m_stars;
+    QVector<SkyCell> m_cells;
+    QPixmap m_starPixmap;
+#if QT_VERSION >= 0x040700
+    QVector<QPainter::PixmapFragment> m_fragments;
+#endif
 };
 
 }
@@ -13,13 +13,14 @@
 #include "MarbleDebug.h"
 #include "MarbleDirs.h"
 #include "routing/RouteRequest.h"
+#include "routing/RoutingProcessRunner.h"
 #include "routing/instructions/WaypointParser.h"
 #include "routing/instructions/InstructionTransformation.h"
 #include "GeoDataDocument.h"
 #include "GeoDataExtendedData.h"
 
-#include <QtCore/QProcess>
 #include <QtCore/QMap>
+#include <QtCore/QMutex>
 
 namespace Marble
 {
@@ -34,7 +35,15 @@ public:
     /** Static to share the cache among all instances */
     static QMap<QString, QByteArray> m_partialRoutes;
 
-    QByteArray retrieveWaypoints( const QString &query ) const;
+    /** Guards m_partialRoutes, runners are executed in parallel */
+    static QMutex m_partialRoutesMutex;
+
+    /** Partial routes cached at most */
+    static const int m_maxPartialRoutes = 100;
+
+    QByteArray retrieveWaypoints( const QString &query, const void *owner = 0, bool *cancelled = 0 ) const;
+
+    QByteArray partialRoute( const QString &query, const void *owner, bool *cancelled ) const;
 
     GeoDataDocument* createDocument( GeoDataLineString* routeWaypoints, const QVector<GeoDataPlacemark*> instructions ) const;
 
@@ -57,6 +66,8 @@ GosmoreRunnerPrivate::GosmoreRunnerPrivate()
 
 QMap<QString, QByteArray> GosmoreRunnerPrivate::m_partialRoutes;
 
+QMutex GosmoreRunnerPrivate::m_partialRoutesMutex;
+
 void GosmoreRunnerPrivate::merge( GeoDataLineString* one, const GeoDataLineString& two ) const
 {
     Q_ASSERT( one );
@@ -68,28 +79,50 @@ void GosmoreRunnerPrivate::merge( GeoDataLineString* one, const GeoDataLineStrin
     }
 }
 
-QByteArray GosmoreRunnerPrivate::retrieveWaypoints( const QString &query ) const
+QByteArray GosmoreRunnerPrivate::retrieveWaypoints( const QString &query, const void *owner, bool *cancelled ) const
 {
-    QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
-    env.insert("QUERY_STRING", query);
-    env.insert("LC_ALL", "C");
-    QProcess gosmore;
-    gosmore.setProcessEnvironment(env);
-
-    gosmore.start("gosmore", QStringList() << m_gosmoreMapFile.absoluteFilePath() );
-    if (!gosmore.waitForStarted(5000)) {
-        mDebug() << "Couldn't start gosmore from the current PATH. Install it to retrieve routing results from gosmore.";
-        return QByteArray();
+    RoutingProcessJob job;
+    job.program = "gosmore";
+    job.arguments << m_gosmoreMapFile.absoluteFilePath();
+    job.environment.insert("QUERY_STRING", query);
+    job.environment.insert("LC_ALL", "C");
+    job.timeout = 15000;
+    job.owner = owner;
+
+    QByteArray output;
+    RoutingProcessRunner::Result const result = RoutingProcessRunner::instance()->execute( job, &output );
+    if ( cancelled ) {
+        *cancelled = result == RoutingProcessRunner::Cancelled;
     }
 
-    if ( gosmore.waitForFinished(15000) ) {
-        return gosmore.readAllStandardOutput();
+    if ( result == RoutingProcessRunner::Failed ) {
+        mDebug() << "Couldn't retrieve a result from gosmore. Install it to retrieve routing results from gosmore.";
+    }
+
+    return output;
+}
+
+QByteArray GosmoreRunnerPrivate::partialRoute( const QString &query, const void *owner, bool *cancelled ) const
+{
+    {
+        QMutexLocker locker( &m_partialRoutesMutex );
+        QMap<QString, QByteArray>::const_iterator const iter = m_partialRoutes.constFind( query );
+        if ( iter != m_partialRoutes.constEnd() ) {
+            *cancelled = false;
+            return iter.value();
+        }
     }
-    else {
-        mDebug() << "Couldn't stop gosmore";
+
+    QByteArray const output = retrieveWaypoints( query, owner, cancelled );
+    if ( !output.isEmpty() ) {
+        QMutexLocker locker( &m_partialRoutesMutex );
+        if ( m_partialRoutes.size() >= m_maxPartialRoutes ) {
+            m_partialRoutes.clear();
+        }
+        m_partialRoutes[query] = output;
     }
 
-    return QByteArray();
+    return output;
 }
 
 GeoDataLineString GosmoreRunnerPrivate::parseGosmoreOutput( const QByteArray &content ) const
@@ -224,12 +257,13 @@ void GosmoreRunner::retrieveRoute( const RouteRequest *route )
         double tLat = destination.latitude( GeoDataCoordinates::Degree );
         queryString = queryString.arg(tLat, 0, 'f', 8).arg(tLon, 0, 'f', 8);
 
-        QByteArray output;
-        if ( d->m_partialRoutes.contains( queryString ) ) {
-            output = d->m_partialRoutes[queryString];
-        }
-        else {
-            output = d->retrieveWaypoints( queryString );
+        bool cancelled = false;
+        QByteArray output = d->partialRoute( queryString, route, &cancelled );
+        if ( cancelled ) {
+            // The route request changed meanwhile, the result is obsolete
+            delete wayPoints;
+            emit routeCalculated( 0 );
+            return;
         }
 
         GeoDataLineString points = d->parseGosmoreOutput( output );
@@ -13,6 +13,7 @@
 #include "MarbleDebug.h"
 
 #include "GPXElementDictionary.h"
+#include "GeoFloatParser.h"
 #include "GeoParser.h"
 #include "GeoDataDocument.h"
 #include "GeoDataPlacemark.h"
@@ -33,7 +34,8 @@ GeoNode* GPXeleTagHandler::parse(GeoParser& parser) const
     if (parentItem.represents(gpxTag_trkpt))
     {
         GeoDataTrack* track = parentItem.nodeAs<GeoDataTrack>();
-        track->appendAltitude( parser.readElementText().trimmed().toDouble() );
+        const QString text = parser.readElementText();
+        track->appendAltitude( GeoFloatParser::toDouble( QStringRef( &text ) ) );
 #ifdef DEBUG_TAGS
         mDebug() << "Parsed <" << gpxTag_ele << ">";
 #endif
@@ -22,6 +22,7 @@
 #include "MarbleDebug.h"
 
 #include "GPXElementDictionary.h"
+#include "GeoFloatParser.h"
 #include "GeoParser.h"
 #include "GeoDataLineString.h"
 #include "GeoDataCoordinates.h"
@@ -50,12 +51,12 @@ GeoNode* GPXtrkptTagHandler::parse(GeoParser& parser) const
         tmp = attributes.value(gpxTag_lat);
         if ( !tmp.isEmpty() )
         {
-            lat = tmp.toString().toDouble();
+            lat = GeoFloatParser::toDouble( tmp );
         }
         tmp = attributes.value(gpxTag_lon);
         if ( !tmp.isEmpty() )
         {
-            lon = tmp.toString().toDouble();
+            lon = GeoFloatParser::toDouble( tmp );
         }
         coord.set(lon, lat, 0, GeoDataCoordinates::Degree);
         track->appendCoordinates( coord );
@@ -20,15 +20,21 @@
 namespace Marble
 {
 
-DatabaseQuery::DatabaseQuery( MarbleModel* model, const QString &searchTerm ) :
+DatabaseQuery::DatabaseQuery( MarbleModel* model, const QString &searchTerm, const GeoDataLatLonBox &preferred ) :
     m_queryType( BroadSearch ), m_resultFormat( AddressFormat ), m_searchTerm( searchTerm.trimmed() ),
-    m_category( OsmPlacemark::UnknownCategory )
+    m_hasReferencePosition( false ), m_category( OsmPlacemark::UnknownCategory )
 {
     if ( model && model->positionTracking()->status() == PositionProviderStatusAvailable ) {
         m_position = model->positionTracking()->currentLocation();
         m_resultFormat = DistanceFormat;
+        m_referencePosition = m_position;
+        m_hasReferencePosition = true;
     } else {
         m_resultFormat = AddressFormat;
+        if ( !preferred.isEmpty() ) {
+            m_referencePosition = preferred.center();
+            m_hasReferencePosition = true;
+        }
     }
 
     QStringList terms = m_searchTerm.split( ",", QString::SkipEmptyParts );
@@ -204,4 +210,14 @@ GeoDataCoordinates DatabaseQuery::position() const
     return m_position;
 }
 
+bool DatabaseQuery::hasReferencePosition() const
+{
+    return m_hasReferencePosition;
+}
+
+GeoDataCoordinates DatabaseQuery::referencePosition() const
+{
+    return m_referencePosition;
+}
+
 }
@@ -12,6 +12,7 @@
 #define MARBLE_DATABASEQUERY_H
 
 #include "GeoDataCoordinates.h"
+#include "GeoDataLatLonBox.h"
 #include "OsmPlacemark.h"
 
 #include <QtCore/QList>
@@ -38,7 +39,7 @@ public:
         DistanceFormat
     };
 
-    DatabaseQuery( MarbleModel* model, const QString &searchTerm );
+    DatabaseQuery( MarbleModel* model, const QString &searchTerm, const GeoDataLatLonBox &preferred = GeoDataLatLonBox() );
 
     QueryType queryType() const;
 
@@ -56,6 +57,14 @@ public:
 
     GeoDataCoordinates position() const;
 
+    /**
+      * Results close to this position are preferred: The current position if known
+      * (DistanceFormat), otherwise the center of the preferred area, if any.
+      */
+    bool hasReferencePosition() const;
+
+    GeoDataCoordinates referencePosition() const;
+
 private:
     bool isPointOfInterest( const QString &category );
 
@@ -70,6 +79,10 @@ private:
 
     GeoDataCoordinates m_position;
 
+    bool m_hasReferencePosition;
+
+    GeoDataCoordinates m_referencePosition;
+
     OsmPlacemark::OsmCategory m_category;
 };
 
@@ -16,12 +16,17 @@
 #include "OsmDatabase.h"
 #include "PositionTracking.h"
 
+#include <QtCore/QAtomicInt>
 #include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QPair>
 #include <QtCore/QDataStream>
 #include <QtCore/QStringList>
 #include <QtCore/QRegExp>
 #include <QtCore/QVariant>
+#include <QtCore/QThreadStorage>
 #include <QtCore/QTime>
+#include <QtCore/QtConcurrentMap>
 
 #include <QtSql/QSqlDatabase>
 #include <QtSql/QSqlQuery>
@@ -31,160 +36,423 @@ namespace Marble {
 
 namespace {
 
-static GeoDataCoordinates s_currentPosition;
-static DatabaseQuery* s_currentQuery = 0;
+/** Orders placemarks by their distance to the given position, closest first */
+class PlacemarkSmallerDistance
+{
+public:
+    explicit PlacemarkSmallerDistance( const GeoDataCoordinates &position ) :
+        m_position( position )
+    {
+        // nothing to do
+    }
+
+    bool operator()( const OsmPlacemark &a, const OsmPlacemark &b ) const
+    {
+        return distanceSphere( a.longitude() * DEG2RAD, a.latitude() * DEG2RAD,
+                               m_position.longitude(), m_position.latitude() )
+             < distanceSphere( b.longitude() * DEG2RAD, b.latitude() * DEG2RAD,
+                               m_position.longitude(), m_position.latitude() );
+    }
+
+private:
+    GeoDataCoordinates m_position;
+};
 
-bool placemarkSmallerDistance( const OsmPlacemark &a, const OsmPlacemark &b )
+/** Orders placemarks by how well they match the given query, best match first */
+class PlacemarkHigherScore
 {
-    return distanceSphere( a.longitude() * DEG2RAD, a.latitude() * DEG2RAD,
-                           s_currentPosition.longitude(), s_currentPosition.latitude() )
-         < distanceSphere( b.longitude() * DEG2RAD, b.latitude() * DEG2RAD,
-                           s_currentPosition.longitude(), s_currentPosition.latitude() );
-}
+public:
+    explicit PlacemarkHigherScore( const DatabaseQuery *query ) :
+        m_query( query )
+    {
+        // nothing to do
+    }
+
+    bool operator()( const OsmPlacemark &a, const OsmPlacemark &b ) const
+    {
+        return a.matchScore( m_query ) > b.matchScore( m_query );
+    }
 
-bool placemarkHigherScore( const OsmPlacemark &a, const OsmPlacemark &b )
+private:
+    const DatabaseQuery *const m_query;
+};
+
+/** Generations are unique among all OsmDatabase instances */
+QAtomicInt s_nextGeneration( 0 );
+
+QAtomicInt s_nextConnection( 0 );
+
+/** The database connections opened by one thread, removed when the thread finishes */
+class ThreadConnections
 {
-    return a.matchScore( s_currentQuery ) > b.matchScore( s_currentQuery );
+public:
+    struct Connection
+    {
+        int generation;
+        QString name;
+    };
+
+    ~ThreadConnections()
+    {
+        foreach( const Connection &connection, m_connections ) {
+            QSqlDatabase::removeDatabase( connection.name );
+        }
+    }
+
+    /** Connections by owning OsmDatabase and file name */
+    QHash<QPair<const OsmDatabase*, QString>, Connection> m_connections;
+};
+
+QThreadStorage<ThreadConnections*> s_threadConnections;
+
 }
 
+OsmDatabase::OsmDatabase() :
+    m_generation( s_nextGeneration.fetchAndAddRelaxed( 1 ) )
+{
+    // nothing to do
 }
 
-OsmDatabase::OsmDatabase()
+OsmDatabase::~OsmDatabase()
 {
-    m_database = QSqlDatabase::addDatabase( "QSQLITE" );
+    removeConnections();
 }
 
 void OsmDatabase::addFile( const QString &fileName )
 {
-    m_databases << fileName;
+    Shard shard;
+    shard.fileName = fileName;
+    shard.hasCoverage = false;
+
+    m_mutex.lock();
+    int const generation = m_generation;
+    m_mutex.unlock();
+
+    // Databases created by older versions of osm-addresses have no coverage and are always searched
+    QSqlDatabase database = connection( fileName, generation );
+    if ( database.isOpen() && database.tables().contains( "coverage" ) ) {
+        QSqlQuery query( "SELECT north, south, east, west FROM coverage", database );
+        if ( query.next() && !query.value( 0 ).isNull() ) {
+            shard.coverage = GeoDataLatLonBox( query.value( 0 ).toDouble(), query.value( 1 ).toDouble(),
+                                               query.value( 2 ).toDouble(), query.value( 3 ).toDouble(),
+                                               GeoDataCoordinates::Degree );
+            shard.hasCoverage = true;
+        }
+    }
+
+    QMutexLocker locker( &m_mutex );
+    m_shards << shard;
 }
 
-QVector<OsmPlacemark> OsmDatabase::find( MarbleModel* model, const QString &searchTerm )
+QVector<OsmPlacemark> OsmDatabase::find( MarbleModel* model, const QString &searchTerm, const GeoDataLatLonBox &preferred )
 {
-    if ( m_databases.isEmpty() ) {
+    m_mutex.lock();
+    QList<Shard> const shards = m_shards;
+    int const generation = m_generation;
+    m_mutex.unlock();
+
+    if ( shards.isEmpty() ) {
         return QVector<OsmPlacemark>();
     }
 
-    DatabaseQuery userQuery( model, searchTerm );
+    DatabaseQuery userQuery( model, searchTerm, preferred );
+
+    // Databases covering the preferred area are searched first, the others only
+    // if that yields nothing. Region names can be anywhere, so all are searched then.
+    QList<ShardSearch> nearby;
+    QList<ShardSearch> remote;
+    foreach( const Shard &shard, shards ) {
+        ShardSearch search;
+        search.database = this;
+        search.fileName = shard.fileName;
+        search.generation = generation;
+        search.query = &userQuery;
+        search.searchTerm = searchTerm;
+        if ( !userQuery.region().isEmpty() || preferred.isEmpty() || !shard.hasCoverage || shard.coverage.intersects( preferred ) ) {
+            nearby << search;
+        } else {
+            remote << search;
+        }
+    }
 
-    QVector<OsmPlacemark> result;
     QTime timer;
     timer.start();
-    foreach( const QString &databaseFile, m_databases ) {
-        m_database.setDatabaseName( databaseFile );
-        if ( !m_database.open() ) {
-            mDebug() << "Failed to connect to database " << databaseFile;
+    QVector<OsmPlacemark> result = findInShards( nearby );
+    int searched = nearby.size();
+    if ( result.isEmpty() && !remote.isEmpty() ) {
+        result = findInShards( remote );
+        searched += remote.size();
+    }
+
+    mDebug() << "Offline OSM search query took " << timer.elapsed() << " ms in" << searched << "of" << shards.size() << "databases.";
+
+    qSort( result.begin(), result.end() );
+    unique( result );
+
+    if ( userQuery.resultFormat() == DatabaseQuery::DistanceFormat ) {
+        const GeoDataCoordinates position = model->positionTracking()->currentLocation();
+        qSort( result.begin(), result.end(), PlacemarkSmallerDistance( position ) );
+    } else {
+        if ( userQuery.hasReferencePosition() ) {
+            // Equally good matches close to the view center first
+            qSort( result.begin(), result.end(),
+                   PlacemarkSmallerDistance( userQuery.referencePosition() ) );
         }
+        qStableSort( result.begin(), result.end(), PlacemarkHigherScore( &userQuery ) );
+    }
 
-        QString regionRestriction;
-        if ( !userQuery.region().isEmpty() ) {
-            // Nested set model to support region hierarchies, see http://en.wikipedia.org/wiki/Nested_set_model
-            QSqlQuery regionsQuery( "SELECT lft, rgt FROM regions WHERE name LIKE '%" + userQuery.region() + "%';" );
-            if ( regionsQuery.lastError().isValid() ) {
-                mDebug() << "Error when executing query" << regionsQuery.executedQuery();
-                mDebug() << "Sql reports" << regionsQuery.lastError();
-            }
-            regionRestriction = " AND (";
-            bool first = true;
-            while ( regionsQuery.next() ) {
-                if ( first ) {
-                    first = false;
-                } else {
-                    regionRestriction += " OR ";
-                }
-                regionRestriction += " (regions.lft >= " + regionsQuery.value( 0 ).toString();
-                regionRestriction += " AND regions.lft <= " + regionsQuery.value( 1 ).toString() + ")";
-            }
-            regionRestriction += ")";
+    if ( result.size() > 50 ) {
+        result.remove( 50, result.size()-50 );
+    }
 
-            if ( first ) {
-                continue;
-            }
+    return result;
+}
+
+QVector<OsmPlacemark> OsmDatabase::findInShards( const QList<ShardSearch> &searches )
+{
+    QVector<OsmPlacemark> result;
+    if ( searches.size() == 1 ) {
+        result = searchShard( searches.first() );
+    } else if ( !searches.isEmpty() ) {
+        // The calling thread takes part, so this does not block a thread pool that is busy with runners
+        QList<QVector<OsmPlacemark> > const results = QtConcurrent::blockingMapped( searches, searchShard );
+        foreach( const QVector<OsmPlacemark> &shardResult, results ) {
+            result << shardResult;
         }
+    }
+    return result;
+}
 
-        QString queryString;
-
-        queryString = " SELECT regions.name,"
-                " places.name, places.number,"
-                " places.category, places.lon, places.lat"
-                " FROM regions, places";
-
-        if ( userQuery.queryType() == DatabaseQuery::CategorySearch ) {
-            queryString += " WHERE regions.id = places.region AND places.category = %1";
-            queryString = queryString.arg( (qint32) userQuery.category() );
-            if ( userQuery.resultFormat() == DatabaseQuery::DistanceFormat && userQuery.region().isEmpty() ) {
-                queryString += " ORDER BY ((places.lat-%1)*(places.lat-%1)+(places.lon-%2)*(places.lon-%2))";
-                GeoDataCoordinates position = userQuery.position();
-                queryString = queryString.arg( position.latitude( GeoDataCoordinates::Degree ), 0, 'f', 8 )
-                        .arg( position.longitude( GeoDataCoordinates::Degree ), 0, 'f', 8 );
-            } else {
-                queryString += regionRestriction;
-            }
-        } else if ( userQuery.queryType() == DatabaseQuery::BroadSearch ) {
-            queryString += " WHERE regions.id = places.region"
-                    " AND places.name " + wildcardQuery( searchTerm );
-        } else {
-            queryString += " WHERE regions.id = places.region"
-                    "   AND places.name " + wildcardQuery( userQuery.street() );
-            if ( !userQuery.houseNumber().isEmpty() ) {
-                queryString += " AND places.number " + wildcardQuery( userQuery.houseNumber() );
-            } else {
-                queryString += " AND places.number IS NULL";
-            }
-            queryString += regionRestriction;
+QVector<OsmPlacemark> OsmDatabase::searchShard( const ShardSearch &search )
+{
+    QSqlDatabase database = search.database->connection( search.fileName, search.generation );
+    if ( !database.isOpen() ) {
+        return QVector<OsmPlacemark>();
+    }
+
+    return search.database->findInDatabase( database, *search.query, search.searchTerm );
+}
+
+QSqlDatabase OsmDatabase::connection( const QString &fileName, int generation ) const
+{
+    // A connection must only be used in the thread that created it. Each thread keeps
+    // its own connection to each database open for later searches, until the thread
+    // finishes. Connections of previous generations are replaced once the database
+    // files changed.
+    if ( !s_threadConnections.hasLocalData() ) {
+        s_threadConnections.setLocalData( new ThreadConnections );
+    }
+    ThreadConnections *const connections = s_threadConnections.localData();
+
+    QPair<const OsmDatabase*, QString> const key( this, fileName );
+    if ( connections->m_connections.contains( key ) ) {
+        ThreadConnections::Connection const existing = connections->m_connections.value( key );
+        if ( existing.generation == generation ) {
+            return QSqlDatabase::database( existing.name );
         }
+        QSqlDatabase::removeDatabase( existing.name );
+        connections->m_connections.remove( key );
+    }
 
-        queryString += " LIMIT 50;";
+    ThreadConnections::Connection connection;
+    connection.generation = generation;
+    connection.name = QString( "local-osm-search %1" ).arg( s_nextConnection.fetchAndAddRelaxed( 1 ) );
+    connections->m_connections.insert( key, connection );
+
+    QSqlDatabase database = QSqlDatabase::addDatabase( "QSQLITE", connection.name );
+    database.setDatabaseName( fileName );
+    database.setConnectOptions( "QSQLITE_OPEN_READONLY" );
+    if ( !database.open() ) {
+        mDebug() << "Failed to connect to database " << fileName;
+    }
+    return database;
+}
 
-        /** @todo: sort/filter results from several databases */
+void OsmDatabase::removeConnections() const
+{
+    if ( !s_threadConnections.hasLocalData() ) {
+        return;
+    }
 
-        QSqlQuery query;
-        query.setForwardOnly( true );
-        if ( !query.exec( queryString ) ) {
-            mDebug() << "Failed to execute query" << query.lastError();
-            return result;
+    // Other threads replace their connections on their next search or remove them when they finish
+    ThreadConnections *const connections = s_threadConnections.localData();
+    QMutableHashIterator<QPair<const OsmDatabase*, QString>, ThreadConnections::Connection> iter( connections->m_connections );
+    while ( iter.hasNext() ) {
+        iter.next();
+        if ( iter.key().first == this ) {
+            QSqlDatabase::removeDatabase( iter.value().name );
+            iter.remove();
         }
+    }
+}
 
-        while ( query.next() ) {
-            OsmPlacemark placemark;
-            if ( userQuery.resultFormat() == DatabaseQuery::DistanceFormat ) {
-                GeoDataCoordinates coordinates( query.value(4).toFloat(), query.value(5).toFloat(), 0.0, GeoDataCoordinates::Degree );
-                placemark.setAdditionalInformation( formatDistance( coordinates, userQuery.position() ) );
+QVector<OsmPlacemark> OsmDatabase::findInDatabase( QSqlDatabase &database, const DatabaseQuery &userQuery, const QString &searchTerm ) const
+{
+    QVector<OsmPlacemark> result;
+
+    // Databases created by older versions of osm-addresses lack the indices
+    QStringList const tables = database.tables();
+    bool const hasNameIndex = tables.contains( "namesFts" );
+    bool const hasSpatialIndex = tables.contains( "placemarksRtree" );
+
+    QString regionRestriction;
+    if ( !userQuery.region().isEmpty() ) {
+        // Nested set model to support region hierarchies, see http://en.wikipedia.org/wiki/Nested_set_model
+        QSqlQuery regionsQuery( database );
+        regionsQuery.prepare( "SELECT lft, rgt FROM regions WHERE name LIKE ?" );
+        regionsQuery.addBindValue( '%' + userQuery.region() + '%' );
+        if ( !regionsQuery.exec() ) {
+            mDebug() << "Error when executing query" << regionsQuery.executedQuery();
+            mDebug() << "Sql reports" << regionsQuery.lastError();
+        }
+        regionRestriction = " AND (";
+        bool first = true;
+        while ( regionsQuery.next() ) {
+            if ( first ) {
+                first = false;
             } else {
-                placemark.setAdditionalInformation( query.value( 0 ).toString() );
+                regionRestriction += " OR ";
             }
-            placemark.setName( query.value(1).toString() );
-            placemark.setHouseNumber( query.value(2).toString() );
-            placemark.setCategory( (OsmPlacemark::OsmCategory) query.value(3).toInt() );
-            placemark.setLongitude( query.value(4).toFloat() );
-            placemark.setLatitude( query.value(5).toFloat() );
-            result.push_back( placemark );
+            regionRestriction += " (regions.lft >= " + QString::number( regionsQuery.value( 0 ).toInt() );
+            regionRestriction += " AND regions.lft <= " + QString::number( regionsQuery.value( 1 ).toInt() ) + ")";
         }
+        regionRestriction += ")";
 
-        // mDebug() << "Query string: " << queryString;
+        if ( first ) {
+            return result;
+        }
     }
 
-    mDebug() << "Offline OSM search query took " << timer.elapsed() << " ms.";
-
-    qSort( result.begin(), result.end() );
-    unique( result );
+    if ( userQuery.queryType() == DatabaseQuery::CategorySearch && userQuery.region().isEmpty()
+         && userQuery.hasReferencePosition() && hasSpatialIndex ) {
+        findNearby( database, userQuery, result );
+        return result;
+    }
 
-    if ( userQuery.resultFormat() == DatabaseQuery::DistanceFormat ) {
-        s_currentPosition = model->positionTracking()->currentLocation();
-        qSort( result.begin(), result.end(), placemarkSmallerDistance );
+    QVariantList bindValues;
+    QString queryString = " SELECT regions.name,"
+            " places.name, places.number,"
+            " places.category, places.lon, places.lat"
+            " FROM regions, places"
+            " WHERE regions.id = places.region";
+
+    if ( userQuery.queryType() == DatabaseQuery::CategorySearch ) {
+        queryString += " AND places.category = ?";
+        bindValues << (qint32) userQuery.category();
+        queryString += regionRestriction;
+    } else if ( userQuery.queryType() == DatabaseQuery::BroadSearch ) {
+        queryString += " AND " + nameCondition( "places.name", searchTerm, hasNameIndex, bindValues );
     } else {
-        s_currentQuery = &userQuery;
-        qSort( result.begin(), result.end(), placemarkHigherScore );
-        s_currentQuery = 0;
+        queryString += " AND " + nameCondition( "places.name", userQuery.street(), hasNameIndex, bindValues );
+        if ( !userQuery.houseNumber().isEmpty() ) {
+            queryString += " AND " + nameCondition( "places.number", userQuery.houseNumber(), false, bindValues );
+        } else {
+            queryString += " AND places.number IS NULL";
+        }
+        queryString += regionRestriction;
     }
 
-    if ( result.size() > 50 ) {
-        result.remove( 50, result.size()-50 );
+    if ( userQuery.hasReferencePosition() ) {
+        queryString += " ORDER BY " + distanceExpression( "places", userQuery.referencePosition(), bindValues );
     }
 
+    queryString += " LIMIT 50;";
+
+    QSqlQuery query( database );
+    query.setForwardOnly( true );
+    query.prepare( queryString );
+    foreach( const QVariant &value, bindValues ) {
+        query.addBindValue( value );
+    }
+    if ( !query.exec() ) {
+        mDebug() << "Failed to execute query" << query.lastError();
+        return result;
+    }
+
+    readPlacemarks( query, userQuery, result );
     return result;
 }
 
+void OsmDatabase::findNearby( QSqlDatabase &database, const DatabaseQuery &userQuery, QVector<OsmPlacemark> &result ) const
+{
+    GeoDataCoordinates const center = userQuery.referencePosition();
+    qreal const lon = center.longitude( GeoDataCoordinates::Degree );
+    qreal const lat = center.latitude( GeoDataCoordinates::Degree );
+    qreal const lonScale = 1.0 / qMax<qreal>( 0.01, cos( center.latitude() ) );
+
+    // Grow the search box around the position until it contains enough results.
+    // The box contains all places within radius (in degree, longitude scaled as
+    // in distanceExpression()), but places in its corners are farther away than
+    // places just outside of it. So the results are only complete once the 50th
+    // closest result is within radius as well.
+    for ( qreal radius = 0.05; ; radius *= 8 ) {
+        QVariantList bindValues;
+        bindValues << lon - radius * lonScale << lon + radius * lonScale;
+        bindValues << lat - radius << lat + radius;
+        bindValues << (qint32) userQuery.category();
+        QString queryString = " SELECT regions.name,"
+                " names.name, placemarks.number,"
+                " placemarks.category, placemarks.lon, placemarks.lat"
+                " FROM placemarksRtree, placemarks, names, regions"
+                " WHERE placemarksRtree.minLon >= ? AND placemarksRtree.maxLon <= ?"
+                " AND placemarksRtree.minLat >= ? AND placemarksRtree.maxLat <= ?"
+                " AND placemarks.id = placemarksRtree.id"
+                " AND placemarks.category = ?"
+                " AND names.id = placemarks.nameId"
+                " AND regions.id = placemarks.regionId";
+        queryString += " ORDER BY " + distanceExpression( "placemarks", center, bindValues );
+        queryString += " LIMIT 50;";
+
+        QSqlQuery query( database );
+        query.setForwardOnly( true );
+        query.prepare( queryString );
+        foreach( const QVariant &value, bindValues ) {
+            query.addBindValue( value );
+        }
+        if ( !query.exec() ) {
+            mDebug() << "Failed to execute query" << query.lastError();
+            return;
+        }
+
+        QVector<OsmPlacemark> nearby;
+        readPlacemarks( query, userQuery, nearby );
+        if ( radius >= 180.0 ) {
+            result << nearby;
+            return;
+        }
+
+        if ( nearby.size() >= 50 ) {
+            // The results are sorted by distance already
+            OsmPlacemark const &farthest = nearby.last();
+            qreal const dLat = farthest.latitude() - lat;
+            qreal const dLon = ( farthest.longitude() - lon ) / lonScale;
+            if ( dLat * dLat + dLon * dLon <= radius * radius ) {
+                result << nearby;
+                return;
+            }
+        }
+    }
+}
+
+void OsmDatabase::readPlacemarks( QSqlQuery &query, const DatabaseQuery &userQuery, QVector<OsmPlacemark> &result ) const
+{
+    while ( query.next() ) {
+        OsmPlacemark placemark;
+        if ( userQuery.resultFormat() == DatabaseQuery::DistanceFormat ) {
+            GeoDataCoordinates coordinates( query.value(4).toFloat(), query.value(5).toFloat(), 0.0, GeoDataCoordinates::Degree );
+            placemark.setAdditionalInformation( formatDistance( coordinates, userQuery.position() ) );
+        } else {
+            placemark.setAdditionalInformation( query.value( 0 ).toString() );
+        }
+        placemark.setName( query.value(1).toString() );
+        placemark.setHouseNumber( query.value(2).toString() );
+        placemark.setCategory( (OsmPlacemark::OsmCategory) query.value(3).toInt() );
+        placemark.setLongitude( query.value(4).toFloat() );
+        placemark.setLatitude( query.value(5).toFloat() );
+        result.push_back( placemark );
+    }
+}
+
 void OsmDatabase::unique( QVector<OsmPlacemark> &placemarks ) const
 {
     for ( int i=1; i<placemarks.size(); ++i ) {
@@ -256,19 +524,73 @@ qreal OsmDatabase::bearing( const GeoDataCoordinates &a, const GeoDataCoordinate
                        cos( lat1 ) * sin( lat2 ) - sin( lat1 ) * cos( lat2 ) * cos ( delta ) ), 2 * M_PI );
 }
 
-QString OsmDatabase::wildcardQuery( const QString &term ) const
+QString OsmDatabase::nameCondition( const QString &column, const QString &term, bool useNameIndex, QVariantList &bindValues )
 {
-    QString result = term;
-    if ( term.contains( '*' ) ) {
-        return " LIKE '" + result.replace( '*', '%' ) + "'";
-    } else {
-        return " = '" + result + "'";
+    if ( !term.contains( '*' ) ) {
+        bindValues << term;
+        return column + " = ?";
+    }
+
+    QString pattern = term;
+    bindValues << pattern.replace( '*', '%' );
+    QString result = column + " LIKE ?";
+
+    // The LIKE comparison alone scans all names. Narrow it down to the names
+    // containing the tokens of the search term first.
+    QString const tokens = useNameIndex ? fullTextQuery( term ) : QString();
+    if ( !tokens.isEmpty() ) {
+        bindValues << tokens;
+        result += " AND " + column + " IN (SELECT name FROM namesFts WHERE name MATCH ?)";
     }
+
+    return result;
+}
+
+QString OsmDatabase::fullTextQuery( const QString &term )
+{
+    // Split like the simple tokenizer of sqlite: All ASCII characters except
+    // letters and digits separate tokens. A token with a wildcard becomes a
+    // prefix query, unless the wildcard is at its start. Quoting keeps FTS
+    // operators in the search term from being interpreted.
+    QStringList tokens;
+    QString token;
+    for ( int i = 0; i <= term.size(); ++i ) {
+        QChar const c = i < term.size() ? term.at( i ) : QChar( ' ' );
+        if ( c == '*' || c.unicode() >= 128 || c.isLetterOrNumber() ) {
+            token += c;
+            continue;
+        }
+
+        if ( !token.isEmpty() && !token.startsWith( '*' ) ) {
+            int const wildcard = token.indexOf( '*' );
+            if ( wildcard < 0 ) {
+                tokens << '"' + token + '"';
+            } else {
+                tokens << '"' + token.left( wildcard ) + "*\"";
+            }
+        }
+        token.clear();
+    }
+
+    return tokens.join( " " );
+}
+
+QString OsmDatabase::distanceExpression( const QString &table, const GeoDataCoordinates &position, QVariantList &bindValues )
+{
+    // Squared distance in degrees, longitude scaled for the latitude. Good enough for ranking.
+    qreal const lon = position.longitude( GeoDataCoordinates::Degree );
+    qreal const lat = position.latitude( GeoDataCoordinates::Degree );
+    qreal const scale = cos( position.latitude() );
+    bindValues << lat << lat << lon << lon << scale * scale;
+    return QString( "((%1.lat-?)*(%1.lat-?)+(%1.lon-?)*(%1.lon-?)*?)" ).arg( table );
 }
 
 void OsmDatabase::clear()
 {
-    m_databases.clear();
+    QMutexLocker locker( &m_mutex );
+    m_shards.clear();
+    m_generation = s_nextGeneration.fetchAndAddRelaxed( 1 );
+    removeConnections();
 }
 
 }
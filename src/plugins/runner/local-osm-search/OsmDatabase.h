@@ -12,21 +12,35 @@
 #define MARBLE_OSMDATABASE_H
 
 #include "OsmPlacemark.h"
+#include "GeoDataLatLonBox.h"
 
+#include <QtCore/QList>
+#include <QtCore/QMutex>
 #include <QtCore/QString>
 #include <QtCore/QStringList>
+#include <QtCore/QVariant>
 #include <QtSql/QSqlDatabase>
 
+class QSqlQuery;
+
 namespace Marble {
 
 class MarbleModel;
 class GeoDataCoordinates;
+class DatabaseQuery;
 
+/**
+  * Searches a set of address databases created by osm-addresses, typically
+  * one per country or region. The databases are searched in parallel, each
+  * thread using its own connection to each of them.
+  */
 class OsmDatabase
 {
 public:
     OsmDatabase();
 
+    ~OsmDatabase();
+
     // Methods for read access
 
     /** Open the given file. Previously opened files remain valid. */
@@ -35,17 +49,66 @@ public:
     /** Remove all files */
     void clear();
 
-    /** Search the database for matching regions and placemarks */
-    QVector<OsmPlacemark> find( MarbleModel* model, const QString &searchTerm );
+    /**
+      * Search the databases for matching regions and placemarks. Results close
+      * to the current position or else the center of the preferred area come first.
+      * Databases not covering the preferred area are only searched if the others
+      * have no result.
+      */
+    QVector<OsmPlacemark> find( MarbleModel* model, const QString &searchTerm, const GeoDataLatLonBox &preferred = GeoDataLatLonBox() );
 
 private:
-    QString wildcardQuery( const QString &term ) const;
+    /** A database file and the area its placemarks are in */
+    struct Shard
+    {
+        QString fileName;
+        bool hasCoverage;
+        GeoDataLatLonBox coverage;
+    };
+
+    /** The search of one database, passed to a worker thread */
+    struct ShardSearch
+    {
+        const OsmDatabase* database;
+        QString fileName;
+        int generation;
+        const DatabaseQuery* query;
+        QString searchTerm;
+    };
+
+    static QVector<OsmPlacemark> findInShards( const QList<ShardSearch> &searches );
+
+    static QVector<OsmPlacemark> searchShard( const ShardSearch &search );
+
+    /** The connection of the current thread to the given database file, opened if needed */
+    QSqlDatabase connection( const QString &fileName, int generation ) const;
+
+    /** Removes the connections of the current thread to the databases of this instance */
+    void removeConnections() const;
+
+    QVector<OsmPlacemark> findInDatabase( QSqlDatabase &database, const DatabaseQuery &userQuery, const QString &searchTerm ) const;
+
+    /** Category search around the reference position using the spatial index */
+    void findNearby( QSqlDatabase &database, const DatabaseQuery &userQuery, QVector<OsmPlacemark> &result ) const;
+
+    void readPlacemarks( QSqlQuery &query, const DatabaseQuery &userQuery, QVector<OsmPlacemark> &result ) const;
+
+    /** SQL condition matching the term, which may contain * wildcards, with ? placeholders for the bind values */
+    static QString nameCondition( const QString &column, const QString &term, bool useNameIndex, QVariantList &bindValues );
+
+    /** FTS query matching a superset of the names matched by the wildcard term */
+    static QString fullTextQuery( const QString &term );
+
+    static QString distanceExpression( const QString &table, const GeoDataCoordinates &position, QVariantList &bindValues );
 
     void unique( QVector<OsmPlacemark> &placemarks ) const;
 
-    QStringList m_databases;
+    QList<Shard> m_shards;
+
+    /** Changes whenever the files change, to use new connections */
+    int m_generation;
 
-    QSqlDatabase m_database;
+    QMutex m_mutex;
 
     QString formatDistance( const GeoDataCoordinates &a, const GeoDataCoordinates &b ) const;
 
@@ -0,0 +1,191 @@
+//
+// This file is part of the Marble Virtual Globe.
+//
+// This program is free software licensed under the GNU LGPL. You can
+// find a copy of this license in LICENSE.txt in the top directory of
+// the source code.
+//
+// Copyright 2026      agent <agent@local>
+//
+
+#include "LocalRoutingPlugin.h"
+#include "LocalRoutingRunner.h"
+#include "RoutingGraph.h"
+
+#include "MarbleDebug.h"
+#include "MarbleDirs.h"
+#include "routing/RouteRequest.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+
+namespace Marble
+{
+
+class LocalRoutingPluginPrivate
+{
+public:
+    LocalRoutingPluginPrivate();
+
+    ~LocalRoutingPluginPrivate();
+
+    static QString mapDirectory();
+
+    static int transport( const QString &transport );
+
+    void initialize();
+
+    QMutex m_mutex;
+    bool m_initialized;
+    QList<RoutingGraph*> m_graphs;
+};
+
+LocalRoutingPluginPrivate::LocalRoutingPluginPrivate() :
+    m_initialized( false )
+{
+    // nothing to do
+}
+
+LocalRoutingPluginPrivate::~LocalRoutingPluginPrivate()
+{
+    qDeleteAll( m_graphs );
+}
+
+QString LocalRoutingPluginPrivate::mapDirectory()
+{
+    return MarbleDirs::localPath() + "/maps/earth/local-routing/";
+}
+
+int LocalRoutingPluginPrivate::transport( const QString &transport )
+{
+    if ( transport == "bicycle" ) {
+        return RoutingProfile::Bicycle;
+    } else if ( transport == "foot" ) {
+        return RoutingProfile::Pedestrian;
+    }
+
+    return RoutingProfile::Motorcar;
+}
+
+void LocalRoutingPluginPrivate::initialize()
+{
+    if ( m_initialized ) {
+        return;
+    }
+    m_initialized = true;
+
+    QDir const directory( mapDirectory() );
+    foreach( const QFileInfo &file, directory.entryInfoList( QStringList() << "*.chg", QDir::Files ) ) {
+        RoutingGraph* graph = new RoutingGraph( file.absoluteFilePath() );
+        if ( graph->isValid() ) {
+            m_graphs << graph;
+        } else {
+            mDebug() << "Ignoring invalid routing graph" << file.absoluteFilePath();
+            delete graph;
+        }
+    }
+}
+
+LocalRoutingPlugin::LocalRoutingPlugin( QObject *parent ) :
+    RunnerPlugin( parent ),
+    d( new LocalRoutingPluginPrivate )
+{
+    setCapabilities( Routing );
+    setSupportedCelestialBodies( QStringList() << "earth" );
+    setCanWorkOffline( true );
+    setName( tr( "Local Routing" ) );
+    setNameId( "local-routing" );
+    setDescription( tr( "Offline routing on preprocessed OpenStreetMap data without external programs" ) );
+    setGuiString( tr( "Local Routing" ) );
+}
+
+LocalRoutingPlugin::~LocalRoutingPlugin()
+{
+    delete d;
+}
+
+MarbleAbstractRunner* LocalRoutingPlugin::newRunner() const
+{
+    return new LocalRoutingRunner( this );
+}
+
+bool LocalRoutingPlugin::supportsTemplate( RoutingProfilesModel::ProfileTemplate profileTemplate ) const
+{
+    return profileTemplate == RoutingProfilesModel::CarFastestTemplate
+        || profileTemplate == RoutingProfilesModel::BicycleTemplate
+        || profileTemplate == RoutingProfilesModel::PedestrianTemplate;
+}
+
+QHash< QString, QVariant > LocalRoutingPlugin::templateSettings( RoutingProfilesModel::ProfileTemplate profileTemplate ) const
+{
+    QHash<QString, QVariant> result;
+    switch ( profileTemplate ) {
+        case RoutingProfilesModel::CarFastestTemplate:
+            result["transport"] = "motorcar";
+            break;
+        case RoutingProfilesModel::BicycleTemplate:
+            result["transport"] = "bicycle";
+            break;
+        case RoutingProfilesModel::PedestrianTemplate:
+            result["transport"] = "foot";
+            break;
+        case RoutingProfilesModel::CarShortestTemplate:
+        case RoutingProfilesModel::CarEcologicalTemplate:
+            break;
+        case RoutingProfilesModel::LastTemplate:
+            Q_ASSERT( false );
+            break;
+    }
+    return result;
+}
+
+bool LocalRoutingPlugin::canWork( Capability capability ) const
+{
+    if ( supports( capability ) ) {
+        QMutexLocker locker( &d->m_mutex );
+        d->initialize();
+        return !d->m_graphs.isEmpty();
+    } else {
+        return false;
+    }
+}
+
+const RoutingGraph* LocalRoutingPlugin::graphForRequest( const RouteRequest* request ) const
+{
+    QMutexLocker locker( &d->m_mutex );
+    d->initialize();
+
+    QHash<QString, QVariant> settings = request->routingProfile().pluginSettings()[nameId()];
+    int const transport = settings.contains( "transport" )
+                          ? d->transport( settings["transport"].toString() )
+                          : int( request->routingProfile().transportType() );
+
+    for ( int j = 0; j < d->m_graphs.size(); ++j ) {
+        const RoutingGraph* graph = d->m_graphs[j];
+        if ( graph->transport() != transport ) {
+            continue;
+        }
+
+        bool valid = true;
+        for ( int i = 0; i < request->size() && valid; ++i ) {
+            valid = graph->contains( request->at( i ) );
+        }
+
+        if ( valid ) {
+            if ( j ) {
+                // Subsequent route requests will likely be in the same region
+                d->m_graphs.swap( 0, j );
+            }
+            return graph;
+        }
+    }
+
+    return 0;
+}
+
+}
+
+Q_EXPORT_PLUGIN2( LocalRoutingPlugin, Marble::LocalRoutingPlugin )
+
+#include "LocalRoutingPlugin.moc"
@@ -0,0 +1,61 @@
+//
+// This file is part of the Marble Virtual Globe.
+//
+// This program is free software licensed under the GNU LGPL. You can
+// find a copy of this license in LICENSE.txt in the top directory of
+// the source code.
+//
+// Copyright 2026      agent <agent@local>
+//
+
+#ifndef MARBLE_LOCALROUTINGPLUGIN_H
+#define MARBLE_LOCALROUTINGPLUGIN_H
+
+#include "RunnerPlugin.h"
+
+namespace Marble
+{
+
+class LocalRoutingPluginPrivate;
+class RouteRequest;
+class RoutingGraph;
+
+/**
+ * @short Offline routing without external programs.
+ *
+ * Routes are calculated in-process on routing graphs which were preprocessed
+ * with contraction hierarchies by tools/routing-graph. The graphs are installed
+ * in maps/earth/local-routing/ in the local Marble data directory, one file
+ * per region and transport type.
+ */
+class LocalRoutingPlugin : public RunnerPlugin
+{
+    Q_OBJECT
+    Q_INTERFACES( Marble::RunnerPlugin )
+
+public:
+    explicit LocalRoutingPlugin( QObject *parent = 0 );
+
+    ~LocalRoutingPlugin();
+
+    virtual MarbleAbstractRunner* newRunner() const;
+
+    virtual bool supportsTemplate( RoutingProfilesModel::ProfileTemplate profileTemplate ) const;
+
+    virtual QHash< QString, QVariant > templateSettings( RoutingProfilesModel::ProfileTemplate profileTemplate ) const;
+
+    virtual bool canWork( Capability capability ) const;
+
+    /**
+     * Returns a graph for the transport type of the request that contains all its
+     * waypoints or 0 if there is none. Graphs stay mapped while the plugin exists.
+     */
+    const RoutingGraph* graphForRequest( const RouteRequest* request ) const;
+
+private:
+    LocalRoutingPluginPrivate* const d;
+};
+
+}
+
+#endif
@@ -0,0 +1,202 @@
+//
+// This file is part of the Marble Virtual Globe.
+//
+// This program is free software licensed under the GNU LGPL. You can
+// find a copy of this license in LICENSE.txt in the top directory of
+// the source code.
+//
+// Copyright 2026      agent <agent@local>
+//
+
+#include "LocalRoutingRunner.h"
+#include "LocalRoutingPlugin.h"
+#include "RoutingGraph.h"
+
+#include "MarbleDebug.h"
+#include "routing/RouteRequest.h"
+#include "routing/instructions/InstructionTransformation.h"
+#include "GeoDataDocument.h"
+#include "GeoDataData.h"
+#include "GeoDataExtendedData.h"
+
+#include <QtCore/QTime>
+
+namespace Marble
+{
+
+class LocalRoutingRunnerPrivate
+{
+public:
+    const LocalRoutingPlugin* m_plugin;
+
+    explicit LocalRoutingRunnerPrivate( const LocalRoutingPlugin* plugin );
+
+    bool retrievePath( const RoutingGraph* graph, const RouteRequest *route, RoutingGraph::Path *path ) const;
+
+    GeoDataLineString* retrieveRoute( const RouteRequest *route, QVector<GeoDataPlacemark*> *instructions ) const;
+
+    GeoDataDocument* createDocument( GeoDataLineString* geometry, const QVector<GeoDataPlacemark*> &instructions ) const;
+};
+
+LocalRoutingRunnerPrivate::LocalRoutingRunnerPrivate( const LocalRoutingPlugin* plugin ) :
+    m_plugin( plugin )
+{
+    // nothing to do
+}
+
+bool LocalRoutingRunnerPrivate::retrievePath( const RoutingGraph* graph, const RouteRequest *route, RoutingGraph::Path *path ) const
+{
+    // Maximum distance in meters between a waypoint and the road network
+    qreal const lookupRadius = 1500.0;
+
+    qint64 previous = -1;
+    for ( int i = 0; i < route->size(); ++i ) {
+        qint64 const node = graph->nearestNode( route->at( i ), lookupRadius );
+        if ( node < 0 ) {
+            mDebug() << "No road found near waypoint" << i << "in" << graph->filename();
+            return false;
+        }
+
+        if ( previous >= 0 && !graph->route( previous, node, path ) ) {
+            mDebug() << "No route found between waypoints" << i - 1 << "and" << i;
+            return false;
+        }
+        previous = node;
+    }
+
+    return path->nodes.size() > 1;
+}
+
+GeoDataLineString* LocalRoutingRunnerPrivate::retrieveRoute( const RouteRequest *route, QVector<GeoDataPlacemark*> *instructions ) const
+{
+    const RoutingGraph* graph = m_plugin->graphForRequest( route );
+    if ( !graph ) {
+        mDebug() << "No routing graph covers the route request";
+        return 0;
+    }
+
+    QTime timer;
+    timer.start();
+    RoutingGraph::Path path;
+    if ( !retrievePath( graph, route, &path ) ) {
+        return 0;
+    }
+    mDebug() << "Route with" << path.nodes.size() << "nodes calculated in" << timer.elapsed() << "ms";
+
+    GeoDataLineString* geometry = new GeoDataLineString;
+    foreach( quint32 node, path.nodes ) {
+        geometry->append( graph->coordinates( node ) );
+    }
+
+    int secondsRemaining = 0;
+    foreach( quint32 weight, path.weights ) {
+        secondsRemaining += weight;
+    }
+    secondsRemaining /= 10;
+
+    RoutingWaypoints waypoints;
+    for ( int i = 0; i < path.nodes.size(); ++i ) {
+        // Each waypoint carries the road leaving it, the last one the road reaching it
+        int const edge = qMin( i, path.ways.size() - 1 );
+        quint32 const way = path.ways[edge];
+        QString const road = graph->wayName( way );
+        QString const type = graph->wayType( way );
+
+        bool const last = i == path.nodes.size() - 1;
+        bool const branchingPossible = !last && graph->degree( path.nodes[i] ) > 2;
+        RoutingWaypoint::JunctionType junction = branchingPossible ? RoutingWaypoint::Other : RoutingWaypoint::None;
+        if ( branchingPossible && graph->isRoundabout( way ) ) {
+            junction = RoutingWaypoint::Roundabout;
+        }
+
+        GeoDataCoordinates const coordinates = graph->coordinates( path.nodes[i] );
+        RoutingPoint point( coordinates.longitude( GeoDataCoordinates::Degree ),
+                            coordinates.latitude( GeoDataCoordinates::Degree ) );
+        waypoints.push_back( RoutingWaypoint( point, junction, "", type, secondsRemaining, road ) );
+
+        if ( !last ) {
+            secondsRemaining = qMax( 0, secondsRemaining - int( path.weights[edge] / 10 ) );
+        }
+    }
+
+    RoutingInstructions directions = InstructionTransformation::process( waypoints );
+    for ( int i = 0; i < directions.size(); ++i ) {
+        GeoDataPlacemark* placemark = new GeoDataPlacemark( directions[i].instructionText() );
+        GeoDataExtendedData extendedData;
+        GeoDataData turnType;
+        turnType.setName( "turnType" );
+        turnType.setValue( qVariantFromValue<int>( int( directions[i].turnType() ) ) );
+        extendedData.addValue( turnType );
+        placemark->setExtendedData( extendedData );
+        Q_ASSERT( !directions[i].points().isEmpty() );
+        GeoDataLineString* instructionGeometry = new GeoDataLineString;
+        QVector<RoutingWaypoint> items = directions[i].points();
+        for ( int j = 0; j < items.size(); ++j ) {
+            RoutingPoint point = items[j].point();
+            GeoDataCoordinates coordinates( point.lon(), point.lat(), 0.0, GeoDataCoordinates::Degree );
+            instructionGeometry->append( coordinates );
+        }
+        placemark->setGeometry( instructionGeometry );
+        instructions->push_back( placemark );
+    }
+
+    return geometry;
+}
+
+GeoDataDocument* LocalRoutingRunnerPrivate::createDocument( GeoDataLineString *geometry, const QVector<GeoDataPlacemark*> &instructions ) const
+{
+    if ( !geometry || geometry->isEmpty() ) {
+        delete geometry;
+        return 0;
+    }
+
+    GeoDataDocument* result = new GeoDataDocument;
+    GeoDataPlacemark* routePlacemark = new GeoDataPlacemark;
+    routePlacemark->setName( "Route" );
+    routePlacemark->setGeometry( geometry );
+    result->append( routePlacemark );
+
+    QString name = "%1 %2 (Local Routing)";
+    QString unit = "m";
+    qreal length = geometry->length( EARTH_RADIUS );
+    if ( length >= 1000 ) {
+        length /= 1000.0;
+        unit = "km";
+    }
+
+    foreach( GeoDataPlacemark* placemark, instructions ) {
+        result->append( placemark );
+    }
+
+    result->setName( name.arg( length, 0, 'f', 1 ).arg( unit ) );
+    return result;
+}
+
+LocalRoutingRunner::LocalRoutingRunner( const LocalRoutingPlugin* plugin, QObject *parent ) :
+    MarbleAbstractRunner( parent ),
+    d( new LocalRoutingRunnerPrivate( plugin ) )
+{
+    // nothing to do
+}
+
+LocalRoutingRunner::~LocalRoutingRunner()
+{
+    delete d;
+}
+
+GeoDataFeature::GeoDataVisualCategory LocalRoutingRunner::category() const
+{
+    return GeoDataFeature::OsmSite;
+}
+
+void LocalRoutingRunner::retrieveRoute( const RouteRequest *route )
+{
+    QVector<GeoDataPlacemark*> instructions;
+    GeoDataLineString* waypoints = d->retrieveRoute( route, &instructions );
+    GeoDataDocument* result = d->createDocument( waypoints, instructions );
+    emit routeCalculated( result );
+}
+
+} // namespace Marble
+
+#include "LocalRoutingRunner.moc"
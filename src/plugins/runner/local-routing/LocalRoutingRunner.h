@@ -0,0 +1,42 @@
+//
+// This file is part of the Marble Virtual Globe.
+//
+// This program is free software licensed under the GNU LGPL. You can
+// find a copy of this license in LICENSE.txt in the top directory of
+// the source code.
+//
+// Copyright 2026      agent <agent@local>
+//
+
+#ifndef MARBLE_LOCALROUTINGRUNNER_H
+#define MARBLE_LOCALROUTINGRUNNER_H
+
+#include "MarbleAbstractRunner.h"
+
+namespace Marble
+{
+
+class LocalRoutingPlugin;
+class LocalRoutingRunnerPrivate;
+
+class LocalRoutingRunner : public MarbleAbstractRunner
+{
+    Q_OBJECT
+public:
+    explicit LocalRoutingRunner( const LocalRoutingPlugin* plugin, QObject *parent = 0 );
+
+    ~LocalRoutingRunner();
+
+    // Overriding MarbleAbstractRunner
+    GeoDataFeature::GeoDataVisualCategory category() const;
+
+    // Overriding MarbleAbstractRunner
+    virtual void retrieveRoute( const RouteRequest *request );
+
+private:
+    LocalRoutingRunnerPrivate* const d;
+};
+
+}
+
+#endif
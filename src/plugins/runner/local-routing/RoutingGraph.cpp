@@ -0,0 +1,453 @@
+//
+// This file is part of the Marble Virtual Globe.
+//
+// This program is free software licensed under the GNU LGPL. You can
+// find a copy of this license in LICENSE.txt in the top directory of
+// the source code.
+//
+// Copyright 2026      agent <agent@local>
+//
+
+#include "RoutingGraph.h"
+#include "RoutingGraphFormat.h"
+
+#include "global.h"
+#include "MarbleDebug.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QPair>
+
+#include <climits>
+#include <cmath>
+#include <functional>
+#include <queue>
+#include <vector>
+
+namespace Marble
+{
+
+using namespace RoutingGraphFormat;
+
+namespace
+{
+
+/** Tentative distance and predecessor of a node during a search */
+struct Label
+{
+    quint32 distance;
+    quint32 parent;
+};
+
+typedef QPair<quint32, quint32> QueueItem; // distance, node
+typedef std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem> > Queue;
+
+/** One direction of the bidirectional search */
+struct Search
+{
+    QHash<quint32, Label> labels;
+    Queue queue;
+
+    void start( quint32 node )
+    {
+        Label label;
+        label.distance = 0;
+        label.parent = node;
+        labels.insert( node, label );
+        queue.push( QueueItem( 0, node ) );
+    }
+
+    quint32 minimum() const
+    {
+        return queue.empty() ? UINT_MAX : queue.top().first;
+    }
+};
+
+}
+
+class RoutingGraphPrivate
+{
+public:
+    RoutingGraphPrivate( const QString &filename );
+
+    bool open();
+
+    void close();
+
+    void settle( Search &search, const Search &other, quint32 edgeFlag,
+                 quint32 &best, qint64 &meetingNode ) const;
+
+    const Edge *findEdge( quint32 from, quint32 to ) const;
+
+    void unpack( quint32 from, quint32 to, RoutingGraph::Path *path ) const;
+
+    qreal distance( const Node &node, qreal lon, qreal lat ) const;
+
+    int cell( qint32 lon, qint32 lat, int &column, int &row ) const;
+
+    QFile m_file;
+    uchar *m_data;
+
+    const Header *m_header;
+    const Node *m_nodes;
+    const Edge *m_edges;
+    const Way *m_ways;
+    const char *m_strings;
+    const quint32 *m_cells;
+};
+
+RoutingGraphPrivate::RoutingGraphPrivate( const QString &filename ) :
+    m_file( filename ),
+    m_data( 0 ),
+    m_header( 0 ),
+    m_nodes( 0 ),
+    m_edges( 0 ),
+    m_ways( 0 ),
+    m_strings( 0 ),
+    m_cells( 0 )
+{
+    // nothing to do
+}
+
+bool RoutingGraphPrivate::open()
+{
+    if ( !m_file.open( QFile::ReadOnly ) ) {
+        mDebug() << "Cannot open routing graph" << m_file.fileName();
+        return false;
+    }
+
+    qint64 const size = m_file.size();
+    if ( size < qint64( sizeof( Header ) ) ) {
+        return false;
+    }
+
+    m_data = m_file.map( 0, size );
+    if ( !m_data ) {
+        mDebug() << "Cannot map routing graph" << m_file.fileName();
+        return false;
+    }
+
+    m_header = reinterpret_cast<const Header*>( m_data );
+    if ( m_header->magic != MagicNumber || m_header->version != Version ) {
+        mDebug() << "Unsupported routing graph format in" << m_file.fileName();
+        return false;
+    }
+
+    quint64 const cellCount = quint64( m_header->gridSize ) * m_header->gridSize + 1;
+    if ( m_header->gridSize == 0
+         || m_header->nodesOffset + quint64( m_header->nodeCount + 1 ) * sizeof( Node ) > quint64( size )
+         || m_header->edgesOffset + quint64( m_header->edgeCount ) * sizeof( Edge ) > quint64( size )
+         || m_header->waysOffset + quint64( m_header->wayCount ) * sizeof( Way ) > quint64( size )
+         || m_header->stringsOffset + quint64( m_header->stringSize ) > quint64( size )
+         || m_header->cellsOffset + cellCount * sizeof( quint32 ) > quint64( size ) ) {
+        mDebug() << "Truncated routing graph" << m_file.fileName();
+        return false;
+    }
+
+    m_nodes = reinterpret_cast<const Node*>( m_data + m_header->nodesOffset );
+    m_edges = reinterpret_cast<const Edge*>( m_data + m_header->edgesOffset );
+    m_ways = reinterpret_cast<const Way*>( m_data + m_header->waysOffset );
+    m_strings = reinterpret_cast<const char*>( m_data + m_header->stringsOffset );
+    m_cells = reinterpret_cast<const quint32*>( m_data + m_header->cellsOffset );
+    return true;
+}
+
+void RoutingGraphPrivate::close()
+{
+    if ( m_data ) {
+        m_file.unmap( m_data );
+        m_data = 0;
+    }
+    m_file.close();
+    m_header = 0;
+}
+
+void RoutingGraphPrivate::settle( Search &search, const Search &other, quint32 edgeFlag,
+                                  quint32 &best, qint64 &meetingNode ) const
+{
+    QueueItem const item = search.queue.top();
+    search.queue.pop();
+
+    quint32 const distance = item.first;
+    quint32 const node = item.second;
+    if ( distance > search.labels.value( node ).distance ) {
+        // Outdated queue entry, the node was reached on a shorter path meanwhile
+        return;
+    }
+
+    QHash<quint32, Label>::const_iterator const otherLabel = other.labels.constFind( node );
+    if ( otherLabel != other.labels.constEnd() && distance + otherLabel->distance < best ) {
+        best = distance + otherLabel->distance;
+        meetingNode = node;
+    }
+
+    // Both searches only go upwards in the hierarchy
+    for ( quint32 i = m_nodes[node].firstEdge; i < m_nodes[node + 1].firstEdge; ++i ) {
+        const Edge &edge = m_edges[i];
+        if ( !( edge.flags & edgeFlag ) ) {
+            continue;
+        }
+
+        quint32 const newDistance = distance + edge.weight;
+        QHash<quint32, Label>::iterator label = search.labels.find( edge.target );
+        if ( label == search.labels.end() ) {
+            Label newLabel;
+            newLabel.distance = newDistance;
+            newLabel.parent = node;
+            search.labels.insert( edge.target, newLabel );
+            search.queue.push( QueueItem( newDistance, edge.target ) );
+        } else if ( newDistance < label->distance ) {
+            label->distance = newDistance;
+            label->parent = node;
+            search.queue.push( QueueItem( newDistance, edge.target ) );
+        }
+    }
+}
+
+const Edge *RoutingGraphPrivate::findEdge( quint32 from, quint32 to ) const
+{
+    // Edges are stored at the node with the lower rank only
+    bool const upwards = m_nodes[from].rank < m_nodes[to].rank;
+    quint32 const node = upwards ? from : to;
+    quint32 const target = upwards ? to : from;
+    quint32 const flag = upwards ? Forward : Backward;
+
+    const Edge *result = 0;
+    for ( quint32 i = m_nodes[node].firstEdge; i < m_nodes[node + 1].firstEdge; ++i ) {
+        const Edge &edge = m_edges[i];
+        if ( edge.target == target && ( edge.flags & flag ) ) {
+            if ( !result || edge.weight < result->weight ) {
+                result = &edge;
+            }
+        }
+    }
+
+    return result;
+}
+
+void RoutingGraphPrivate::unpack( quint32 from, quint32 to, RoutingGraph::Path *path ) const
+{
+    // Shortcuts are replaced by the two edges they bypass until only edges
+    // of the original road network remain
+    QVector< QPair<quint32, quint32> > stack;
+    stack << QPair<quint32, quint32>( from, to );
+
+    while ( !stack.isEmpty() ) {
+        QPair<quint32, quint32> const arc = stack.last();
+        stack.pop_back();
+
+        const Edge *edge = findEdge( arc.first, arc.second );
+        Q_ASSERT( edge );
+        if ( !edge ) {
+            continue;
+        }
+
+        if ( edge->flags & Shortcut ) {
+            stack << QPair<quint32, quint32>( edge->data, arc.second );
+            stack << QPair<quint32, quint32>( arc.first, edge->data );
+        } else {
+            path->ways << edge->data;
+            path->weights << edge->weight;
+            path->nodes << arc.second;
+        }
+    }
+}
+
+qreal RoutingGraphPrivate::distance( const Node &node, qreal lon, qreal lat ) const
+{
+    // An equirectangular approximation is good enough to compare nearby nodes
+    qreal const nodeLat = node.lat / CoordinateFactor * DEG2RAD;
+    qreal const x = ( node.lon / CoordinateFactor * DEG2RAD - lon ) * cos( 0.5 * ( nodeLat + lat ) );
+    qreal const y = nodeLat - lat;
+    return EARTH_RADIUS * sqrt( x * x + y * y );
+}
+
+int RoutingGraphPrivate::cell( qint32 lon, qint32 lat, int &column, int &row ) const
+{
+    int const gridSize = m_header->gridSize;
+    qint64 const width = qMax<qint64>( 1, qint64( m_header->east ) - m_header->west );
+    qint64 const height = qMax<qint64>( 1, qint64( m_header->north ) - m_header->south );
+    column = qBound<qint64>( 0, ( qint64( lon ) - m_header->west ) * gridSize / width, gridSize - 1 );
+    row = qBound<qint64>( 0, ( qint64( lat ) - m_header->south ) * gridSize / height, gridSize - 1 );
+    return row * gridSize + column;
+}
+
+RoutingGraph::RoutingGraph( const QString &filename ) :
+    d( new RoutingGraphPrivate( filename ) )
+{
+    if ( !d->open() ) {
+        d->close();
+    }
+}
+
+RoutingGraph::~RoutingGraph()
+{
+    d->close();
+    delete d;
+}
+
+bool RoutingGraph::isValid() const
+{
+    return d->m_header;
+}
+
+QString RoutingGraph::filename() const
+{
+    return d->m_file.fileName();
+}
+
+int RoutingGraph::transport() const
+{
+    return d->m_header ? d->m_header->transport : -1;
+}
+
+bool RoutingGraph::contains( const GeoDataCoordinates &coordinates ) const
+{
+    if ( !d->m_header ) {
+        return false;
+    }
+
+    qreal const lon = coordinates.longitude( GeoDataCoordinates::Degree ) * CoordinateFactor;
+    qreal const lat = coordinates.latitude( GeoDataCoordinates::Degree ) * CoordinateFactor;
+    return lon >= d->m_header->west && lon <= d->m_header->east
+        && lat >= d->m_header->south && lat <= d->m_header->north;
+}
+
+qint64 RoutingGraph::nearestNode( const GeoDataCoordinates &coordinates, qreal maxDistance ) const
+{
+    if ( !d->m_header || d->m_header->nodeCount == 0 ) {
+        return -1;
+    }
+
+    qreal const lon = coordinates.longitude();
+    qreal const lat = coordinates.latitude();
+    int column = 0;
+    int row = 0;
+    d->cell( qRound( lon * RAD2DEG * CoordinateFactor ), qRound( lat * RAD2DEG * CoordinateFactor ), column, row );
+
+    // The smaller side of a cell in meters, to know when further rings of cells
+    // cannot contain closer nodes
+    int const gridSize = d->m_header->gridSize;
+    qreal const cellWidth = ( qreal( d->m_header->east ) - d->m_header->west ) / gridSize / CoordinateFactor * DEG2RAD
+                            * cos( lat ) * EARTH_RADIUS;
+    qreal const cellHeight = ( qreal( d->m_header->north ) - d->m_header->south ) / gridSize / CoordinateFactor * DEG2RAD
+                             * EARTH_RADIUS;
+    qreal const cellSize = qMax<qreal>( 1.0, qMin( cellWidth, cellHeight ) );
+
+    qint64 result = -1;
+    qreal best = maxDistance;
+    for ( int ring = 0; ring < gridSize && ( ring - 1 ) * cellSize <= best; ++ring ) {
+        for ( int y = row - ring; y <= row + ring; ++y ) {
+            if ( y < 0 || y >= gridSize ) {
+                continue;
+            }
+            for ( int x = column - ring; x <= column + ring; ++x ) {
+                if ( x < 0 || x >= gridSize ) {
+                    continue;
+                }
+                if ( qAbs( x - column ) != ring && qAbs( y - row ) != ring ) {
+                    continue; // inner cells were checked in previous rings already
+                }
+
+                int const index = y * gridSize + x;
+                for ( quint32 i = d->m_cells[index]; i < d->m_cells[index + 1]; ++i ) {
+                    qreal const distance = d->distance( d->m_nodes[i], lon, lat );
+                    if ( distance <= best ) {
+                        best = distance;
+                        result = i;
+                    }
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+bool RoutingGraph::route( quint32 source, quint32 target, Path *path ) const
+{
+    if ( !d->m_header || source >= d->m_header->nodeCount || target >= d->m_header->nodeCount ) {
+        return false;
+    }
+
+    if ( path->nodes.isEmpty() ) {
+        path->nodes << source;
+    }
+
+    if ( source == target ) {
+        return true;
+    }
+
+    Search forward;
+    Search backward;
+    forward.start( source );
+    backward.start( target );
+
+    quint32 best = UINT_MAX;
+    qint64 meetingNode = -1;
+
+    // Each search can stop once it cannot improve the best path anymore
+    while ( forward.minimum() < best || backward.minimum() < best ) {
+        if ( forward.minimum() <= backward.minimum() ) {
+            d->settle( forward, backward, Forward, best, meetingNode );
+        } else {
+            d->settle( backward, forward, Backward, best, meetingNode );
+        }
+    }
+
+    if ( meetingNode < 0 ) {
+        return false;
+    }
+
+    QVector<quint32> upwards;
+    for ( quint32 node = meetingNode; node != source; node = forward.labels.value( node ).parent ) {
+        upwards.prepend( node );
+    }
+    upwards.prepend( source );
+
+    for ( int i = 1; i < upwards.size(); ++i ) {
+        d->unpack( upwards[i-1], upwards[i], path );
+    }
+
+    for ( quint32 node = meetingNode; node != target; ) {
+        quint32 const next = backward.labels.value( node ).parent;
+        d->unpack( node, next, path );
+        node = next;
+    }
+
+    return true;
+}
+
+GeoDataCoordinates RoutingGraph::coordinates( quint32 node ) const
+{
+    const Node &item = d->m_nodes[node];
+    return GeoDataCoordinates( item.lon / CoordinateFactor, item.lat / CoordinateFactor,
+                               0.0, GeoDataCoordinates::Degree );
+}
+
+int RoutingGraph::degree( quint32 node ) const
+{
+    return d->m_nodes[node].degree;
+}
+
+QString RoutingGraph::wayName( quint32 way ) const
+{
+    return QString::fromUtf8( d->m_strings + d->m_ways[way].name );
+}
+
+QString RoutingGraph::wayType( quint32 way ) const
+{
+    if ( isRoundabout( way ) ) {
+        // That's what the instruction generation expects for roundabouts
+        return "roundabout";
+    }
+
+    return QString::fromLatin1( highwayTypes()[d->m_ways[way].type] );
+}
+
+bool RoutingGraph::isRoundabout( quint32 way ) const
+{
+    return d->m_ways[way].flags & Roundabout;
+}
+
+}
@@ -0,0 +1,89 @@
+//
+// This file is part of the Marble Virtual Globe.
+//
+// This program is free software licensed under the GNU LGPL. You can
+// find a copy of this license in LICENSE.txt in the top directory of
+// the source code.
+//
+// Copyright 2026      agent <agent@local>
+//
+
+#ifndef MARBLE_ROUTINGGRAPH_H
+#define MARBLE_ROUTINGGRAPH_H
+
+#include "GeoDataCoordinates.h"
+
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+namespace Marble
+{
+
+class RoutingGraphPrivate;
+
+/**
+ * @short A memory mapped routing graph preprocessed with contraction hierarchies.
+ *
+ * The graph is read only once opened, so it can be queried from several
+ * threads at the same time.
+ */
+class RoutingGraph
+{
+public:
+    /** A path through the original road network */
+    struct Path
+    {
+        QVector<quint32> nodes;   ///< All nodes of the path, in order
+        QVector<quint32> ways;    ///< The way of the edge following nodes[i]
+        QVector<quint32> weights; ///< The travel time of that edge in tenths of a second
+    };
+
+    explicit RoutingGraph( const QString &filename );
+
+    ~RoutingGraph();
+
+    /** Returns true if the file could be mapped and has the expected format */
+    bool isValid() const;
+
+    QString filename() const;
+
+    /** The RoutingProfile::TransportType the graph was built for */
+    int transport() const;
+
+    /** Returns true if the bounding box of the graph contains the given position */
+    bool contains( const GeoDataCoordinates &coordinates ) const;
+
+    /**
+     * Returns the node closest to the given position or -1 if there is no node
+     * within maxDistance meters.
+     */
+    qint64 nearestNode( const GeoDataCoordinates &coordinates, qreal maxDistance ) const;
+
+    /**
+     * Calculates the fastest path from source to target and appends it to path.
+     * The source node is only appended if path is empty. Returns false if target
+     * cannot be reached.
+     */
+    bool route( quint32 source, quint32 target, Path *path ) const;
+
+    GeoDataCoordinates coordinates( quint32 node ) const;
+
+    /** Number of roads meeting at the node */
+    int degree( quint32 node ) const;
+
+    QString wayName( quint32 way ) const;
+
+    /** The highway=* value of the way */
+    QString wayType( quint32 way ) const;
+
+    bool isRoundabout( quint32 way ) const;
+
+private:
+    Q_DISABLE_COPY( RoutingGraph )
+
+    RoutingGraphPrivate *const d;
+};
+
+}
+
+#endif
@@ -0,0 +1,119 @@
+//
+// This file is part of the Marble Virtual Globe.
+//
+// This program is free software licensed under the GNU LGPL. You can
+// find a copy of this license in LICENSE.txt in the top directory of
+// the source code.
+//
+// Copyright 2026      agent <agent@local>
+//
+
+#ifndef MARBLE_ROUTINGGRAPHFORMAT_H
+#define MARBLE_ROUTINGGRAPHFORMAT_H
+
+#include <QtCore/QtGlobal>
+
+/**
+ * The on-disk layout of routing graphs used by the local routing plugin.
+ * Graph files are written by tools/routing-graph and memory mapped by the
+ * plugin, so all structures are plain data in native byte order.
+ *
+ * A file starts with a Header, followed by the sections it references:
+ * nodeCount + 1 Nodes (the last one is a sentinel for the edge range of the
+ * last node), edgeCount Edges, wayCount Ways, the string table and
+ * gridSize * gridSize + 1 cell offsets.
+ *
+ * The graph is preprocessed with contraction hierarchies: Each node has a
+ * rank and only stores the edges to nodes of a higher rank. Shortcut edges
+ * bypass a contracted node of a lower rank, which is stored in the edge to
+ * unpack the shortcut later on. Nodes are sorted by the grid cell they are
+ * located in to look up the nearest node of a position quickly.
+ */
+
+namespace Marble
+{
+
+namespace RoutingGraphFormat
+{
+
+static const quint32 MagicNumber = 0x4d434847; // "MCHG"
+static const quint32 Version = 1;
+
+/** Coordinates are stored as fixed point degree values with this factor */
+static const qreal CoordinateFactor = 10000000.0;
+
+enum EdgeFlag {
+    Forward = 0x1,  ///< The edge can be used from the node to its target
+    Backward = 0x2, ///< The edge can be used from its target to the node
+    Shortcut = 0x4  ///< The edge bypasses the node stored in Edge::data
+};
+
+enum WayFlag {
+    Roundabout = 0x1
+};
+
+struct Header
+{
+    quint32 magic;
+    quint32 version;
+    quint32 transport;   ///< RoutingProfile::TransportType the graph was built for
+    quint32 nodeCount;
+    quint32 edgeCount;
+    quint32 wayCount;
+    quint32 stringSize;
+    quint32 gridSize;
+    qint32 west;
+    qint32 south;
+    qint32 east;
+    qint32 north;
+    quint32 nodesOffset;
+    quint32 edgesOffset;
+    quint32 waysOffset;
+    quint32 stringsOffset;
+    quint32 cellsOffset;
+    quint32 reserved;
+};
+
+struct Node
+{
+    qint32 lon;
+    qint32 lat;
+    quint32 firstEdge;
+    quint32 rank;
+    quint16 degree;      ///< Number of neighbors in the original road network
+    quint16 reserved;
+};
+
+struct Edge
+{
+    quint32 target;
+    quint32 weight;      ///< Travel time in tenths of a second
+    quint32 data;        ///< Bypassed node for shortcuts, index of the way otherwise
+    quint32 flags;
+};
+
+struct Way
+{
+    quint32 name;        ///< Offset of the zero terminated UTF-8 name in the string table
+    quint16 type;        ///< Index in highwayTypes()
+    quint16 flags;
+};
+
+/** The highway=* values routes can use, in the order of Way::type */
+inline const char * const *highwayTypes()
+{
+    static const char * const types[] = {
+        "motorway", "motorway_link", "trunk", "trunk_link",
+        "primary", "primary_link", "secondary", "secondary_link",
+        "tertiary", "tertiary_link", "unclassified", "residential",
+        "living_street", "service", "road", "track", "cycleway",
+        "path", "footway", "pedestrian", "steps", 0
+    };
+    return types;
+}
+
+}
+
+}
+
+#endif
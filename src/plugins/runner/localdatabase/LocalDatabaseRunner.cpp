@@ -12,7 +12,7 @@
 
 #include "MarbleAbstractRunner.h"
 #include "MarbleModel.h"
-#include "MarblePlacemarkModel.h"
+#include "PlacemarkRegistry.h"
 #include "GeoDataFeature.h"
 #include "GeoDataPlacemark.h"
 #include "GeoDataCoordinates.h"
@@ -46,27 +46,9 @@ void LocalDatabaseRunner::search( const QString &searchTerm )
     QVector<GeoDataPlacemark*> vector;
 
     if (model()) {
-        QAbstractItemModel * placemarkModel = model()->placemarkModel();
-
-        if (placemarkModel) {
-            QModelIndexList resultList;
-            QModelIndex firstIndex = placemarkModel->index( 0, 0 );
-            resultList = placemarkModel->match( firstIndex,
-                                    Qt::DisplayRole, searchTerm, -1,
-                                    Qt::MatchStartsWith );
-
-            foreach ( const QModelIndex& index, resultList )
-            {
-                if( !index.isValid() ) {
-                    mDebug() << "invalid index!!!";
-                    continue;
-                }
-                GeoDataPlacemark *placemark = dynamic_cast<GeoDataPlacemark*>(qvariant_cast<GeoDataObject*>( index.data( MarblePlacemarkModel::ObjectPointerRole )));
-                if ( placemark ) {
-                    vector.append( new GeoDataPlacemark( *placemark ));
-                }
-            }
-        }
+        // The placemarks may be removed in the GUI thread while we search,
+        // so the registry copies the matching ones for us
+        vector = model()->placemarkRegistry()->copyPlacemarks( searchTerm );
     }
 
     emit searchFinished( vector );
@@ -14,12 +14,12 @@
 #include "MarbleDebug.h"
 #include "MarbleDirs.h"
 #include "routing/RouteRequest.h"
+#include "routing/RoutingProcessRunner.h"
 #include "routing/instructions/WaypointParser.h"
 #include "routing/instructions/InstructionTransformation.h"
 #include "GeoDataDocument.h"
 #include "GeoDataExtendedData.h"
 
-#include <QtCore/QProcess>
 #include <QtCore/QMap>
 #include <QtCore/QTemporaryFile>
 #include <MarbleMap.h>
@@ -38,7 +38,7 @@ public:
 
     WaypointParser m_parser;
 
-    QByteArray retrieveWaypoints( const QStringList &params ) const;
+    QByteArray retrieveWaypoints( const QStringList &params, const void *owner ) const;
 
     GeoDataDocument* createDocument( GeoDataLineString* routeWaypoints, const QVector<GeoDataPlacemark*> instructions ) const;
 
@@ -86,29 +86,31 @@ private:
     QString m_dirName;
 };
 
-QByteArray RoutinoRunnerPrivate::retrieveWaypoints( const QStringList &params ) const
+QByteArray RoutinoRunnerPrivate::retrieveWaypoints( const QStringList &params, const void *owner ) const
 {
     TemporaryDir dir;
-    QProcess routinoProcess;
-    routinoProcess.setWorkingDirectory( dir.dirName() );
 
     QStringList routinoParams;
     routinoParams << params;
     routinoParams << "--dir=" + m_mapDir.absolutePath();
     routinoParams << "--output-text-all";
     mDebug() << routinoParams;
-    routinoProcess.start( "routino-router", routinoParams );
-    if ( !routinoProcess.waitForStarted( 5000 ) ) {
-        mDebug() << "Couldn't start routino-router from the current PATH. Install it to retrieve routing results from routino.";
-        return 0;
-    }
 
-    if ( routinoProcess.waitForFinished(60 * 1000) ) {
-        mDebug() << routinoProcess.readAll();
+    RoutingProcessJob job;
+    job.program = "routino-router";
+    job.arguments = routinoParams;
+    job.workingDirectory = dir.dirName();
+    job.timeout = 60 * 1000;
+    job.owner = owner;
+
+    QByteArray output;
+    switch ( RoutingProcessRunner::instance()->execute( job, &output ) ) {
+    case RoutingProcessRunner::Finished: {
+        mDebug() << output;
         mDebug() << "routino finished";
-        QFile file( routinoProcess.workingDirectory() + "/shortest-all.txt" );
+        QFile file( dir.dirName() + "/shortest-all.txt" );
         if ( !file.exists() ) {
-            file.setFileName( routinoProcess.workingDirectory() + "/quickest-all.txt" );
+            file.setFileName( dir.dirName() + "/quickest-all.txt" );
         }
         if ( !file.exists() ) {
             mDebug() << "Can't get results";
@@ -116,11 +118,17 @@ QByteArray RoutinoRunnerPrivate::retrieveWaypoints( const QStringList &params )
             file.open( QIODevice::ReadOnly );
             return file.readAll();
         }
+        break;
     }
-    else {
-        mDebug() << "Couldn't stop routino";
+    case RoutingProcessRunner::Failed:
+        mDebug() << "Couldn't run routino-router from the current PATH. Install it to retrieve routing results from routino.";
+        break;
+    case RoutingProcessRunner::Cancelled:
+        mDebug() << "Routing request changed, routino result discarded";
+        break;
     }
-    return 0;
+
+    return QByteArray();
 }
 
 GeoDataLineString* RoutinoRunnerPrivate::parseRoutinoOutput( const QByteArray &content ) const
@@ -258,7 +266,7 @@ void RoutinoRunner::retrieveRoute( const RouteRequest *route )
     }
     */
 
-    QByteArray output = d->retrieveWaypoints( params );
+    QByteArray output = d->retrieveWaypoints( params, route );
     GeoDataLineString* wayPoints = d->parseRoutinoOutput( output );
     QVector<GeoDataPlacemark*> instructions = d->parseRoutinoInstructions( output );
 
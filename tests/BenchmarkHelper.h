@@ -0,0 +1,103 @@
+//
+// This file is part of the Marble Virtual Globe.
+//
+// This program is free software licensed under the GNU LGPL. You can
+// find a copy of this license in LICENSE.txt in the top directory of
+// the source code.
+//
+// Copyright 2026      agent <agent@local>
+//
+
+#ifndef MARBLE_BENCHMARKHELPER_H
+#define MARBLE_BENCHMARKHELPER_H
+
+// Command line handling and statistics shared by the benchmark executables
+
+#include <QtCore/QDebug>
+#include <QtCore/QFile>
+#include <QtCore/QStringList>
+#include <QtCore/QTextStream>
+#include <QtCore/QVector>
+#include <QtCore/QtAlgorithms>
+
+namespace Marble
+{
+
+namespace BenchmarkHelper
+{
+
+/** Returns the value following @p name in @p arguments, or @p defaultValue */
+inline QString option( const QStringList &arguments, const QString &name, const QString &defaultValue = QString() )
+{
+    const int index = arguments.indexOf( name );
+    if ( index >= 0 && index + 1 < arguments.size() ) {
+        return arguments.at( index + 1 );
+    }
+    return defaultValue;
+}
+
+/** Returns the comma separated values following @p name in @p arguments, or those of @p defaultValue */
+inline QStringList listOption( const QStringList &arguments, const QString &name, const QString &defaultValue )
+{
+    return option( arguments, name, defaultValue ).split( ',', QString::SkipEmptyParts );
+}
+
+/** Returns the arguments which are neither options starting with "--" nor their values */
+inline QStringList positionalArguments( const QStringList &arguments )
+{
+    QStringList result;
+    for ( int i = 0; i < arguments.size(); ++i ) {
+        if ( arguments.at( i ).startsWith( "--" ) ) {
+            ++i;
+        } else {
+            result << arguments.at( i );
+        }
+    }
+    return result;
+}
+
+/** Opens @p file for writing to @p fileName, or to stdout if it is empty */
+inline bool openOutput( QFile &file, const QString &fileName )
+{
+    if ( fileName.isEmpty() ) {
+        return file.open( stdout, QIODevice::WriteOnly );
+    }
+
+    file.setFileName( fileName );
+    if ( !file.open( QIODevice::WriteOnly ) ) {
+        qCritical() << "Cannot write to" << fileName;
+        return false;
+    }
+    return true;
+}
+
+inline qreal median( QVector<qreal> values )
+{
+    if ( values.isEmpty() ) {
+        return 0.0;
+    }
+    qSort( values );
+    return values.at( values.size() / 2 );
+}
+
+/** Writes the column names of throughput measurements */
+inline void writeThroughputHeader( QTextStream &output )
+{
+    output << "document\tmegabytes\tmedian_ms\tmegabytes_per_second\n";
+}
+
+/** Writes the throughput of processing @p bytes of @p document in the given @p times (in ms) */
+inline void writeThroughput( QTextStream &output, const QString &document, qint64 bytes, const QVector<qreal> &times )
+{
+    const qreal megabytes = bytes / ( 1024.0 * 1024.0 );
+    const qreal milliseconds = qMax<qreal>( 1.0, median( times ) );
+    output << document << '\t' << megabytes << '\t' << milliseconds << '\t'
+           << 1000.0 * megabytes / milliseconds << '\n';
+    output.flush();
+}
+
+}
+
+}
+
+#endif
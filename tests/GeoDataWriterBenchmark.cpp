@@ -0,0 +1,125 @@
+//
+// This file is part of the Marble Virtual Globe.
+//
+// This program is free software licensed under the GNU LGPL. You can
+// find a copy of this license in LICENSE.txt in the top directory of
+// the source code.
+//
+// Copyright 2026      agent <agent@local>
+//
+
+// Measures the write throughput of the KML writer in MB/s. Writes a synthetic
+// document of line strings and points, or the given KML files after parsing them.
+//
+// Usage: GeoDataWriterBenchmark [--points 1000000] [--iterations 5] [file.kml ...]
+//
+// The synthetic document contains the given number of coordinates in total.
+// All documents are written to memory to exclude disk access.
+
+#include <QtCore/QBuffer>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDebug>
+#include <QtCore/QFile>
+#include <QtCore/QStringList>
+#include <QtCore/QTextStream>
+#include <QtCore/QTime>
+#include <QtCore/QVector>
+
+#include "BenchmarkHelper.h"
+#include "GeoDataDocument.h"
+#include "GeoDataLineString.h"
+#include "GeoDataParser.h"
+#include "GeoDataPlacemark.h"
+#include "GeoWriter.h"
+#include "KmlElementDictionary.h"
+
+using namespace Marble;
+using namespace Marble::BenchmarkHelper;
+
+namespace
+{
+
+GeoDataDocument *syntheticDocument( int points )
+{
+    GeoDataDocument *document = new GeoDataDocument;
+
+    qsrand( 42 );
+    for ( int i = 0; points > 0; ++i ) {
+        qreal lon = 360.0 * qrand() / RAND_MAX - 180.0;
+        qreal lat = 160.0 * qrand() / RAND_MAX - 80.0;
+        GeoDataPlacemark *placemark = new GeoDataPlacemark( QString( "Placemark %1" ).arg( i ) );
+        if ( i % 10 ) {
+            GeoDataLineString *lineString = new GeoDataLineString;
+            for ( int j = 0; j < 500; ++j ) {
+                lon += 0.0001 * ( qrand() % 10 );
+                lat += 0.0001 * ( qrand() % 10 );
+                lineString->append( GeoDataCoordinates( lon, lat, j % 300, GeoDataCoordinates::Degree ) );
+            }
+            placemark->setGeometry( lineString );
+            points -= 500;
+        } else {
+            placemark->setCoordinate( lon, lat, 100.5, GeoDataCoordinates::Degree );
+            points -= 1;
+        }
+        document->append( placemark );
+    }
+
+    return document;
+}
+
+}
+
+int main( int argc, char *argv[] )
+{
+    QCoreApplication app( argc, argv );
+    QStringList arguments = app.arguments();
+    arguments.removeFirst();
+
+    const int points = qMax( 1, option( arguments, "--points", "1000000" ).toInt() );
+    const int iterations = qMax( 1, option( arguments, "--iterations", "5" ).toInt() );
+
+    const QStringList files = positionalArguments( arguments );
+
+    QTextStream output( stdout );
+    writeThroughputHeader( output );
+
+    QList<QPair<QString, GeoDataDocument*> > documents;
+    if ( files.isEmpty() ) {
+        documents << qMakePair( QString( "synthetic" ), syntheticDocument( points ) );
+    }
+    foreach( const QString &fileName, files ) {
+        QFile file( fileName );
+        GeoDataParser parser( GeoData_KML );
+        if ( !file.open( QIODevice::ReadOnly ) || !parser.read( &file ) ) {
+            qCritical() << "Cannot read" << fileName;
+            return 1;
+        }
+        documents << qMakePair( fileName, static_cast<GeoDataDocument*>( parser.releaseDocument() ) );
+    }
+
+    for ( int i = 0; i < documents.size(); ++i ) {
+        QVector<qreal> times;
+        qint64 size = 0;
+        for ( int j = 0; j < iterations; ++j ) {
+            QByteArray data;
+            QBuffer buffer( &data );
+            buffer.open( QIODevice::WriteOnly );
+            GeoWriter writer;
+            writer.setDocumentType( kml::kmlTag_nameSpace22 );
+
+            QTime timer;
+            timer.start();
+            if ( !writer.write( &buffer, documents.at( i ).second ) ) {
+                qCritical() << "Failed to write" << documents.at( i ).first;
+                return 1;
+            }
+            times << timer.elapsed();
+            size = data.size();
+        }
+
+        writeThroughput( output, documents.at( i ).first, size, times );
+        delete documents.at( i ).second;
+    }
+
+    return 0;
+}
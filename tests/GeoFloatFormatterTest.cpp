@@ -0,0 +1,76 @@
+//
+// This file is part of the Marble Virtual Globe.
+//
+// This program is free software licensed under the GNU LGPL. You can
+// find a copy of this license in LICENSE.txt in the top directory of
+// the source code.
+//
+// Copyright 2026      agent <agent@local>
+//
+
+#include <QtCore/QObject>
+#include <QtTest/QtTest>
+
+#include "GeoFloatFormatter.h"
+
+using namespace Marble;
+
+class GeoFloatFormatterTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void append_data();
+    void append();
+    void appendMany();
+};
+
+void GeoFloatFormatterTest::append_data()
+{
+    QTest::addColumn<double>( "value" );
+    QTest::addColumn<int>( "precision" );
+
+    QTest::newRow( "zero" ) << 0.0 << 10;
+    QTest::newRow( "integer" ) << 42.0 << 2;
+    QTest::newRow( "no decimals" ) << 13.6 << 0;
+    QTest::newRow( "longitude" ) << 13.377704810 << 10;
+    QTest::newRow( "negative" ) << -52.5163 << 10;
+    QTest::newRow( "antimeridian" ) << -180.0 << 10;
+    QTest::newRow( "altitude" ) << 8848.86 << 2;
+    QTest::newRow( "round up" ) << 0.999999999999 << 7;
+    QTest::newRow( "tiny" ) << 1e-12 << 10;
+    QTest::newRow( "negative tiny" ) << -1e-12 << 10;
+    QTest::newRow( "negative zero" ) << -0.0 << 2;
+    QTest::newRow( "tie" ) << 0.125 << 2;
+    QTest::newRow( "max precision" ) << 0.123456789012345 << 15;
+    QTest::newRow( "large" ) << 1e20 << 2;
+    QTest::newRow( "too precise" ) << 1.5 << 20;
+}
+
+void GeoFloatFormatterTest::append()
+{
+    QFETCH( double, value );
+    QFETCH( int, precision );
+
+    QString text = "prefix ";
+    GeoFloatFormatter::append( text, value, precision );
+    QCOMPARE( text, "prefix " + QString::number( value, 'f', precision ) );
+
+    QByteArray bytes = "prefix ";
+    GeoFloatFormatter::append( bytes, value, precision );
+    QCOMPARE( bytes, "prefix " + QByteArray::number( value, 'f', precision ) );
+}
+
+void GeoFloatFormatterTest::appendMany()
+{
+    qsrand( 42 );
+    for ( int i = 0; i < 100000; ++i ) {
+        const qreal value = 360.0 * qrand() / RAND_MAX - 180.0;
+        QString text;
+        GeoFloatFormatter::append( text, value, 10 );
+        QCOMPARE( text, QString::number( value, 'f', 10 ) );
+    }
+}
+
+QTEST_MAIN( GeoFloatFormatterTest )
+
+#include "GeoFloatFormatterTest.moc"
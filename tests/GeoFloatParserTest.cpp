@@ -0,0 +1,89 @@
+//
+// This file is part of the Marble Virtual Globe.
+//
+// This program is free software licensed under the GNU LGPL. You can
+// find a copy of this license in LICENSE.txt in the top directory of
+// the source code.
+//
+// Copyright 2026      agent <agent@local>
+//
+
+#include <QtCore/QObject>
+#include <QtTest/QtTest>
+
+#include "GeoFloatParser.h"
+
+using namespace Marble;
+
+class GeoFloatParserTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void toDouble_data();
+    void toDouble();
+    void parseTuple();
+};
+
+void GeoFloatParserTest::toDouble_data()
+{
+    QTest::addColumn<QString>( "text" );
+
+    QTest::newRow( "integer" ) << "42";
+    QTest::newRow( "negative" ) << "-13.4050";
+    QTest::newRow( "positive" ) << "+52.52";
+    QTest::newRow( "leading zeros" ) << "0.000123";
+    QTest::newRow( "coordinate" ) << "13.377704810";
+    QTest::newRow( "no integer part" ) << ".5";
+    QTest::newRow( "no fraction part" ) << "7.";
+    QTest::newRow( "exponent" ) << "1.5e3";
+    QTest::newRow( "negative exponent" ) << "-2.25E-4";
+    QTest::newRow( "long mantissa" ) << "3.14159265358979323846264338";
+    QTest::newRow( "large exponent" ) << "1e300";
+    QTest::newRow( "small exponent" ) << "4.9e-320";
+    QTest::newRow( "whitespace" ) << "  8.25\n";
+    QTest::newRow( "empty" ) << "";
+    QTest::newRow( "sign only" ) << "-";
+    QTest::newRow( "garbage" ) << "1.5abc";
+    QTest::newRow( "comma" ) << "1,5";
+}
+
+void GeoFloatParserTest::toDouble()
+{
+    QFETCH( QString, text );
+
+    bool expectedOk = false;
+    const double expected = text.toDouble( &expectedOk );
+
+    bool ok = false;
+    const double value = GeoFloatParser::toDouble( QStringRef( &text ), &ok );
+
+    QCOMPARE( ok, expectedOk );
+    QCOMPARE( value, expected );
+}
+
+void GeoFloatParserTest::parseTuple()
+{
+    const QString text = "13.5,-52.25,100 ";
+    const QChar* position = text.constData();
+    const QChar* const end = position + text.size();
+
+    qreal value = 0.0;
+    QVERIFY( GeoFloatParser::parse( position, end, value ) );
+    QCOMPARE( value, 13.5 );
+    QCOMPARE( *position, QChar( ',' ) );
+
+    ++position;
+    QVERIFY( GeoFloatParser::parse( position, end, value ) );
+    QCOMPARE( value, -52.25 );
+
+    ++position;
+    QVERIFY( GeoFloatParser::parse( position, end, value ) );
+    QCOMPARE( value, 100.0 );
+    QCOMPARE( *position, QChar( ' ' ) );
+
+    QVERIFY( !GeoFloatParser::parse( position, end, value ) );
+}
+
+QTEST_MAIN( GeoFloatParserTest )
+
+#include "GeoFloatParserTest.moc"
@@ -0,0 +1,135 @@
+//
+// This file is part of the Marble Virtual Globe.
+//
+// This program is free software licensed under the GNU LGPL. You can
+// find a copy of this license in LICENSE.txt in the top directory of
+// the source code.
+//
+// Copyright 2026      agent <agent@local>
+//
+
+// Measures the parse throughput of the KML parser in MB/s. Parses a synthetic
+// document of line strings and gx:Track elements, or the given KML files.
+//
+// Usage: KmlParserBenchmark [--size 20] [--iterations 5] [file.kml ...]
+//
+// The synthetic document is generated in memory with the given size in MB.
+// All documents are parsed from memory to exclude disk access.
+
+#include <QtCore/QBuffer>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDebug>
+#include <QtCore/QFile>
+#include <QtCore/QStringList>
+#include <QtCore/QTextStream>
+#include <QtCore/QTime>
+#include <QtCore/QVector>
+
+#include "BenchmarkHelper.h"
+#include "GeoDataDocument.h"
+#include "GeoDataParser.h"
+
+using namespace Marble;
+using namespace Marble::BenchmarkHelper;
+
+namespace
+{
+
+QByteArray syntheticDocument( int megabytes )
+{
+    QByteArray result;
+    QTextStream stream( &result );
+    stream.setRealNumberNotation( QTextStream::FixedNotation );
+    stream << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+           << "<kml xmlns=\"http://www.opengis.net/kml/2.2\" xmlns:gx=\"http://www.google.com/kml/ext/2.2\">\n"
+           << "<Document>\n";
+
+    qsrand( 42 );
+    for ( int i = 0; stream.pos() < megabytes * 1024 * 1024; ++i ) {
+        qreal lon = 360.0 * qrand() / RAND_MAX - 180.0;
+        qreal lat = 160.0 * qrand() / RAND_MAX - 80.0;
+        stream << "<Placemark><name>Placemark " << i << "</name>\n";
+        if ( i % 2 ) {
+            stream.setRealNumberPrecision( 7 );
+            stream << "<LineString><coordinates>\n";
+            for ( int j = 0; j < 500; ++j ) {
+                lon += 0.0001 * ( qrand() % 10 );
+                lat += 0.0001 * ( qrand() % 10 );
+                stream << lon << ',' << lat << ',' << ( j % 300 ) << '\n';
+            }
+            stream << "</coordinates></LineString>\n";
+        } else {
+            stream.setRealNumberPrecision( 9 );
+            stream << "<gx:Track>\n";
+            for ( int j = 0; j < 200; ++j ) {
+                stream << "<when>2012-03-" << QString::number( 1 + j / 100 ).rightJustified( 2, '0' )
+                       << "T10:" << QString::number( ( j / 60 ) % 60 ).rightJustified( 2, '0' )
+                       << ':' << QString::number( j % 60 ).rightJustified( 2, '0' ) << "Z</when>\n";
+            }
+            for ( int j = 0; j < 200; ++j ) {
+                lon += 0.00001 * ( qrand() % 10 );
+                lat += 0.00001 * ( qrand() % 10 );
+                stream << "<gx:coord>" << lon << ' ' << lat << ' ' << 100.5 + j << "</gx:coord>\n";
+            }
+            stream << "</gx:Track>\n";
+        }
+        stream << "</Placemark>\n";
+    }
+
+    stream << "</Document>\n</kml>\n";
+    stream.flush();
+    return result;
+}
+
+}
+
+int main( int argc, char *argv[] )
+{
+    QCoreApplication app( argc, argv );
+    QStringList arguments = app.arguments();
+    arguments.removeFirst();
+
+    const int size = qMax( 1, option( arguments, "--size", "20" ).toInt() );
+    const int iterations = qMax( 1, option( arguments, "--iterations", "5" ).toInt() );
+
+    const QStringList files = positionalArguments( arguments );
+
+    QTextStream output( stdout );
+    writeThroughputHeader( output );
+
+    QList<QPair<QString, QByteArray> > documents;
+    if ( files.isEmpty() ) {
+        documents << qMakePair( QString( "synthetic" ), syntheticDocument( size ) );
+    }
+    foreach( const QString &fileName, files ) {
+        QFile file( fileName );
+        if ( !file.open( QIODevice::ReadOnly ) ) {
+            qCritical() << "Cannot open" << fileName;
+            return 1;
+        }
+        documents << qMakePair( fileName, file.readAll() );
+    }
+
+    for ( int i = 0; i < documents.size(); ++i ) {
+        QByteArray &data = documents[i].second;
+        QVector<qreal> times;
+        for ( int j = 0; j < iterations; ++j ) {
+            QBuffer buffer( &data );
+            buffer.open( QIODevice::ReadOnly );
+            GeoDataParser parser( GeoData_KML );
+
+            QTime timer;
+            timer.start();
+            if ( !parser.read( &buffer ) ) {
+                qCritical() << "Failed to parse" << documents.at( i ).first << parser.errorString();
+                return 1;
+            }
+            times << timer.elapsed();
+            delete parser.releaseDocument();
+        }
+
+        writeThroughput( output, documents.at( i ).first, data.size(), times );
+    }
+
+    return 0;
+}
@@ -0,0 +1,178 @@
+//
+// This file is part of the Marble Virtual Globe.
+//
+// This program is free software licensed under the GNU LGPL. You can
+// find a copy of this license in LICENSE.txt in the top directory of
+// the source code.
+//
+// Copyright 2026      agent <agent@local>
+//
+
+// Creates synthetic address databases in the format of osm-addresses, one
+// per "country", and measures search times of the local-osm-search runner
+// over them. Results are reported as tab separated values.
+//
+// Usage: LocalOsmSearchBenchmark [--shards 1,4,16] [--placemarks 100000]
+//            [--iterations 20] [--directory /tmp/local-osm-search-benchmark]
+//            [--output results.tsv]
+//
+// Each shard covers a 2x2 degree cell next to the previous one. Every case
+// is run without a preferred area (all shards are searched) and with the
+// area of the first shard as preferred area (only that shard is searched).
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QStringList>
+#include <QtCore/QTextStream>
+#include <QtCore/QTime>
+#include <QtCore/QVector>
+#include <QtSql/QSqlDatabase>
+
+#include "BenchmarkHelper.h"
+#include "GeoDataLatLonBox.h"
+#include "OsmDatabase.h"
+#include "OsmPlacemark.h"
+#include "OsmRegion.h"
+#include "SqlWriter.h"
+
+using namespace Marble;
+using namespace Marble::BenchmarkHelper;
+
+namespace
+{
+
+GeoDataLatLonBox shardArea( int shard )
+{
+    const qreal west = -10.0 + 2.0 * shard;
+    return GeoDataLatLonBox( 52.0, 50.0, west + 2.0, west, GeoDataCoordinates::Degree );
+}
+
+/** Writes a database through SqlWriter of osm-addresses */
+bool createShard( const QString &fileName, int shard, int placemarks )
+{
+    QFile::remove( fileName );
+    {
+        SqlWriter writer( fileName );
+        if ( !QSqlDatabase::database().isOpen() ) {
+            qCritical() << "Cannot create" << fileName;
+            return false;
+        }
+
+        // A country with ten cities as nested set
+        const GeoDataLatLonBox area = shardArea( shard );
+        const int regions = 10;
+        const int firstRegion = shard * ( regions + 1 ) + 1;
+        OsmRegion country;
+        country.setIdentifier( firstRegion );
+        country.setParentIdentifier( 0 );
+        country.setLeft( 1 );
+        country.setRight( 2 * regions + 2 );
+        country.setName( QString( "Country %1" ).arg( shard ) );
+        country.setLongitude( area.center().longitude( GeoDataCoordinates::Degree ) );
+        country.setLatitude( area.center().latitude( GeoDataCoordinates::Degree ) );
+        writer.addOsmRegion( country );
+        for ( int i = 0; i < regions; ++i ) {
+            OsmRegion city;
+            city.setIdentifier( firstRegion + 1 + i );
+            city.setParentIdentifier( firstRegion );
+            city.setLeft( 2 + 2 * i );
+            city.setRight( 3 + 2 * i );
+            city.setName( QString( "City %1-%2" ).arg( shard ).arg( i ) );
+            city.setLongitude( area.west( GeoDataCoordinates::Degree ) + 0.2 * i );
+            city.setLatitude( area.south( GeoDataCoordinates::Degree ) + 0.2 * i );
+            writer.addOsmRegion( city );
+        }
+
+        // Streets with house numbers, and some hotels
+        const int streets = qMax( 1, placemarks / 20 );
+        qsrand( shard );
+        for ( int i = 0; i < placemarks; ++i ) {
+            const bool hotel = i % 100 == 0;
+            OsmPlacemark placemark;
+            placemark.setRegionId( firstRegion + 1 + i % regions );
+            placemark.setName( hotel ? QString( "Hotel" ) : QString( "Street %1" ).arg( i % streets ) );
+            placemark.setHouseNumber( hotel ? QString() : QString::number( 1 + i / streets ) );
+            placemark.setCategory( hotel ? OsmPlacemark::AccomodationHotel : OsmPlacemark::Address );
+            placemark.setLongitude( area.west( GeoDataCoordinates::Degree ) + 2.0 * qrand() / RAND_MAX );
+            placemark.setLatitude( area.south( GeoDataCoordinates::Degree ) + 2.0 * qrand() / RAND_MAX );
+            writer.addOsmPlacemark( placemark );
+        }
+    }
+    QSqlDatabase::database().close();
+    QSqlDatabase::removeDatabase( QSqlDatabase::defaultConnection );
+    return true;
+}
+
+}
+
+int main( int argc, char *argv[] )
+{
+    QCoreApplication app( argc, argv );
+    const QStringList arguments = app.arguments();
+
+    const int placemarks = option( arguments, "--placemarks", "100000" ).toInt();
+    const int iterations = qMax( 1, option( arguments, "--iterations", "20" ).toInt() );
+    const QDir directory( option( arguments, "--directory", QDir::tempPath() + "/local-osm-search-benchmark" ) );
+    if ( !QDir().mkpath( directory.absolutePath() ) ) {
+        qCritical() << "Cannot create" << directory.absolutePath();
+        return 1;
+    }
+
+    QFile outputFile;
+    if ( !openOutput( outputFile, option( arguments, "--output" ) ) ) {
+        return 1;
+    }
+
+    QTextStream stream( &outputFile );
+    stream << "shards\tplacemarks\tquery\tpreferred\tresults\tmedian_ms\tmax_ms\n";
+
+    const QStringList queries = QStringList() << "Street 42" << "Street 4*" << "Street 7 3, City 0-3" << "hotel";
+
+    int existingShards = 0;
+    foreach( const QString &shardsOption, listOption( arguments, "--shards", "1,4,16" ) ) {
+        const int shards = qMax( 1, shardsOption.toInt() );
+
+        OsmDatabase database;
+        for ( int i = 0; i < shards; ++i ) {
+            const QString fileName = directory.filePath( QString( "shard-%1-%2.sqlite" ).arg( placemarks ).arg( i ) );
+            if ( i >= existingShards || !QFile::exists( fileName ) ) {
+                if ( !createShard( fileName, i, placemarks ) ) {
+                    qCritical() << "Failed to create" << fileName;
+                    return 1;
+                }
+            }
+            database.addFile( fileName );
+        }
+        existingShards = qMax( existingShards, shards );
+
+        foreach( const QString &query, queries ) {
+            for ( int preferred = 0; preferred < 2; ++preferred ) {
+                const GeoDataLatLonBox area = preferred ? shardArea( 0 ) : GeoDataLatLonBox();
+                QVector<qreal> times;
+                int results = 0;
+
+                // The first search opens the connections and warms up the page cache
+                database.find( 0, query, area );
+                for ( int i = 0; i < iterations; ++i ) {
+                    QTime timer;
+                    timer.start();
+                    results = database.find( 0, query, area ).size();
+                    times << timer.elapsed();
+                }
+
+                qreal maximum = 0.0;
+                foreach( qreal time, times ) {
+                    maximum = qMax( maximum, time );
+                }
+
+                stream << shards << '\t' << placemarks << '\t' << query << '\t' << ( preferred ? "yes" : "no" ) << '\t'
+                       << results << '\t' << median( times ) << '\t' << maximum << '\n';
+                stream.flush();
+            }
+        }
+    }
+
+    return 0;
+}
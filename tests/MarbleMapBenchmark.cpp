@@ -0,0 +1,433 @@
+//
+// This file is part of the Marble Virtual Globe.
+//
+// This program is free software licensed under the GNU LGPL. You can
+// find a copy of this license in LICENSE.txt in the top directory of
+// the source code.
+//
+// Copyright 2026      agent <agent@local>
+//
+
+// Renders a scripted matrix of views with MarbleMap into an offscreen
+// image and reports frame time statistics as tab separated values.
+//
+// Usage: MarbleMapBenchmark [--themes earth/plain/plain.dgml,...]
+//            [--projections spherical,equirectangular,mercator]
+//            [--radii 250,1000] [--qualities normal,high] [--sizes 800x600]
+//            [--paths still,pan,zoom] [--frames 50] [--warmup 1]
+//            [--output results.tsv] [--baseline baseline.tsv] [--tolerance 10]
+//
+// Only bundled map data is used, downloads are disabled. When a baseline
+// is given, the median frame time of each case is compared against it and
+// the exit code is non-zero if any case got slower than the tolerance (in
+// percent) allows.
+
+#include <QtCore/QDateTime>
+#include <QtCore/QDebug>
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QStringList>
+#include <QtCore/QTextStream>
+#include <QtCore/QThreadPool>
+#include <QtCore/QTime>
+#include <QtCore/QVector>
+#include <QtGui/QApplication>
+#include <QtGui/QImage>
+
+#if QT_VERSION >= 0x040800
+#include <QtCore/QElapsedTimer>
+#endif
+
+#include <cmath>
+
+#include "BenchmarkHelper.h"
+#include "GeoPainter.h"
+#include "LayerInterface.h"
+#include "MarbleDirs.h"
+#include "MarbleMap.h"
+#include "MarbleModel.h"
+
+namespace Marble
+{
+
+/** Millisecond timer, with sub-millisecond resolution where Qt provides it */
+class FrameTimer
+{
+public:
+    void start()
+    {
+        m_timer.start();
+    }
+
+    qreal elapsed() const
+    {
+#if QT_VERSION >= 0x040800
+        return m_timer.nsecsElapsed() / 1000000.0;
+#else
+        return m_timer.elapsed();
+#endif
+    }
+
+private:
+#if QT_VERSION >= 0x040800
+    QElapsedTimer m_timer;
+#else
+    QTime m_timer;
+#endif
+};
+
+/**
+ * Takes a time stamp whenever a render position starts. It sorts before
+ * all other layers of a render position, so the difference between two
+ * subsequent stamps is the time spent in all layers of the former one.
+ */
+class ProbeLayer : public LayerInterface
+{
+public:
+    explicit ProbeLayer( const FrameTimer *timer )
+        : m_timer( timer )
+    {
+    }
+
+    static QStringList positions()
+    {
+        return QStringList() << "STARS" << "BEHIND_TARGET" << "SURFACE"
+                             << "HOVERS_ABOVE_SURFACE" << "ATMOSPHERE" << "ORBIT"
+                             << "ALWAYS_ON_TOP" << "FLOAT_ITEM" << "USER_TOOLS";
+    }
+
+    virtual QStringList renderPosition() const
+    {
+        return positions();
+    }
+
+    virtual qreal zValue() const
+    {
+        return -1.0e9;
+    }
+
+    virtual bool render( GeoPainter *painter, ViewportParams *viewport,
+                         const QString &renderPos, GeoSceneLayer *layer )
+    {
+        Q_UNUSED( painter );
+        Q_UNUSED( viewport );
+        Q_UNUSED( layer );
+        m_stamps.append( qMakePair( renderPos, m_timer->elapsed() ) );
+        return true;
+    }
+
+    void clear()
+    {
+        m_stamps.clear();
+    }
+
+    /** Adds the time spent in each render position, ending at @p frameEnd */
+    void accumulate( qreal frameEnd, QHash<QString, qreal> &stageTimes ) const
+    {
+        for ( int i = 0; i < m_stamps.size(); ++i ) {
+            const qreal end = i + 1 < m_stamps.size() ? m_stamps.at( i + 1 ).second : frameEnd;
+            stageTimes[m_stamps.at( i ).first] += end - m_stamps.at( i ).second;
+        }
+    }
+
+private:
+    const FrameTimer *const m_timer;
+    QVector< QPair<QString, qreal> > m_stamps;
+};
+
+struct BenchmarkCase
+{
+    QString mapThemeId;
+    Projection projection;
+    int radius;
+    MapQuality quality;
+    QSize size;
+    QString path;
+
+    QString name() const
+    {
+        QString theme = mapThemeId.section( '/', -2, -2 );
+        return QString( "%1/%2/r%3/%4/%5x%6/%7" ).arg( theme ).arg( projectionName( projection ) )
+                .arg( radius ).arg( qualityName( quality ) ).arg( size.width() )
+                .arg( size.height() ).arg( path );
+    }
+
+    static QString projectionName( Projection projection )
+    {
+        switch ( projection ) {
+        case Spherical:       return "spherical";
+        case Equirectangular: return "equirectangular";
+        case Mercator:        return "mercator";
+        }
+        return QString();
+    }
+
+    static QString qualityName( MapQuality quality )
+    {
+        switch ( quality ) {
+        case OutlineQuality: return "outline";
+        case LowQuality:     return "low";
+        case NormalQuality:  return "normal";
+        case HighQuality:    return "high";
+        case PrintQuality:   return "print";
+        }
+        return QString();
+    }
+};
+
+struct BenchmarkResult
+{
+    QString name;
+    QVector<qreal> frameTimes;
+    QHash<QString, qreal> stageTimes;
+
+    qreal percentile( qreal p ) const
+    {
+        // nearest rank on the sorted frame times
+        const int rank = qBound( 0, int( ceil( p * frameTimes.size() ) ) - 1, frameTimes.size() - 1 );
+        return frameTimes.at( rank );
+    }
+
+    qreal mean() const
+    {
+        qreal sum = 0.0;
+        foreach( qreal time, frameTimes ) {
+            sum += time;
+        }
+        return sum / frameTimes.size();
+    }
+};
+
+class MarbleMapBenchmark
+{
+public:
+    MarbleMapBenchmark()
+        : m_map( &m_model ),
+          m_probe( &m_timer ),
+          m_frames( 50 ),
+          m_warmup( 1 )
+    {
+        // Keep the views reproducible: no downloads and a fixed sun position
+        m_model.setWorkOffline( true );
+        m_model.setClockSpeed( 0 );
+        m_model.setClockDateTime( QDateTime( QDate( 2012, 3, 20 ), QTime( 12, 0 ), Qt::UTC ) );
+        m_map.addLayer( &m_probe );
+    }
+
+    ~MarbleMapBenchmark()
+    {
+        m_map.removeLayer( &m_probe );
+    }
+
+    void setFrames( int frames ) { m_frames = qMax( 1, frames ); }
+    void setWarmup( int warmup ) { m_warmup = qMax( 0, warmup ); }
+
+    BenchmarkResult run( const BenchmarkCase &benchmarkCase )
+    {
+        if ( m_map.mapThemeId() != benchmarkCase.mapThemeId ) {
+            m_map.setMapThemeId( benchmarkCase.mapThemeId );
+        }
+        m_map.setProjection( benchmarkCase.projection );
+        m_map.setSize( benchmarkCase.size );
+        m_map.setMapQualityForViewContext( benchmarkCase.quality, Still );
+        m_map.setViewContext( Still );
+        m_map.setShowFrameRate( false );
+
+        QImage image( benchmarkCase.size, QImage::Format_ARGB32_Premultiplied );
+
+        // Run the whole path before measuring so that tiles and
+        // placemarks are loaded and the caches are filled
+        for ( int i = 0; i < m_warmup; ++i ) {
+            for ( int frame = 0; frame < m_frames; ++frame ) {
+                setView( benchmarkCase, frame );
+                paint( image );
+                settle();
+            }
+        }
+
+        BenchmarkResult result;
+        result.name = benchmarkCase.name();
+        result.frameTimes.reserve( m_frames );
+        for ( int frame = 0; frame < m_frames; ++frame ) {
+            setView( benchmarkCase, frame );
+            image.fill( 0 );
+            m_probe.clear();
+            const qreal frameTime = paint( image );
+            m_probe.accumulate( frameTime, result.stageTimes );
+            result.frameTimes.append( frameTime );
+        }
+        settle();
+
+        foreach( const QString &stage, result.stageTimes.keys() ) {
+            result.stageTimes[stage] /= m_frames;
+        }
+        qSort( result.frameTimes );
+        return result;
+    }
+
+private:
+    qreal paint( QImage &image )
+    {
+        const bool doClip = m_map.radius() > m_map.width() / 2 || m_map.radius() > m_map.height() / 2;
+        GeoPainter painter( &image, m_map.viewport(), m_map.mapQuality(), doClip );
+        m_timer.start();
+        m_map.paint( painter, QRect() );
+        return m_timer.elapsed();
+    }
+
+    void setView( const BenchmarkCase &benchmarkCase, int frame )
+    {
+        const qreal progress = qreal( frame ) / m_frames;
+        qreal lon = 8.4;
+        qreal lat = 49.0;
+        int radius = benchmarkCase.radius;
+
+        if ( benchmarkCase.path == "pan" ) {
+            // once around the globe, with a gentle swing in latitude
+            lon += 360.0 * progress;
+            lat = 30.0 * sin( 2 * M_PI * progress );
+        }
+        else if ( benchmarkCase.path == "zoom" ) {
+            // zoom in by a factor of 16 and back out again
+            const qreal exponent = 4.0 * ( 1.0 - qAbs( 2.0 * progress - 1.0 ) );
+            radius = qRound( benchmarkCase.radius * pow( 2.0, exponent ) );
+        }
+
+        m_map.setRadius( radius );
+        m_map.centerOn( lon > 180.0 ? lon - 360.0 : lon, lat );
+    }
+
+    void settle()
+    {
+        QThreadPool::globalInstance()->waitForDone();
+        QCoreApplication::processEvents();
+    }
+
+    MarbleModel m_model;
+    MarbleMap m_map;
+    FrameTimer m_timer;
+    ProbeLayer m_probe;
+    int m_frames;
+    int m_warmup;
+};
+
+}
+
+using namespace Marble;
+using namespace Marble::BenchmarkHelper;
+
+QHash<QString, qreal> readBaseline( const QString &filename )
+{
+    QHash<QString, qreal> baseline;
+    QFile file( filename );
+    if ( !file.open( QIODevice::ReadOnly ) ) {
+        qWarning() << "Cannot open baseline" << filename;
+        return baseline;
+    }
+
+    QTextStream stream( &file );
+    int column = -1;
+    while ( !stream.atEnd() ) {
+        const QStringList fields = stream.readLine().split( '\t' );
+        if ( fields.first() == "case" ) {
+            column = fields.indexOf( "p50" );
+        } else if ( column > 0 && column < fields.size() ) {
+            baseline[fields.first()] = fields.at( column ).toDouble();
+        }
+    }
+
+    return baseline;
+}
+
+int main( int argc, char *argv[] )
+{
+    QApplication app( argc, argv );
+    const QStringList arguments = app.arguments();
+
+    MarbleDirs::setMarbleDataPath( DATA_PATH );
+    MarbleDirs::setMarblePluginPath( PLUGIN_PATH );
+
+    QHash<QString, Projection> projections;
+    projections["spherical"] = Spherical;
+    projections["equirectangular"] = Equirectangular;
+    projections["mercator"] = Mercator;
+
+    QHash<QString, MapQuality> qualities;
+    qualities["outline"] = OutlineQuality;
+    qualities["low"] = LowQuality;
+    qualities["normal"] = NormalQuality;
+    qualities["high"] = HighQuality;
+    qualities["print"] = PrintQuality;
+
+    QList<BenchmarkCase> cases;
+    foreach( const QString &theme, listOption( arguments, "--themes", "earth/plain/plain.dgml,earth/srtm/srtm.dgml,earth/bluemarble/bluemarble.dgml" ) ) {
+        foreach( const QString &projection, listOption( arguments, "--projections", "spherical,equirectangular,mercator" ) ) {
+            foreach( const QString &radius, listOption( arguments, "--radii", "250,1000" ) ) {
+                foreach( const QString &quality, listOption( arguments, "--qualities", "normal,high" ) ) {
+                    foreach( const QString &size, listOption( arguments, "--sizes", "800x600" ) ) {
+                        foreach( const QString &path, listOption( arguments, "--paths", "still,pan,zoom" ) ) {
+                            if ( !projections.contains( projection ) || !qualities.contains( quality ) ) {
+                                qWarning() << "Ignoring unknown projection or quality" << projection << quality;
+                                continue;
+                            }
+                            BenchmarkCase benchmarkCase;
+                            benchmarkCase.mapThemeId = theme;
+                            benchmarkCase.projection = projections[projection];
+                            benchmarkCase.radius = radius.toInt();
+                            benchmarkCase.quality = qualities[quality];
+                            benchmarkCase.size = QSize( size.section( 'x', 0, 0 ).toInt(), size.section( 'x', 1, 1 ).toInt() );
+                            benchmarkCase.path = path;
+                            cases << benchmarkCase;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    MarbleMapBenchmark benchmark;
+    benchmark.setFrames( option( arguments, "--frames", "50" ).toInt() );
+    benchmark.setWarmup( option( arguments, "--warmup", "1" ).toInt() );
+
+    QFile outputFile;
+    if ( !openOutput( outputFile, option( arguments, "--output" ) ) ) {
+        return 1;
+    }
+
+    const QString baselineFile = option( arguments, "--baseline" );
+    const QHash<QString, qreal> baseline = baselineFile.isEmpty() ? QHash<QString, qreal>() : readBaseline( baselineFile );
+    const qreal tolerance = 1.0 + option( arguments, "--tolerance", "10" ).toDouble() / 100.0;
+
+    // All times are in milliseconds, stages are the mean time spent per frame
+    QTextStream stream( &outputFile );
+    stream << "case\tframes\tmean\tp50\tp90\tp99\tmax";
+    foreach( const QString &stage, ProbeLayer::positions() ) {
+        stream << '\t' << stage;
+    }
+    if ( !baseline.isEmpty() ) {
+        stream << "\tbaseline_p50";
+    }
+    stream << endl;
+
+    int regressions = 0;
+    foreach( const BenchmarkCase &benchmarkCase, cases ) {
+        const BenchmarkResult result = benchmark.run( benchmarkCase );
+        stream << result.name << '\t' << result.frameTimes.size() << '\t' << result.mean()
+               << '\t' << result.percentile( 0.5 ) << '\t' << result.percentile( 0.9 )
+               << '\t' << result.percentile( 0.99 ) << '\t' << result.frameTimes.last();
+        foreach( const QString &stage, ProbeLayer::positions() ) {
+            stream << '\t' << result.stageTimes.value( stage );
+        }
+        if ( !baseline.isEmpty() ) {
+            stream << '\t' << baseline.value( result.name, -1 );
+            if ( baseline.contains( result.name ) && result.percentile( 0.5 ) > baseline[result.name] * tolerance ) {
+                qWarning() << "Regression in" << result.name << ":" << result.percentile( 0.5 )
+                           << "ms instead of" << baseline[result.name] << "ms";
+                ++regressions;
+            }
+        }
+        stream << endl;
+    }
+
+    return regressions > 0 ? 1 : 0;
+}
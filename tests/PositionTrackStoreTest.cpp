@@ -0,0 +1,138 @@
+//
+// This file is part of the Marble Virtual Globe.
+//
+// This program is free software licensed under the GNU LGPL. You can
+// find a copy of this license in LICENSE.txt in the top directory of
+// the source code.
+//
+// Copyright 2026      agent <agent@local>
+//
+
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QObject>
+#include <QtTest/QtTest>
+
+#include "GeoDataLineString.h"
+#include "GeoDataMultiGeometry.h"
+#include "PositionTrackStore.h"
+
+using namespace Marble;
+
+class PositionTrackStoreTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void simplifyStraightLine();
+    void simplifyKeepsCorner();
+    void boundedSize();
+    void spillFile();
+
+private:
+    /** A zigzag track with about 10 meters between subsequent positions */
+    static GeoDataCoordinates position( int i );
+};
+
+GeoDataCoordinates PositionTrackStoreTest::position( int i )
+{
+    const qreal step = 10.0 / EARTH_RADIUS;
+    const qreal lon = ( i % 1000 < 500 ? i % 500 : 500 - i % 500 ) * step;
+    const qreal lat = ( i / 500 ) * 50.0 * step;
+    return GeoDataCoordinates( lon, lat );
+}
+
+void PositionTrackStoreTest::simplifyStraightLine()
+{
+    GeoDataLineString line;
+    for ( int i = 0; i < 100; ++i ) {
+        line.append( GeoDataCoordinates( 0.0001 * i, 0.0 ) );
+    }
+
+    const GeoDataLineString result = PositionTrackStore::simplified( line, 1.0 );
+    QCOMPARE( result.size(), 2 );
+    QCOMPARE( result.first(), line.first() );
+    QCOMPARE( result.last(), line.last() );
+}
+
+void PositionTrackStoreTest::simplifyKeepsCorner()
+{
+    GeoDataLineString line;
+    for ( int i = 0; i <= 50; ++i ) {
+        line.append( GeoDataCoordinates( 0.0001 * i, 0.0 ) );
+    }
+    for ( int i = 1; i <= 50; ++i ) {
+        line.append( GeoDataCoordinates( 0.005, 0.0001 * i ) );
+    }
+
+    const GeoDataLineString result = PositionTrackStore::simplified( line, 1.0 );
+    QCOMPARE( result.size(), 3 );
+    QCOMPARE( result.at( 1 ), line.at( 50 ) );
+}
+
+void PositionTrackStoreTest::boundedSize()
+{
+    PositionTrackStore store;
+    store.setRecentSize( 100 );
+    store.setChunkSize( 50 );
+
+    GeoDataMultiGeometry track;
+    store.rebuild( &track );
+
+    const int count = 50000;
+    for ( int i = 0; i < count; ++i ) {
+        if ( store.append( position( i ) ) ) {
+            store.rebuild( &track );
+        }
+    }
+
+    QVERIFY( !store.isEmpty() );
+    QVERIFY( store.size() < count / 10 );
+    QCOMPARE( store.currentLineString()->last(), position( count - 1 ) );
+
+    GeoDataMultiGeometry exported;
+    store.exportTrack( &exported );
+    QCOMPARE( exported.size(), 1 );
+    QCOMPARE( static_cast<GeoDataLineString*>( exported.child( 0 ) )->first(), position( 0 ) );
+
+    store.clear();
+    QVERIFY( store.isEmpty() );
+}
+
+void PositionTrackStoreTest::spillFile()
+{
+    PositionTrackStore store;
+    store.setRecentSize( 10 );
+    store.setChunkSize( 10 );
+    store.setSpillEnabled( true );
+    const QString fileName = store.spillFile();
+    QVERIFY( !fileName.isEmpty() );
+
+    for ( int i = 0; i < 95; ++i ) {
+        store.append( position( i ) );
+    }
+    store.startSegment();
+    for ( int i = 0; i < 5; ++i ) {
+        store.append( position( i ) );
+    }
+    QVERIFY( QFile::exists( fileName ) );
+
+    GeoDataMultiGeometry exported;
+    store.exportTrack( &exported );
+    QCOMPARE( exported.size(), 2 );
+    const GeoDataLineString *first = static_cast<GeoDataLineString*>( exported.child( 0 ) );
+    QCOMPARE( first->size(), 95 );
+    for ( int i = 0; i < 95; ++i ) {
+        QCOMPARE( first->at( i ), position( i ) );
+    }
+    QCOMPARE( static_cast<GeoDataLineString*>( exported.child( 1 ) )->size(), 5 );
+
+    store.clear();
+    QCOMPARE( QFileInfo( fileName ).size(), qint64( 0 ) );
+
+    store.setSpillEnabled( false );
+    QVERIFY( !QFile::exists( fileName ) );
+}
+
+QTEST_MAIN( PositionTrackStoreTest )
+
+#include "PositionTrackStoreTest.moc"
@@ -0,0 +1,255 @@
+//
+// This file is part of the Marble Virtual Globe.
+//
+// This program is free software licensed under the GNU LGPL. You can
+// find a copy of this license in LICENSE.txt in the top directory of
+// the source code.
+//
+// Copyright 2026      agent <agent@local>
+//
+
+#include <QtCore/QDir>
+#include <QtCore/QHash>
+#include <QtCore/QObject>
+#include <QtCore/QTemporaryFile>
+#include <QtCore/QTextStream>
+#include <QtCore/QVector>
+#include <QtTest/QtTest>
+
+#include "ContractionHierarchy.h"
+#include "OsmRoutingReader.h"
+#include "RoutingGraph.h"
+#include "RoutingGraphFormat.h"
+#include "RoutingGraphWriter.h"
+
+using namespace Marble;
+
+/**
+ * Preprocesses a small hand-made road network with the routing-graph tool
+ * classes and checks the routes of RoutingGraph on it.
+ *
+ * Nodes 1 to 9 form a grid of three rows from north to south (1-3, 4-6, 7-9).
+ * Neighbors in a row are about 715 m apart, the rows 1113 m. The middle row
+ * is a primary road, the middle column a one-way secondary road to the south,
+ * all others are residential. Node 10 is a dead end only reachable
+ * through a one-way road from node 9, and nodes 11 and 12 are a separate road.
+ */
+class RoutingGraphTest : public QObject
+{
+    Q_OBJECT
+public:
+    RoutingGraphTest() : m_graph( 0 ) {}
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void shortestPath();
+    void oneway();
+    void unreachable();
+    void matchesDijkstra();
+
+private:
+    /** The graph node of the node with the given id of the .osm file */
+    quint32 node( int osmId ) const;
+
+    /** Travel time of the fastest path using the edges of the original road network */
+    quint32 dijkstra( quint32 source, quint32 target ) const;
+
+    static quint32 pathWeight( const RoutingGraph::Path &path );
+
+    QTemporaryFile m_graphFile;
+    RoutingGraph *m_graph;
+    QHash<int, GeoDataCoordinates> m_coordinates;
+    QVector<RoadEdge> m_edges; ///< Of the original road network, with graph nodes
+};
+
+void RoutingGraphTest::initTestCase()
+{
+    for ( int i = 0; i < 9; ++i ) {
+        m_coordinates[i + 1] = GeoDataCoordinates( 8.0 + 0.01 * ( i % 3 ), 50.0 - 0.01 * ( i / 3 ), 0.0, GeoDataCoordinates::Degree );
+    }
+    m_coordinates[10] = GeoDataCoordinates( 8.03, 49.98, 0.0, GeoDataCoordinates::Degree );
+    m_coordinates[11] = GeoDataCoordinates( 8.10, 50.10, 0.0, GeoDataCoordinates::Degree );
+    m_coordinates[12] = GeoDataCoordinates( 8.11, 50.10, 0.0, GeoDataCoordinates::Degree );
+
+    QTemporaryFile osmFile( QDir::tempPath() + "/RoutingGraphTest-XXXXXX.osm" );
+    QVERIFY( osmFile.open() );
+    {
+        QTextStream stream( &osmFile );
+        stream << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<osm version=\"0.6\">\n";
+        stream.setRealNumberNotation( QTextStream::FixedNotation );
+        stream.setRealNumberPrecision( 7 );
+        foreach( int id, m_coordinates.keys() ) {
+            stream << "<node id=\"" << id << "\" lat=\"" << m_coordinates[id].latitude( GeoDataCoordinates::Degree )
+                   << "\" lon=\"" << m_coordinates[id].longitude( GeoDataCoordinates::Degree ) << "\"/>\n";
+        }
+
+        const char *const ways[][3] = {
+            { "1 2 3", "residential", "" },
+            { "4 5 6", "primary", "" },
+            { "7 8 9", "residential", "" },
+            { "1 4 7", "residential", "" },
+            { "2 5 8", "secondary", "yes" },
+            { "3 6 9", "residential", "" },
+            { "9 10", "residential", "yes" },
+            { "11 12", "residential", "" }
+        };
+        for ( unsigned int i = 0; i < sizeof( ways ) / sizeof( ways[0] ); ++i ) {
+            stream << "<way id=\"" << i + 1 << "\">\n";
+            foreach( const QString &ref, QString( ways[i][0] ).split( ' ' ) ) {
+                stream << "<nd ref=\"" << ref << "\"/>\n";
+            }
+            stream << "<tag k=\"highway\" v=\"" << ways[i][1] << "\"/>\n";
+            if ( *ways[i][2] ) {
+                stream << "<tag k=\"oneway\" v=\"" << ways[i][2] << "\"/>\n";
+            }
+            stream << "</way>\n";
+        }
+        stream << "</osm>\n";
+    }
+    osmFile.close();
+
+    OsmRoutingReader reader( Motorcar );
+    QVERIFY( reader.read( osmFile.fileName() ) );
+
+    ContractionHierarchy hierarchy( reader.longitudes().size() );
+    foreach( const RoadEdge &edge, reader.edges() ) {
+        hierarchy.addEdge( edge.from, edge.to, edge.weight, edge.way );
+    }
+    hierarchy.contract();
+
+    QVERIFY( m_graphFile.open() );
+    m_graphFile.close();
+    QVERIFY( RoutingGraphWriter( reader, hierarchy ).write( m_graphFile.fileName(), Motorcar ) );
+
+    m_graph = new RoutingGraph( m_graphFile.fileName() );
+    QVERIFY( m_graph->isValid() );
+
+    // The writer renumbers the nodes, find them by their position
+    foreach( RoadEdge edge, reader.edges() ) {
+        const qreal factor = RoutingGraphFormat::CoordinateFactor;
+        const GeoDataCoordinates from( reader.longitudes()[edge.from] / factor, reader.latitudes()[edge.from] / factor,
+                                       0.0, GeoDataCoordinates::Degree );
+        const GeoDataCoordinates to( reader.longitudes()[edge.to] / factor, reader.latitudes()[edge.to] / factor,
+                                     0.0, GeoDataCoordinates::Degree );
+        edge.from = m_graph->nearestNode( from, 1.0 );
+        edge.to = m_graph->nearestNode( to, 1.0 );
+        m_edges << edge;
+    }
+}
+
+void RoutingGraphTest::cleanupTestCase()
+{
+    delete m_graph;
+}
+
+quint32 RoutingGraphTest::node( int osmId ) const
+{
+    const qint64 result = m_graph->nearestNode( m_coordinates[osmId], 1.0 );
+    Q_ASSERT( result >= 0 );
+    return result;
+}
+
+quint32 RoutingGraphTest::dijkstra( quint32 source, quint32 target ) const
+{
+    const quint32 infinity = 0xffffffff;
+    QVector<quint32> distances( m_coordinates.size(), infinity );
+    QVector<bool> settled( m_coordinates.size(), false );
+    distances[source] = 0;
+    forever {
+        int current = -1;
+        for ( int i = 0; i < distances.size(); ++i ) {
+            if ( !settled[i] && distances[i] != infinity && ( current < 0 || distances[i] < distances[current] ) ) {
+                current = i;
+            }
+        }
+        if ( current < 0 || quint32( current ) == target ) {
+            break;
+        }
+
+        settled[current] = true;
+        foreach( const RoadEdge &edge, m_edges ) {
+            if ( edge.from == quint32( current ) ) {
+                distances[edge.to] = qMin( distances[edge.to], distances[current] + edge.weight );
+            }
+        }
+    }
+
+    return distances[target];
+}
+
+quint32 RoutingGraphTest::pathWeight( const RoutingGraph::Path &path )
+{
+    quint32 result = 0;
+    foreach( quint32 weight, path.weights ) {
+        result += weight;
+    }
+    return result;
+}
+
+void RoutingGraphTest::shortestPath()
+{
+    // The one-way secondary road in the middle is faster than the primary road
+    // or any residential road
+    RoutingGraph::Path path;
+    QVERIFY( m_graph->route( node( 1 ), node( 9 ), &path ) );
+
+    QVector<quint32> expected;
+    expected << node( 1 ) << node( 2 ) << node( 5 ) << node( 8 ) << node( 9 );
+    QCOMPARE( path.nodes, expected );
+    QCOMPARE( path.ways.size(), path.nodes.size() - 1 );
+    QCOMPARE( path.weights.size(), path.nodes.size() - 1 );
+}
+
+void RoutingGraphTest::oneway()
+{
+    // The way back cannot use the one-way road and takes the primary road instead
+    RoutingGraph::Path path;
+    QVERIFY( m_graph->route( node( 9 ), node( 1 ), &path ) );
+
+    QVector<quint32> expected;
+    expected << node( 9 ) << node( 6 ) << node( 5 ) << node( 4 ) << node( 1 );
+    QCOMPARE( path.nodes, expected );
+
+    RoutingGraph::Path deadEnd;
+    QVERIFY( m_graph->route( node( 1 ), node( 10 ), &deadEnd ) );
+    RoutingGraph::Path back;
+    QVERIFY( !m_graph->route( node( 10 ), node( 1 ), &back ) );
+}
+
+void RoutingGraphTest::unreachable()
+{
+    RoutingGraph::Path toIsland;
+    QVERIFY( !m_graph->route( node( 1 ), node( 11 ), &toIsland ) );
+    RoutingGraph::Path fromIsland;
+    QVERIFY( !m_graph->route( node( 12 ), node( 5 ), &fromIsland ) );
+    RoutingGraph::Path onIsland;
+    QVERIFY( m_graph->route( node( 11 ), node( 12 ), &onIsland ) );
+}
+
+void RoutingGraphTest::matchesDijkstra()
+{
+    const int nodes = m_coordinates.size();
+    for ( int source = 0; source < nodes; ++source ) {
+        for ( int target = 0; target < nodes; ++target ) {
+            if ( source == target ) {
+                continue;
+            }
+
+            const quint32 expected = dijkstra( source, target );
+            RoutingGraph::Path path;
+            const bool found = m_graph->route( source, target, &path );
+            QCOMPARE( found, expected != 0xffffffff );
+            if ( found ) {
+                QCOMPARE( path.nodes.first(), quint32( source ) );
+                QCOMPARE( path.nodes.last(), quint32( target ) );
+                QCOMPARE( pathWeight( path ), expected );
+            }
+        }
+    }
+}
+
+QTEST_MAIN( RoutingGraphTest )
+
+#include "RoutingGraphTest.moc"
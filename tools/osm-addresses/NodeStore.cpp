@@ -0,0 +1,196 @@
+//
+// This file is part of the Marble Virtual Globe.
+//
+// This program is free software licensed under the GNU LGPL. You can
+// find a copy of this license in LICENSE.txt in the top directory of
+// the source code.
+//
+// Copyright 2026      agent <agent@local>
+//
+
+#include "NodeStore.h"
+
+#include <QtCore/QDebug>
+#include <QtCore/QTemporaryFile>
+#include <QtCore/QtAlgorithms>
+
+#include <cmath>
+
+namespace Marble
+{
+
+// Number of entries buffered in memory before they are written to the backing file
+static const int BufferSize = 64 * 1024;
+
+static const double FixedPointFactor = 10000000.0;
+
+Coordinate::Coordinate(float lon_, float lat_) : lon(lon_), lat(lat_)
+{
+    // nothing to do
+}
+
+NodeStore::NodeStore() :
+    m_file( 0 ),
+    m_fileBacked( false ),
+    m_mapping( 0 ),
+    m_data( 0 ),
+    m_size( 0 ),
+    m_lastId( 0 ),
+    m_sorted( true )
+{
+    // nothing to do
+}
+
+NodeStore::~NodeStore()
+{
+    clear();
+    closeFile();
+}
+
+void NodeStore::setBackingDirectory( const QString &directory )
+{
+    Q_ASSERT( m_size == 0 );
+    closeFile();
+    m_fileBacked = !directory.isEmpty();
+    if ( !m_fileBacked ) {
+        return;
+    }
+
+    // A new file, so that no existing file of the user gets overwritten
+    m_file = new QTemporaryFile( directory + "/osm-addresses-nodes-XXXXXX.dat" );
+    if ( !m_file->open() ) {
+        qCritical() << "Unable to create a node store in " << directory << ", keeping nodes in memory.";
+        closeFile();
+    }
+}
+
+void NodeStore::append( qint64 id, const Coordinate &coordinate )
+{
+    Entry entry;
+    entry.id = id;
+    entry.lon = qint32( floor( coordinate.lon * FixedPointFactor + 0.5 ) );
+    entry.lat = qint32( floor( coordinate.lat * FixedPointFactor + 0.5 ) );
+
+    m_sorted = m_sorted && ( m_size == 0 || id > m_lastId );
+    m_lastId = id;
+    ++m_size;
+
+    m_entries.push_back( entry );
+    if ( m_fileBacked && m_entries.size() >= BufferSize ) {
+        flush();
+    }
+}
+
+void NodeStore::finish()
+{
+    if ( m_fileBacked ) {
+        flush();
+        if ( m_size > 0 ) {
+            m_mapping = m_file->map( 0, qint64( m_size ) * sizeof( Entry ) );
+            if ( !m_mapping ) {
+                qCritical() << "Unable to map node store " << m_file->fileName() << ": " << m_file->errorString();
+                m_data = 0;
+                m_size = 0;
+                return;
+            }
+            m_data = reinterpret_cast<const Entry*>( m_mapping );
+            if ( !m_sorted ) {
+                Entry* begin = reinterpret_cast<Entry*>( m_mapping );
+                qSort( begin, begin + m_size, lessId );
+            }
+        }
+    } else {
+        if ( !m_sorted ) {
+            qSort( m_entries.begin(), m_entries.end(), lessId );
+        }
+        m_entries.squeeze();
+        m_data = m_entries.constData();
+    }
+
+    m_sorted = true;
+}
+
+void NodeStore::clear()
+{
+    m_entries.clear();
+    m_data = 0;
+    m_size = 0;
+    m_lastId = 0;
+    m_sorted = true;
+    if ( m_mapping ) {
+        m_file->unmap( m_mapping );
+        m_mapping = 0;
+    }
+    if ( m_file ) {
+        m_file->resize( 0 );
+        m_file->seek( 0 );
+    }
+}
+
+int NodeStore::size() const
+{
+    return m_size;
+}
+
+bool NodeStore::contains( qint64 id ) const
+{
+    return find( id ) != 0;
+}
+
+Coordinate NodeStore::value( qint64 id ) const
+{
+    const Entry* entry = find( id );
+    return entry ? coordinate( *entry ) : Coordinate();
+}
+
+Coordinate NodeStore::at( int index ) const
+{
+    Q_ASSERT( m_data && index >= 0 && index < m_size );
+    return coordinate( m_data[index] );
+}
+
+bool NodeStore::lessId( const Entry &a, const Entry &b )
+{
+    return a.id < b.id;
+}
+
+Coordinate NodeStore::coordinate( const Entry &entry )
+{
+    return Coordinate( entry.lon / FixedPointFactor, entry.lat / FixedPointFactor );
+}
+
+const NodeStore::Entry* NodeStore::find( qint64 id ) const
+{
+    if ( !m_data ) {
+        return 0;
+    }
+
+    Entry key;
+    key.id = id;
+    const Entry* end = m_data + m_size;
+    const Entry* entry = qLowerBound( m_data, end, key, lessId );
+    return entry != end && entry->id == id ? entry : 0;
+}
+
+void NodeStore::closeFile()
+{
+    // Removes the temporary file
+    delete m_file;
+    m_file = 0;
+    m_fileBacked = false;
+}
+
+void NodeStore::flush()
+{
+    if ( m_entries.isEmpty() ) {
+        return;
+    }
+
+    qint64 const bytes = qint64( m_entries.size() ) * sizeof( Entry );
+    if ( m_file->write( reinterpret_cast<const char*>( m_entries.constData() ), bytes ) != bytes ) {
+        qCritical() << "Failed to write to node store " << m_file->fileName() << ": " << m_file->errorString();
+    }
+    m_entries.clear();
+}
+
+}
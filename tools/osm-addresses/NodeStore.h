@@ -0,0 +1,108 @@
+//
+// This file is part of the Marble Virtual Globe.
+//
+// This program is free software licensed under the GNU LGPL. You can
+// find a copy of this license in LICENSE.txt in the top directory of
+// the source code.
+//
+// Copyright 2026      agent <agent@local>
+//
+
+#ifndef MARBLE_NODESTORE_H
+#define MARBLE_NODESTORE_H
+
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+class QTemporaryFile;
+
+namespace Marble
+{
+
+struct Coordinate {
+    float lon;
+    float lat;
+
+    Coordinate(float lon=0.0, float lat=0.0);
+};
+
+/**
+  * Coordinates of OSM nodes, keyed by their 64 bit node id. Coordinates
+  * are kept in fixed point with 1e-7 degree resolution like in the OSM
+  * database, which takes 16 bytes per node.
+  *
+  * Nodes can be appended in any order. Call finish() once all nodes are
+  * appended, lookups are only valid afterwards. With a backing file the
+  * nodes are written to disk while appending and memory mapped for lookups,
+  * so that country-size extracts do not need to fit into RAM.
+  */
+class NodeStore
+{
+public:
+    NodeStore();
+
+    ~NodeStore();
+
+    /**
+      * Store nodes in a new temporary file in the given directory instead of in
+      * memory. Must be called before append(). The file is removed on destruction.
+      */
+    void setBackingDirectory( const QString &directory );
+
+    void append( qint64 id, const Coordinate &coordinate );
+
+    /** Sort the appended nodes by id and prepare lookups */
+    void finish();
+
+    void clear();
+
+    int size() const;
+
+    bool contains( qint64 id ) const;
+
+    /** The coordinate of the node with the given id, or a null coordinate if there is none */
+    Coordinate value( qint64 id ) const;
+
+    /** The coordinate of the node at the given position, 0 <= index < size() */
+    Coordinate at( int index ) const;
+
+private:
+    Q_DISABLE_COPY( NodeStore )
+
+    struct Entry {
+        qint64 id;
+        qint32 lon;
+        qint32 lat;
+    };
+
+    static bool lessId( const Entry &a, const Entry &b );
+
+    static Coordinate coordinate( const Entry &entry );
+
+    const Entry* find( qint64 id ) const;
+
+    void flush();
+
+    /** Closes and removes the backing file */
+    void closeFile();
+
+    QVector<Entry> m_entries;
+
+    QTemporaryFile* m_file;
+
+    bool m_fileBacked;
+
+    uchar* m_mapping;
+
+    const Entry* m_data;
+
+    int m_size;
+
+    qint64 m_lastId;
+
+    bool m_sorted;
+};
+
+}
+
+#endif // MARBLE_NODESTORE_H
@@ -145,14 +145,14 @@ Way::operator OsmPlacemark() const
     return placemark;
 }
 
-void Way::setPosition( const QHash<int, Coordinate> &database, OsmPlacemark &placemark ) const
+void Way::setPosition( const NodeStore &database, OsmPlacemark &placemark ) const
 {
     if ( !nodes.isEmpty() ) {
         if ( nodes.first() == nodes.last() && database.contains( nodes.first() ) ) {
             GeoDataLinearRing ring;
-            foreach( int id, nodes ) {
+            foreach( qint64 id, nodes ) {
                 if ( database.contains( id ) ) {
-                    const Coordinate &node = database[id];
+                    const Coordinate node = database.value( id );
                     GeoDataCoordinates coordinates( node.lon, node.lat, 0.0, GeoDataCoordinates::Degree );
                     ring << coordinates;
                 } else {
@@ -166,9 +166,9 @@ void Way::setPosition( const QHash<int, Coordinate> &database, OsmPlacemark &pla
                 placemark.setLatitude( center.latitude( GeoDataCoordinates::Degree ) );
             }
         } else {
-            int id = nodes.at( nodes.size() / 2 );
+            qint64 id = nodes.at( nodes.size() / 2 );
             if ( database.contains( id ) ) {
-                const Coordinate &node = database[id];
+                const Coordinate node = database.value( id );
                 placemark.setLongitude( node.lon );
                 placemark.setLatitude( node.lat );
             }
@@ -176,7 +176,7 @@ void Way::setPosition( const QHash<int, Coordinate> &database, OsmPlacemark &pla
     }
 }
 
-void Way::setRegion( const QHash<int, Node> &database,  const OsmRegionTree & tree, QList<OsmOsmRegion> & osmOsmRegions, OsmPlacemark &placemark ) const
+void Way::setRegion( const QHash<qint64, Node> &database, OsmRegionIndex & index, QList<OsmOsmRegion> & osmOsmRegions, OsmPlacemark &placemark ) const
 {
     if ( !city.isEmpty() ) {
         foreach( const OsmOsmRegion & region, osmOsmRegions ) {
@@ -210,7 +210,12 @@ void Way::setRegion( const QHash<int, Node> &database,  const OsmRegionTree & tr
     }
 
     GeoDataCoordinates position( placemark.longitude(), placemark.latitude(), 0.0, GeoDataCoordinates::Degree );
-    placemark.setRegionId( tree.smallestRegionId( position ) );
+    placemark.setRegionId( index.smallestRegionId( position ) );
+}
+
+void OsmParser::setNodeStoreDirectory( const QString &directory )
+{
+    m_coordinates.setBackingDirectory( directory );
 }
 
 void OsmParser::read( const QFileInfo &content, const QString &areaName )
@@ -218,6 +223,7 @@ void OsmParser::read( const QFileInfo &content, const QString &areaName )
     QTime timer;
     timer.start();
 
+    m_coordinates.clear();
     m_nodes.clear();
     m_ways.clear();
     m_relations.clear();
@@ -233,6 +239,8 @@ void OsmParser::read( const QFileInfo &content, const QString &areaName )
     }
     while ( needAnotherPass );
 
+    m_coordinates.finish();
+
     qWarning() << "Step 2: " << m_coordinates.size() << "coordinates."
                << "Now extracting regions from" << m_relations.size() << "relations";
 
@@ -294,7 +302,8 @@ void OsmParser::read( const QFileInfo &content, const QString &areaName )
     mainArea.setName( areaName );
     mainArea.setAdminLevel( 1 );
     QPair<float, float> minLon( -180.0, 180.0 ), minLat( -90.0, 90.0 );
-    foreach( const Coordinate & node, m_coordinates ) {
+    for ( int i = 0; i < m_coordinates.size(); ++i ) {
+        const Coordinate node = m_coordinates.at( i );
         minLon.first  = qMin( node.lon, minLon.first );
         minLon.second = qMax( node.lon, minLon.second );
         minLat.first  = qMin( node.lat, minLat.first );
@@ -317,25 +326,38 @@ void OsmParser::read( const QFileInfo &content, const QString &areaName )
     int left = 0;
     regionTree.traverse( left );
 
+    OsmRegionIndex regionIndex( regionTree );
+
     qWarning() << "Step 4: Creating placemarks from" << m_nodes.size() << "nodes";
 
-    foreach( const Node & node, m_nodes ) {
-        if ( node.save ) {
-            OsmPlacemark placemark = node;
-            GeoDataCoordinates position( node.lon, node.lat, 0.0, GeoDataCoordinates::Degree );
-            placemark.setRegionId( regionTree.smallestRegionId( position ) );
+    QVector<const Node*> savedNodes;
+    QVector<GeoDataCoordinates> positions;
+    QHash<qint64, Node>::const_iterator iter = m_nodes.constBegin();
+    for ( ; iter != m_nodes.constEnd(); ++iter ) {
+        if ( iter.value().save ) {
+            savedNodes << &iter.value();
+            positions << GeoDataCoordinates( iter.value().lon, iter.value().lat, 0.0, GeoDataCoordinates::Degree );
+        }
+    }
 
-            if ( !node.name.isEmpty() ) {
-                placemark.setHouseNumber( QString() );
-                m_placemarks.push_back( placemark );
-            }
+    QVector<int> const regionIds = regionIndex.smallestRegionIds( positions );
+    positions.clear();
 
-            if ( !node.street.isEmpty() && node.name != node.street ) {
-                placemark.setCategory( OsmPlacemark::Address );
-                placemark.setName( node.street.trimmed() );
-                placemark.setHouseNumber( node.houseNumber.trimmed() );
-                m_placemarks.push_back( placemark );
-            }
+    for ( int i = 0; i < savedNodes.size(); ++i ) {
+        const Node & node = *savedNodes[i];
+        OsmPlacemark placemark = node;
+        placemark.setRegionId( regionIds[i] );
+
+        if ( !node.name.isEmpty() ) {
+            placemark.setHouseNumber( QString() );
+            m_placemarks.push_back( placemark );
+        }
+
+        if ( !node.street.isEmpty() && node.name != node.street ) {
+            placemark.setCategory( OsmPlacemark::Address );
+            placemark.setName( node.street.trimmed() );
+            placemark.setHouseNumber( node.houseNumber.trimmed() );
+            m_placemarks.push_back( placemark );
         }
     }
 
@@ -362,7 +384,7 @@ void OsmParser::read( const QFileInfo &content, const QString &areaName )
             Q_ASSERT( !ways.isEmpty() );
             OsmPlacemark placemark = ways.first();
             ways.first().setPosition( m_coordinates, placemark );
-            ways.first().setRegion( m_nodes, regionTree, m_osmOsmRegions, placemark );
+            ways.first().setRegion( m_nodes, regionIndex, m_osmOsmRegions, placemark );
 
             if ( placemark.category() != OsmPlacemark::Address && !ways.first().name.isEmpty() ) {
                 placemark.setHouseNumber( QString() );
@@ -453,7 +475,7 @@ QList< QList<Way> > OsmParser::merge( const QList<Way> &ways ) const
 void OsmParser::importMultipolygon( const Relation &relation )
 {
     /** @todo: import nodes? What are they used for? */
-    typedef QPair<int, RelationRole> RelationPair;
+    typedef QPair<qint64, RelationRole> RelationPair;
     QVector<GeoDataLineString> outer;
     QVector<GeoDataLineString> inner;
     foreach( const RelationPair & pair, relation.ways ) {
@@ -491,7 +513,7 @@ void OsmParser::importMultipolygon( const Relation &relation )
     }
 }
 
-void OsmParser::importWay( QVector<GeoDataLineString> &ways, int id )
+void OsmParser::importWay( QVector<GeoDataLineString> &ways, qint64 id )
 {
     if ( !m_ways.contains( id ) ) {
         qDebug() << "Skipping unknown way " << id << ". Check data.";
@@ -499,11 +521,11 @@ void OsmParser::importWay( QVector<GeoDataLineString> &ways, int id )
     }
 
     GeoDataLineString way;
-    foreach( int node, m_ways[id].nodes ) {
+    foreach( qint64 node, m_ways[id].nodes ) {
         if ( !m_coordinates.contains( node ) ) {
             qDebug() << "Skipping unknown node " << node << ". Check data.";
         } else {
-            const Coordinate &nd = m_coordinates[node];
+            const Coordinate nd = m_coordinates.value( node );
             GeoDataCoordinates coordinates( nd.lon, nd.lat, 0.0, GeoDataCoordinates::Degree );
             way << coordinates;
         }
@@ -629,22 +651,22 @@ void OsmParser::setCategory( Element &element, const QString &key, const QString
 GeoDataLinearRing* OsmParser::convexHull() const
 {
     Q_ASSERT(m_coordinates.size()>2);
-    QList<Coordinate> coordinates = m_coordinates.values();
 
     QVector<GrahamScanHelper> points;
-    points.reserve( coordinates.size()+1 );
-    Coordinate start = coordinates.first();
+    points.reserve( m_coordinates.size()+1 );
+    Coordinate start = m_coordinates.at( 0 );
     int startPos = 0;
-    for ( int i=0; i<coordinates.size(); ++i ) {
-        if ( coordinates[i].lon < start.lon ) {
-            start = coordinates[i];
+    for ( int i=0; i<m_coordinates.size(); ++i ) {
+        const Coordinate coordinate = m_coordinates.at( i );
+        if ( coordinate.lon < start.lon ) {
+            start = coordinate;
             startPos = i;
         }
-        points << coordinates[i];
+        points << coordinate;
     }
 
     int const n = points.size();
-    Q_ASSERT( n == coordinates.size() );
+    Q_ASSERT( n == m_coordinates.size() );
     Q_ASSERT( n>2 );
     qSwap( points[1], points[startPos] );
 
@@ -754,9 +776,4 @@ void OsmParser::writeKml( const QString &area, const QString &version, const QSt
     file.close();
 }
 
-Coordinate::Coordinate(float lon_, float lat_) : lon(lon_), lat(lat_)
-{
-    // nothing to do
-}
-
 }
@@ -12,9 +12,11 @@
 #define MARBLE_OSMPARSER_H
 
 #include "Writer.h"
+#include "NodeStore.h"
 #include "OsmRegion.h"
 #include "OsmPlacemark.h"
 #include "OsmRegionTree.h"
+#include "OsmRegionIndex.h"
 
 #include "marble/GeoDataLineString.h"
 #include "marble/GeoDataPolygon.h"
@@ -61,13 +63,6 @@ struct Element {
         category( OsmPlacemark::UnknownCategory ) {}
 };
 
-struct Coordinate {
-    float lon;
-    float lat;
-
-    Coordinate(float lon=0.0, float lat=0.0);
-};
-
 struct Node : public Element {
     float lon;
     float lat;
@@ -77,12 +72,12 @@ struct Node : public Element {
 };
 
 struct Way : public Element {
-    QList<int> nodes;
+    QList<qint64> nodes;
     bool isBuilding;
 
     operator OsmPlacemark() const;
-    void setPosition( const QHash<int, Coordinate> &database, OsmPlacemark &placemark ) const;
-    void setRegion( const QHash<int, Node> &database, const OsmRegionTree & tree, QList<OsmOsmRegion> & osmOsmRegions, OsmPlacemark &placemark ) const;
+    void setPosition( const NodeStore &database, OsmPlacemark &placemark ) const;
+    void setRegion( const QHash<qint64, Node> &database, OsmRegionIndex & index, QList<OsmOsmRegion> & osmOsmRegions, OsmPlacemark &placemark ) const;
 };
 
 struct WayMerger {
@@ -120,9 +115,9 @@ public:
 };
 
 struct Relation : public Element {
-    QList<int> nodes;
-    QList< QPair<int, RelationRole> > ways;
-    QList<int> relations;
+    QList<qint64> nodes;
+    QList< QPair<qint64, RelationRole> > ways;
+    QList<qint64> relations;
     QString name;
     bool isMultipolygon;
     bool isAdministrativeBoundary;
@@ -153,6 +148,9 @@ public:
 
     void addWriter( Writer* writer );
 
+    /** Keep node coordinates in a temporary file in the given directory instead of in memory while reading */
+    void setNodeStoreDirectory( const QString &directory );
+
     void read( const QFileInfo &file, const QString &areaName );
 
     void writeKml( const QString &area, const QString &version, const QString &date, const QString &transport, const QString &payload, const QString &outputKml ) const;
@@ -164,20 +162,20 @@ protected:
 
     void setCategory( Element &element, const QString &key, const QString &value );
 
-    QHash<int, Coordinate> m_coordinates;
+    NodeStore m_coordinates;
 
-    QHash<int, Node> m_nodes;
+    QHash<qint64, Node> m_nodes;
 
-    QHash<int, Way> m_ways;
+    QHash<qint64, Way> m_ways;
 
-    QHash<int, Relation> m_relations;
+    QHash<qint64, Relation> m_relations;
 
 private:
     GeoDataLinearRing *convexHull() const;
 
     void importMultipolygon( const Relation &relation );
 
-    void importWay( QVector<Marble::GeoDataLineString> &ways, int id );
+    void importWay( QVector<Marble::GeoDataLineString> &ways, qint64 id );
 
     QList< QList<Way> > merge( const QList<Way> &ways ) const;
 
@@ -0,0 +1,524 @@
+//
+// This file is part of the Marble Virtual Globe.
+//
+// This program is free software licensed under the GNU LGPL. You can
+// find a copy of this license in LICENSE.txt in the top directory of
+// the source code.
+//
+// Copyright 2026      agent <agent@local>
+//
+
+#include "OsmRegionIndex.h"
+
+#include "marble/GeoDataLinearRing.h"
+#include "marble/GeoDataLatLonAltBox.h"
+
+#include <QtCore/QtAlgorithms>
+#include <QtCore/QPair>
+
+#include <cmath>
+
+namespace Marble
+{
+
+// Maximum number of children of an R-tree node
+static const int RTreeNodeSize = 16;
+
+// Rings with at most this many edges are not split into buckets
+static const int MinimumBucketedEdges = 32;
+
+// Average number of edges per bucket
+static const int EdgesPerBucket = 8;
+
+// Size of the grid cells that query results are shared within, in radian (about 1 km)
+static const qreal CellSize = 0.01 * M_PI / 180.0;
+
+namespace {
+    bool lessFirst( const QPair<qreal, int> &a, const QPair<qreal, int> &b )
+    {
+        return a.first < b.first;
+    }
+
+    bool lessCell( const QPair<qint64, int> &a, const QPair<qint64, int> &b )
+    {
+        return a.first < b.first;
+    }
+}
+
+OsmRegionIndex::Box::Box() :
+    west( 0.0 ), east( 0.0 ), south( 0.0 ), north( 0.0 )
+{
+    // nothing to do
+}
+
+bool OsmRegionIndex::Box::contains( qreal lon, qreal lat ) const
+{
+    return west <= lon && lon <= east && south <= lat && lat <= north;
+}
+
+bool OsmRegionIndex::Box::intersects( const Box &other ) const
+{
+    return west <= other.east && other.west <= east && south <= other.north && other.south <= north;
+}
+
+void OsmRegionIndex::Box::unite( const Box &other )
+{
+    west = qMin( west, other.west );
+    east = qMax( east, other.east );
+    south = qMin( south, other.south );
+    north = qMax( north, other.north );
+}
+
+OsmRegionIndex::Ring::Ring() :
+    m_bucketCount( 0 ),
+    m_bucketWidth( 0.0 )
+{
+    // nothing to do
+}
+
+void OsmRegionIndex::Ring::set( const GeoDataLinearRing &ring )
+{
+    int const points = ring.size();
+    m_points.resize( 2 * points );
+    for ( int i = 0; i < points; ++i ) {
+        m_points[2*i] = ring.at( i ).longitude();
+        m_points[2*i+1] = ring.at( i ).latitude();
+    }
+
+    if ( points == 0 ) {
+        m_bucketCount = 0;
+        return;
+    }
+
+    GeoDataLatLonAltBox const box = ring.latLonAltBox();
+    m_box.south = box.south();
+    m_box.north = box.north();
+    if ( box.crossesDateLine() ) {
+        m_box.west = -M_PI;
+        m_box.east = M_PI;
+    } else {
+        m_box.west = box.west();
+        m_box.east = box.east();
+    }
+
+    m_bucketCount = points <= MinimumBucketedEdges ? 1 : points / EdgesPerBucket;
+    m_bucketWidth = ( m_box.east - m_box.west ) / m_bucketCount;
+    if ( m_bucketWidth <= 0.0 ) {
+        m_bucketCount = 1;
+    }
+
+    // Counting sort of the edges into the buckets their longitude range overlaps
+    QVector<int> counts( m_bucketCount + 1, 0 );
+    for ( int i = 0, j = points - 1; i < points; j = i++ ) {
+        int const first = bucket( qMin( m_points[2*i], m_points[2*j] ) );
+        int const last = bucket( qMax( m_points[2*i], m_points[2*j] ) );
+        for ( int k = first; k <= last; ++k ) {
+            ++counts[k+1];
+        }
+    }
+
+    m_bucketStart.resize( m_bucketCount + 1 );
+    m_bucketStart[0] = 0;
+    for ( int k = 0; k < m_bucketCount; ++k ) {
+        m_bucketStart[k+1] = m_bucketStart[k] + counts[k+1];
+    }
+
+    m_bucketEdges.resize( m_bucketStart[m_bucketCount] );
+    QVector<int> fill = m_bucketStart;
+    for ( int i = 0, j = points - 1; i < points; j = i++ ) {
+        int const first = bucket( qMin( m_points[2*i], m_points[2*j] ) );
+        int const last = bucket( qMax( m_points[2*i], m_points[2*j] ) );
+        for ( int k = first; k <= last; ++k ) {
+            m_bucketEdges[fill[k]++] = i;
+        }
+    }
+}
+
+bool OsmRegionIndex::Ring::isEmpty() const
+{
+    return m_bucketCount == 0;
+}
+
+const OsmRegionIndex::Box &OsmRegionIndex::Ring::box() const
+{
+    return m_box;
+}
+
+int OsmRegionIndex::Ring::bucket( qreal lon ) const
+{
+    if ( m_bucketCount == 1 ) {
+        return 0;
+    }
+
+    return qBound( 0, int( ( lon - m_box.west ) / m_bucketWidth ), m_bucketCount - 1 );
+}
+
+bool OsmRegionIndex::Ring::contains( qreal lon, qreal lat ) const
+{
+    if ( isEmpty() || !m_box.contains( lon, lat ) ) {
+        return false;
+    }
+
+    // Same crossing test as GeoDataLinearRing::contains(), restricted to
+    // the edges which overlap the longitude of the point
+    int const points = m_points.size() / 2;
+    int const k = bucket( lon );
+    bool inside = false;
+    for ( int e = m_bucketStart[k]; e < m_bucketStart[k+1]; ++e ) {
+        int const i = m_bucketEdges[e];
+        int const j = i == 0 ? points - 1 : i - 1;
+        qreal const oneLon = m_points[2*i];
+        qreal const oneLat = m_points[2*i+1];
+        qreal const twoLon = m_points[2*j];
+        qreal const twoLat = m_points[2*j+1];
+
+        if ( ( oneLon < lon && twoLon >= lon ) || ( twoLon < lon && oneLon >= lon ) ) {
+            if ( oneLat + ( lon - oneLon ) / ( twoLon - oneLon ) * ( twoLat - oneLat ) < lat ) {
+                inside = !inside;
+            }
+        }
+    }
+
+    return inside;
+}
+
+OsmRegionIndex::CellState OsmRegionIndex::Ring::classify( const Box &cell ) const
+{
+    if ( isEmpty() || !m_box.intersects( cell ) ) {
+        return Outside;
+    }
+
+    int const points = m_points.size() / 2;
+    int const first = bucket( cell.west );
+    int const last = bucket( cell.east );
+    for ( int k = first; k <= last; ++k ) {
+        for ( int e = m_bucketStart[k]; e < m_bucketStart[k+1]; ++e ) {
+            int const i = m_bucketEdges[e];
+            int const j = i == 0 ? points - 1 : i - 1;
+            Box edge;
+            edge.west = qMin( m_points[2*i], m_points[2*j] );
+            edge.east = qMax( m_points[2*i], m_points[2*j] );
+            edge.south = qMin( m_points[2*i+1], m_points[2*j+1] );
+            edge.north = qMax( m_points[2*i+1], m_points[2*j+1] );
+            if ( edge.intersects( cell ) ) {
+                return Boundary;
+            }
+        }
+    }
+
+    // The boundary does not pass through the cell, so all of its points agree
+    qreal const lon = ( cell.west + cell.east ) / 2.0;
+    qreal const lat = ( cell.south + cell.north ) / 2.0;
+    return contains( lon, lat ) ? Inside : Outside;
+}
+
+bool OsmRegionIndex::Entry::contains( qreal lon, qreal lat ) const
+{
+    if ( !outer.contains( lon, lat ) ) {
+        return false;
+    }
+
+    foreach( const Ring &ring, inner ) {
+        if ( ring.contains( lon, lat ) ) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+OsmRegionIndex::CellState OsmRegionIndex::Entry::classify( const Box &cell ) const
+{
+    CellState const state = outer.classify( cell );
+    if ( state == Outside ) {
+        return Outside;
+    }
+
+    bool boundary = state == Boundary;
+    foreach( const Ring &ring, inner ) {
+        CellState const innerState = ring.classify( cell );
+        if ( innerState == Inside ) {
+            return Outside;
+        }
+        boundary = boundary || innerState == Boundary;
+    }
+
+    return boundary ? Boundary : Inside;
+}
+
+OsmRegionIndex::OsmRegionIndex( const OsmRegionTree &tree ) :
+    m_rootIdentifier( tree.node().identifier() ),
+    m_rootLevel( tree.node().adminLevel() )
+{
+    foreach( const OsmRegionTree &child, tree.children() ) {
+        addEntries( child, -1 );
+    }
+
+    buildRTree();
+    m_cell.key = -1;
+    m_cell.answer = -1;
+}
+
+void OsmRegionIndex::addEntries( const OsmRegionTree &tree, int parent )
+{
+    Entry entry;
+    entry.identifier = tree.node().identifier();
+    entry.adminLevel = tree.node().adminLevel();
+    entry.parent = parent;
+    entry.outer.set( tree.node().geometry().outerBoundary() );
+    foreach( const GeoDataLinearRing &ring, tree.node().geometry().innerBoundaries() ) {
+        Ring innerRing;
+        innerRing.set( ring );
+        entry.inner << innerRing;
+    }
+
+    int const index = m_entries.size();
+    m_entries << entry;
+
+    foreach( const OsmRegionTree &child, tree.children() ) {
+        addEntries( child, index );
+    }
+}
+
+void OsmRegionIndex::buildRTree()
+{
+    QVector<RTreeItem> items;
+    for ( int i = 0; i < m_entries.size(); ++i ) {
+        // Regions without geometry cannot contain anything
+        if ( !m_entries[i].outer.isEmpty() ) {
+            RTreeItem item;
+            item.box = m_entries[i].outer.box();
+            item.index = i;
+            items << item;
+        }
+    }
+
+    if ( items.isEmpty() ) {
+        return;
+    }
+
+    // Packed R-tree, built bottom up with the sort-tile-recursive algorithm
+    sortTileRecursive( items );
+    QVector<RTreeNode> level;
+    for ( int i = 0; i < items.size(); i += RTreeNodeSize ) {
+        RTreeNode node;
+        node.leaf = true;
+        node.first = m_leafEntries.size();
+        node.box = items[i].box;
+        for ( int k = i; k < qMin( i + RTreeNodeSize, items.size() ); ++k ) {
+            node.box.unite( items[k].box );
+            m_leafEntries << items[k].index;
+        }
+        node.last = m_leafEntries.size();
+        level << node;
+    }
+
+    while ( level.size() > 1 ) {
+        QVector<RTreeItem> levelItems;
+        for ( int i = 0; i < level.size(); ++i ) {
+            RTreeItem item;
+            item.box = level[i].box;
+            item.index = i;
+            levelItems << item;
+        }
+        sortTileRecursive( levelItems );
+
+        int const offset = m_nodes.size();
+        foreach( const RTreeItem &item, levelItems ) {
+            m_nodes << level[item.index];
+        }
+
+        QVector<RTreeNode> parents;
+        for ( int i = 0; i < levelItems.size(); i += RTreeNodeSize ) {
+            RTreeNode node;
+            node.leaf = false;
+            node.first = offset + i;
+            node.last = offset + qMin( i + RTreeNodeSize, levelItems.size() );
+            node.box = m_nodes[node.first].box;
+            for ( int k = node.first; k < node.last; ++k ) {
+                node.box.unite( m_nodes[k].box );
+            }
+            parents << node;
+        }
+        level = parents;
+    }
+
+    m_nodes << level.first();
+}
+
+void OsmRegionIndex::sortTileRecursive( QVector<RTreeItem> &items )
+{
+    int const nodes = ( items.size() + RTreeNodeSize - 1 ) / RTreeNodeSize;
+    int const slices = qMax( 1, int( ceil( sqrt( qreal( nodes ) ) ) ) );
+    int const sliceSize = slices * RTreeNodeSize;
+
+    QVector< QPair<qreal, int> > order;
+    for ( int i = 0; i < items.size(); ++i ) {
+        order << qMakePair( ( items[i].box.west + items[i].box.east ) / 2.0, i );
+    }
+    qSort( order.begin(), order.end(), lessFirst );
+
+    QVector<RTreeItem> result;
+    result.reserve( items.size() );
+    for ( int i = 0; i < order.size(); i += sliceSize ) {
+        QVector< QPair<qreal, int> > slice;
+        for ( int k = i; k < qMin( i + sliceSize, order.size() ); ++k ) {
+            RTreeItem const &item = items[order[k].second];
+            slice << qMakePair( ( item.box.south + item.box.north ) / 2.0, order[k].second );
+        }
+        qSort( slice.begin(), slice.end(), lessFirst );
+        for ( int k = 0; k < slice.size(); ++k ) {
+            result << items[slice[k].second];
+        }
+    }
+
+    items = result;
+}
+
+void OsmRegionIndex::query( const Box &box, QVector<int> &result ) const
+{
+    result.clear();
+    if ( m_nodes.isEmpty() ) {
+        return;
+    }
+
+    QVector<int> stack;
+    stack << m_nodes.size() - 1;
+    while ( !stack.isEmpty() ) {
+        RTreeNode const &node = m_nodes[stack.last()];
+        stack.pop_back();
+        if ( !node.box.intersects( box ) ) {
+            continue;
+        }
+
+        for ( int i = node.first; i < node.last; ++i ) {
+            if ( node.leaf ) {
+                if ( m_entries[m_leafEntries[i]].outer.box().intersects( box ) ) {
+                    result << m_leafEntries[i];
+                }
+            } else {
+                stack << i;
+            }
+        }
+    }
+
+    // Parents before children, as in the region tree
+    qSort( result );
+}
+
+qint64 OsmRegionIndex::cellKey( qreal lon, qreal lat )
+{
+    qint64 const x = qint64( floor( ( lon + M_PI ) / CellSize ) );
+    qint64 const y = qint64( floor( ( lat + M_PI / 2.0 ) / CellSize ) );
+    return ( x << 32 ) + y;
+}
+
+void OsmRegionIndex::updateCell( qint64 key )
+{
+    if ( m_cell.key == key ) {
+        return;
+    }
+
+    Box cell;
+    cell.west = ( key >> 32 ) * CellSize - M_PI;
+    cell.east = cell.west + CellSize;
+    cell.south = ( key & 0xffffffff ) * CellSize - M_PI / 2.0;
+    cell.north = cell.south + CellSize;
+
+    m_cell.key = key;
+    query( cell, m_cell.candidates );
+    m_cell.parents.resize( m_cell.candidates.size() );
+    m_cell.states.resize( m_cell.candidates.size() );
+
+    bool boundary = false;
+    for ( int k = 0; k < m_cell.candidates.size(); ++k ) {
+        Entry const &entry = m_entries[m_cell.candidates[k]];
+        m_cell.parents[k] = -1;
+        if ( entry.parent >= 0 ) {
+            QVector<int>::const_iterator parent = qBinaryFind( m_cell.candidates.constBegin(),
+                                                               m_cell.candidates.constBegin() + k,
+                                                               entry.parent );
+            if ( parent == m_cell.candidates.constBegin() + k ) {
+                // The parent does not touch this cell, so its children are never reached
+                m_cell.states[k] = Outside;
+                continue;
+            }
+            m_cell.parents[k] = parent - m_cell.candidates.constBegin();
+            if ( m_cell.states[m_cell.parents[k]] == Outside ) {
+                m_cell.states[k] = Outside;
+                continue;
+            }
+        }
+
+        m_cell.states[k] = entry.classify( cell );
+        boundary = boundary || m_cell.states[k] == Boundary;
+    }
+
+    m_cell.answer = -1;
+    if ( !boundary ) {
+        // Every point in the cell gets the same answer
+        m_cell.answer = m_rootIdentifier;
+        int level = m_rootLevel;
+        for ( int k = 0; k < m_cell.candidates.size(); ++k ) {
+            Entry const &entry = m_entries[m_cell.candidates[k]];
+            if ( m_cell.states[k] == Inside && entry.adminLevel >= level ) {
+                level = entry.adminLevel;
+                m_cell.answer = entry.identifier;
+            }
+        }
+    }
+}
+
+int OsmRegionIndex::smallestRegionId( qreal lon, qreal lat )
+{
+    updateCell( cellKey( lon, lat ) );
+    if ( m_cell.answer >= 0 ) {
+        return m_cell.answer;
+    }
+
+    // The deepest region containing the point, with the regions visited
+    // in tree order. Equals the recursive descent in OsmRegionTree.
+    int result = m_rootIdentifier;
+    int level = m_rootLevel;
+    QVector<bool> contained( m_cell.candidates.size(), false );
+    for ( int k = 0; k < m_cell.candidates.size(); ++k ) {
+        int const parent = m_cell.parents[k];
+        if ( m_cell.states[k] == Outside || ( parent >= 0 && !contained[parent] ) ) {
+            continue;
+        }
+
+        Entry const &entry = m_entries[m_cell.candidates[k]];
+        contained[k] = m_cell.states[k] == Inside || entry.contains( lon, lat );
+        if ( contained[k] && entry.adminLevel >= level ) {
+            level = entry.adminLevel;
+            result = entry.identifier;
+        }
+    }
+
+    return result;
+}
+
+int OsmRegionIndex::smallestRegionId( const GeoDataCoordinates &coordinates )
+{
+    return smallestRegionId( coordinates.longitude(), coordinates.latitude() );
+}
+
+QVector<int> OsmRegionIndex::smallestRegionIds( const QVector<GeoDataCoordinates> &coordinates )
+{
+    QVector< QPair<qint64, int> > order;
+    order.reserve( coordinates.size() );
+    for ( int i = 0; i < coordinates.size(); ++i ) {
+        order << qMakePair( cellKey( coordinates[i].longitude(), coordinates[i].latitude() ), i );
+    }
+    qSort( order.begin(), order.end(), lessCell );
+
+    QVector<int> result( coordinates.size() );
+    for ( int i = 0; i < order.size(); ++i ) {
+        GeoDataCoordinates const &position = coordinates[order[i].second];
+        result[order[i].second] = smallestRegionId( position.longitude(), position.latitude() );
+    }
+
+    return result;
+}
+
+}
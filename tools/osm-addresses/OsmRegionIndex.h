@@ -0,0 +1,146 @@
+//
+// This file is part of the Marble Virtual Globe.
+//
+// This program is free software licensed under the GNU LGPL. You can
+// find a copy of this license in LICENSE.txt in the top directory of
+// the source code.
+//
+// Copyright 2026      agent <agent@local>
+//
+
+#ifndef MARBLE_OSMREGIONINDEX_H
+#define MARBLE_OSMREGIONINDEX_H
+
+#include "OsmRegionTree.h"
+
+#include <QtCore/QVector>
+
+namespace Marble
+{
+
+class GeoDataLinearRing;
+
+/**
+  * A spatial index over the regions of an OsmRegionTree to speed up
+  * smallestRegionId() queries for large numbers of points:
+  * - The bounding boxes of all regions are kept in a packed R-tree, so
+  *   only regions near a point are looked at.
+  * - The edges of each polygon ring are bucketed by longitude. A
+  *   containment test only checks the edges of one bucket.
+  * - Queries are answered per grid cell first. Regions which contain
+  *   a cell completely or do not touch it at all need no polygon test
+  *   for any point in that cell. Points sorted by location (which
+  *   smallestRegionIds() does) therefore mostly reuse the previous answer.
+  */
+class OsmRegionIndex
+{
+public:
+    explicit OsmRegionIndex( const OsmRegionTree &tree );
+
+    /** Same result as OsmRegionTree::smallestRegionId() */
+    int smallestRegionId( const GeoDataCoordinates &coordinates );
+
+    /** Batch version of smallestRegionId(). The result order matches the input order */
+    QVector<int> smallestRegionIds( const QVector<GeoDataCoordinates> &coordinates );
+
+private:
+    enum CellState {
+        Outside,
+        Inside,
+        Boundary
+    };
+
+    /** An axis aligned bounding box, in radian */
+    struct Box {
+        qreal west;
+        qreal east;
+        qreal south;
+        qreal north;
+
+        Box();
+        bool contains( qreal lon, qreal lat ) const;
+        bool intersects( const Box &other ) const;
+        void unite( const Box &other );
+    };
+
+    /** A linear ring with its edges bucketed by longitude */
+    class Ring
+    {
+    public:
+        Ring();
+        void set( const GeoDataLinearRing &ring );
+        bool isEmpty() const;
+        const Box &box() const;
+        bool contains( qreal lon, qreal lat ) const;
+        CellState classify( const Box &cell ) const;
+
+    private:
+        int bucket( qreal lon ) const;
+
+        Box m_box;
+        QVector<qreal> m_points; // lon, lat pairs
+        int m_bucketCount;
+        qreal m_bucketWidth;
+        QVector<int> m_bucketStart; // m_bucketCount+1 offsets into m_bucketEdges
+        QVector<int> m_bucketEdges; // edge i connects point i and i-1
+    };
+
+    struct Entry {
+        int identifier;
+        int adminLevel;
+        int parent; // index into m_entries, or -1 for children of the root
+        Ring outer;
+        QVector<Ring> inner;
+
+        bool contains( qreal lon, qreal lat ) const;
+        CellState classify( const Box &cell ) const;
+    };
+
+    struct RTreeNode {
+        Box box;
+        bool leaf;
+        int first; // children in m_nodes, or entries in m_leafEntries for leaves
+        int last;
+    };
+
+    struct RTreeItem {
+        Box box;
+        int index;
+    };
+
+    struct Cell {
+        qint64 key;
+        QVector<int> candidates; // entry indices in tree pre-order
+        QVector<int> parents;    // positions of the parents in candidates, -1 for none
+        QVector<CellState> states;
+        int answer; // valid if no candidate is on the boundary, -1 otherwise
+    };
+
+    void addEntries( const OsmRegionTree &tree, int parent );
+
+    void buildRTree();
+
+    static void sortTileRecursive( QVector<RTreeItem> &items );
+
+    void query( const Box &box, QVector<int> &result ) const;
+
+    static qint64 cellKey( qreal lon, qreal lat );
+
+    void updateCell( qint64 key );
+
+    int smallestRegionId( qreal lon, qreal lat );
+
+    int m_rootIdentifier;
+    int m_rootLevel;
+
+    QVector<Entry> m_entries;
+
+    QVector<RTreeNode> m_nodes; // the root is the last node
+    QVector<int> m_leafEntries;
+
+    Cell m_cell;
+};
+
+}
+
+#endif // MARBLE_OSMREGIONINDEX_H
@@ -31,6 +31,7 @@ SqlWriter::SqlWriter( const QString &filename, QObject* parent ) :
 
     execQuery( "DROP TABLE IF EXISTS placemarks;" );
     execQuery( "CREATE TABLE placemarks ("
+               " id INTEGER PRIMARY KEY,"
                " regionId INTEGER,"
                " nameId INTEGER,"
                " number VARCHAR(8),"
@@ -62,6 +63,9 @@ SqlWriter::SqlWriter( const QString &filename, QObject* parent ) :
                " FROM names"
                " INNER JOIN placemarks"
                " ON names.id=placemarks.nameId" );
+    execQuery( "DROP TABLE IF EXISTS namesFts" );
+    execQuery( "DROP TABLE IF EXISTS placemarksRtree" );
+    execQuery( "DROP TABLE IF EXISTS coverage" );
     execQuery( "BEGIN TRANSACTION" );
 }
 
@@ -71,6 +75,25 @@ SqlWriter::~SqlWriter()
     execQuery( "CREATE INDEX namesIndex ON names(name)" );
     execQuery( "CREATE INDEX placemarksIndex ON placemarks(regionId,nameId,category)" );
     execQuery( "CREATE INDEX regionsIndex ON regions(name,parent,lft,rgt)" );
+
+    // Token index of the names. Wildcard searches use it instead of scanning all names.
+    // The ids of the indexed rows are the docids. Readers fall back to LIKE if the index is missing,
+    // e.g. because sqlite was built without FTS support.
+    execQuery( "BEGIN TRANSACTION" );
+    execQuery( "CREATE VIRTUAL TABLE namesFts USING fts4(name)" );
+    execQuery( "INSERT INTO namesFts(docid, name) SELECT id, name FROM names" );
+    execQuery( "INSERT INTO namesFts(namesFts) VALUES('optimize')" );
+
+    // Spatial index of the placemarks for nearby searches
+    execQuery( "CREATE VIRTUAL TABLE placemarksRtree USING rtree(id, minLon, maxLon, minLat, maxLat)" );
+    execQuery( "INSERT INTO placemarksRtree SELECT id, lon, lon, lat, lat FROM placemarks" );
+
+    // Bounding box of the placemarks. Readers with several databases only search those covering the view.
+    execQuery( "CREATE TABLE coverage AS SELECT"
+               " max(lat) AS north, min(lat) AS south, max(lon) AS east, min(lon) AS west"
+               " FROM placemarks" );
+    execQuery( "END TRANSACTION" );
+    execQuery( "ANALYZE" );
 }
 
 void SqlWriter::addOsmRegion( const OsmRegion &region )
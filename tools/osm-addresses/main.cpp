@@ -63,6 +63,7 @@ void usage()
     qDebug() << "\t--name aName";
     qDebug() << "\t--date aDate";
     qDebug() << "\t--payload aFilename";
+    qDebug() << "\t--node-store aDirectory (keep node coordinates in a temporary file in the given directory instead of in memory)";
 }
 
 int main( int argc, char *argv[] )
@@ -82,6 +83,7 @@ int main( int argc, char *argv[] )
     QString date;
     QString transport;
     QString payload;
+    QString nodeStore;
     for ( int i=1; i<argc-3; ++i ) {
         QString arg( argv[i] );
         if ( arg == "-v" ) {
@@ -98,6 +100,8 @@ int main( int argc, char *argv[] )
             transport = argv[++i];
         } else if ( arg == "--payload" ) {
             payload = argv[++i];
+        } else if ( arg == "--node-store" ) {
+            nodeStore = argv[++i];
         } else {
             usage();
             return 1;
@@ -124,6 +128,7 @@ int main( int argc, char *argv[] )
     Q_ASSERT( parser );
     SqlWriter sql( outputSqlite );
     parser->addWriter( &sql );
+    parser->setNodeStoreDirectory( nodeStore );
     parser->read( file, name );
     parser->writeKml( name, version, date, transport, payload, outputKml );
 }
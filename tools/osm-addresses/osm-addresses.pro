@@ -32,9 +32,11 @@ LIBS += -lprotobuf
 SOURCES += main.cpp \
     OsmParser.cpp \
     Writer.cpp \
+    NodeStore.cpp \
     SqlWriter.cpp \
     OsmRegion.cpp \
     OsmRegionTree.cpp \
+    OsmRegionIndex.cpp \
     pbf/fileformat.pb.cc \
     pbf/osmformat.pb.cc \
     pbf/PbfParser.cpp \
@@ -43,9 +45,11 @@ SOURCES += main.cpp \
 HEADERS += \
     OsmParser.h \
     Writer.h \
+    NodeStore.h \
     SqlWriter.h \
     OsmRegion.h \
     OsmRegionTree.h \
+    OsmRegionIndex.h \
     pbf/osmformat.pb.h \
     pbf/fileformat.pb.h \
     pbf/PbfParser.h \
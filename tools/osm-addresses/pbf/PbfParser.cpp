@@ -15,6 +15,9 @@
 #include "PbfParser.h"
 
 #include <QtCore/QDebug>
+#include <QtCore/QThread>
+#include <QtCore/QTime>
+#include <QtCore/QtConcurrentMap>
 
 #include <zlib.h>
 
@@ -28,7 +31,8 @@ using namespace OSMPBF;
 PbfParser::PbfParser() :
     m_currentGroup( 0 ),
     m_currentEntity( 0 ),
-    m_loadBlock( false )
+    m_loadBlock( false ),
+    m_nodeCount( 0 )
 {
     GOOGLE_PROTOBUF_VERIFY_VERSION;
 }
@@ -64,41 +68,51 @@ bool PbfParser::parse( const QFileInfo &fileInfo, int pass, bool &needAnotherPas
         return false;
     }
 
-    m_loadBlock = true;
-
-    while ( true ) {
-
-        if ( m_loadBlock ) {
-            if ( !readNext() ) {
-                if ( pass == 1 ) {
-                    m_referencedWays.clear();
-                } else if ( pass == 2 ) {
-                    m_referencedNodes.clear();
-                }
+    QTime timer;
+    timer.start();
+    m_nodeCount = 0;
+
+    // Reading blobs from disk is cheap compared to inflating and decoding them.
+    // Blobs are therefore read in batches and decoded on all cores while the
+    // previous batch is handed to the handlers, in the order of the file.
+    int const batchSize = 4 * qMax( 1, QThread::idealThreadCount() );
+    bool success = true;
+    QList<QByteArray> batch = readBlobs( batchSize, success );
+    QFuture<PrimitiveBlock*> decoded = QtConcurrent::mapped( batch, decodeBlock );
+
+    while ( !batch.isEmpty() ) {
+        QList<QByteArray> nextBatch;
+        if ( success ) {
+            nextBatch = readBlobs( batchSize, success );
+        }
+        QFuture<PrimitiveBlock*> nextDecoded = QtConcurrent::mapped( nextBatch, decodeBlock );
 
-                return true;
+        for ( int i = 0; i < batch.size(); ++i ) {
+            PrimitiveBlock* block = decoded.resultAt( i );
+            if ( block && success ) {
+                m_primitiveBlock.Swap( block );
+                parsePrimitiveBlock();
+            } else {
+                success = false;
             }
-            loadBlock();
-            loadGroup();
+            delete block;
         }
 
-        switch ( m_mode ) {
-        case ModeNode:
-            parseNode();
-            break;
-        case ModeWay:
-            parseWay();
-            break;
-        case ModeRelation:
-            parseRelation();
-            break;
-        case ModeDense:
-            parseDense();
-            break;
-        }
+        batch = nextBatch;
+        decoded = nextDecoded;
     }
 
-    return true;
+    if ( pass == 1 ) {
+        m_referencedWays.clear();
+    } else if ( pass == 2 ) {
+        m_referencedNodes.clear();
+    }
+
+    qreal const seconds = qMax( 1, timer.elapsed() ) / 1000.0;
+    qWarning() << "Pass" << pass << "processed" << m_nodeCount << "nodes in" << seconds << "s ("
+               << qRound64( m_nodeCount / seconds ) << "nodes/sec)";
+
+    return success;
 }
 
 bool PbfParser::parseBlobHeader()
@@ -146,19 +160,21 @@ bool PbfParser::parseBlob()
         return false;
     }
 
-    if ( m_blob.has_raw() ) {
-        const std::string& data = m_blob.raw();
-        m_buffer.resize( data.size() );
-        for ( unsigned int i = 0; i < data.size(); ++i ) {
-            m_buffer[i] = data[i];
-        }
-    } else if ( m_blob.has_zlib_data() ) {
-        m_buffer.resize( m_blob.raw_size() );
+    return inflateBlob( m_blob, m_buffer );
+}
+
+bool PbfParser::inflateBlob( const Blob &blob, QByteArray &buffer )
+{
+    if ( blob.has_raw() ) {
+        const std::string& data = blob.raw();
+        buffer = QByteArray( data.data(), data.size() );
+    } else if ( blob.has_zlib_data() ) {
+        buffer.resize( blob.raw_size() );
         z_stream zStream;
-        zStream.next_in = ( unsigned char* ) m_blob.zlib_data().data();
-        zStream.avail_in = m_blob.zlib_data().size();
-        zStream.next_out = ( unsigned char* ) m_buffer.data();
-        zStream.avail_out = m_blob.raw_size();
+        zStream.next_in = ( unsigned char* ) blob.zlib_data().data();
+        zStream.avail_in = blob.zlib_data().size();
+        zStream.next_out = ( unsigned char* ) buffer.data();
+        zStream.avail_out = blob.raw_size();
         zStream.zalloc = Z_NULL;
         zStream.zfree = Z_NULL;
         zStream.opaque = Z_NULL;
@@ -177,9 +193,7 @@ bool PbfParser::parseBlob()
             qCritical() << "failed to close zlib m_stream";
             return false;
         }
-
-        return true;
-    } else if ( m_blob.has_lzma_data() ) {
+    } else if ( blob.has_lzma_data() ) {
         qCritical() << "No support for lzma decryption implemented, sorry.";
         return false;
     } else {
@@ -208,24 +222,83 @@ bool PbfParser::parseData()
     return true;
 }
 
-bool PbfParser::readNext()
+QList<QByteArray> PbfParser::readBlobs( int count, bool &success )
 {
-    if ( !parseBlobHeader() )
-        return false;
+    QList<QByteArray> result;
+    while ( result.size() < count && !m_stream.atEnd() ) {
+        if ( !parseBlobHeader() ) {
+            success = false;
+            break;
+        }
 
-    if ( m_blobHeader.type() != "OSMData" ) {
-        qCritical() << "invalid block type, found" << m_blobHeader.type().data() << "instead of OSMData";
-        return false;
+        if ( m_blobHeader.type() != "OSMData" ) {
+            qCritical() << "invalid block type, found" << m_blobHeader.type().data() << "instead of OSMData";
+            success = false;
+            break;
+        }
+
+        int size = m_blobHeader.datasize();
+        QByteArray blob( qMax( 0, size ), 0 );
+        if ( size < 0 || m_stream.readRawData( blob.data(), size ) != size ) {
+            qCritical() << "failed to read blob";
+            success = false;
+            break;
+        }
+
+        result << blob;
     }
 
-    if ( !parseBlob() )
-        return false;
+    return result;
+}
+
+PrimitiveBlock* PbfParser::decodeBlock( const QByteArray &data )
+{
+    Blob blob;
+    if ( !blob.ParseFromArray( data.constData(), data.size() ) ) {
+        qCritical() << "failed to parse blob";
+        return 0;
+    }
 
-    if ( !m_primitiveBlock.ParseFromArray( m_buffer.data(), m_buffer.size() ) ) {
+    QByteArray buffer;
+    if ( !inflateBlob( blob, buffer ) ) {
+        return 0;
+    }
+
+    PrimitiveBlock* block = new PrimitiveBlock;
+    if ( !block->ParseFromArray( buffer.constData(), buffer.size() ) ) {
         qCritical() << "failed to parse PrimitiveBlock";
-        return false;
+        delete block;
+        return 0;
+    }
+
+    return block;
+}
+
+void PbfParser::parsePrimitiveBlock()
+{
+    if ( m_primitiveBlock.primitivegroup_size() == 0 ) {
+        return;
+    }
+
+    loadBlock();
+    loadGroup();
+
+    while ( !m_loadBlock ) {
+        switch ( m_mode ) {
+        case ModeNode:
+            parseNode();
+            break;
+        case ModeWay:
+            parseWay();
+            break;
+        case ModeRelation:
+            parseRelation();
+            break;
+        case ModeDense:
+            parseDense();
+            break;
+        }
     }
-    return true;
 }
 
 void PbfParser::loadGroup()
@@ -257,6 +330,7 @@ void PbfParser::loadBlock()
 
 void PbfParser::parseNode()
 {
+    ++m_nodeCount;
     if ( m_pass == 2 ) {
         const Node& inputNode = m_primitiveBlock.primitivegroup( m_currentGroup ).nodes( m_currentEntity );
         Marble::Node node;
@@ -292,7 +366,7 @@ void PbfParser::parseNode()
         }
 
         if ( m_referencedNodes.contains( inputNode.id() ) ) {
-            m_coordinates[inputNode.id()] = node;
+            m_coordinates.append( inputNode.id(), node );
         }
     }
 
@@ -351,13 +425,13 @@ void PbfParser::parseWay()
 
         if ( relation.isAdministrativeBoundary && !way.name.isEmpty() ) {
             relation.name = way.name;
-            relation.ways << QPair<int, Marble::RelationRole>( inputWay.id(), Marble::Outer );
+            relation.ways << QPair<qint64, Marble::RelationRole>( inputWay.id(), Marble::Outer );
             m_relations[inputWay.id()] = relation;
         }
 
         if ( way.save || m_referencedWays.contains( inputWay.id() ) ) {
             if ( !way.isBuilding && way.nodes.size() > 1 && !m_referencedWays.contains( inputWay.id() ) ) {
-                QList<int> nodes = way.nodes;
+                QList<qint64> nodes = way.nodes;
                 way.nodes.clear();
                 way.nodes << nodes.first();
                 if ( nodes.size() > 2 ) {
@@ -366,7 +440,7 @@ void PbfParser::parseWay()
                 way.nodes << nodes.last();
             }
 
-            foreach( int node, way.nodes ) {
+            foreach( qint64 node, way.nodes ) {
                 m_referencedNodes << node;
             }
 
@@ -421,7 +495,7 @@ void PbfParser::parseRelation()
                     if ( role == "outer" ) relationRole = Marble::Outer;
                     if ( role == "inner" ) relationRole = Marble::Inner;
                     m_referencedWays << lastRef;
-                    relation.ways.push_back( QPair<int, Marble::RelationRole>( lastRef, relationRole ) );
+                    relation.ways.push_back( QPair<qint64, Marble::RelationRole>( lastRef, relationRole ) );
                 }
                 break;
                 case OSMPBF::Relation::RELATION:
@@ -446,6 +520,7 @@ void PbfParser::parseRelation()
 
 void PbfParser::parseDense()
 {
+    ++m_nodeCount;
     const DenseNodes& dense = m_primitiveBlock.primitivegroup( m_currentGroup ).dense();
     if ( m_pass == 2 ) {
         m_lastDenseID += dense.id( m_currentEntity );
@@ -495,7 +570,7 @@ void PbfParser::parseDense()
         }
 
         if ( m_referencedNodes.contains( m_lastDenseID ) ) {
-            m_coordinates[m_lastDenseID] = node;
+            m_coordinates.append( m_lastDenseID, node );
         }
     }
 
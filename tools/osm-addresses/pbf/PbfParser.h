@@ -24,6 +24,7 @@
 #include <QtCore/QSet>
 #include <QtCore/QFile>
 #include <QtCore/QDataStream>
+#include <QtCore/QList>
 
 class PbfParser : public Marble::OsmParser
 {
@@ -46,7 +47,15 @@ private:
 
     bool parseData();
 
-    bool readNext();
+    /** Read up to @p count raw OSMData blobs. @p success is set to false on errors */
+    QList<QByteArray> readBlobs( int count, bool &success );
+
+    /** Inflate and decode a raw OSMData blob. Thread-safe, the caller takes ownership */
+    static OSMPBF::PrimitiveBlock* decodeBlock( const QByteArray &blob );
+
+    static bool inflateBlob( const OSMPBF::Blob &blob, QByteArray &buffer );
+
+    void parsePrimitiveBlock();
 
     void loadBlock();
 
@@ -85,9 +94,10 @@ private:
     long long m_lastDenseLongitude;
     int m_lastDenseTag;
     int m_pass;
+    qint64 m_nodeCount;
 
-    QSet<int> m_referencedWays;
-    QSet<int> m_referencedNodes;
+    QSet<qint64> m_referencedWays;
+    QSet<qint64> m_referencedNodes;
 };
 
 #endif // PBFPARSER_H
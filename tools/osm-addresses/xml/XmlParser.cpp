@@ -44,31 +44,31 @@ bool XmlParser::startElement ( const QString & /*namespaceURI*/, const QString &
 {
     if ( qName == "node" ) {
         m_node = Node();
-        m_id = atts.value( "id" ).toInt();
+        m_id = atts.value( "id" ).toLongLong();
         m_node.lon = atts.value( "lon" ).toFloat();
         m_node.lat = atts.value( "lat" ).toFloat();
         m_element = NodeType;
     } else if ( qName == "way" ) {
-        m_id = atts.value( "id" ).toInt();
+        m_id = atts.value( "id" ).toLongLong();
         m_way = Way();
         m_element = WayType;
     } else if ( qName == "nd" ) {
-        m_way.nodes.push_back( atts.value( "ref" ).toInt() );
+        m_way.nodes.push_back( atts.value( "ref" ).toLongLong() );
     } else if ( qName == "relation" ) {
-        m_id = atts.value( "id" ).toInt();
+        m_id = atts.value( "id" ).toLongLong();
         m_relation = Relation();
         m_relation.nodes.clear();
         m_element = RelationType;
     } else if ( qName == "member" ) {
         if ( atts.value( "type" ) == "node" ) {
-            m_relation.nodes.push_back( atts.value( "ref" ).toInt() );
+            m_relation.nodes.push_back( atts.value( "ref" ).toLongLong() );
         } else if ( atts.value( "type" ) == "way" ) {
             RelationRole role = None;
             if ( atts.value( "role" ) == "outer" ) role = Outer;
             if ( atts.value( "role" ) == "inner" ) role = Inner;
-            m_relation.ways.push_back( QPair<int, RelationRole>( atts.value( "ref" ).toInt(), role ) );
+            m_relation.ways.push_back( QPair<qint64, RelationRole>( atts.value( "ref" ).toLongLong(), role ) );
         } else if ( atts.value( "type" ) == "relation" ) {
-            m_relation.relations.push_back( atts.value( "ref" ).toInt() );
+            m_relation.relations.push_back( atts.value( "ref" ).toLongLong() );
         } else {
             qDebug() << "Unknown relation member type " << atts.value( "type" );
         }
@@ -133,6 +133,7 @@ bool XmlParser::endElement ( const QString & /*namespaceURI*/, const QString & /
 {
     if ( qName == "node" ) {
         m_nodes[m_id] = m_node;
+        m_coordinates.append( m_id, m_node );
     } else if ( qName == "way" ) {
         m_ways[m_id] = m_way;
     } else if ( qName == "relation" ) {
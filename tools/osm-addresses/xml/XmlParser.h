@@ -51,7 +51,7 @@ private:
 
     Relation m_relation;
 
-    int m_id;
+    qint64 m_id;
 
     ElementType m_element;
 
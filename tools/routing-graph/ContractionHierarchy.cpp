@@ -0,0 +1,256 @@
+//
+// This file is part of the Marble Virtual Globe.
+//
+// This program is free software licensed under the GNU LGPL. You can
+// find a copy of this license in LICENSE.txt in the top directory of
+// the source code.
+//
+// Copyright 2026      agent <agent@local>
+//
+
+#include "ContractionHierarchy.h"
+#include "RoutingGraphFormat.h"
+
+#include <QtCore/QDebug>
+#include <QtCore/QPair>
+#include <QtCore/QSet>
+#include <QtCore/QTime>
+
+#include <functional>
+#include <queue>
+#include <vector>
+
+namespace Marble
+{
+
+using namespace RoutingGraphFormat;
+
+// Witness searches are stopped after settling that many nodes. A stopped
+// search may add a superfluous shortcut, but never misses a needed one.
+static const int simulationSettleLimit = 100;
+static const int contractionSettleLimit = 1000;
+
+ContractionHierarchy::ContractionHierarchy( int nodeCount ) :
+    m_edges( nodeCount ),
+    m_ranks( nodeCount, Infinity ),
+    m_contracted( nodeCount, false ),
+    m_contractedNeighbors( nodeCount, 0 ),
+    m_degrees( nodeCount, 0 ),
+    m_distances( nodeCount, Infinity )
+{
+    // nothing to do
+}
+
+void ContractionHierarchy::addEdge( quint32 from, quint32 to, quint32 weight, quint32 way )
+{
+    bool known = false;
+    foreach( const Edge &edge, m_edges[from] ) {
+        known = known || edge.target == to;
+    }
+    if ( !known ) {
+        ++m_degrees[from];
+        ++m_degrees[to];
+    }
+
+    // Each edge is known to both of its nodes
+    insertEdge( from, to, weight, way, Forward );
+    insertEdge( to, from, weight, way, Backward );
+}
+
+void ContractionHierarchy::insertEdge( quint32 node, quint32 target, quint32 weight, quint32 data, quint32 flags )
+{
+    QVector<Edge> &edges = m_edges[node];
+    for ( int i = 0; i < edges.size(); ++i ) {
+        Edge &edge = edges[i];
+        if ( edge.target == target && ( edge.flags & ( Forward | Backward ) ) == ( flags & ( Forward | Backward ) ) ) {
+            if ( weight < edge.weight ) {
+                edge.weight = weight;
+                edge.data = data;
+                edge.flags = flags;
+            }
+            return;
+        }
+    }
+
+    Edge edge;
+    edge.target = target;
+    edge.weight = weight;
+    edge.data = data;
+    edge.flags = flags;
+    edges << edge;
+}
+
+void ContractionHierarchy::witnessSearch( quint32 source, quint32 excluded, quint32 maxWeight, int maxSettled )
+{
+    foreach( quint32 node, m_touched ) {
+        m_distances[node] = Infinity;
+    }
+    m_touched.clear();
+
+    typedef QPair<quint32, quint32> QueueItem; // distance, node
+    std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem> > queue;
+    m_distances[source] = 0;
+    m_touched << source;
+    queue.push( QueueItem( 0, source ) );
+
+    int settled = 0;
+    while ( !queue.empty() && settled < maxSettled ) {
+        QueueItem const item = queue.top();
+        queue.pop();
+        if ( item.first > m_distances[item.second] ) {
+            continue;
+        }
+        if ( item.first > maxWeight ) {
+            break;
+        }
+        ++settled;
+
+        foreach( const Edge &edge, m_edges[item.second] ) {
+            if ( !( edge.flags & Forward ) || edge.target == excluded || m_contracted[edge.target] ) {
+                continue;
+            }
+
+            quint32 const distance = item.first + edge.weight;
+            if ( distance < m_distances[edge.target] ) {
+                if ( m_distances[edge.target] == Infinity ) {
+                    m_touched << edge.target;
+                }
+                m_distances[edge.target] = distance;
+                queue.push( QueueItem( distance, edge.target ) );
+            }
+        }
+    }
+}
+
+int ContractionHierarchy::contractNode( quint32 node, bool simulate )
+{
+    QVector<Edge> incoming;
+    QVector<Edge> outgoing;
+    foreach( const Edge &edge, m_edges[node] ) {
+        if ( m_contracted[edge.target] ) {
+            continue;
+        }
+        if ( edge.flags & Backward ) {
+            incoming << edge;
+        }
+        if ( edge.flags & Forward ) {
+            outgoing << edge;
+        }
+    }
+
+    int shortcuts = 0;
+    foreach( const Edge &in, incoming ) {
+        quint32 maxWeight = 0;
+        foreach( const Edge &out, outgoing ) {
+            if ( out.target != in.target ) {
+                maxWeight = qMax( maxWeight, in.weight + out.weight );
+            }
+        }
+        if ( maxWeight == 0 ) {
+            continue;
+        }
+
+        witnessSearch( in.target, node, maxWeight, simulate ? simulationSettleLimit : contractionSettleLimit );
+
+        foreach( const Edge &out, outgoing ) {
+            if ( out.target == in.target ) {
+                continue;
+            }
+
+            quint32 const weight = in.weight + out.weight;
+            if ( m_distances[out.target] > weight ) {
+                // No path avoiding node is as short, so a shortcut is needed
+                ++shortcuts;
+                if ( !simulate ) {
+                    insertEdge( in.target, out.target, weight, node, Forward | Shortcut );
+                    insertEdge( out.target, in.target, weight, node, Backward | Shortcut );
+                }
+            }
+        }
+    }
+
+    return shortcuts - incoming.size() - outgoing.size();
+}
+
+int ContractionHierarchy::priority( quint32 node )
+{
+    int const edgeDifference = contractNode( node, true );
+    return 2 * edgeDifference + m_contractedNeighbors[node];
+}
+
+void ContractionHierarchy::contract()
+{
+    QTime timer;
+    timer.start();
+
+    typedef QPair<int, quint32> QueueItem; // priority, node
+    std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem> > queue;
+    for ( int i = 0; i < m_edges.size(); ++i ) {
+        queue.push( QueueItem( priority( i ), i ) );
+    }
+
+    quint32 rank = 0;
+    while ( !queue.empty() ) {
+        quint32 const node = queue.top().second;
+        queue.pop();
+
+        // Priorities change while neighbors get contracted. Update them lazily.
+        int const current = priority( node );
+        if ( !queue.empty() && current > queue.top().first ) {
+            queue.push( QueueItem( current, node ) );
+            continue;
+        }
+
+        contractNode( node, false );
+        m_contracted[node] = true;
+        m_ranks[node] = rank++;
+
+        foreach( const Edge &edge, m_edges[node] ) {
+            ++m_contractedNeighbors[edge.target];
+        }
+
+        if ( rank % 100000 == 0 ) {
+            qDebug() << "Contracted" << rank << "of" << m_edges.size() << "nodes";
+        }
+    }
+
+    qDebug() << "Contraction finished in" << timer.elapsed() / 1000 << "seconds";
+}
+
+quint32 ContractionHierarchy::rank( quint32 node ) const
+{
+    return m_ranks[node];
+}
+
+int ContractionHierarchy::degree( quint32 node ) const
+{
+    return m_degrees[node];
+}
+
+QVector<ContractionHierarchy::Edge> ContractionHierarchy::upwardEdges( quint32 node ) const
+{
+    QVector<Edge> result;
+    foreach( const Edge &edge, m_edges[node] ) {
+        if ( m_ranks[edge.target] < m_ranks[node] ) {
+            continue;
+        }
+
+        bool merged = false;
+        for ( int i = 0; i < result.size() && !merged; ++i ) {
+            Edge &other = result[i];
+            if ( other.target == edge.target && other.weight == edge.weight && other.data == edge.data
+                 && ( other.flags & Shortcut ) == ( edge.flags & Shortcut ) ) {
+                other.flags |= edge.flags;
+                merged = true;
+            }
+        }
+
+        if ( !merged ) {
+            result << edge;
+        }
+    }
+
+    return result;
+}
+
+}
@@ -0,0 +1,83 @@
+//
+// This file is part of the Marble Virtual Globe.
+//
+// This program is free software licensed under the GNU LGPL. You can
+// find a copy of this license in LICENSE.txt in the top directory of
+// the source code.
+//
+// Copyright 2026      agent <agent@local>
+//
+
+#ifndef MARBLE_CONTRACTIONHIERARCHY_H
+#define MARBLE_CONTRACTIONHIERARCHY_H
+
+#include <QtCore/QVector>
+
+namespace Marble
+{
+
+/**
+ * @short Preprocesses a road network with contraction hierarchies.
+ *
+ * Nodes are contracted one after another in the order of their importance,
+ * which is estimated by the number of shortcuts their contraction needs. The
+ * shortcuts preserve the shortest paths between the remaining nodes. Each
+ * node gets the position it was contracted at as its rank.
+ */
+class ContractionHierarchy
+{
+public:
+    struct Edge
+    {
+        quint32 target;
+        quint32 weight;
+        quint32 data;    ///< Bypassed node for shortcuts, the way otherwise
+        quint32 flags;   ///< RoutingGraphFormat::EdgeFlag values
+    };
+
+    explicit ContractionHierarchy( int nodeCount );
+
+    /** Adds the directed edge from -> to of the original road network */
+    void addEdge( quint32 from, quint32 to, quint32 weight, quint32 way );
+
+    void contract();
+
+    quint32 rank( quint32 node ) const;
+
+    /** Number of neighbors in the original road network */
+    int degree( quint32 node ) const;
+
+    /**
+     * The edges to nodes with a higher rank, including shortcuts. Edges that can
+     * be used in both directions are merged.
+     */
+    QVector<Edge> upwardEdges( quint32 node ) const;
+
+private:
+    enum {
+        Infinity = 0xffffffff
+    };
+
+    void insertEdge( quint32 node, quint32 target, quint32 weight, quint32 data, quint32 flags );
+
+    /** Number of shortcuts the contraction of node needs, which are added if not simulating */
+    int contractNode( quint32 node, bool simulate );
+
+    int priority( quint32 node );
+
+    void witnessSearch( quint32 source, quint32 excluded, quint32 maxWeight, int maxSettled );
+
+    QVector< QVector<Edge> > m_edges;
+    QVector<quint32> m_ranks;
+    QVector<bool> m_contracted;
+    QVector<int> m_contractedNeighbors;
+    QVector<int> m_degrees;
+
+    // State of the witness search, reused to avoid allocations
+    QVector<quint32> m_distances;
+    QVector<quint32> m_touched;
+};
+
+}
+
+#endif
@@ -0,0 +1,349 @@
+//
+// This file is part of the Marble Virtual Globe.
+//
+// This program is free software licensed under the GNU LGPL. You can
+// find a copy of this license in LICENSE.txt in the top directory of
+// the source code.
+//
+// Copyright 2026      agent <agent@local>
+//
+
+#include "OsmRoutingReader.h"
+#include "RoutingGraphFormat.h"
+
+#include <QtCore/QDebug>
+#include <QtCore/QFile>
+#include <QtCore/QXmlStreamReader>
+
+#include <cmath>
+
+namespace Marble
+{
+
+OsmRoutingReader::OsmRoutingReader( Transport transport ) :
+    m_transport( transport )
+{
+    // nothing to do
+}
+
+bool OsmRoutingReader::read( const QString &filename )
+{
+    if ( !readWays( filename ) || !readNodes( filename ) ) {
+        return false;
+    }
+
+    createEdges();
+    qDebug() << "Read" << m_ways.size() << "ways with" << m_longitudes.size() << "nodes and"
+             << m_edges.size() << "edges";
+    return true;
+}
+
+const QVector<qint32> &OsmRoutingReader::longitudes() const
+{
+    return m_longitudes;
+}
+
+const QVector<qint32> &OsmRoutingReader::latitudes() const
+{
+    return m_latitudes;
+}
+
+const QVector<RoadEdge> &OsmRoutingReader::edges() const
+{
+    return m_edges;
+}
+
+const QVector<RoadWay> &OsmRoutingReader::ways() const
+{
+    return m_ways;
+}
+
+bool OsmRoutingReader::readWays( const QString &filename )
+{
+    QFile file( filename );
+    if ( !file.open( QFile::ReadOnly ) ) {
+        qCritical() << "Cannot open" << filename;
+        return false;
+    }
+
+    QXmlStreamReader xml( &file );
+    while ( !xml.atEnd() ) {
+        if ( xml.readNext() == QXmlStreamReader::StartElement && xml.name() == "way" ) {
+            readWay( xml );
+        }
+    }
+
+    if ( xml.hasError() ) {
+        qCritical() << "Failed to parse" << filename << ":" << xml.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+void OsmRoutingReader::readWay( QXmlStreamReader &xml )
+{
+    QVector<qint64> nodes;
+    QString highway;
+    QString name;
+    QString oneway;
+    QString junction;
+    QHash<QString, QString> access;
+    qreal maxSpeed = 0.0;
+
+    while ( !xml.atEnd() ) {
+        QXmlStreamReader::TokenType const token = xml.readNext();
+        if ( token == QXmlStreamReader::EndElement && xml.name() == "way" ) {
+            break;
+        }
+        if ( token != QXmlStreamReader::StartElement ) {
+            continue;
+        }
+
+        QXmlStreamAttributes const attributes = xml.attributes();
+        if ( xml.name() == "nd" ) {
+            nodes << attributes.value( "ref" ).toString().toLongLong();
+        } else if ( xml.name() == "tag" ) {
+            QString const key = attributes.value( "k" ).toString();
+            QString const value = attributes.value( "v" ).toString();
+            if ( key == "highway" ) {
+                highway = value;
+            } else if ( key == "name" ) {
+                name = value;
+            } else if ( key == "ref" && name.isEmpty() ) {
+                name = value;
+            } else if ( key == "oneway" ) {
+                oneway = value;
+            } else if ( key == "junction" ) {
+                junction = value;
+            } else if ( key == "maxspeed" ) {
+                // Only plain km/h values are considered
+                maxSpeed = value.toDouble();
+            } else if ( key == "access" || key == "motor_vehicle" || key == "motorcar"
+                        || key == "bicycle" || key == "foot" || key == "oneway:bicycle" ) {
+                access[key] = value;
+            }
+        }
+    }
+
+    qreal wayspeed = speed( highway );
+    if ( wayspeed <= 0.0 || nodes.size() < 2 ) {
+        return;
+    }
+
+    QStringList accessKeys = QStringList() << "access";
+    if ( m_transport == Motorcar ) {
+        accessKeys << "motor_vehicle" << "motorcar";
+        if ( maxSpeed > 0.0 ) {
+            wayspeed = qMin( wayspeed, maxSpeed );
+        }
+    } else if ( m_transport == Bicycle ) {
+        accessKeys << "bicycle";
+    } else {
+        accessKeys << "foot";
+    }
+
+    bool allowed = true;
+    foreach( const QString &key, accessKeys ) {
+        if ( access.contains( key ) ) {
+            QString const value = access[key];
+            allowed = value != "no" && value != "private";
+        }
+    }
+    if ( !allowed ) {
+        return;
+    }
+
+    bool const roundabout = junction == "roundabout";
+    bool forward = true;
+    bool backward = true;
+    if ( m_transport != Pedestrian ) {
+        if ( oneway == "yes" || oneway == "true" || oneway == "1" || ( roundabout && oneway.isEmpty() )
+             || ( oneway.isEmpty() && ( highway == "motorway" || highway == "motorway_link" ) ) ) {
+            backward = false;
+        } else if ( oneway == "-1" ) {
+            forward = false;
+        }
+        if ( m_transport == Bicycle && access.value( "oneway:bicycle" ) == "no" ) {
+            forward = backward = true;
+        }
+    }
+
+    const char * const *types = RoutingGraphFormat::highwayTypes();
+    quint16 type = 0;
+    while ( types[type] && highway != types[type] ) {
+        ++type;
+    }
+
+    RoadWay way;
+    way.name = name.toUtf8();
+    way.type = type;
+    way.roundabout = roundabout;
+
+    PendingWay pending;
+    pending.way = m_ways.size();
+    pending.speed = wayspeed;
+    pending.forward = forward;
+    pending.backward = backward;
+    foreach( qint64 id, nodes ) {
+        QHash<qint64, quint32>::const_iterator const iter = m_nodeIndex.constFind( id );
+        if ( iter == m_nodeIndex.constEnd() ) {
+            quint32 const index = m_nodeIndex.size();
+            m_nodeIndex.insert( id, index );
+            pending.nodes << index;
+        } else {
+            pending.nodes << iter.value();
+        }
+    }
+
+    m_ways << way;
+    m_pendingWays << pending;
+}
+
+bool OsmRoutingReader::readNodes( const QString &filename )
+{
+    QFile file( filename );
+    if ( !file.open( QFile::ReadOnly ) ) {
+        qCritical() << "Cannot open" << filename;
+        return false;
+    }
+
+    int const nodeCount = m_nodeIndex.size();
+    m_longitudes.fill( 0, nodeCount );
+    m_latitudes.fill( 0, nodeCount );
+    m_hasCoordinates.fill( false, nodeCount );
+
+    QXmlStreamReader xml( &file );
+    while ( !xml.atEnd() ) {
+        if ( xml.readNext() != QXmlStreamReader::StartElement ) {
+            continue;
+        }
+
+        if ( xml.name() == "way" || xml.name() == "relation" ) {
+            // Nodes come first in .osm files
+            break;
+        }
+
+        if ( xml.name() == "node" ) {
+            QXmlStreamAttributes const attributes = xml.attributes();
+            qint64 const id = attributes.value( "id" ).toString().toLongLong();
+            QHash<qint64, quint32>::const_iterator const iter = m_nodeIndex.constFind( id );
+            if ( iter != m_nodeIndex.constEnd() ) {
+                qreal const lon = attributes.value( "lon" ).toString().toDouble();
+                qreal const lat = attributes.value( "lat" ).toString().toDouble();
+                m_longitudes[iter.value()] = qRound( lon * RoutingGraphFormat::CoordinateFactor );
+                m_latitudes[iter.value()] = qRound( lat * RoutingGraphFormat::CoordinateFactor );
+                m_hasCoordinates[iter.value()] = true;
+            }
+        }
+    }
+
+    if ( xml.hasError() ) {
+        qCritical() << "Failed to parse" << filename << ":" << xml.errorString();
+        return false;
+    }
+
+    int const missing = m_hasCoordinates.count( false );
+    if ( missing > 0 ) {
+        qWarning() << missing << "nodes referenced by ways are missing in" << filename;
+    }
+
+    return true;
+}
+
+qreal OsmRoutingReader::speed( const QString &highway ) const
+{
+    static QHash<QString, qreal> carSpeeds;
+    static QHash<QString, qreal> bicycleSpeeds;
+    static QHash<QString, qreal> footSpeeds;
+
+    if ( carSpeeds.isEmpty() ) {
+        carSpeeds["motorway"] = 110;
+        carSpeeds["motorway_link"] = 60;
+        carSpeeds["trunk"] = 90;
+        carSpeeds["trunk_link"] = 50;
+        carSpeeds["primary"] = 70;
+        carSpeeds["primary_link"] = 50;
+        carSpeeds["secondary"] = 60;
+        carSpeeds["secondary_link"] = 40;
+        carSpeeds["tertiary"] = 50;
+        carSpeeds["tertiary_link"] = 30;
+        carSpeeds["unclassified"] = 40;
+        carSpeeds["residential"] = 30;
+        carSpeeds["road"] = 30;
+        carSpeeds["living_street"] = 10;
+        carSpeeds["service"] = 15;
+
+        bicycleSpeeds = carSpeeds;
+        bicycleSpeeds.remove( "motorway" );
+        bicycleSpeeds.remove( "motorway_link" );
+        bicycleSpeeds.remove( "trunk" );
+        bicycleSpeeds.remove( "trunk_link" );
+        foreach( const QString &key, bicycleSpeeds.keys() ) {
+            bicycleSpeeds[key] = 16;
+        }
+        bicycleSpeeds["cycleway"] = 18;
+        bicycleSpeeds["track"] = 12;
+        bicycleSpeeds["path"] = 12;
+
+        footSpeeds = bicycleSpeeds;
+        foreach( const QString &key, footSpeeds.keys() ) {
+            footSpeeds[key] = 5;
+        }
+        footSpeeds["footway"] = 5;
+        footSpeeds["pedestrian"] = 5;
+        footSpeeds["steps"] = 3;
+    }
+
+    switch ( m_transport ) {
+    case Motorcar:
+        return carSpeeds.value( highway );
+    case Bicycle:
+        return bicycleSpeeds.value( highway );
+    case Pedestrian:
+        return footSpeeds.value( highway );
+    }
+
+    return 0.0;
+}
+
+void OsmRoutingReader::createEdges()
+{
+    qreal const earthRadius = 6378000.0;
+    qreal const deg2rad = M_PI / 180.0 / RoutingGraphFormat::CoordinateFactor;
+
+    foreach( const PendingWay &way, m_pendingWays ) {
+        for ( int i = 1; i < way.nodes.size(); ++i ) {
+            quint32 const a = way.nodes[i-1];
+            quint32 const b = way.nodes[i];
+            if ( a == b || !m_hasCoordinates[a] || !m_hasCoordinates[b] ) {
+                continue;
+            }
+
+            qreal const latA = m_latitudes[a] * deg2rad;
+            qreal const latB = m_latitudes[b] * deg2rad;
+            qreal const x = ( m_longitudes[b] - m_longitudes[a] ) * deg2rad * cos( 0.5 * ( latA + latB ) );
+            qreal const y = latB - latA;
+            qreal const meters = earthRadius * sqrt( x * x + y * y );
+
+            RoadEdge edge;
+            edge.weight = qMax<quint32>( 1, qRound( 10.0 * meters / ( way.speed / 3.6 ) ) );
+            edge.way = way.way;
+            if ( way.forward ) {
+                edge.from = a;
+                edge.to = b;
+                m_edges << edge;
+            }
+            if ( way.backward ) {
+                edge.from = b;
+                edge.to = a;
+                m_edges << edge;
+            }
+        }
+    }
+
+    m_pendingWays.clear();
+    m_nodeIndex.clear();
+}
+
+}
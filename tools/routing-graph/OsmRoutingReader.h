@@ -0,0 +1,104 @@
+//
+// This file is part of the Marble Virtual Globe.
+//
+// This program is free software licensed under the GNU LGPL. You can
+// find a copy of this license in LICENSE.txt in the top directory of
+// the source code.
+//
+// Copyright 2026      agent <agent@local>
+//
+
+#ifndef MARBLE_OSMROUTINGREADER_H
+#define MARBLE_OSMROUTINGREADER_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+
+class QXmlStreamReader;
+
+namespace Marble
+{
+
+/** Same values as RoutingProfile::TransportType */
+enum Transport {
+    Motorcar = 0,
+    Bicycle = 1,
+    Pedestrian = 2
+};
+
+/** A directed connection between two subsequent nodes of a way */
+struct RoadEdge
+{
+    quint32 from;
+    quint32 to;
+    quint32 weight; ///< Travel time in tenths of a second
+    quint32 way;
+};
+
+struct RoadWay
+{
+    QByteArray name;
+    quint16 type;
+    bool roundabout;
+};
+
+/**
+ * @short Extracts the road network usable with a transport type from an .osm file.
+ *
+ * The file is read twice: The first pass collects the routable ways, the
+ * second one the coordinates of the nodes they reference.
+ */
+class OsmRoutingReader
+{
+public:
+    explicit OsmRoutingReader( Transport transport );
+
+    bool read( const QString &filename );
+
+    /** Coordinates of the nodes in fixed point degrees, see RoutingGraphFormat */
+    const QVector<qint32> &longitudes() const;
+    const QVector<qint32> &latitudes() const;
+
+    const QVector<RoadEdge> &edges() const;
+
+    const QVector<RoadWay> &ways() const;
+
+private:
+    struct PendingWay
+    {
+        QVector<quint32> nodes;
+        quint32 way;
+        qreal speed;     ///< km/h
+        bool forward;
+        bool backward;
+    };
+
+    bool readWays( const QString &filename );
+
+    bool readNodes( const QString &filename );
+
+    void readWay( QXmlStreamReader &xml );
+
+    /** The speed in km/h on a highway of the given type or 0 if it is not usable */
+    qreal speed( const QString &highway ) const;
+
+    void createEdges();
+
+    Transport m_transport;
+
+    QHash<qint64, quint32> m_nodeIndex;
+    QVector<qint32> m_longitudes;
+    QVector<qint32> m_latitudes;
+    QVector<bool> m_hasCoordinates;
+
+    QVector<PendingWay> m_pendingWays;
+    QVector<RoadEdge> m_edges;
+    QVector<RoadWay> m_ways;
+};
+
+}
+
+#endif
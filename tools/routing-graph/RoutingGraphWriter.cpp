@@ -0,0 +1,212 @@
+//
+// This file is part of the Marble Virtual Globe.
+//
+// This program is free software licensed under the GNU LGPL. You can
+// find a copy of this license in LICENSE.txt in the top directory of
+// the source code.
+//
+// Copyright 2026      agent <agent@local>
+//
+
+#include "RoutingGraphWriter.h"
+#include "ContractionHierarchy.h"
+#include "OsmRoutingReader.h"
+#include "RoutingGraphFormat.h"
+
+#include <QtCore/QDebug>
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QPair>
+
+#include <climits>
+#include <cmath>
+#include <cstring>
+
+namespace Marble
+{
+
+using namespace RoutingGraphFormat;
+
+namespace
+{
+
+/** Writes the data and pads it to a multiple of four bytes */
+bool writeSection( QFile &file, const char *data, qint64 size )
+{
+    if ( file.write( data, size ) != size ) {
+        return false;
+    }
+    qint64 const padding = ( 4 - size % 4 ) % 4;
+    return file.write( QByteArray( padding, '\0' ) ) == padding;
+}
+
+template<class T>
+bool writeSection( QFile &file, const QVector<T> &data )
+{
+    return writeSection( file, reinterpret_cast<const char*>( data.constData() ), data.size() * sizeof( T ) );
+}
+
+quint32 alignedSize( qint64 size )
+{
+    return quint32( ( size + 3 ) / 4 * 4 );
+}
+
+}
+
+RoutingGraphWriter::RoutingGraphWriter( const OsmRoutingReader &reader, const ContractionHierarchy &hierarchy ) :
+    m_reader( reader ),
+    m_hierarchy( hierarchy )
+{
+    // nothing to do
+}
+
+bool RoutingGraphWriter::write( const QString &filename, int transport ) const
+{
+    QVector<qint32> const &longitudes = m_reader.longitudes();
+    QVector<qint32> const &latitudes = m_reader.latitudes();
+
+    // Nodes without any edge cannot be part of a route
+    QVector<quint32> used;
+    Header header;
+    memset( &header, 0, sizeof( Header ) );
+    header.west = INT_MAX;
+    header.south = INT_MAX;
+    header.east = INT_MIN;
+    header.north = INT_MIN;
+    for ( int i = 0; i < longitudes.size(); ++i ) {
+        if ( m_hierarchy.degree( i ) > 0 ) {
+            used << i;
+            header.west = qMin( header.west, longitudes[i] );
+            header.east = qMax( header.east, longitudes[i] );
+            header.south = qMin( header.south, latitudes[i] );
+            header.north = qMax( header.north, latitudes[i] );
+        }
+    }
+
+    if ( used.isEmpty() ) {
+        qCritical() << "The road network is empty, no routing graph written.";
+        return false;
+    }
+
+    // About 16 nodes per cell keep nearest node lookups fast
+    header.gridSize = qBound( 1, int( sqrt( used.size() / 16.0 ) ), 1024 );
+    qint64 const width = qMax<qint64>( 1, qint64( header.east ) - header.west );
+    qint64 const height = qMax<qint64>( 1, qint64( header.north ) - header.south );
+
+    QVector< QPair<quint32, quint32> > cells; // cell, node
+    cells.reserve( used.size() );
+    foreach( quint32 node, used ) {
+        qint64 const column = qMin<qint64>( ( qint64( longitudes[node] ) - header.west ) * header.gridSize / width, header.gridSize - 1 );
+        qint64 const row = qMin<qint64>( ( qint64( latitudes[node] ) - header.south ) * header.gridSize / height, header.gridSize - 1 );
+        cells << QPair<quint32, quint32>( row * header.gridSize + column, node );
+    }
+    qSort( cells );
+
+    QHash<quint32, quint32> newIds;
+    for ( int i = 0; i < cells.size(); ++i ) {
+        newIds[cells[i].second] = i;
+    }
+
+    QVector<quint32> cellOffsets( header.gridSize * header.gridSize + 1, 0 );
+    for ( int i = 0, cell = 0; cell <= int( header.gridSize * header.gridSize ); ++cell ) {
+        while ( i < cells.size() && int( cells[i].first ) < cell ) {
+            ++i;
+        }
+        cellOffsets[cell] = i;
+    }
+
+    QVector<Node> nodes;
+    QVector<Edge> edges;
+    nodes.reserve( cells.size() + 1 );
+    for ( int i = 0; i < cells.size(); ++i ) {
+        quint32 const oldId = cells[i].second;
+
+        Node node;
+        node.lon = longitudes[oldId];
+        node.lat = latitudes[oldId];
+        node.firstEdge = edges.size();
+        node.rank = m_hierarchy.rank( oldId );
+        node.degree = qMin( 0xffff, m_hierarchy.degree( oldId ) );
+        node.reserved = 0;
+        nodes << node;
+
+        foreach( const ContractionHierarchy::Edge &upward, m_hierarchy.upwardEdges( oldId ) ) {
+            Edge edge;
+            edge.target = newIds.value( upward.target );
+            edge.weight = upward.weight;
+            edge.data = ( upward.flags & Shortcut ) ? newIds.value( upward.data ) : upward.data;
+            edge.flags = upward.flags;
+            edges << edge;
+        }
+    }
+
+    Node sentinel;
+    memset( &sentinel, 0, sizeof( Node ) );
+    sentinel.firstEdge = edges.size();
+    nodes << sentinel;
+
+    QVector<Way> ways;
+    QByteArray strings( 1, '\0' );
+    QHash<QByteArray, quint32> stringOffsets;
+    foreach( const RoadWay &roadWay, m_reader.ways() ) {
+        Way way;
+        way.name = 0;
+        if ( !roadWay.name.isEmpty() ) {
+            if ( !stringOffsets.contains( roadWay.name ) ) {
+                stringOffsets[roadWay.name] = strings.size();
+                strings.append( roadWay.name );
+                strings.append( '\0' );
+            }
+            way.name = stringOffsets[roadWay.name];
+        }
+        way.type = roadWay.type;
+        way.flags = roadWay.roundabout ? Roundabout : 0;
+        ways << way;
+    }
+
+    header.magic = MagicNumber;
+    header.version = Version;
+    header.transport = transport;
+    header.nodeCount = nodes.size() - 1;
+    header.edgeCount = edges.size();
+    header.wayCount = ways.size();
+    header.stringSize = strings.size();
+    header.nodesOffset = alignedSize( sizeof( Header ) );
+    header.edgesOffset = header.nodesOffset + alignedSize( nodes.size() * sizeof( Node ) );
+    header.waysOffset = header.edgesOffset + alignedSize( edges.size() * sizeof( Edge ) );
+    header.stringsOffset = header.waysOffset + alignedSize( ways.size() * sizeof( Way ) );
+    header.cellsOffset = header.stringsOffset + alignedSize( strings.size() );
+
+    // Write to a temporary file first, the plugin may have mapped the old one
+    QString const partFile = filename + ".part";
+    QFile file( partFile );
+    if ( !file.open( QFile::WriteOnly | QFile::Truncate ) ) {
+        qCritical() << "Cannot write" << partFile;
+        return false;
+    }
+
+    bool success = writeSection( file, reinterpret_cast<const char*>( &header ), sizeof( Header ) );
+    success = success && writeSection( file, nodes );
+    success = success && writeSection( file, edges );
+    success = success && writeSection( file, ways );
+    success = success && writeSection( file, strings.constData(), strings.size() );
+    success = success && writeSection( file, cellOffsets );
+    file.close();
+
+    if ( !success ) {
+        qCritical() << "Failed to write" << partFile;
+        QFile::remove( partFile );
+        return false;
+    }
+
+    QFile::remove( filename );
+    if ( !QFile::rename( partFile, filename ) ) {
+        qCritical() << "Cannot rename" << partFile << "to" << filename;
+        return false;
+    }
+
+    qDebug() << "Wrote" << header.nodeCount << "nodes and" << header.edgeCount << "edges to" << filename;
+    return true;
+}
+
+}
@@ -0,0 +1,42 @@
+//
+// This file is part of the Marble Virtual Globe.
+//
+// This program is free software licensed under the GNU LGPL. You can
+// find a copy of this license in LICENSE.txt in the top directory of
+// the source code.
+//
+// Copyright 2026      agent <agent@local>
+//
+
+#ifndef MARBLE_ROUTINGGRAPHWRITER_H
+#define MARBLE_ROUTINGGRAPHWRITER_H
+
+#include <QtCore/QString>
+
+namespace Marble
+{
+
+class ContractionHierarchy;
+class OsmRoutingReader;
+
+/**
+ * @short Writes a contracted road network in the format of RoutingGraphFormat.
+ *
+ * Nodes without edges are dropped and the remaining ones are sorted by the
+ * grid cell they are located in.
+ */
+class RoutingGraphWriter
+{
+public:
+    RoutingGraphWriter( const OsmRoutingReader &reader, const ContractionHierarchy &hierarchy );
+
+    bool write( const QString &filename, int transport ) const;
+
+private:
+    const OsmRoutingReader &m_reader;
+    const ContractionHierarchy &m_hierarchy;
+};
+
+}
+
+#endif
@@ -0,0 +1,83 @@
+//
+// This file is part of the Marble Virtual Globe.
+//
+// This program is free software licensed under the GNU LGPL. You can
+// find a copy of this license in LICENSE.txt in the top directory of
+// the source code.
+//
+// Copyright 2026      agent <agent@local>
+//
+
+#include "ContractionHierarchy.h"
+#include "OsmRoutingReader.h"
+#include "RoutingGraphWriter.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDebug>
+#include <QtCore/QFileInfo>
+#include <QtCore/QStringList>
+
+using namespace Marble;
+
+void usage()
+{
+    qDebug() << "Usage: routing-graph [--transport motorcar|bicycle|foot] input.osm output.chg";
+    qDebug() << "\tPreprocesses the roads in input.osm for the local routing plugin.";
+    qDebug() << "\tInstall the result in maps/earth/local-routing/ of the local Marble data directory.";
+}
+
+int main( int argc, char *argv[] )
+{
+    QCoreApplication app( argc, argv );
+    QStringList const arguments = app.arguments();
+    if ( arguments.size() < 3 ) {
+        usage();
+        return 1;
+    }
+
+    Transport transport = Motorcar;
+    for ( int i = 1; i < arguments.size() - 2; ++i ) {
+        if ( arguments[i] == "--transport" && i + 1 < arguments.size() - 2 ) {
+            QString const value = arguments[++i];
+            if ( value == "motorcar" ) {
+                transport = Motorcar;
+            } else if ( value == "bicycle" ) {
+                transport = Bicycle;
+            } else if ( value == "foot" ) {
+                transport = Pedestrian;
+            } else {
+                usage();
+                return 1;
+            }
+        } else {
+            usage();
+            return 1;
+        }
+    }
+
+    QFileInfo const input( arguments[arguments.size() - 2] );
+    QString const output = arguments.last();
+    if ( !input.exists() ) {
+        qDebug() << "File " << input.absoluteFilePath() << " does not exist. Exiting.";
+        return 2;
+    }
+
+    if ( !input.fileName().endsWith( ".osm" ) ) {
+        qDebug() << "Unsupported file format: " << input.fileName();
+        return 3;
+    }
+
+    OsmRoutingReader reader( transport );
+    if ( !reader.read( input.absoluteFilePath() ) ) {
+        return 4;
+    }
+
+    ContractionHierarchy hierarchy( reader.longitudes().size() );
+    foreach( const RoadEdge &edge, reader.edges() ) {
+        hierarchy.addEdge( edge.from, edge.to, edge.weight, edge.way );
+    }
+    hierarchy.contract();
+
+    RoutingGraphWriter writer( reader, hierarchy );
+    return writer.write( output, transport ) ? 0 : 5;
+}
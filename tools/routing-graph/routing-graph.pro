@@ -0,0 +1,22 @@
+QT       += core
+QT       -= gui
+
+TARGET = routing-graph
+CONFIG   += console
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+# The file format is shared with the local routing plugin
+INCLUDEPATH += ../../src/plugins/runner/local-routing
+
+SOURCES += main.cpp \
+    OsmRoutingReader.cpp \
+    ContractionHierarchy.cpp \
+    RoutingGraphWriter.cpp
+
+HEADERS += \
+    OsmRoutingReader.h \
+    ContractionHierarchy.h \
+    RoutingGraphWriter.h \
+    ../../src/plugins/runner/local-routing/RoutingGraphFormat.h
@@ -22,6 +22,13 @@ int main(int argc, char *argv[])
 {
     QCoreApplication  app(argc, argv);
 
+    // Stars up to magnitude 6 are visible to the naked eye. The stars plugin
+    // picks the stars to show by magnitude, so fainter ones can be included.
+    double maximumMagnitude = 6.0;
+    if ( app.arguments().size() > 1 ) {
+        maximumMagnitude = app.arguments().at( 1 ).toDouble();
+    }
+
     QFile file("stars.dat");
     file.open(QIODevice::WriteOnly);
     QDataStream out(&file);
@@ -60,7 +67,7 @@ int main(int argc, char *argv[])
             double magValue = magString.toDouble();
 
 //            qDebug() << "Rec:" << recString << "Dec.:" << decString << "Mag.:" << magString;
-            if ( !line.isNull() && magValue < 6.0 ) {
+            if ( !line.isNull() && magValue < maximumMagnitude ) {
                 qDebug() << "RA:" << raValue << "DE:" << deValue << "mag:" << magValue;
                 out << raValue;
                 out << deValue;